@@ -52,6 +52,9 @@
 /* Define to 1 if you have the 'setenv' function. */
 #cmakedefine HAVE_SETENV 1
 
+/* Define to 1 if you have the 'fork' function. */
+#cmakedefine HAVE_FORK 1
+
 /* Define to 1 if you have the `select' function. */
 #cmakedefine HAVE_SELECT 1
 
@@ -64,6 +67,9 @@
 /* Define to 1 if you have the 'nanosleep' function. */
 #cmakedefine HAVE_NANOSLEEP 1
 
+/* Define to 1 if you have the 'clock_nanosleep' function. */
+#cmakedefine HAVE_CLOCK_NANOSLEEP 1
+
 /* Define to 1 if you have the 'alphasort' function. */
 #cmakedefine HAVE_ALPHASORT 1
 
@@ -8,7 +8,7 @@
 #include "main.h"
 #include "screen.h"
 
-extern unsigned char savbkg[1024*1024*2];
+extern unsigned char savbkg[1024*1024*4];
 
 typedef struct                       /**** BMP file header structure ****/
 {
@@ -209,6 +209,16 @@ int SDL_SaveBMP(SDL_Surface *surface,const char *file){
 
    for (i = 0; i < retrow * retroh; i++)
    {
+      if (retrobpp == 4)
+      {
+         Uint32 argb = ((Uint32 *)savbkg)[i];
+
+         pixels[(i*3)+0]= (argb >> 16) & 0xff;
+         pixels[(i*3)+1]= argb & 0xff;
+         pixels[(i*3)+2]= (argb >> 8) & 0xff;
+         continue;
+      }
+
       temp = (unsigned short  int) (*ptr)&0xffff;
 
 #define R5 ((temp>>11)&0x1F)
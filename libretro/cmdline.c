@@ -9,7 +9,7 @@ static char XARGV[64][1024];
 static const char* xargv_cmd[64];
 int PARAMCOUNT=0;
 
-extern int  hmain(int argc, char *argv[]);
+extern bool Main_Start(int argc, char *argv[]);
 void parse_cmdline( const char *argv );
 
 void Add_Option(const char* option)
@@ -25,10 +25,10 @@ void Add_Option(const char* option)
    sprintf(XARGV[PARAMCOUNT++],"%s\0",option);
 }
 
-int pre_main(const char *argv)
+bool pre_main(const char *argv)
 {
    int i;
-   bool Only1Arg;
+   bool Only1Arg, ok;
 
    parse_cmdline(argv); 
 
@@ -64,11 +64,11 @@ int pre_main(const char *argv)
       printf("%2d  %s\n",i,XARGV[i]);
    }
 
-   hmain(PARAMCOUNT,( char **)xargv_cmd); 
+   ok = Main_Start(PARAMCOUNT,( char **)xargv_cmd); 
 
    xargv_cmd[PARAMCOUNT - 2] = NULL;
 
-   return 0;
+   return ok;
 }
 
 void parse_cmdline(const char *argv)
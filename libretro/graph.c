@@ -5,12 +5,24 @@
 
 #include "graph.h"
 
+/* Overlay colors are always given as RGB565, convert them
+ * when the core outputs XRGB8888 */
+static inline void PutPixelBmp(unsigned short *buffer, int idx, unsigned short color)
+{
+   if (retrobpp == 4)
+      ((unsigned int *)buffer)[idx] = ((color >> 11) << 19)
+                                    | (((color >> 5) & 0x3f) << 10)
+                                    | ((color & 0x1f) << 3);
+   else
+      buffer[idx] = color;
+}
+
 void DrawPointBmp(unsigned short *buffer,int x, int y, unsigned short color)
 {
    int idx;
 
    idx=x+y*VIRTUAL_WIDTH;
-   buffer[idx]=color;	
+   PutPixelBmp(buffer, idx, color);	
 }
 
 void DrawFBoxBmp(unsigned short *buffer,int x,int y,int dx,int dy,unsigned short color)
@@ -22,7 +34,7 @@ void DrawFBoxBmp(unsigned short *buffer,int x,int y,int dx,int dy,unsigned short
       for(j=y;j<y+dy;j++)
       {
          idx=i+j*VIRTUAL_WIDTH;
-         buffer[idx]=color;	
+         PutPixelBmp(buffer, idx, color);	
       }
    }
 
@@ -35,17 +47,17 @@ void DrawBoxBmp(unsigned short  *buffer,int x,int y,int dx,int dy,unsigned short
    for(i=x;i<x+dx;i++)
    {
       idx=i+y*VIRTUAL_WIDTH;
-      buffer[idx]=color;
+      PutPixelBmp(buffer, idx, color);
       idx=i+(y+dy)*VIRTUAL_WIDTH;
-      buffer[idx]=color;
+      PutPixelBmp(buffer, idx, color);
    }
 
    for(j=y;j<y+dy;j++)
    {
       idx=x+j*VIRTUAL_WIDTH;
-      buffer[idx]=color;	
+      PutPixelBmp(buffer, idx, color);	
       idx=(x+dx)+j*VIRTUAL_WIDTH;
-      buffer[idx]=color;	
+      PutPixelBmp(buffer, idx, color);	
    }
 
 }
@@ -58,7 +70,7 @@ void DrawHlineBmp(unsigned short  *buffer,int x,int y,int dx,int dy,unsigned sho
 	for(i=x;i<x+dx;i++)
    {
 		idx=i+y*VIRTUAL_WIDTH;
-		buffer[idx]=color;		
+		PutPixelBmp(buffer, idx, color);		
 	}
 }
 
@@ -69,7 +81,7 @@ void DrawVlineBmp(unsigned short *buffer,int x,int y,int dx,int dy,unsigned shor
 	for(j=y;j<y+dy;j++)
    {
 		idx=x+j*VIRTUAL_WIDTH;
-		buffer[idx]=color;		
+		PutPixelBmp(buffer, idx, color);		
 	}	
 }
 
@@ -91,7 +103,7 @@ void DrawlineBmp(unsigned short *buffer,int x1,int y1,int x2,int y2,unsigned sho
       else
       {
          idx=x1+y1*VIRTUAL_WIDTH;
-         buffer[idx]=color;
+         PutPixelBmp(buffer, idx, color);
       }
       return;
    }
@@ -131,7 +143,7 @@ void DrawlineBmp(unsigned short *buffer,int x1,int y1,int x2,int y2,unsigned sho
 
    for (; x < dx; x++, idx +=pixx)
    {
-      buffer[idx]=color;
+      PutPixelBmp(buffer, idx, color);
       y += dy;
       if (y >= dx)
       {
@@ -158,7 +170,7 @@ void DrawCircle(unsigned short *buf,int x, int y, int radius,unsigned short rgba
       if (full)
          DrawlineBmp(buf,x,y, x1,y1,rgba); 
       else
-         buf[x1+y1*VIRTUAL_WIDTH]=rgba;
+         PutPixelBmp(buf, x1+y1*VIRTUAL_WIDTH, rgba);
    }
 
 }
@@ -209,7 +221,7 @@ void Draw_string(unsigned short *surf, signed short int x, signed short int y,
 
    for(yrepeat = y; yrepeat < y+ surfh; yrepeat++) 
       for(xrepeat = x; xrepeat< x+surfw; xrepeat++,yptr++)
-         if(*yptr!=0)surf[xrepeat+yrepeat*VIRTUAL_WIDTH] = *yptr;
+         if(*yptr!=0)PutPixelBmp(surf, xrepeat+yrepeat*VIRTUAL_WIDTH, *yptr);
 
    free(linesurf);
 }
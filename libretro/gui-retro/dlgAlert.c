@@ -134,11 +134,14 @@ static int DlgAlert_ShowDlg(const char *text)
 
 	static int pauseon=0; 
 
+	//dialogs can't return to the frontend when called from the emulation
+	if (!gui_can_run())
+	{
+		free(orig_t);
+		return 0;
+	}
+
 	if(pauseg==0){
-		//HACK fix crash if alert dialog appear before pause was set to ON or before the first co_switch in main thread. 
-#ifndef HAVE_LIBCO
-return 0;
-#endif
 		printf("set pause on!\n");
 		pauseg=1;
 		pauseon=1; 
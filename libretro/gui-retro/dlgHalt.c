@@ -48,12 +48,11 @@ void Dialog_HaltDlg(void)
 	SDL_SetRelativeMouseMode(SDL_FALSE);
 #endif
 static int pauseon=0; 
+	//dialogs can't return to the frontend when called from the emulation
+	if (!gui_can_run())
+		return;
+
 	if(pauseg==0){
-		//HACK fix crash if alert dialog appear before pause was set to ON or before the first co_switch in main thread. 
-#ifndef HAVE_LIBCO
-//FIXME no gui without libco
-return;
-#endif
 		printf("set pause on!\n");
 		pauseg=1;
 		pauseon=1; 
@@ -24,7 +24,7 @@ extern int touch;
 int gmx,gmy;
 int okold=0,boutc=0;
 
-extern unsigned short int bmp[1024*1024];
+extern unsigned short int bmp[1024*1024*2];
 #define B ((rgba>> 8)&0xff)>>3 
 #define G ((rgba>>16)&0xff)>>3
 #define R ((rgba>>24)&0xff)>>3
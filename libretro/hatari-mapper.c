@@ -22,7 +22,6 @@ extern bool Dialog_DoProperty(void);
 extern void Screen_SetFullUpdate(void);
 extern void Main_HandleMouseMotion(void);
 extern void Main_UnInit(void);
-extern int  hmain(int argc, char *argv[]);
 extern int Reset_Cold(void);
 
 //TIME
@@ -41,8 +40,8 @@ unsigned long  Ktime=0 , LastFPSTime=0;
 
 //VIDEO
 extern SDL_Surface *sdlscrn; 
-unsigned short int bmp[1024*1024];
-unsigned char savbkg[1024*1024* 2];
+unsigned short int bmp[1024*1024*2];	/* big enough for XRGB8888 */
+unsigned char savbkg[1024*1024* 4];
 
 //SOUND
 short signed int SNDBUF[1024*2];
@@ -143,6 +142,17 @@ long GetTicks(void)
 
 int slowdown=0;
 
+//The dialogs are modal loops, they can only return frames to the
+//frontend when they run in the GUI co-thread (see retro_run_gui())
+bool gui_can_run(void)
+{
+#ifdef HAVE_LIBCO
+   return guiThread && co_active() == guiThread;
+#else
+   return false;
+#endif
+}
+
 //NO SURE FIND BETTER WAY TO COME BACK IN MAIN THREAD IN HATARI GUI
 void gui_poll_events(void)
 {
@@ -153,9 +163,9 @@ void gui_poll_events(void)
       slowdown=0;
       frame++; 
       LastFPSTime = Ktime;	
-      //FIXME NOLIBCO
 #ifdef HAVE_LIBCO
-      co_switch(mainThread);
+      if (gui_can_run())
+         co_switch(mainThread);
 #endif
    }
 }
@@ -171,7 +181,7 @@ void save_bkg(void)
 
    for(j=0;j<retroh;j++)
    {
-      for(i=0;i<retrow*2;i++)
+      for(i=0;i<retrow*retrobpp;i++)
       {
          savbkg[k]=*ptr;
          ptr++;
@@ -182,7 +192,30 @@ void save_bkg(void)
 
 void retro_fillrect(SDL_Surface * surf,SDL_Rect *rect,unsigned int col)
 {
-   DrawFBoxBmp(bmp,rect->x,rect->y,rect->w ,rect->h,col); 
+   int x, y, x1, y1, x2, y2;
+   unsigned char *line;
+
+   x1 = 0; y1 = 0;
+   x2 = surf->w; y2 = surf->h;
+   if (rect)
+   {
+      if (rect->x > x1) x1 = rect->x;
+      if (rect->y > y1) y1 = rect->y;
+      if (rect->x + rect->w < x2) x2 = rect->x + rect->w;
+      if (rect->y + rect->h < y2) y2 = rect->y + rect->h;
+   }
+
+   // col is already in the surface pixel format (SDL_MapRGB)
+   for (y = y1; y < y2; y++)
+   {
+      line = (unsigned char *)surf->pixels + y * surf->pitch;
+      if (surf->format->BytesPerPixel == 4)
+         for (x = x1; x < x2; x++)
+            ((Uint32 *)line)[x] = col;
+      else
+         for (x = x1; x < x2; x++)
+            ((Uint16 *)line)[x] = col;
+   }
 }
 
 int  GuiGetMouseState( int * x,int * y)
@@ -221,20 +254,40 @@ SDL_Surface *prepare_texture(int w,int h,int b)
       return NULL;
    }
 
-   bitmp->format->BitsPerPixel = 16;
-   bitmp->format->BytesPerPixel = 2;
-   bitmp->format->Rloss=3;
-   bitmp->format->Gloss=3;
-   bitmp->format->Bloss=3;
-   bitmp->format->Aloss=0;
-   bitmp->format->Rshift=11;
-   bitmp->format->Gshift=6;
-   bitmp->format->Bshift=0;
-   bitmp->format->Ashift=0;
-   bitmp->format->Rmask=0x0000F800;
-   bitmp->format->Gmask=0x000007E0;
-   bitmp->format->Bmask=0x0000001F;
-   bitmp->format->Amask=0x00000000;
+   if (retrobpp == 4)
+   {
+      bitmp->format->BitsPerPixel = 32;
+      bitmp->format->BytesPerPixel = 4;
+      bitmp->format->Rloss=0;
+      bitmp->format->Gloss=0;
+      bitmp->format->Bloss=0;
+      bitmp->format->Aloss=0;
+      bitmp->format->Rshift=16;
+      bitmp->format->Gshift=8;
+      bitmp->format->Bshift=0;
+      bitmp->format->Ashift=0;
+      bitmp->format->Rmask=0x00FF0000;
+      bitmp->format->Gmask=0x0000FF00;
+      bitmp->format->Bmask=0x000000FF;
+      bitmp->format->Amask=0x00000000;
+   }
+   else
+   {
+      bitmp->format->BitsPerPixel = 16;
+      bitmp->format->BytesPerPixel = 2;
+      bitmp->format->Rloss=3;
+      bitmp->format->Gloss=3;
+      bitmp->format->Bloss=3;
+      bitmp->format->Aloss=0;
+      bitmp->format->Rshift=11;
+      bitmp->format->Gshift=6;
+      bitmp->format->Bshift=0;
+      bitmp->format->Ashift=0;
+      bitmp->format->Rmask=0x0000F800;
+      bitmp->format->Gmask=0x000007E0;
+      bitmp->format->Bmask=0x0000001F;
+      bitmp->format->Amask=0x00000000;
+   }
    bitmp->format->colorkey=0;
    bitmp->format->alpha=0;
    bitmp->format->palette = NULL;
@@ -242,7 +295,7 @@ SDL_Surface *prepare_texture(int w,int h,int b)
    bitmp->flags=0;
    bitmp->w=w;
    bitmp->h=h;
-   bitmp->pitch=retrow*2;
+   bitmp->pitch=retrow*retrobpp;
    bitmp->pixels=(unsigned char *)&bmp[0];
    bitmp->clip_rect.x=0;
    bitmp->clip_rect.y=0;
@@ -285,10 +338,8 @@ void texture_init(void)
 void enter_gui(void)
 {
    save_bkg();
-#ifdef HAVE_LIBCO
-   Dialog_DoProperty();
-//FIXME NOLIBCO
-#endif
+   if (gui_can_run())
+      Dialog_DoProperty();
    pauseg=0;
 }
 
@@ -21,12 +21,15 @@ extern int Reset_Warm(void);
 #include "SDL_types.h"
 
 #define RGB565(r, g, b)  (((r) << (5+6)) | ((g) << 6) | (b))
-#define SDL_MapRGB(a, r, g, b) RGB565( (r)>>3, (g)>>3, (b)>>3)
+#define XRGB8888(r, g, b)  (((r) << 16) | ((g) << 8) | (b))
+#define SDL_MapRGB(a, r, g, b) ((a)->BitsPerPixel == 32 ? XRGB8888((r), (g), (b)) \
+                                                         : RGB565((r)>>3, (g)>>3, (b)>>3))
 
 extern long GetTicks(void);
 extern void retro_fillrect(SDL_Surface * surf,SDL_Rect *rect,unsigned int col);
 extern SDL_Surface *prepare_texture(int w,int h,int b);
 extern int SDL_SaveBMP(SDL_Surface *surface,const char *file);
+extern int retro_screen_dirty;
 
 typedef struct SDL_Event{
 Uint8 type;
@@ -59,8 +62,8 @@ Uint8 type;
 #define SDL_LockSurface(a) 0
 #define SDL_UnlockSurface(a) 0
 #define SDL_FillRect(s,r,c) retro_fillrect((s),(r),(c))
-#define SDL_UpdateRects(a, b,c)
-#define SDL_UpdateRect(...)
+#define SDL_UpdateRects(a, b,c) (retro_screen_dirty = 1)
+#define SDL_UpdateRect(...) (retro_screen_dirty = 1)
 #define SDL_SetVideoMode(w, h, b, f) prepare_texture((w),(h),(b))
 //KEY
 #define SDL_GetError() "RetroWrapper"
@@ -43,6 +43,9 @@
 /* Define to 1 if you have the 'setenv' function. */
 //#define HAVE_SETENV 1
 
+/* Define to 1 if you have the 'fork' function. */
+//#define HAVE_FORK 1
+
 /* Define to 1 if you have the `select' function. */
 //#define HAVE_SELECT 1
 
@@ -72,6 +75,9 @@
 /* Define to 1 if you have the 'nanosleep' function. */
 //#define HAVE_NANOSLEEP 1
 
+/* Define to 1 if you have the 'clock_nanosleep' function. */
+//#define HAVE_CLOCK_NANOSLEEP 1
+
 /* Define to 1 if you have the 'alphasort' function. */
 #ifndef WIN32PORT
 #define HAVE_ALPHASORT 1
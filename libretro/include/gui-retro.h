@@ -19,6 +19,7 @@
 #include "graph.h"
 
 extern void gui_poll_events();
+extern bool gui_can_run(void);
 extern int  GuiGetMouseState( int * x,int * y);
 extern int pauseg;
 
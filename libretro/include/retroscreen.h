@@ -6,5 +6,6 @@ extern int CROP_HEIGHT;
 extern int VIRTUAL_WIDTH;
 extern int retrow ; 
 extern int retroh ;
+extern int retrobpp ;
 
 #endif
@@ -18,7 +18,7 @@ extern const char SDLKeyToSTScanCode[512] ;
 #ifdef HAVE_LIBCO
 #include <libco.h>
 extern cothread_t mainThread;
-extern cothread_t emuThread;
+extern cothread_t guiThread;
 #endif
 
 extern char Key_Sate[512];
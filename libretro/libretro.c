@@ -6,10 +6,7 @@
 
 #if defined(HAVE_LIBCO) 
 cothread_t mainThread;
-cothread_t emuThread;
-#else
-extern void RetroLoop();
-int CPULOOP=1;
+cothread_t guiThread;
 #endif
 
 int CROP_WIDTH;
@@ -17,8 +14,11 @@ int CROP_HEIGHT;
 int VIRTUAL_WIDTH ;
 int retrow=1024; 
 int retroh=1024;
+int retrobpp=2;          /* 2 = RGB565, 4 = XRGB8888 */
+int retro_screen_dirty=1; /* set by SDL_UpdateRects() when the screen changed */
 
-extern unsigned short int bmp[1024*1024];
+extern unsigned short int bmp[1024*1024*2];
+extern SDL_Surface *sdlscrn;
 extern int STATUTON,SHOWKEY,SHIFTON,pauseg,SND ,snd_sampler;
 extern short signed int SNDBUF[1024*2];
 extern char RPATH[512];
@@ -31,7 +31,14 @@ extern void texture_init(void);
 extern void texture_uninit(void);
 extern void Emu_init();
 extern void Emu_uninit();
-extern void Quit_Hatari();
+extern bool Main_RunFrame(void);
+extern int Main_Stop(void);
+extern void pause_select(void);
+extern void Screen_SetFullUpdate(void);
+extern bool bSkipScreenDraw;
+extern bool Sound_SkipSynthesis;
+extern size_t MemorySnapShot_CaptureLight(void *pBuffer, size_t nSize);
+extern bool MemorySnapShot_RestoreLight(const void *pBuffer, size_t nSize);
 
 const char *retro_save_directory;
 const char *retro_system_directory;
@@ -42,6 +49,10 @@ static retro_audio_sample_t audio_cb;
 static retro_audio_sample_batch_t audio_batch_cb;
 static retro_environment_t environ_cb;
 
+static bool can_dupe = false;
+static bool zero_copy = false;
+static struct retro_framebuffer retro_fb;
+
 void retro_set_environment(retro_environment_t cb)
 {
    environ_cb = cb;
@@ -52,6 +63,10 @@ void retro_set_environment(retro_environment_t cb)
          "Internal resolution; 640x480|832x576|832x588|800x600|960x720|1024x768|1024x1024",
 
       },
+      {
+         "Hatari_zero_copy",
+         "Render into frontend framebuffer; disabled|enabled",
+      },
       { NULL, NULL },
    };
 
@@ -62,9 +77,15 @@ void retro_set_environment(retro_environment_t cb)
 static void update_variables(void)
 {
    struct retro_variable var = {
-      .key = "Hatari_resolution",
+      .key = "Hatari_zero_copy",
    };
 
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+      zero_copy = strcmp(var.value, "enabled") == 0;
+
+   var.key = "Hatari_resolution";
+   var.value = NULL;
+
    if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
    {
       char *pch;
@@ -88,24 +109,89 @@ static void update_variables(void)
    }
 }
 
-static void retro_wrap_emulator()
-{
-   pre_main(RPATH);
-#if defined(HAVE_LIBCO)
-   pauseg=-1;
+static bool emu_running = false;
 
-   environ_cb(RETRO_ENVIRONMENT_SHUTDOWN, 0); 
+static void retro_start_emulator(void)
+{
+   emu_running = pre_main(RPATH);
+   if (!emu_running)
+   {
+      pauseg=-1;
+      environ_cb(RETRO_ENVIRONMENT_SHUTDOWN, 0); 
+   }
+}
 
-   // Were done here
-   co_switch(mainThread);
+#if defined(HAVE_LIBCO)
+/* Hatari's dialogs are modal loops, so they run in a co-thread that
+ * returns to the frontend every frame (see gui_poll_events()). The
+ * emulation itself doesn't need it, the co-thread only exists while
+ * a dialog is open or while Hatari is initialized (which can show
+ * the dialog for selecting a TOS image). */
+static void (*gui_func)(void);
+static bool gui_done;
+
+static void retro_wrap_gui(void)
+{
+   gui_func();
+   gui_done = true;
 
-   // Dead emulator, but libco says not to return
+   // libco says not to return
    while(true)
-   {
-      LOGI("Running a dead emulator.");
       co_switch(mainThread);
+}
+#endif
+
+/* Call given function, which may show dialogs. With libco, this returns
+ * at the next frame shown by the dialogs and the following calls resume
+ * them, until the function itself returns. */
+static void retro_run_gui(void (*func)(void))
+{
+#if defined(HAVE_LIBCO)
+   if(!guiThread)
+   {
+      mainThread = co_active();
+      gui_func = func;
+      gui_done = false;
+      guiThread = co_create(65536*sizeof(void*), retro_wrap_gui);
    }
+   co_switch(guiThread);
+   if(gui_done)
+   {
+      co_delete(guiThread);
+      guiThread = 0;
+   }
+#else
+   func();
+#endif
+}
+
+/* Return true while a dialog is shown (or Hatari is being initialized) */
+static bool retro_gui_running(void)
+{
+#if defined(HAVE_LIBCO)
+   if(guiThread)
+      return true;
 #endif
+   return pauseg==1;
+}
+
+/* Run the emulation for one frame, or the dialogs if they're shown */
+static void retro_run_emulator(void)
+{
+   if(retro_gui_running())
+   {
+      retro_run_gui(pause_select);
+      return;
+   }
+   if(!emu_running)
+      return;
+
+   if(!Main_RunFrame())
+   {
+      Main_Stop();
+      emu_running = false;
+      environ_cb(RETRO_ENVIRONMENT_SHUTDOWN, 0); 
+   }
 }
 
 void Emu_init()
@@ -121,15 +207,8 @@ void Emu_init()
 
    memset(Key_Sate,0,512);
    memset(Key_Sate2,0,512);
-#if defined(HAVE_LIBCO)
-   if(!emuThread && !mainThread)
-   {
-      mainThread = co_active();
-      emuThread = co_create(65536*sizeof(void*), retro_wrap_emulator);
-   }
-#else
-   retro_wrap_emulator();
-#endif
+
+   retro_run_gui(retro_start_emulator);
 }
 
 void Emu_uninit()
@@ -186,13 +265,24 @@ void retro_init(void)
    printf("Retro SAVE_DIRECTORY %s\n",retro_save_directory);
    printf("Retro CONTENT_DIRECTORY %s\n",retro_content_directory);
 
-   enum retro_pixel_format fmt = RETRO_PIXEL_FORMAT_RGB565;
-   if (!environ_cb(RETRO_ENVIRONMENT_SET_PIXEL_FORMAT, &fmt))
+   // XRGB8888 lets Hatari use its 32-bit converters without losing colors
+   enum retro_pixel_format fmt = RETRO_PIXEL_FORMAT_XRGB8888;
+   if (environ_cb(RETRO_ENVIRONMENT_SET_PIXEL_FORMAT, &fmt))
+      retrobpp = 4;
+   else
    {
-      fprintf(stderr, "RGB565 is not supported.\n");
-      exit(0);
+      fmt = RETRO_PIXEL_FORMAT_RGB565;
+      if (!environ_cb(RETRO_ENVIRONMENT_SET_PIXEL_FORMAT, &fmt))
+      {
+         fprintf(stderr, "Neither XRGB8888 nor RGB565 is supported.\n");
+         exit(0);
+      }
+      retrobpp = 2;
    }
 
+   if (!environ_cb(RETRO_ENVIRONMENT_GET_CAN_DUPE, &can_dupe))
+      can_dupe = false;
+
 struct retro_input_descriptor inputDescriptors[] = {
 		{ 0, RETRO_DEVICE_JOYPAD, 0, RETRO_DEVICE_ID_JOYPAD_A, "A = fire" },
 		{ 0, RETRO_DEVICE_JOYPAD, 0, RETRO_DEVICE_ID_JOYPAD_B, "B" },
@@ -212,25 +302,24 @@ struct retro_input_descriptor inputDescriptors[] = {
 		{ 0, RETRO_DEVICE_JOYPAD, 0, RETRO_DEVICE_ID_JOYPAD_L3, "L3" }
 	};
 	environ_cb(RETRO_ENVIRONMENT_SET_INPUT_DESCRIPTORS, &inputDescriptors);
-#if defined(HAVE_LIBCO)
-Emu_init();
-#endif
    texture_init();
 }
 
 void retro_deinit(void)
 {	 
-   Emu_uninit(); 
-
 #if defined(HAVE_LIBCO)
-   if(emuThread)
+   if(guiThread)
    {	 
-      co_delete(emuThread);
-      emuThread = 0;
+      co_delete(guiThread);
+      guiThread = 0;
    }
-#else
-   Quit_Hatari();
 #endif
+   if(emu_running)
+   {
+      Main_Stop();
+      emu_running = false;
+   }
+   Emu_uninit(); 
    LOGI("Retro DeInit\n");
 }
 
@@ -280,43 +369,111 @@ void retro_set_video_refresh(retro_video_refresh_t cb)
    video_cb = cb;
 }
 
+static bool retro_overlay_shown(void)
+{
+   return SHOWKEY==1 || STATUTON==1 || pauseg==1;
+}
+
+/* Point the emulator screen surface to the frontend framebuffer when
+ * zero-copy output is enabled and nothing is drawn over the emulated
+ * screen, otherwise back to bmp. Returns true if the frame is to be
+ * presented from retro_fb. As the frontend buffer only holds what was
+ * drawn during this retro_run(), frames which aren't redrawn have to be
+ * duped, so this mode also needs RETRO_ENVIRONMENT_GET_CAN_DUPE. */
+static bool retro_setup_framebuffer(void)
+{
+   enum retro_pixel_format fmt;
+
+   if (zero_copy && can_dupe && sdlscrn && !retro_overlay_shown()
+       && sdlscrn->w == retrow && sdlscrn->h == retroh)
+   {
+      fmt = retrobpp == 4 ? RETRO_PIXEL_FORMAT_XRGB8888 : RETRO_PIXEL_FORMAT_RGB565;
+
+      retro_fb.width = retrow;
+      retro_fb.height = retroh;
+      retro_fb.access_flags = RETRO_MEMORY_ACCESS_WRITE;
+      if (environ_cb(RETRO_ENVIRONMENT_GET_CURRENT_SOFTWARE_FRAMEBUFFER, &retro_fb)
+          && retro_fb.data && retro_fb.format == fmt && retro_fb.pitch <= 0xffff)
+      {
+         if (sdlscrn->pixels != retro_fb.data || sdlscrn->pitch != retro_fb.pitch)
+         {
+            // new buffer, its initial contents are unspecified
+            memset(retro_fb.data, 0, retro_fb.pitch * retroh);
+            sdlscrn->pixels = retro_fb.data;
+            sdlscrn->pitch = retro_fb.pitch;
+            Screen_SetFullUpdate();
+         }
+         return true;
+      }
+   }
+
+   if (sdlscrn && sdlscrn->pixels != (void *)bmp)
+   {
+      sdlscrn->pixels = bmp;
+      sdlscrn->pitch = retrow * retrobpp;
+      Screen_SetFullUpdate();
+   }
+   return false;
+}
+
 void retro_run(void)
 {
-   int x;
+   int av_enable;
    unsigned width = 640;
    unsigned height = 400;
+   bool use_fb, overlay;
 
    bool updated = false;
 
    if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE_UPDATE, &updated) && updated)
       update_variables();
 
+   // frames run ahead by the frontend are neither shown nor heard
+   if (!environ_cb(RETRO_ENVIRONMENT_GET_AUDIO_VIDEO_ENABLE, &av_enable))
+      av_enable = 3;
+   bSkipScreenDraw = !(av_enable & 1);
+   Sound_SkipSynthesis = !(av_enable & 2);
+
    if(pauseg==0)
-   {
       update_input();
+   use_fb = retro_setup_framebuffer();
 
-#if !defined(HAVE_LIBCO)
-      RetroLoop();
-#endif
-      if(SND==1)
-      {
-	audio_batch_cb(SNDBUF, snd_sampler);/*
-         int16_t *p=(int16_t*)SNDBUF;
+   // overlays are drawn over the previous frame by update_input(), so
+   // they're shown before the emulation redraws the screen. Otherwise
+   // the emulation runs first, so the frame reflects the current input
+   // (and the frontend buffer is only valid during this call anyway)
+   overlay = retro_overlay_shown();
+   if (!overlay)
+      retro_run_emulator();
 
-         for(x = 0; x < snd_sampler; x++)
-            audio_cb(*p++,*p++);*/
-      }
-   }
+   if(pauseg==0 && SND==1 && (av_enable & 2))
+      audio_batch_cb(SNDBUF, snd_sampler);
 
-   if(ConfigureParams.Screen.bAllowOverscan || SHOWKEY==1 || STATUTON==1 || pauseg==1 )
+   if(ConfigureParams.Screen.bAllowOverscan || overlay)
    {
       width  = retrow;
       height = retroh;
    }
-   video_cb(bmp, width, height, retrow<< 1);
-#if defined(HAVE_LIBCO)
-   co_switch(emuThread);
-#endif
+   if (use_fb)
+   {
+      // the frontend buffer wasn't (fully) drawn, repeat the previous frame
+      if (!retro_screen_dirty || bSkipScreenDraw)
+         video_cb(NULL, width, height, retro_fb.pitch);
+      else
+         video_cb(retro_fb.data, width, height, retro_fb.pitch);
+   }
+   else
+   {
+      // let the frontend repeat the previous frame if nothing was redrawn
+      if ((!retro_screen_dirty || bSkipScreenDraw) && can_dupe && !overlay)
+         video_cb(NULL, width, height, retrow * retrobpp);
+      else
+         video_cb(bmp, width, height, retrow * retrobpp);
+   }
+   retro_screen_dirty = 0;
+
+   if (overlay)
+      retro_run_emulator();
 }
 
 bool retro_load_game(const struct retro_game_info *info)
@@ -328,11 +485,7 @@ bool retro_load_game(const struct retro_game_info *info)
    full_path = info->path;
 
    strcpy(RPATH,full_path);
-#if defined(HAVE_LIBCO)
-   co_switch(emuThread);
-#else
    Emu_init();
-#endif
    return true;
 }
 
@@ -354,19 +507,30 @@ bool retro_load_game_special(unsigned type, const struct retro_game_info *info,
    return false;
 }
 
+/* Serialization uses Hatari's lightweight memory snapshots, which are
+ * cheap enough to be done on every frame for run-ahead. They're only
+ * meant to be restored with the same configuration, TOS and disks.
+ * Their size only depends on the configuration (written floppy images
+ * use a fixed size slot), so it doesn't grow during a session. */
 size_t retro_serialize_size(void)
 {
-   return 0;
+   if (!emu_running)
+      return 0;
+   return MemorySnapShot_CaptureLight(NULL, 0);
 }
 
 bool retro_serialize(void *data_, size_t size)
 {
-   return false;
+   if (!emu_running || retro_gui_running())
+      return false;
+   return MemorySnapShot_CaptureLight(data_, size) > 0;
 }
 
 bool retro_unserialize(const void *data_, size_t size)
 {
-   return false;
+   if (!emu_running || retro_gui_running())
+      return false;
+   return MemorySnapShot_RestoreLight(data_, size);
 }
 
 void *retro_get_memory_data(unsigned id)
@@ -28,82 +28,233 @@ static volatile bool bPlayingBuffer = false;	/* Is playing buffer? */
 int SoundBufferSize = 1024 / 4;			/* Size of sound buffer (in samples) */
 int CompleteSndBufIdx;				/* Replay-index into MixBuffer */
 int SdlAudioBufferSize = 0;			/* in ms (0 = use default) */
-int pulse_swallowing_count = 0;			/* Sound disciplined emulation rate controlled by  */
-						/*  window comparator and pulse swallowing counter */
+int AudioLatency = 0;				/* in ms (0 = emulation paced by host timer) */
+
+/* Sound disciplined playback : instead of changing the emulation rate, */
+/* the samples in MixBuffer are resampled in Audio_CallBack() with a ratio */
+/* adjusted from the buffer's fill level (16.16 fixed point values) */
+#define AUDIO_RATIO_ONE		0x10000
+#define AUDIO_RATIO_MAX_ADJUST	( AUDIO_RATIO_ONE * 58 / 10000 )	/* +/- 0.58% (10 cents) */
+static Uint32 ResampleRatio = AUDIO_RATIO_ONE;	/* Number of input samples for 1 output sample */
+static Uint32 ResampleFrac = 0;			/* Fractional part of the position in MixBuffer */
+
+
+#if !defined(__GNUC__)
+/*-----------------------------------------------------------------------*/
+/**
+ * Atomically add 'val' to the counter shared with the audio callback and
+ * return its previous value. SDL1.2 has no atomic operations, so the
+ * audio lock is used instead (it is recursive, so this also works from
+ * inside the callback).
+ */
+int Audio_AtomicAdd(volatile int *ptr, int val)
+{
+#if WITH_SDL2
+	return SDL_AtomicAdd((SDL_atomic_t *)ptr, val);
+#else
+	int old;
+
+	SDL_LockAudio();
+	old = *ptr;
+	*ptr = old + val;
+	SDL_UnlockAudio();
+	return old;
+#endif
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Atomically read the counter shared with the audio callback.
+ */
+int Audio_AtomicGet(volatile int *ptr)
+{
+#if WITH_SDL2
+	return SDL_AtomicGet((SDL_atomic_t *)ptr);
+#else
+	int val;
+
+	SDL_LockAudio();
+	val = *ptr;
+	SDL_UnlockAudio();
+	return val;
+#endif
+}
+#endif
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Compute the resampling ratio used to keep the number of samples in
+ * MixBuffer close to the middle of a window around SoundBufferSize.
+ * The ratio is changed within +/- 0.58% (10 cents), which is not audible.
+ * Note that an octave (frequency doubling) has 12 semitones (12th root of
+ * two for a semitone), and that one semitone has 100 cents (1200th root
+ * of two for one cent).
+ */
+static Uint32 Audio_ComputeResampleRatio(int nAvailable)
+{
+	int window, nSamplesPerFrame, target, delta;
+
+	if (!ConfigureParams.Sound.bEnableSoundSync)
+		return AUDIO_RATIO_ONE;
+
+	nSamplesPerFrame = nAudioFrequency/nScreenRefreshRate;
+	window = (nSamplesPerFrame > SoundBufferSize) ? nSamplesPerFrame : SoundBufferSize;
+
+	if (AudioLatency > 0)
+	{
+		/* Emulation is paced by the audio output, use the same target */
+		target = Audio_GetLatencyTarget();
+	}
+	else
+	{
+		/* Middle of the window [1.5*window , 2.25*window] used by the previous */
+		/* window comparator (which changed the emulation rate instead) */
+		target = window + (window >> 1) + (window >> 3) + (window >> 4);
+	}
+
+	/* Proportional control : full adjustment when we're 'window' samples away */
+	delta = (int)(((Sint64)(nAvailable - target) * AUDIO_RATIO_MAX_ADJUST) / window);
+	if (delta > AUDIO_RATIO_MAX_ADJUST)
+		delta = AUDIO_RATIO_MAX_ADJUST;
+	else if (delta < -AUDIO_RATIO_MAX_ADJUST)
+		delta = -AUDIO_RATIO_MAX_ADJUST;
+
+	return AUDIO_RATIO_ONE + delta;
+}
+
 
 /*-----------------------------------------------------------------------*/
 /**
  * SDL audio callback function - copy emulation sound to audio system.
+ *
+ * MixBuffer is a single producer / single consumer ring buffer : the
+ * emulation writes samples after ActiveSndBufIdx and then increases
+ * nGeneratedSamples, the callback reads samples from CompleteSndBufIdx
+ * and then decreases nGeneratedSamples. Both counters are updated with
+ * atomic operations, so no lock is needed here.
  */
 static void Audio_CallBack(void *userdata, Uint8 *stream, int len)
 {
 	Sint16 *pBuffer;
-	int i, window, nSamplesPerFrame;
+	int i, nAvailable, nConsumed;
+	Uint32 pos, frac;
+	int idx, idx_next;
 
 	pBuffer = (Sint16 *)stream;
 	len = len / 4;  // Use length in samples (16 bit stereo), not in bytes
 
-	/* Adjust emulation rate within +/- 0.58% (10 cents) occasionally,
-	 * to synchronize sound. Note that an octave (frequency doubling)
-	 * has 12 semitones (12th root of two for a semitone), and that
-	 * one semitone has 100 cents (1200th root of two for one cent).
-	 * Ten cents are desired, thus, the 120th root of two minus one is
-	 * multiplied by 1,000,000 to convert to microseconds, and divided
-	 * by nScreenRefreshRate=60 to get a 96 microseconds swallow size.
-	 * (2^(10cents/(12semitones*100cents)) - 1) * 10^6 / nScreenRefreshRate
-	 * See: main.c - Main_WaitOnVbl()
-	 */
-
-	pulse_swallowing_count = 0;	/* 0 = Unaltered emulation rate */
+	nAvailable = Audio_AtomicGet(&nGeneratedSamples);
+	ResampleRatio = Audio_ComputeResampleRatio(nAvailable);
 
-	if (ConfigureParams.Sound.bEnableSoundSync)
+	if (ResampleRatio != AUDIO_RATIO_ONE || ResampleFrac != 0)
 	{
-		/* Sound synchronized emulation */
-		nSamplesPerFrame = nAudioFrequency/nScreenRefreshRate;
-		window = (nSamplesPerFrame > SoundBufferSize) ? nSamplesPerFrame : SoundBufferSize;
-
-		/* Window Comparator for SoundBufferSize */
-		if (nGeneratedSamples < window + (window >> 1))
-		/* Increase emulation rate to maintain sound synchronization */
-			pulse_swallowing_count = -5793 / nScreenRefreshRate;
-		else
-		if (nGeneratedSamples > (window << 1) + (window >> 2))
-		/* Decrease emulation rate to maintain sound synchronization */
-			pulse_swallowing_count = 5793 / nScreenRefreshRate;
-
-		/* Otherwise emulation rate is unaltered. */
+		/* We need one more sample after the last position to interpolate */
+		nConsumed = ( ResampleFrac + (Uint32)len * ResampleRatio ) >> 16;
+		if (nAvailable < nConsumed + 1)
+		{
+			/* Not enough samples, use the available ones without resampling */
+			ResampleRatio = AUDIO_RATIO_ONE;
+			ResampleFrac = 0;
+		}
 	}
 
-	if (nGeneratedSamples >= len)
+	if (ResampleRatio == AUDIO_RATIO_ONE && ResampleFrac == 0)
 	{
-		/* Enough samples available: Pass completed buffer to audio system
-		 * by write samples into sound buffer and by converting them from
-		 * 'signed' to 'unsigned' */
-		for (i = 0; i < len; i++)
+		nConsumed = (nAvailable >= len) ? len : nAvailable;
+
+		/* Pass completed buffer to audio system */
+		for (i = 0; i < nConsumed; i++)
 		{
 			*pBuffer++ = MixBuffer[(CompleteSndBufIdx + i) % MIXBUFFER_SIZE][0];
 			*pBuffer++ = MixBuffer[(CompleteSndBufIdx + i) % MIXBUFFER_SIZE][1];
 		}
-		CompleteSndBufIdx += len;
-		nGeneratedSamples -= len;
+
+		/* Not enough samples available : clear rest of the buffer to ensure */
+		/* we don't play random bytes instead of missing samples */
+		if (nConsumed < len)
+			memset(pBuffer, 0, (len - nConsumed) * 4);
 	}
-	else  /* Not enough samples available: */
+	else
 	{
-		for (i = 0; i < nGeneratedSamples; i++)
+		/* Linear interpolation between 2 consecutive samples */
+		pos = ResampleFrac;
+		for (i = 0; i < len; i++)
 		{
-			*pBuffer++ = MixBuffer[(CompleteSndBufIdx + i) % MIXBUFFER_SIZE][0];
-			*pBuffer++ = MixBuffer[(CompleteSndBufIdx + i) % MIXBUFFER_SIZE][1];
+			idx = (CompleteSndBufIdx + (pos >> 16)) % MIXBUFFER_SIZE;
+			idx_next = (idx + 1) % MIXBUFFER_SIZE;
+			/* Only keep 15 bits of the fraction, so the product of the
+			 * difference (up to 65535) by it can't overflow a Sint32 */
+			frac = ( pos >> 1 ) & 0x7fff;
+			*pBuffer++ = MixBuffer[idx][0] + (((MixBuffer[idx_next][0] - MixBuffer[idx][0]) * (Sint32)frac) >> 15);
+			*pBuffer++ = MixBuffer[idx][1] + (((MixBuffer[idx_next][1] - MixBuffer[idx][1]) * (Sint32)frac) >> 15);
+			pos += ResampleRatio;
 		}
-		/* Clear rest of the buffer to ensure we don't play random bytes instead */
-		/* of missing samples */
-		memset(pBuffer, 0, (len - nGeneratedSamples) * 4);
-
-		CompleteSndBufIdx += nGeneratedSamples;
-		nGeneratedSamples = 0;
-		
+		nConsumed = pos >> 16;
+		ResampleFrac = pos & 0xffff;
 	}
 
-	CompleteSndBufIdx = CompleteSndBufIdx % MIXBUFFER_SIZE;
+	CompleteSndBufIdx = (CompleteSndBufIdx + nConsumed) % MIXBUFFER_SIZE;
+	Audio_AtomicAdd(&nGeneratedSamples, -nConsumed);
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Restart resampling at the beginning of a sample, so the first buffer
+ * after a sound reset doesn't use the phase of the previous one.
+ * Must be called with the audio lock held.
+ */
+void Audio_ResetResampling(void)
+{
+	ResampleRatio = AUDIO_RATIO_ONE;
+	ResampleFrac = 0;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Return the number of samples waiting in MixBuffer to be played.
+ * Can be used to tune the latency with SdlAudioBufferSize.
+ */
+int Audio_GetBufferFill(void)
+{
+	return Audio_AtomicGet(&nGeneratedSamples);
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Return the number of samples that should stay in MixBuffer when the
+ * emulation is paced by the audio output (see Main_WaitOnVbl()), or 0
+ * if the emulation is paced by the host timer.
+ */
+int Audio_GetLatencyTarget(void)
+{
+	if (AudioLatency <= 0 || !bSoundWorking)
+		return 0;
+
+	return nAudioFrequency * AudioLatency / 1000;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Show audio buffer information (for the debugger's "info" command)
+ */
+void Audio_Info(FILE *fp, Uint32 dummy)
+{
+	int nFill = Audio_GetBufferFill();
+
+	fprintf(fp, "Audio output: %s, %d Hz\n", bSoundWorking ? "enabled" : "disabled", nAudioFrequency);
+	fprintf(fp, "- SDL buffer size: %d samples\n", SoundBufferSize);
+	fprintf(fp, "- Ring buffer fill level: %d samples (%d ms)\n", nFill,
+		nAudioFrequency ? nFill * 1000 / nAudioFrequency : 0);
+	if (AudioLatency > 0)
+		fprintf(fp, "- Emulation paced by audio output, target latency: %d ms\n", AudioLatency);
+	fprintf(fp, "- Resampling ratio: %.4f (%s)\n", (double)ResampleRatio / AUDIO_RATIO_ONE,
+		ConfigureParams.Sound.bEnableSoundSync ? "sound sync" : "fixed");
 }
 
 
@@ -211,6 +362,8 @@ void Audio_UnInit(void)
 /*-----------------------------------------------------------------------*/
 /**
  * Lock the audio sub system so that the callback function will not be called.
+ * This is only needed when both ring buffer's indexes are changed at the same
+ * time (sound reset), normal updates don't need it.
  */
 void Audio_Lock(void)
 {
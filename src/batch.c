@@ -0,0 +1,378 @@
+/*
+  Hatari - batch.c
+
+  This file is distributed under the GNU General Public License, version 2
+  or at your option any later version. Read the file gpl.txt for details.
+
+  Headless batch mode, for running many independent emulation sessions
+  listed in a job file.
+
+  Emulation state is global, so instead of running several machines in
+  the same process, the parent process initializes Hatari only once
+  (TOS image, CPU function tables, YM volume tables...) and then forks
+  a new process for each job, up to the given number of workers at the
+  same time. All the data set up before the fork is shared copy-on-write
+  between the jobs, which saves both startup time and memory.
+
+  Each line of the job file has the format:
+	<name> <VBLs> [Hatari options]
+  Empty lines and lines starting with '#' are ignored. Spaces within
+  an option value need to be escaped with '\'.
+
+  Job output goes to '<name>.log'. After the given number of VBLs,
+  the screen is saved to '<name>.png' (or '.bmp' without PNG support)
+  and the emulation state to '<name>.sav', then the job exits.
+  Jobs use the "none" video backend, so that only the saved frame is
+  converted, unless their options ask for another one.
+*/
+const char Batch_fileid[] = "Hatari batch.c : " __DATE__ " " __TIME__;
+
+#include "config.h"
+
+#if HAVE_FORK
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "main.h"
+#include "batch.h"
+#include "change.h"
+#include "configuration.h"
+#include "log.h"
+#include "memorySnapShot.h"
+#include "screenSnapShot.h"
+#include "str.h"
+
+#if HAVE_LIBPNG
+#define BATCH_SCREEN_EXT	".png"
+#else
+#define BATCH_SCREEN_EXT	".bmp"
+#endif
+
+typedef struct {
+	char *name;		/* job name, used as prefix for the output files */
+	Uint32 vbls;		/* how many VBLs to run */
+	char *args;		/* Hatari options for this job or NULL */
+	pid_t pid;		/* process running the job, 0 if not started */
+	int status;		/* waitpid() status of the finished job */
+} batch_job_t;
+
+static batch_job_t *BatchJobs;
+static int nBatchJobs;
+static int nBatchWorkers;		/* 0 = number of online CPUs */
+static batch_job_t *CurrentJob;		/* job run by this process, NULL in parent */
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Free the job list
+ */
+static void Batch_FreeJobs(void)
+{
+	int i;
+
+	for (i = 0; i < nBatchJobs; i++)
+	{
+		free(BatchJobs[i].name);
+		free(BatchJobs[i].args);
+	}
+	free(BatchJobs);
+	BatchJobs = NULL;
+	nBatchJobs = 0;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Parse given job file line and add it to the job list.
+ * Return error string or NULL on success.
+ */
+static const char *Batch_AddJob(char *line)
+{
+	batch_job_t *jobs, *job;
+	char *name, *end;
+	long vbls;
+
+	name = line;
+	line += strcspn(line, " \t");
+	if (*line)
+		*line++ = '\0';
+	line += strspn(line, " \t");
+
+	vbls = strtol(line, &end, 10);
+	if (end == line || vbls <= 0 || (*end && !isspace((unsigned char)*end)))
+		return "invalid VBL count";
+	line = end + strspn(end, " \t");
+
+	jobs = realloc(BatchJobs, (nBatchJobs + 1) * sizeof(batch_job_t));
+	if (!jobs)
+		return "out of memory";
+	BatchJobs = jobs;
+
+	job = &BatchJobs[nBatchJobs];
+	memset(job, 0, sizeof(*job));
+	job->name = strdup(name);
+	job->vbls = vbls;
+	if (*line)
+		job->args = strdup(line);
+	if (!job->name || (*line && !job->args))
+	{
+		free(job->name);
+		free(job->args);
+		return "out of memory";
+	}
+	nBatchJobs++;
+	return NULL;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Read the jobs from given file and enable batch mode.
+ * Return error string or NULL on success.
+ */
+const char *Batch_SetJobFile(const char *filename)
+{
+	static char errstr[128];
+	const char *err = NULL;
+	char line[1024], *p;
+	int lineno = 0;
+	FILE *fp;
+
+	if (CurrentJob)
+		return "Batch mode can't be used within a batch job";
+
+	fp = fopen(filename, "r");
+	if (!fp)
+		return "Can't open the job file";
+
+	Batch_FreeJobs();
+	while (!err && fgets(line, sizeof(line), fp))
+	{
+		lineno++;
+		p = Str_Trim(line);
+		if (!*p || *p == '#')
+			continue;
+		err = Batch_AddJob(p);
+	}
+	fclose(fp);
+
+	if (err)
+	{
+		Batch_FreeJobs();
+		snprintf(errstr, sizeof(errstr), "Job file line %d: %s", lineno, err);
+		return errstr;
+	}
+	if (!nBatchJobs)
+		return "No jobs in the job file";
+
+	/* jobs run without any user interaction */
+#if HAVE_SETENV
+	setenv("SDL_VIDEODRIVER", "dummy", 1);
+	setenv("SDL_AUDIODRIVER", "dummy", 1);
+#endif
+	ConfigureParams.Screen.nVideoBackend = VIDEO_BACKEND_NONE;
+	ConfigureParams.Sound.bEnableSound = false;
+	ConfigureParams.Log.nAlertDlgLogLevel = LOG_FATAL;
+	return NULL;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Set how many jobs can run at the same time, 0 = number of online CPUs.
+ * Return error string or NULL on success.
+ */
+const char *Batch_SetWorkers(int workers)
+{
+	if (workers < 0)
+		return "Invalid number of batch workers";
+	nBatchWorkers = workers;
+	return NULL;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Return true if a job file was given
+ */
+bool Batch_IsEnabled(void)
+{
+	return nBatchJobs > 0;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Set up the forked process for running given job.
+ * Return false if job options can't be applied.
+ */
+static bool Batch_StartJob(batch_job_t *job)
+{
+	char filename[FILENAME_MAX];
+	int fd;
+
+	CurrentJob = job;
+
+	/* job output goes to its own log file, no input */
+	snprintf(filename, sizeof(filename), "%s.log", job->name);
+	fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd >= 0)
+	{
+		dup2(fd, STDOUT_FILENO);
+		dup2(fd, STDERR_FILENO);
+		close(fd);
+	}
+	else
+	{
+		perror(filename);
+	}
+	fd = open("/dev/null", O_RDONLY);
+	if (fd >= 0)
+	{
+		dup2(fd, STDIN_FILENO);
+		close(fd);
+	}
+
+	fprintf(stderr, "Batch job '%s': %u VBLs, options: %s\n",
+		job->name, job->vbls, job->args ? job->args : "-");
+
+	ConfigureParams.System.bFastForward = true;
+	if (job->args && !Change_ApplyCommandline(job->args))
+	{
+		fprintf(stderr, "ERROR: invalid options for job '%s'\n", job->name);
+		return false;
+	}
+	Main_SetRunVBLs(job->vbls);
+	return true;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Show how given job ended
+ */
+static void Batch_ShowStatus(batch_job_t *job)
+{
+	if (WIFEXITED(job->status))
+		fprintf(stderr, "Batch job '%s': exit code %d\n",
+			job->name, WEXITSTATUS(job->status));
+	else
+		fprintf(stderr, "Batch job '%s': killed by signal %d\n",
+			job->name, WTERMSIG(job->status));
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Run the jobs, forking a new process for each of them.
+ *
+ * Returns true in the forked processes, which should then continue
+ * with the emulation. In the parent process, this returns false once
+ * all the jobs have finished, with the exit code set to 1 if some
+ * job failed, 0 otherwise.
+ */
+bool Batch_Run(int *pExitCode)
+{
+	int workers, running, next, failed, status, i;
+	pid_t pid;
+
+	workers = nBatchWorkers;
+	if (!workers)
+		workers = sysconf(_SC_NPROCESSORS_ONLN);
+	if (workers < 1)
+		workers = 1;
+	fprintf(stderr, "Batch mode: %d jobs, %d workers.\n", nBatchJobs, workers);
+
+	running = next = 0;
+	while (next < nBatchJobs || running > 0)
+	{
+		/* start jobs until all workers are busy */
+		while (running < workers && next < nBatchJobs)
+		{
+			batch_job_t *job = &BatchJobs[next++];
+
+			/* don't get parent's buffered output duplicated */
+			fflush(stdout);
+			fflush(stderr);
+
+			pid = fork();
+			if (pid == 0)
+			{
+				if (!Batch_StartJob(job))
+					_exit(1);
+				return true;
+			}
+			if (pid < 0)
+			{
+				perror("Batch job fork");
+				job->status = -1;
+				continue;
+			}
+			job->pid = pid;
+			running++;
+		}
+		if (!running)
+			break;
+
+		/* wait for any job to finish */
+		pid = waitpid(-1, &status, 0);
+		if (pid < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			perror("Batch job wait");
+			break;
+		}
+		for (i = 0; i < next; i++)
+		{
+			if (BatchJobs[i].pid == pid)
+			{
+				BatchJobs[i].status = status;
+				BatchJobs[i].pid = 0;
+				running--;
+				Batch_ShowStatus(&BatchJobs[i]);
+				break;
+			}
+		}
+	}
+
+	failed = 0;
+	for (i = 0; i < nBatchJobs; i++)
+	{
+		if (BatchJobs[i].pid || i >= next ||
+		    !WIFEXITED(BatchJobs[i].status) || WEXITSTATUS(BatchJobs[i].status))
+			failed++;
+	}
+	fprintf(stderr, "Batch mode: %d/%d jobs succeeded.\n", nBatchJobs - failed, nBatchJobs);
+
+	Batch_FreeJobs();
+	*pExitCode = failed ? 1 : 0;
+	return false;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Called when the job has run the requested number of VBLs,
+ * saves the job results. Does nothing outside of batch jobs.
+ */
+void Batch_JobDone(void)
+{
+	char filename[FILENAME_MAX];
+
+	if (!CurrentJob)
+		return;
+
+	snprintf(filename, sizeof(filename), "%s" BATCH_SCREEN_EXT, CurrentJob->name);
+	ScreenSnapShot_SaveToFile(filename);
+
+	snprintf(filename, sizeof(filename), "%s.sav", CurrentJob->name);
+	MemorySnapShot_Capture(filename, false);
+}
+
+#endif /* HAVE_FORK */
@@ -1044,6 +1044,83 @@ void Blitter_Skew_WriteByte(void)
 }
 
 
+/*-----------------------------------------------------------------------*/
+/**
+ * Native long access handlers for pairs of blitter word registers.
+ * They are called once by ioMem.c for a long access, instead of
+ * calling the handler of each word one after the other.
+ */
+void Blitter_Halftone_ReadLong(void)
+{
+	int index = (IoAccessCurrentAddress - REG_HT_RAM) / 2;
+
+	Blitter_Halftone_ReadWord(index);
+	Blitter_Halftone_ReadWord(index + 1);
+}
+
+void Blitter_Halftone_WriteLong(void)
+{
+	int index = (IoAccessCurrentAddress - REG_HT_RAM) / 2;
+
+	Blitter_Halftone_WriteWord(index);
+	Blitter_Halftone_WriteWord(index + 1);
+}
+
+void Blitter_SourceInc_ReadLong(void)
+{
+	Blitter_SourceXInc_ReadWord();
+	Blitter_SourceYInc_ReadWord();
+}
+
+void Blitter_SourceInc_WriteLong(void)
+{
+	Blitter_SourceXInc_WriteWord();
+	Blitter_SourceYInc_WriteWord();
+}
+
+void Blitter_Endmask_ReadLong(void)
+{
+	if (IoAccessCurrentAddress == REG_END_MASK1)
+		Blitter_Endmask1_ReadWord();
+	Blitter_Endmask2_ReadWord();
+	if (IoAccessCurrentAddress == REG_END_MASK2)
+		Blitter_Endmask3_ReadWord();
+}
+
+void Blitter_Endmask_WriteLong(void)
+{
+	if (IoAccessCurrentAddress == REG_END_MASK1)
+		Blitter_Endmask1_WriteWord();
+	Blitter_Endmask2_WriteWord();
+	if (IoAccessCurrentAddress == REG_END_MASK2)
+		Blitter_Endmask3_WriteWord();
+}
+
+void Blitter_DestInc_ReadLong(void)
+{
+	Blitter_DestXInc_ReadWord();
+	Blitter_DestYInc_ReadWord();
+}
+
+void Blitter_DestInc_WriteLong(void)
+{
+	Blitter_DestXInc_WriteWord();
+	Blitter_DestYInc_WriteWord();
+}
+
+void Blitter_Count_ReadLong(void)
+{
+	Blitter_WordsPerLine_ReadWord();
+	Blitter_LinesPerBitblock_ReadWord();
+}
+
+void Blitter_Count_WriteLong(void)
+{
+	Blitter_WordsPerLine_WriteWord();
+	Blitter_LinesPerBitblock_WriteWord();
+}
+
+
 /*-----------------------------------------------------------------------*/
 /**
  * Handler which continues blitting after 64 bus cycles.
@@ -37,6 +37,7 @@ const char Change_fileid[] = "Hatari change.c : " __DATE__ " " __TIME__;
 #include "statusbar.h"
 #include "tos.h"
 #include "vdi.h"
+#include "vdiDraw.h"
 #include "video.h"
 #include "hatari-glue.h"
 #if ENABLE_DSP_EMU
@@ -81,6 +82,10 @@ bool Change_DoNeedReset(CNF_PARAMS *current, CNF_PARAMS *changed)
 	if (strcmp(changed->Rom.szTosImageFileName, current->Rom.szTosImageFileName))
 		return true;
 
+	/* Did change IKBD ROM image? */
+	if (strcmp(changed->Rom.szIkbdRomFileName, current->Rom.szIkbdRomFileName))
+		return true;
+
 	/* Did change ACSI hard disk image? */
 	for (i = 0; i < MAX_ACSI_DEVS; i++)
 	{
@@ -198,6 +203,7 @@ void Change_CopyChangedParamsToConfiguration(CNF_PARAMS *current, CNF_PARAMS *ch
 	     || changed->Screen.nMaxHeight != current->Screen.nMaxHeight
 	     || changed->Screen.bAllowOverscan != current->Screen.bAllowOverscan
 	     || changed->Screen.bShowStatusbar != current->Screen.bShowStatusbar
+	     || changed->Screen.nVideoBackend != current->Screen.nVideoBackend
 #if WITH_SDL2
 	     || changed->Screen.nRenderScaleQuality != current->Screen.nRenderScaleQuality
 	     || changed->Screen.bUseVsync != current->Screen.bUseVsync
@@ -208,6 +214,13 @@ void Change_CopyChangedParamsToConfiguration(CNF_PARAMS *current, CNF_PARAMS *ch
 		bScreenModeChange = true;
 	}
 
+	/* Did toggle VDI host drawing? Forget tracked attributes */
+	if (changed->Screen.bVdiHostDraw != current->Screen.bVdiHostDraw)
+	{
+		Dprintf("- VDI host drawing>\n");
+		VDIDraw_Reset();
+	}
+
 	/* Did set new printer parameters? */
 	if (changed->Printer.bEnablePrinting != current->Printer.bEnablePrinting
 	    || strcmp(changed->Printer.szPrintToFileName,current->Printer.szPrintToFileName))
@@ -52,6 +52,7 @@ static const struct Config_Tag configs_Log[] =
 	{ "nAlertDlgLogLevel", Int_Tag, &ConfigureParams.Log.nAlertDlgLogLevel },
 	{ "bConfirmQuit", Bool_Tag, &ConfigureParams.Log.bConfirmQuit },
 	{ "bNatFeats", Bool_Tag, &ConfigureParams.Log.bNatFeats },
+	{ "sNatFeatsFileName", String_Tag, ConfigureParams.Log.sNatFeatsFileName },
 	{ "bConsoleWindow", Bool_Tag, &ConfigureParams.Log.bConsoleWindow },
 	{ NULL , Error_Tag, NULL }
 };
@@ -82,6 +83,7 @@ static const struct Config_Tag configs_Screen[] =
 	{ "nForceBpp", Int_Tag, &ConfigureParams.Screen.nForceBpp },
 	{ "bAspectCorrect", Bool_Tag, &ConfigureParams.Screen.bAspectCorrect },
 	{ "bUseExtVdiResolutions", Bool_Tag, &ConfigureParams.Screen.bUseExtVdiResolutions },
+	{ "bVdiHostDraw", Bool_Tag, &ConfigureParams.Screen.bVdiHostDraw },
 	{ "nVdiWidth", Int_Tag, &ConfigureParams.Screen.nVdiWidth },
 	{ "nVdiHeight", Int_Tag, &ConfigureParams.Screen.nVdiHeight },
 	{ "nVdiColors", Int_Tag, &ConfigureParams.Screen.nVdiColors },
@@ -92,6 +94,9 @@ static const struct Config_Tag configs_Screen[] =
 	{ "bForceMax", Bool_Tag, &ConfigureParams.Screen.bForceMax },
 	{ "nMaxWidth", Int_Tag, &ConfigureParams.Screen.nMaxWidth },
 	{ "nMaxHeight", Int_Tag, &ConfigureParams.Screen.nMaxHeight },
+	{ "bRenderThread", Bool_Tag, &ConfigureParams.Screen.bRenderThread },
+	{ "bLineBatch", Bool_Tag, &ConfigureParams.Screen.bLineBatch },
+	{ "nVideoBackend", Int_Tag, &ConfigureParams.Screen.nVideoBackend },
 #if WITH_SDL2
 	{ "nRenderScaleQuality", Int_Tag, &ConfigureParams.Screen.nRenderScaleQuality },
 	{ "bUseVsync", Int_Tag, &ConfigureParams.Screen.bUseVsync },
@@ -387,6 +392,7 @@ static const struct Config_Tag configs_Sound[] =
 	{ "bEnableSoundSync", Bool_Tag, &ConfigureParams.Sound.bEnableSoundSync },
 	{ "nPlaybackFreq", Int_Tag, &ConfigureParams.Sound.nPlaybackFreq },
 	{ "nSdlAudioBufferSize", Int_Tag, &ConfigureParams.Sound.SdlAudioBufferSize },
+	{ "nAudioLatency", Int_Tag, &ConfigureParams.Sound.nAudioLatency },
 	{ "szYMCaptureFileName", String_Tag, ConfigureParams.Sound.szYMCaptureFileName },
 	{ "YmVolumeMixing", Int_Tag, &ConfigureParams.Sound.YmVolumeMixing },
 	{ NULL , Error_Tag, NULL }
@@ -489,6 +495,7 @@ static const struct Config_Tag configs_Rom[] =
 	{ "szTosImageFileName", String_Tag, ConfigureParams.Rom.szTosImageFileName },
 	{ "bPatchTos", Bool_Tag, &ConfigureParams.Rom.bPatchTos },
 	{ "szCartridgeImageFileName", String_Tag, ConfigureParams.Rom.szCartridgeImageFileName },
+	{ "szIkbdRomFileName", String_Tag, ConfigureParams.Rom.szIkbdRomFileName },
 	{ NULL , Error_Tag, NULL }
 };
 
@@ -546,6 +553,7 @@ static const struct Config_Tag configs_System[] =
 	{ "n_FPUType", Int_Tag, &ConfigureParams.System.n_FPUType },
 /* JIT	{ "bCompatibleFPU", Bool_Tag, &ConfigureParams.System.bCompatibleFPU }, */
 	{ "bMMU", Bool_Tag, &ConfigureParams.System.bMMU },
+	{ "IdleLoops", Int_Tag, &ConfigureParams.System.IdleLoopMode },
 #endif
 	{ "VideoTiming", Int_Tag, &ConfigureParams.System.VideoTimingMode },
 	{ NULL , Error_Tag, NULL }
@@ -585,6 +593,7 @@ void Configuration_SetDefault(void)
 	ConfigureParams.Log.nAlertDlgLogLevel = LOG_ERROR;
 	ConfigureParams.Log.bConfirmQuit = true;
 	ConfigureParams.Log.bNatFeats = false;
+	ConfigureParams.Log.sNatFeatsFileName[0] = '\0';
 	ConfigureParams.Log.bConsoleWindow = false;
 
 	/* Set defaults for debugger */
@@ -740,6 +749,7 @@ void Configuration_SetDefault(void)
 	ConfigureParams.Screen.bAspectCorrect = true;
 	ConfigureParams.Screen.nMonitorType = MONITOR_TYPE_RGB;
 	ConfigureParams.Screen.bUseExtVdiResolutions = false;
+	ConfigureParams.Screen.bVdiHostDraw = false;
 	ConfigureParams.Screen.nVdiWidth = 640;
 	ConfigureParams.Screen.nVdiHeight = 480;
 	ConfigureParams.Screen.nVdiColors = GEMCOLOR_16;
@@ -751,6 +761,9 @@ void Configuration_SetDefault(void)
 	ConfigureParams.Screen.nMaxWidth = 2*NUM_VISIBLE_LINE_PIXELS;
 	ConfigureParams.Screen.nMaxHeight = 2*NUM_VISIBLE_LINES+STATUSBAR_MAX_HEIGHT;
 	ConfigureParams.Screen.bForceMax = false;
+	ConfigureParams.Screen.bRenderThread = false;
+	ConfigureParams.Screen.bLineBatch = false;
+	ConfigureParams.Screen.nVideoBackend = VIDEO_BACKEND_SDL;
 #if WITH_SDL2
 	ConfigureParams.Screen.nRenderScaleQuality = 0;
 	ConfigureParams.Screen.bUseVsync = false;
@@ -764,6 +777,7 @@ void Configuration_SetDefault(void)
 	sprintf(ConfigureParams.Sound.szYMCaptureFileName, "%s%chatari.wav",
 	        psWorkingDir, PATHSEP);
 	ConfigureParams.Sound.SdlAudioBufferSize = 0;
+	ConfigureParams.Sound.nAudioLatency = 0;
 	ConfigureParams.Sound.YmVolumeMixing = YM_TABLE_MIXING;
 
 	/* Set defaults for Rom */
@@ -771,6 +785,7 @@ void Configuration_SetDefault(void)
 	        Paths_GetDataDir(), PATHSEP);
 	ConfigureParams.Rom.bPatchTos = true;
 	strcpy(ConfigureParams.Rom.szCartridgeImageFileName, "");
+	strcpy(ConfigureParams.Rom.szIkbdRomFileName, "");
 
 	/* Set defaults for System */
 	ConfigureParams.System.nMachineType = MACHINE_ST;
@@ -783,6 +798,7 @@ void Configuration_SetDefault(void)
 	ConfigureParams.System.bCompatibleFPU = true; /* JIT */
 	ConfigureParams.System.bMMU = false;
 	ConfigureParams.System.bCycleExactCpu = true;
+	ConfigureParams.System.IdleLoopMode = IDLE_LOOP_MODE_RUN;
 #endif
 	ConfigureParams.System.VideoTimingMode = VIDEO_TIMING_MODE_WS3;
 	ConfigureParams.System.bCompatibleCpu = true;
@@ -871,6 +887,15 @@ void Configuration_Apply(bool bReset)
 	else if ( SdlAudioBufferSize > 100 )		/* max of 100 ms */
 		SdlAudioBufferSize = 100;
 
+	/* Emulation paced by the audio output, with a target latency in ms */
+	AudioLatency = ConfigureParams.Sound.nAudioLatency;
+	if ( AudioLatency == 0 )			/* paced by the host timer */
+		;
+	else if ( AudioLatency < 10 )			/* min of 10 ms */
+		AudioLatency = 10;
+	else if ( AudioLatency > 200 )			/* max of 200 ms */
+		AudioLatency = 200;
+
 	/* Set playback frequency */
 	Audio_SetOutputAudioFreq(ConfigureParams.Sound.nPlaybackFreq);
 
@@ -887,6 +912,12 @@ void Configuration_Apply(bool bReset)
 	if ( Config_IsMachineFalcon() )
 		Crossbar_Recalculate_Clocks_Cycles();
 
+	/* Idle loops mode, config file value isn't checked when loaded */
+	if ( ( ConfigureParams.System.IdleLoopMode != IDLE_LOOP_MODE_RUN )
+	  && ( ConfigureParams.System.IdleLoopMode != IDLE_LOOP_MODE_SKIP )
+	  && ( ConfigureParams.System.IdleLoopMode != IDLE_LOOP_MODE_CHECK ) )
+		ConfigureParams.System.IdleLoopMode = IDLE_LOOP_MODE_RUN;
+
 	/* Check/constrain CPU settings and change corresponding
 	 * UAE cpu_level & cpu_compatible variables
 	 */
@@ -896,6 +927,8 @@ void Configuration_Apply(bool bReset)
 	File_MakeAbsoluteName(ConfigureParams.Rom.szTosImageFileName);
 	if (strlen(ConfigureParams.Rom.szCartridgeImageFileName) > 0)
 		File_MakeAbsoluteName(ConfigureParams.Rom.szCartridgeImageFileName);
+	if (strlen(ConfigureParams.Rom.szIkbdRomFileName) > 0)
+		File_MakeAbsoluteName(ConfigureParams.Rom.szIkbdRomFileName);
 	File_CleanFileName(ConfigureParams.HardDisk.szHardDiskDirectories[0]);
 	File_MakeAbsoluteName(ConfigureParams.HardDisk.szHardDiskDirectories[0]);
 	File_MakeAbsoluteName(ConfigureParams.Memory.szMemoryCaptureFileName);
@@ -903,6 +936,8 @@ void Configuration_Apply(bool bReset)
 	if (strlen(ConfigureParams.Keyboard.szMappingFileName) > 0)
 		File_MakeAbsoluteName(ConfigureParams.Keyboard.szMappingFileName);
 	File_MakeAbsoluteName(ConfigureParams.Video.AviRecordFile);
+	if (strlen(ConfigureParams.Log.sNatFeatsFileName) > 0)
+		File_MakeAbsoluteName(ConfigureParams.Log.sNatFeatsFileName);
 	for (i = 0; i < MAX_ACSI_DEVS; i++)
 	{
 		File_MakeAbsoluteName(ConfigureParams.Acsi[i].sDeviceFile);
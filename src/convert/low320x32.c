@@ -21,7 +21,7 @@ static void ConvertLowRes_320x32Bit(void)
 	{
 
 		eax = STScreenLineOffset[y] + STScreenLeftSkipBytes;  /* Offset for this line + Amount to skip on left hand side */
-		edi = (Uint32 *)((Uint8 *)pSTScreen + eax);       /* ST format screen 4-plane 16 colors */
+		edi = (Uint32 *)((Uint8 *)pSTScreenConv + eax);   /* ST format screen 4-plane 16 colors */
 		ebp = (Uint32 *)((Uint8 *)pSTScreenCopy + eax);   /* Previous ST format screen */
 		esi = (Uint32 *)pPCScreenDest;                    /* PC format screen */
 
@@ -39,7 +39,7 @@ static void ConvertLowRes_320x32Bit(void)
 			{
 				/* copy word */
 
-				bScreenContentsChanged = true;
+				MARK_LINE_CHANGED;
 
 #if SDL_BYTEORDER == SDL_BIG_ENDIAN
 				/* Plot pixels */
@@ -29,7 +29,7 @@ static void ConvertLowRes_320x32Bit_Spec(void)
 
 		/* Get screen addresses, 'edi'-ST screen, 'ebp'-Previous ST screen, 'esi'-PC screen */
 		eax = STScreenLineOffset[y] + STScreenLeftSkipBytes;  /* Offset for this line + Amount to skip on left hand side */
-		edi = (Uint32 *)((Uint8 *)pSTScreen + eax);       /* ST format screen 4-plane 16 colors */
+		edi = (Uint32 *)((Uint8 *)pSTScreenConv + eax);   /* ST format screen 4-plane 16 colors */
 		ebp = (Uint32 *)((Uint8 *)pSTScreenCopy + eax);   /* Previous ST format screen */
 		esi = (Uint32 *)pPCScreenDest;                    /* PC format screen */
 
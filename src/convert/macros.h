@@ -85,6 +85,17 @@ static const Uint32 Remap_2_Planes_Upper[256] = {
 
 
 /*----------------------------------------------------------------------*/
+/* Mark the line at pPCScreenDest as changed, lines are converted
+ * from top to bottom so this gives the screen area to update
+ */
+#define MARK_LINE_CHANGED \
+{ \
+	bScreenContentsChanged = true; \
+	if (!pPCScreenChangedStart) \
+		pPCScreenChangedStart = pPCScreenDest; \
+	pPCScreenChangedEnd = pPCScreenDest; \
+}
+
 /* Macros to convert from Atari's planar mode to chunky mode
  * (1 byte per pixel). Convert by blocks of 4 pixels.
  * 16 low res pixels -> 4 planes of 16 bits
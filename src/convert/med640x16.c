@@ -20,7 +20,7 @@ static void ConvertMediumRes_640x16Bit(void)
 	{
 
 		eax = STScreenLineOffset[y] + STScreenLeftSkipBytes;  /* Offset for this line + Amount to skip on left hand side */
-		edi = (Uint32 *)((Uint8 *)pSTScreen + eax);        /* ST format screen 4-plane 16 colors */
+		edi = (Uint32 *)((Uint8 *)pSTScreenConv + eax);    /* ST format screen 4-plane 16 colors */
 		ebp = (Uint32 *)((Uint8 *)pSTScreenCopy + eax);    /* Previous ST format screen */
 		esi = (Uint16 *)pPCScreenDest;                     /* PC format screen */
 
@@ -54,7 +54,7 @@ static void Line_ConvertMediumRes_640x16Bit(Uint32 *edi, Uint32 *ebp, Uint16 *es
 		{
 			/* copy word */
 
-			bScreenContentsChanged = true;
+			MARK_LINE_CHANGED;
 
 #if SDL_BYTEORDER == SDL_BIG_ENDIAN
 			/* Plot in 'right-order' on big endian systems */
@@ -19,7 +19,7 @@ static void ConvertMediumRes_640x16Bit_Spec(void)
 	for (y = STScreenStartHorizLine; y < STScreenEndHorizLine; y++)
 	{
 		eax = STScreenLineOffset[y] + STScreenLeftSkipBytes;  /* Offset for this line + Amount to skip on left hand side */
-		edi = (Uint32 *)((Uint8 *)pSTScreen + eax);        /* ST format screen 4-plane 16 colors */
+		edi = (Uint32 *)((Uint8 *)pSTScreenConv + eax);    /* ST format screen 4-plane 16 colors */
 		ebp = (Uint32 *)((Uint8 *)pSTScreenCopy + eax);    /* Previous ST format screen */
 		esi = (Uint16 *)pPCScreenDest;                     /* PC format screen */
 
@@ -60,6 +60,9 @@ static bool ismoves;
 bool mmu_ttr_enabled;
 int mmu_atc_ways;
 
+struct mmu_tlb_entry mmu_tlb[ATC_TYPE][MMU_TLB_SIZE];
+bool mmu_tlb_direct;
+
 int mmu040_movem;
 uaecptr mmu040_movem_ea;
 uae_u32 mmu040_move16[4];
@@ -109,6 +112,45 @@ void mmu_make_transparent_region(uaecptr baseaddr, uae_u32 size, int datamode)
 void mmu_tt_modified (void)
 {
 	mmu_ttr_enabled = ((regs.dtt0 | regs.dtt1 | regs.itt0 | regs.itt1) & MMU_TTR_BIT_ENABLED) != 0;
+	mmu_tlb_flush_all();
+}
+
+/*
+ * Translation cache flushing, see mmu_tlb_lookup()
+ */
+void mmu_tlb_flush_all(void)
+{
+	int type, i;
+
+	for (type = 0; type < ATC_TYPE; type++)
+		for (i = 0; i < MMU_TLB_SIZE; i++)
+			mmu_tlb[type][i].tag = MMU_TLB_INVALID;
+}
+
+/* Flush given logical page, for both S and data/instruction */
+void mmu_tlb_flush_page(uaecptr addr)
+{
+	int type, n, i;
+
+	addr &= ~mmu_pagemask;
+	for (n = 0; n < (mmu_pagesize_8k ? 2 : 1); n++) {
+		i = ((addr >> 12) + n) & (MMU_TLB_SIZE - 1);
+		for (type = 0; type < ATC_TYPE; type++) {
+			if ((mmu_tlb[type][i].tag & ~1) == addr)
+				mmu_tlb[type][i].tag = MMU_TLB_INVALID;
+		}
+	}
+}
+
+/* Flush the logical page of given ATC line, which is about to be replaced */
+void mmu_tlb_flush_atc_line(struct mmu_atc_line *l, int index)
+{
+	uaecptr addr;
+
+	/* tag has the logical address bits above the ATC index */
+	addr = (l->tag << 1) & (mmu_tagmask << 1);
+	addr |= index << (mmu_pagesize_8k ? 13 : 12);
+	mmu_tlb_flush_page(addr);
 }
 
 
@@ -484,6 +526,7 @@ static uaecptr mmu_fill_atc(uaecptr addr, bool super, bool data, bool write, str
 {
 	uae_u32 desc;
 
+	mmu_tlb_flush_page(addr);
 	*status = 0;
 	SAVE_EXCEPTION;
 	TRY(prb) {
@@ -1230,6 +1273,7 @@ void REGPARAM2 mmu_flush_atc(uaecptr addr, bool super, bool global)
 			}
 		}
 	}	
+	mmu_tlb_flush_page(addr);
 }
 
 void REGPARAM2 mmu_flush_atc_all(bool global)
@@ -1244,12 +1288,16 @@ void REGPARAM2 mmu_flush_atc_all(bool global)
 			}
 		}
 	}
+	mmu_tlb_flush_all();
 }
 
 void REGPARAM2 mmu_set_funcs(void)
 {
 	if (currprefs.mmu_model != 68040 && currprefs.mmu_model != 68060)
 		return;
+	mmu_tlb_flush_all();
+	/* RAM can be accessed directly only without cache emulation */
+	mmu_tlb_direct = !currprefs.cpu_cycle_exact && !currprefs.cpu_compatible;
 	if (currprefs.cpu_cycle_exact || currprefs.cpu_compatible) {
 		x_phys_get_iword = get_word_icache040;
 		x_phys_get_ilong = get_long_icache040;
@@ -195,6 +195,74 @@ extern struct mmu_atc_line mmu_atc_array[ATC_TYPE][ATC_WAYS][ATC_SLOTS];
 /* Last matched ATC index, next lookup starts from this index as an optimization */
 extern int mmu_atc_ways;
 
+/*
+ * Emulator side translation cache in front of the ATC, which avoids the
+ * TTR checks and the ATC way scan on most accesses. It's a direct mapped
+ * table indexed by the logical page number, one for data and one for
+ * instructions, holding the physical page for a logical page + S bit.
+ * Entries are only created from valid ATC lines and are flushed whenever
+ * ATC lines are replaced or invalidated, or TC/TTRs change, so this never
+ * holds a translation that the ATC doesn't have.
+ */
+#define MMU_TLB_BITS	10
+#define MMU_TLB_SIZE	(1 << MMU_TLB_BITS)
+#define MMU_TLB_INVALID	0xffffffff
+
+struct mmu_tlb_entry {
+	uae_u32 tag;		/* logical page | S, MMU_TLB_INVALID if unused */
+	uaecptr phys;		/* physical page */
+	bool write;		/* ATC line is modified and not write protected */
+};
+
+extern struct mmu_tlb_entry mmu_tlb[ATC_TYPE][MMU_TLB_SIZE];
+extern bool mmu_tlb_direct;
+
+extern void mmu_tlb_flush_all(void);
+extern void mmu_tlb_flush_page(uaecptr addr);
+extern void mmu_tlb_flush_atc_line(struct mmu_atc_line *l, int index);
+
+static ALWAYS_INLINE uae_u32 mmu_tlb_tag(uaecptr addr)
+{
+	return (addr & ~mmu_pagemask) | (mmu_is_super >> 31);
+}
+
+/* Return the physical address for given logical address if it's in
+ * the translation cache, or MMU_TLB_INVALID */
+static ALWAYS_INLINE uaecptr mmu_tlb_lookup(uaecptr addr, bool data, bool write)
+{
+	struct mmu_tlb_entry *e = &mmu_tlb[data][(addr >> 12) & (MMU_TLB_SIZE - 1)];
+
+	if (e->tag != mmu_tlb_tag(addr) || (write && !e->write))
+		return MMU_TLB_INVALID;
+	return e->phys | (addr & mmu_pagemask);
+}
+
+static ALWAYS_INLINE void mmu_tlb_add(uaecptr addr, bool data, struct mmu_atc_line *cl)
+{
+	struct mmu_tlb_entry *e = &mmu_tlb[data][(addr >> 12) & (MMU_TLB_SIZE - 1)];
+
+	e->tag = mmu_tlb_tag(addr);
+	e->phys = cl->phys;
+	e->write = cl->modified && !cl->write_protect;
+}
+
+/* Host address for a physical address returned by mmu_tlb_lookup(),
+ * or NULL if it must be accessed through the x_phys_xxx() functions.
+ * For writes, the ST RAM write stamp is updated here */
+static ALWAYS_INLINE uae_u8 *mmu_tlb_host_read(uaecptr phys)
+{
+	uae_u8 *p = mmu_tlb_direct ? direct_read_ptr(phys) : NULL;
+	return p ? p + (phys & 0xffff) : NULL;
+}
+static ALWAYS_INLINE uae_u8 *mmu_tlb_host_write(uaecptr phys)
+{
+	uae_u8 *p = mmu_tlb_direct ? direct_write_ptr(phys) : NULL;
+	if (!p)
+		return NULL;
+	STMemory_MarkWritten(phys);
+	return p + (phys & 0xffff);
+}
+
 /*
  * mmu access is a 4 step process:
  * if mmu is not enabled just read physical
@@ -228,6 +296,8 @@ static ALWAYS_INLINE bool mmu_lookup(uaecptr addr, bool data, bool write,
 	}
 	// we select a random way to void
 	*cl=&mmu_atc_array[data][way_miss%ATC_WAYS][index];
+	if ((*cl)->valid)
+		mmu_tlb_flush_atc_line(*cl, index);
 	(*cl)->tag = tag;
 	way_miss++;
 	return false;
@@ -261,6 +331,8 @@ static ALWAYS_INLINE bool mmu_user_lookup(uaecptr addr, bool super, bool data,
 	}
 	// we select a random way to void
 	*cl=&mmu_atc_array[data][way_miss%ATC_WAYS][index];
+	if ((*cl)->valid)
+		mmu_tlb_flush_atc_line(*cl, index);
 	(*cl)->tag = tag;
 	way_miss++;
 	return false;
@@ -401,105 +473,204 @@ extern void mmu_put_move16(uaecptr addr, uae_u32 *val, bool data, int size);
 static ALWAYS_INLINE uae_u32 mmu_get_long(uaecptr addr, bool data, int size, bool rmw)
 {
 	struct mmu_atc_line *cl;
+	uaecptr phys;
+	uae_u8 *p;
+
+	phys = mmu_tlb_lookup(addr, data, false);
+	if (likely(phys != MMU_TLB_INVALID)) {
+		p = mmu_tlb_host_read(phys);
+		if (p)
+			return do_get_mem_long(p);
+		return x_phys_get_long(phys);
+	}
 
 	//                                       addr,super,data
 	if ((!regs.mmu_enabled) || (mmu_match_ttr(addr,regs.s != 0,data,rmw)!=TTR_NO_MATCH))
 		return x_phys_get_long(addr);
-	if (likely(mmu_lookup(addr, data, false, &cl)))
+	if (likely(mmu_lookup(addr, data, false, &cl))) {
+		mmu_tlb_add(addr, data, cl);
 		return x_phys_get_long(mmu_get_real_address(addr, cl));
+	}
 	return mmu_get_long_slow(addr, regs.s != 0, data, size, rmw, cl);
 }
 
 static ALWAYS_INLINE uae_u32 mmu_get_ilong(uaecptr addr, int size)
 {
 	struct mmu_atc_line *cl;
+	uaecptr phys;
+	uae_u8 *p;
+
+	phys = mmu_tlb_lookup(addr, false, false);
+	if (likely(phys != MMU_TLB_INVALID)) {
+		p = mmu_tlb_host_read(phys);
+		if (p)
+			return do_get_mem_long(p);
+		return x_phys_get_ilong(phys);
+	}
 
 	//                                       addr,super,data
 	if ((!regs.mmu_enabled) || (mmu_match_ttr(addr, regs.s != 0, false, false) != TTR_NO_MATCH))
 		return x_phys_get_ilong(addr);
-	if (likely(mmu_lookup(addr, false, false, &cl)))
+	if (likely(mmu_lookup(addr, false, false, &cl))) {
+		mmu_tlb_add(addr, false, cl);
 		return x_phys_get_ilong(mmu_get_real_address(addr, cl));
+	}
 	return mmu_get_ilong_slow(addr, regs.s != 0, size, cl);
 }
 
 static ALWAYS_INLINE uae_u16 mmu_get_word(uaecptr addr, bool data, int size, bool rmw)
 {
 	struct mmu_atc_line *cl;
+	uaecptr phys;
+	uae_u8 *p;
+
+	phys = mmu_tlb_lookup(addr, data, false);
+	if (likely(phys != MMU_TLB_INVALID)) {
+		p = mmu_tlb_host_read(phys);
+		if (p)
+			return do_get_mem_word(p);
+		return x_phys_get_word(phys);
+	}
 
 	//                                       addr,super,data
 	if ((!regs.mmu_enabled) || (mmu_match_ttr(addr,regs.s != 0,data,rmw)!=TTR_NO_MATCH))
 		return x_phys_get_word(addr);
-	if (likely(mmu_lookup(addr, data, false, &cl)))
+	if (likely(mmu_lookup(addr, data, false, &cl))) {
+		mmu_tlb_add(addr, data, cl);
 		return x_phys_get_word(mmu_get_real_address(addr, cl));
+	}
 	return mmu_get_word_slow(addr, regs.s != 0, data, size, rmw, cl);
 }
 
 static ALWAYS_INLINE uae_u16 mmu_get_iword(uaecptr addr, int size)
 {
 	struct mmu_atc_line *cl;
+	uaecptr phys;
+	uae_u8 *p;
+
+	phys = mmu_tlb_lookup(addr, false, false);
+	if (likely(phys != MMU_TLB_INVALID)) {
+		p = mmu_tlb_host_read(phys);
+		if (p)
+			return do_get_mem_word(p);
+		return x_phys_get_iword(phys);
+	}
 
 	//                                       addr,super,data
 	if ((!regs.mmu_enabled) || (mmu_match_ttr(addr, regs.s != 0, false, false) != TTR_NO_MATCH))
 		return x_phys_get_iword(addr);
-	if (likely(mmu_lookup(addr, false, false, &cl)))
+	if (likely(mmu_lookup(addr, false, false, &cl))) {
+		mmu_tlb_add(addr, false, cl);
 		return x_phys_get_iword(mmu_get_real_address(addr, cl));
+	}
 	return mmu_get_iword_slow(addr, regs.s != 0, size, cl);
 }
 
 static ALWAYS_INLINE uae_u8 mmu_get_byte(uaecptr addr, bool data, int size, bool rmw)
 {
 	struct mmu_atc_line *cl;
+	uaecptr phys;
+	uae_u8 *p;
+
+	phys = mmu_tlb_lookup(addr, data, false);
+	if (likely(phys != MMU_TLB_INVALID)) {
+		p = mmu_tlb_host_read(phys);
+		if (p)
+			return *p;
+		return x_phys_get_byte(phys);
+	}
 
 	//                                       addr,super,data
 	if ((!regs.mmu_enabled) || (mmu_match_ttr(addr,regs.s != 0,data,rmw)!=TTR_NO_MATCH))
 		return x_phys_get_byte(addr);
-	if (likely(mmu_lookup(addr, data, false, &cl)))
+	if (likely(mmu_lookup(addr, data, false, &cl))) {
+		mmu_tlb_add(addr, data, cl);
 		return x_phys_get_byte(mmu_get_real_address(addr, cl));
+	}
 	return mmu_get_byte_slow(addr, regs.s != 0, data, size, rmw, cl);
 }
 
 static ALWAYS_INLINE void mmu_put_long(uaecptr addr, uae_u32 val, bool data, int size, bool rmw)
 {
 	struct mmu_atc_line *cl;
+	uaecptr phys;
+	uae_u8 *p;
+
+	phys = mmu_tlb_lookup(addr, data, true);
+	if (likely(phys != MMU_TLB_INVALID)) {
+		p = mmu_tlb_host_write(phys);
+		if (p)
+			do_put_mem_long(p, val);
+		else
+			x_phys_put_long(phys, val);
+		return;
+	}
 
 	//                                        addr,super,data
 	if ((!regs.mmu_enabled) || mmu_match_ttr_write(addr,regs.s != 0,data,val,size,rmw)==TTR_OK_MATCH) {
 		x_phys_put_long(addr,val);
 		return;
 	}
-	if (likely(mmu_lookup(addr, data, true, &cl)))
+	if (likely(mmu_lookup(addr, data, true, &cl))) {
+		mmu_tlb_add(addr, data, cl);
 		x_phys_put_long(mmu_get_real_address(addr, cl), val);
-	else
+	} else
 		mmu_put_long_slow(addr, val, regs.s != 0, data, size, rmw, cl);
 }
 
 static ALWAYS_INLINE void mmu_put_word(uaecptr addr, uae_u16 val, bool data, int size, bool rmw)
 {
 	struct mmu_atc_line *cl;
+	uaecptr phys;
+	uae_u8 *p;
+
+	phys = mmu_tlb_lookup(addr, data, true);
+	if (likely(phys != MMU_TLB_INVALID)) {
+		p = mmu_tlb_host_write(phys);
+		if (p)
+			do_put_mem_word(p, val);
+		else
+			x_phys_put_word(phys, val);
+		return;
+	}
 
 	//                                        addr,super,data
 	if ((!regs.mmu_enabled) || (mmu_match_ttr_write(addr,regs.s != 0,data,val,size,rmw)==TTR_OK_MATCH)) {
 		x_phys_put_word(addr,val);
 		return;
 	}
-	if (likely(mmu_lookup(addr, data, true, &cl)))
+	if (likely(mmu_lookup(addr, data, true, &cl))) {
+		mmu_tlb_add(addr, data, cl);
 		x_phys_put_word(mmu_get_real_address(addr, cl), val);
-	else
+	} else
 		mmu_put_word_slow(addr, val, regs.s != 0, data, size, rmw, cl);
 }
 
 static ALWAYS_INLINE void mmu_put_byte(uaecptr addr, uae_u8 val, bool data, int size, bool rmw)
 {
 	struct mmu_atc_line *cl;
+	uaecptr phys;
+	uae_u8 *p;
+
+	phys = mmu_tlb_lookup(addr, data, true);
+	if (likely(phys != MMU_TLB_INVALID)) {
+		p = mmu_tlb_host_write(phys);
+		if (p)
+			*p = val;
+		else
+			x_phys_put_byte(phys, val);
+		return;
+	}
 
 	//                                        addr,super,data
 	if ((!regs.mmu_enabled) || (mmu_match_ttr_write(addr,regs.s != 0,data,val,size,rmw)==TTR_OK_MATCH)) {
 		x_phys_put_byte(addr,val);
 		return;
 	}
-	if (likely(mmu_lookup(addr, data, true, &cl)))
+	if (likely(mmu_lookup(addr, data, true, &cl))) {
+		mmu_tlb_add(addr, data, cl);
 		x_phys_put_byte(mmu_get_real_address(addr, cl), val);
-	else
+	} else
 		mmu_put_byte_slow(addr, val, regs.s != 0, data, size, rmw, cl);
 }
 
@@ -138,6 +138,95 @@ static struct {
 } mmu030;
 
 
+/* Emulator side translation cache in front of the ATC, which avoids the
+ * TT checks and the ATC search on most accesses. It's a direct mapped
+ * table indexed by the logical page number, holding the physical page
+ * for a logical page + FC. Entries are only created from valid ATC
+ * entries and are flushed whenever ATC entries are replaced or flushed,
+ * or TC/TT/root pointers are written, so this never holds a translation
+ * that the ATC doesn't have. */
+#define MMU030_TLB_BITS     10
+#define MMU030_TLB_SIZE     (1 << MMU030_TLB_BITS)
+#define MMU030_TLB_INVALID  0xffffffff
+
+typedef struct {
+    uae_u32 tag;        /* logical page | FC, MMU030_TLB_INVALID if unused */
+    uaecptr phys;       /* physical page */
+    int atc;            /* ATC entry this was created from */
+    bool write;         /* ATC entry is modified and not write protected */
+} MMU030_TLB_ENTRY;
+
+static MMU030_TLB_ENTRY mmu030_tlb[MMU030_TLB_SIZE];
+static bool mmu030_tlb_direct_i;
+
+static void mmu030_tlb_flush_all(void) {
+    int i;
+    for (i=0; i<MMU030_TLB_SIZE; i++) {
+        mmu030_tlb[i].tag = MMU030_TLB_INVALID;
+    }
+}
+
+static inline MMU030_TLB_ENTRY *mmu030_tlb_entry(uaecptr addr) {
+    return &mmu030_tlb[(addr >> mmu030.translation.page.size) & (MMU030_TLB_SIZE-1)];
+}
+
+/* Flush given logical page for all function codes */
+static void mmu030_tlb_flush_page(uaecptr logical_addr) {
+    MMU030_TLB_ENTRY *e = mmu030_tlb_entry(logical_addr);
+    if ((e->tag & mmu030.translation.page.imask) == (logical_addr & mmu030.translation.page.imask)) {
+        e->tag = MMU030_TLB_INVALID;
+    }
+}
+
+/* Return the physical address for given logical address if it's in
+ * the translation cache, or MMU030_TLB_INVALID */
+static inline uaecptr mmu030_tlb_lookup(uaecptr addr, uae_u32 fc, bool write) {
+    MMU030_TLB_ENTRY *e = mmu030_tlb_entry(addr);
+    if (e->tag != ((addr & mmu030.translation.page.imask) | fc) || (write && !e->write)) {
+        return MMU030_TLB_INVALID;
+    }
+    /* Maintain history bit like an ATC hit, calling this
+     * for an entry which has it already set does nothing */
+    if (!mmu030.atc[e->atc].mru) {
+        mmu030_atc_handle_history_bit(e->atc);
+    }
+    return e->phys | (addr & mmu030.translation.page.mask);
+}
+
+static inline void mmu030_tlb_add(uaecptr addr, uae_u32 fc, int l) {
+    MMU030_TLB_ENTRY *e;
+
+    if (mmu030.atc[l].physical.bus_error) {
+        return;
+    }
+    /* TT matching depends on the access direction */
+    if (tt_enabled && (mmu030_match_ttr_access(addr, fc, false) ||
+                       mmu030_match_ttr_access(addr, fc, true))) {
+        return;
+    }
+    e = mmu030_tlb_entry(addr);
+    e->tag = (addr & mmu030.translation.page.imask) | fc;
+    e->phys = mmu030.atc[l].physical.addr & mmu030.translation.page.imask;
+    e->atc = l;
+    e->write = mmu030.atc[l].physical.modified && !mmu030.atc[l].physical.write_protect;
+}
+
+/* Host address for a physical address returned by mmu030_tlb_lookup(),
+ * or NULL if it must be accessed through the bank functions.
+ * For writes, the ST RAM write stamp is updated here */
+static inline uae_u8 *mmu030_tlb_host_read(uaecptr phys) {
+    uae_u8 *p = direct_read_ptr(phys);
+    return p ? p + (phys & 0xffff) : NULL;
+}
+static inline uae_u8 *mmu030_tlb_host_write(uaecptr phys) {
+    uae_u8 *p = direct_write_ptr(phys);
+    if (!p)
+        return NULL;
+    STMemory_MarkWritten(phys);
+    return p + (phys & 0xffff);
+}
+
+
 
 /* MMU Status Register
  *
@@ -288,6 +377,9 @@ bool mmu_op30_pmove (uaecptr pc, uae_u32 opcode, uae_u16 next, uaecptr extra)
     
     if (!fd && !rw && !(preg==0x18)) {
         mmu030_flush_atc_all();
+    }
+    if (!rw && !(preg==0x18)) {
+        mmu030_tlb_flush_all();
     }
 	tt_enabled = (tt0_030 & TT_ENABLE) || (tt1_030 & TT_ENABLE);
 	return false;
@@ -432,6 +524,7 @@ uae_u32 mmu_op30_helper_get_fc(uae_u16 next) {
 /* This function flushes ATC entries depending on their function code */
 void mmu030_flush_atc_fc(uae_u32 fc_base, uae_u32 fc_mask) {
     int i;
+    mmu030_tlb_flush_all();
     for (i=0; i<ATC030_NUM_ENTRIES; i++) {
         if (((fc_base&fc_mask)==(mmu030.atc[i].logical.fc&fc_mask)) &&
             mmu030.atc[i].logical.valid) {
@@ -448,6 +541,7 @@ void mmu030_flush_atc_fc(uae_u32 fc_base, uae_u32 fc_mask) {
 void mmu030_flush_atc_page_fc(uaecptr logical_addr, uae_u32 fc_base, uae_u32 fc_mask) {
     int i;
 	logical_addr &= mmu030.translation.page.imask;
+    mmu030_tlb_flush_page(logical_addr);
     for (i=0; i<ATC030_NUM_ENTRIES; i++) {
         if (((fc_base&fc_mask)==(mmu030.atc[i].logical.fc&fc_mask)) &&
             (mmu030.atc[i].logical.addr == logical_addr) &&
@@ -464,6 +558,7 @@ void mmu030_flush_atc_page_fc(uaecptr logical_addr, uae_u32 fc_base, uae_u32 fc_
 void mmu030_flush_atc_page(uaecptr logical_addr) {
     int i;
 	logical_addr &= mmu030.translation.page.imask;
+    mmu030_tlb_flush_page(logical_addr);
     for (i=0; i<ATC030_NUM_ENTRIES; i++) {
         if ((mmu030.atc[i].logical.addr == logical_addr) &&
             mmu030.atc[i].logical.valid) {
@@ -484,6 +579,7 @@ void mmu030_flush_atc_all(void) {
     for (i=0; i<ATC030_NUM_ENTRIES; i++) {
         mmu030.atc[i].logical.valid = false;
     }
+    mmu030_tlb_flush_all();
 }
 
 
@@ -742,6 +838,8 @@ static void mmu030_do_fake_prefetch(void)
 
 bool mmu030_decode_tc(uae_u32 TC)
 {
+    mmu030_tlb_flush_all();
+
     /* Set MMU condition */    
     if (TC & TC_ENABLE_TRANSLATION) {
 		if (!mmu030.enabled)
@@ -1503,6 +1601,11 @@ uae_u32 mmu030_table_search(uaecptr addr, uae_u32 fc, bool write, int level) {
 
     mmu030_atc_handle_history_bit(i);
     
+    if (mmu030.atc[i].logical.valid) {
+        mmu030_tlb_flush_page(mmu030.atc[i].logical.addr);
+    }
+    mmu030_tlb_flush_page(addr);
+
     /* Create ATC entry */
     mmu030.atc[i].logical.addr = addr & mmu030.translation.page.imask; /* delete page index bits */
     mmu030.atc[i].logical.fc = fc;
@@ -1870,6 +1973,7 @@ int mmu030_logical_is_in_atc(uaecptr addr, uae_u32 fc, bool write) {
 					return index;
 				} else {
 					mmu030.atc[index].logical.valid = false;
+					mmu030_tlb_flush_page(maddr);
 				}
 		}
 		index++;
@@ -1907,6 +2011,15 @@ void mmu030_atc_handle_history_bit(int entry_num) {
  */
 
 void mmu030_put_long(uaecptr addr, uae_u32 val, uae_u32 fc) {
+    uaecptr phys = mmu030_tlb_lookup(addr, fc, true);
+    if (phys != MMU030_TLB_INVALID) {
+        uae_u8 *p = mmu030_tlb_host_write(phys);
+        if (p)
+            do_put_mem_long(p, val);
+        else
+            phys_put_long(phys, val);
+        return;
+    }
     
 	//                                        addr,super,write
 	if ((!mmu030.enabled) || (mmu030_match_ttr_access(addr,fc,true)) || (fc==7)) {
@@ -1917,6 +2030,7 @@ void mmu030_put_long(uaecptr addr, uae_u32 val, uae_u32 fc) {
     int atc_line_num = mmu030_logical_is_in_atc(addr, fc, true);
 
     if (atc_line_num>=0) {
+        mmu030_tlb_add(addr, fc, atc_line_num);
         mmu030_put_long_atc(addr, val, atc_line_num, fc);
     } else {
         mmu030_table_search(addr,fc,true,0);
@@ -1925,6 +2039,15 @@ void mmu030_put_long(uaecptr addr, uae_u32 val, uae_u32 fc) {
 }
 
 void mmu030_put_word(uaecptr addr, uae_u16 val, uae_u32 fc) {
+    uaecptr phys = mmu030_tlb_lookup(addr, fc, true);
+    if (phys != MMU030_TLB_INVALID) {
+        uae_u8 *p = mmu030_tlb_host_write(phys);
+        if (p)
+            do_put_mem_word(p, val);
+        else
+            phys_put_word(phys, val);
+        return;
+    }
     
 	//                                        addr,super,write
 	if ((!mmu030.enabled) || (mmu030_match_ttr_access(addr,fc,true)) || (fc==7)) {
@@ -1935,6 +2058,7 @@ void mmu030_put_word(uaecptr addr, uae_u16 val, uae_u32 fc) {
     int atc_line_num = mmu030_logical_is_in_atc(addr, fc, true);
     
     if (atc_line_num>=0) {
+        mmu030_tlb_add(addr, fc, atc_line_num);
         mmu030_put_word_atc(addr, val, atc_line_num, fc);
     } else {
         mmu030_table_search(addr, fc, true, 0);
@@ -1943,6 +2067,15 @@ void mmu030_put_word(uaecptr addr, uae_u16 val, uae_u32 fc) {
 }
 
 void mmu030_put_byte(uaecptr addr, uae_u8 val, uae_u32 fc) {
+    uaecptr phys = mmu030_tlb_lookup(addr, fc, true);
+    if (phys != MMU030_TLB_INVALID) {
+        uae_u8 *p = mmu030_tlb_host_write(phys);
+        if (p)
+            *p = val;
+        else
+            phys_put_byte(phys, val);
+        return;
+    }
     
 	//                                        addr,super,write
 	if ((!mmu030.enabled) || (mmu030_match_ttr_access(addr, fc, true)) || (fc==7)) {
@@ -1953,6 +2086,7 @@ void mmu030_put_byte(uaecptr addr, uae_u8 val, uae_u32 fc) {
     int atc_line_num = mmu030_logical_is_in_atc(addr, fc, true);
 
     if (atc_line_num>=0) {
+        mmu030_tlb_add(addr, fc, atc_line_num);
         mmu030_put_byte_atc(addr, val, atc_line_num, fc);
     } else {
         mmu030_table_search(addr, fc, true, 0);
@@ -1961,6 +2095,13 @@ void mmu030_put_byte(uaecptr addr, uae_u8 val, uae_u32 fc) {
 }
 
 uae_u32 mmu030_get_ilong(uaecptr addr, uae_u32 fc) {
+    uaecptr phys = mmu030_tlb_lookup(addr, fc, false);
+    if (phys != MMU030_TLB_INVALID) {
+        uae_u8 *p = mmu030_tlb_direct_i ? mmu030_tlb_host_read(phys) : NULL;
+        if (p)
+            return do_get_mem_long(p);
+        return x_phys_get_ilong(phys);
+    }
 
 	//                                        addr,super,write
 	if ((!mmu030.enabled) || (mmu030_match_ttr_access(addr, fc, false)) || (fc == 7)) {
@@ -1970,6 +2111,7 @@ uae_u32 mmu030_get_ilong(uaecptr addr, uae_u32 fc) {
 	int atc_line_num = mmu030_logical_is_in_atc(addr, fc, false);
 
 	if (atc_line_num >= 0) {
+		mmu030_tlb_add(addr, fc, atc_line_num);
 		return mmu030_get_ilong_atc(addr, atc_line_num, fc);
 	}
 	else {
@@ -1978,6 +2120,13 @@ uae_u32 mmu030_get_ilong(uaecptr addr, uae_u32 fc) {
 	}
 }
 uae_u32 mmu030_get_long(uaecptr addr, uae_u32 fc) {
+    uaecptr phys = mmu030_tlb_lookup(addr, fc, false);
+    if (phys != MMU030_TLB_INVALID) {
+        uae_u8 *p = mmu030_tlb_host_read(phys);
+        if (p)
+            return do_get_mem_long(p);
+        return phys_get_long(phys);
+    }
     
 	//                                        addr,super,write
 	if ((!mmu030.enabled) || (mmu030_match_ttr_access(addr,fc,false)) || (fc==7)) {
@@ -1987,6 +2136,7 @@ uae_u32 mmu030_get_long(uaecptr addr, uae_u32 fc) {
     int atc_line_num = mmu030_logical_is_in_atc(addr, fc, false);
 
     if (atc_line_num>=0) {
+        mmu030_tlb_add(addr, fc, atc_line_num);
         return mmu030_get_long_atc(addr, atc_line_num, fc);
     } else {
         mmu030_table_search(addr, fc, false, 0);
@@ -1995,6 +2145,13 @@ uae_u32 mmu030_get_long(uaecptr addr, uae_u32 fc) {
 }
 
 uae_u16 mmu030_get_iword(uaecptr addr, uae_u32 fc) {
+    uaecptr phys = mmu030_tlb_lookup(addr, fc, false);
+    if (phys != MMU030_TLB_INVALID) {
+        uae_u8 *p = mmu030_tlb_direct_i ? mmu030_tlb_host_read(phys) : NULL;
+        if (p)
+            return do_get_mem_word(p);
+        return x_phys_get_iword(phys);
+    }
 
 	//                                        addr,super,write
 	if ((!mmu030.enabled) || (mmu030_match_ttr_access(addr, fc, false)) || (fc == 7)) {
@@ -2004,6 +2161,7 @@ uae_u16 mmu030_get_iword(uaecptr addr, uae_u32 fc) {
 	int atc_line_num = mmu030_logical_is_in_atc(addr, fc, false);
 
 	if (atc_line_num >= 0) {
+		mmu030_tlb_add(addr, fc, atc_line_num);
 		return mmu030_get_iword_atc(addr, atc_line_num, fc);
 	} else {
 		mmu030_table_search(addr, fc, false, 0);
@@ -2011,6 +2169,13 @@ uae_u16 mmu030_get_iword(uaecptr addr, uae_u32 fc) {
 	}
 }
 uae_u16 mmu030_get_word(uaecptr addr, uae_u32 fc) {
+    uaecptr phys = mmu030_tlb_lookup(addr, fc, false);
+    if (phys != MMU030_TLB_INVALID) {
+        uae_u8 *p = mmu030_tlb_host_read(phys);
+        if (p)
+            return do_get_mem_word(p);
+        return phys_get_word(phys);
+    }
     
 	//                                        addr,super,write
 	if ((!mmu030.enabled) || (mmu030_match_ttr_access(addr,fc,false)) || (fc==7)) {
@@ -2020,6 +2185,7 @@ uae_u16 mmu030_get_word(uaecptr addr, uae_u32 fc) {
     int atc_line_num = mmu030_logical_is_in_atc(addr, fc, false);
 
     if (atc_line_num>=0) {
+        mmu030_tlb_add(addr, fc, atc_line_num);
         return mmu030_get_word_atc(addr, atc_line_num, fc);
     } else {
         mmu030_table_search(addr, fc, false, 0);
@@ -2028,6 +2194,13 @@ uae_u16 mmu030_get_word(uaecptr addr, uae_u32 fc) {
 }
 
 uae_u8 mmu030_get_byte(uaecptr addr, uae_u32 fc) {
+    uaecptr phys = mmu030_tlb_lookup(addr, fc, false);
+    if (phys != MMU030_TLB_INVALID) {
+        uae_u8 *p = mmu030_tlb_host_read(phys);
+        if (p)
+            return *p;
+        return phys_get_byte(phys);
+    }
     
 	//                                        addr,super,write
 	if ((!mmu030.enabled) || (mmu030_match_ttr_access(addr,fc,false)) || (fc==7)) {
@@ -2037,6 +2210,7 @@ uae_u8 mmu030_get_byte(uaecptr addr, uae_u32 fc) {
     int atc_line_num = mmu030_logical_is_in_atc(addr, fc, false);
 
     if (atc_line_num>=0) {
+        mmu030_tlb_add(addr, fc, atc_line_num);
         return mmu030_get_byte_atc(addr, atc_line_num, fc);
     } else {
         mmu030_table_search(addr, fc, false, 0);
@@ -2344,6 +2518,9 @@ void mmu030_set_funcs(void)
 {
 	if (currprefs.mmu_model != 68030)
 		return;
+	mmu030_tlb_flush_all();
+	/* RAM can be read directly for instructions only without cache emulation */
+	mmu030_tlb_direct_i = !currprefs.cpu_cycle_exact && !currprefs.cpu_compatible;
 	if (currprefs.cpu_cycle_exact || currprefs.cpu_compatible) {
 		x_phys_get_iword = get_word_icache030;
 		x_phys_get_ilong = get_long_icache030;
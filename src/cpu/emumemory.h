@@ -441,6 +441,23 @@ extern uae_u8 *baseaddr[MEMORY_BANKS];
 #define get_mem_bank(addr) (*mem_banks[bankindex(addr)])
 extern addrbank *get_mem_bank_real(uaecptr);
 
+#ifdef WINUAE_FOR_HATARI
+/* Host pointers to the plain RAM/ROM banks, so that get_xxx()/put_xxx() can
+ * access them directly without calling the bank functions. NULL for IO,
+ * bus error and other special banks, which still use the bank functions. */
+extern uae_u8 *mem_direct_read[MEMORY_BANKS];
+extern uae_u8 *mem_direct_write[MEMORY_BANKS];
+extern void memory_set_direct_access(bool enable);
+extern bool memory_is_plain_read(uaecptr addr);
+
+#define direct_read_ptr(addr) mem_direct_read[bankindex(addr)]
+#define direct_write_ptr(addr) mem_direct_write[bankindex(addr)]
+
+/* Direct writes bypass the STmem/SysMem bank functions, so they must update
+ * the ST RAM write stamps themselves (for the video line capture) */
+#include "stMemory.h"
+#endif
+
 #ifdef JIT
 #define put_mem_bank(addr, b, realstart) do { \
 	(mem_banks[bankindex(addr)] = (b)); \
@@ -483,6 +500,43 @@ extern void free_fastmemory (int);
 #define wordput(addr,w) (call_mem_put_func(get_mem_bank(addr).wput, addr, w))
 #define byteput(addr,b) (call_mem_put_func(get_mem_bank(addr).bput, addr, b))
 
+#ifdef WINUAE_FOR_HATARI
+STATIC_INLINE uae_u32 get_long (uaecptr addr)
+{
+	uae_u8 *p = direct_read_ptr(addr);
+	if (p)
+		return do_get_mem_long(p + (addr & 0xffff));
+	return longget (addr);
+}
+STATIC_INLINE uae_u32 get_word (uaecptr addr)
+{
+	uae_u8 *p = direct_read_ptr(addr);
+	if (p)
+		return do_get_mem_word(p + (addr & 0xffff));
+	return wordget (addr);
+}
+STATIC_INLINE uae_u32 get_byte (uaecptr addr)
+{
+	uae_u8 *p = direct_read_ptr(addr);
+	if (p)
+		return p[addr & 0xffff];
+	return byteget (addr);
+}
+STATIC_INLINE uae_u32 get_longi(uaecptr addr)
+{
+	uae_u8 *p = direct_read_ptr(addr);
+	if (p)
+		return do_get_mem_long(p + (addr & 0xffff));
+	return longgeti (addr);
+}
+STATIC_INLINE uae_u32 get_wordi(uaecptr addr)
+{
+	uae_u8 *p = direct_read_ptr(addr);
+	if (p)
+		return do_get_mem_word(p + (addr & 0xffff));
+	return wordgeti (addr);
+}
+#else
 STATIC_INLINE uae_u32 get_long (uaecptr addr)
 {
 	return longget (addr);
@@ -503,6 +557,7 @@ STATIC_INLINE uae_u32 get_wordi(uaecptr addr)
 {
 	return wordgeti (addr);
 }
+#endif
 
 STATIC_INLINE uae_u32 get_long_jit(uaecptr addr)
 {
@@ -575,6 +630,35 @@ STATIC_INLINE void *get_pointer (uaecptr addr)
 # endif
 #endif
 
+#ifdef WINUAE_FOR_HATARI
+STATIC_INLINE void put_long (uaecptr addr, uae_u32 l)
+{
+	uae_u8 *p = direct_write_ptr(addr);
+	if (p) {
+		do_put_mem_long(p + (addr & 0xffff), l);
+		STMemory_MarkWritten(addr);
+	} else
+		longput(addr, l);
+}
+STATIC_INLINE void put_word (uaecptr addr, uae_u32 w)
+{
+	uae_u8 *p = direct_write_ptr(addr);
+	if (p) {
+		do_put_mem_word(p + (addr & 0xffff), w);
+		STMemory_MarkWritten(addr);
+	} else
+		wordput(addr, w);
+}
+STATIC_INLINE void put_byte (uaecptr addr, uae_u32 b)
+{
+	uae_u8 *p = direct_write_ptr(addr);
+	if (p) {
+		p[addr & 0xffff] = b;
+		STMemory_MarkWritten(addr);
+	} else
+		byteput(addr, b);
+}
+#else
 STATIC_INLINE void put_long (uaecptr addr, uae_u32 l)
 {
 	longput(addr, l);
@@ -587,6 +671,7 @@ STATIC_INLINE void put_byte (uaecptr addr, uae_u32 b)
 {
 	byteput(addr, b);
 }
+#endif
 
 STATIC_INLINE void put_long_jit(uaecptr addr, uae_u32 l)
 {
@@ -0,0 +1,69 @@
+ /*
+  * UAE - The Un*x Amiga Emulator
+  *
+  * MC68881 emulation
+  *
+  * Host math functions used for the FPU operations, depending on fptype.
+  * This only depends on USE_LONG_DOUBLE and <math.h>, so that it can
+  * also be used by tests/fpu/fputest.c to compare both variants.
+  */
+
+#ifndef UAE_FPP_MATH_H
+#define UAE_FPP_MATH_H
+
+#include <math.h>
+
+/* Math functions matching fptype, so that the host long double
+ * extended precision is also kept in the transcendental functions */
+#if USE_LONG_DOUBLE
+#define fp_floor	floorl
+#define fp_ceil		ceill
+#define fp_sqrt		sqrtl
+#define fp_sin		sinl
+#define fp_cos		cosl
+#define fp_tan		tanl
+#define fp_asin		asinl
+#define fp_acos		acosl
+#define fp_atan		atanl
+#define fp_sinh		sinhl
+#define fp_cosh		coshl
+#define fp_tanh		tanhl
+#define fp_atanh	atanhl
+#define fp_exp		expl
+#define fp_expm1	expm1l
+#define fp_pow		powl
+#define fp_log		logl
+#define fp_log1p	log1pl
+#define fp_log10	log10l
+#define fp_frexp	frexpl
+#define fp_ldexp	ldexpl
+#else
+#define fp_floor	floor
+#define fp_ceil		ceil
+#define fp_sqrt		sqrt
+#define fp_sin		sin
+#define fp_cos		cos
+#define fp_tan		tan
+#define fp_asin		asin
+#define fp_acos		acos
+#define fp_atan		atan
+#define fp_sinh		sinh
+#define fp_cosh		cosh
+#define fp_tanh		tanh
+#define fp_atanh	atanh
+#define fp_exp		exp
+#define fp_expm1	expm1
+#define fp_pow		pow
+#define fp_log		log
+#define fp_log1p	log1p
+#define fp_log10	log10
+#define fp_frexp	frexp
+#define fp_ldexp	ldexp
+#endif
+
+#define fp_round_to_minus_infinity(x) fp_floor(x)
+#define fp_round_to_plus_infinity(x) fp_ceil(x)
+#define fp_round_to_zero(x)	((x) >= 0.0 ? fp_floor(x) : fp_ceil(x))
+#define fp_round_to_nearest(x) ((x) >= 0.0 ? (int)((x) + 0.5) : (int)((x) - 0.5))
+
+#endif /* UAE_FPP_MATH_H */
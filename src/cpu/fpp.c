@@ -33,6 +33,7 @@
 #include "events.h"
 #include "newcpu.h"
 #include "md-fpp.h"
+#include "fpp-math.h"
 #include "savestate.h"
 #include "cpu_prefetch.h"
 #include "cpummu.h"
@@ -51,7 +52,7 @@ STATIC_INLINE int isinrom (void)
 	return (munge24 (m68k_getpc ()) & 0xFFF80000) == 0xF80000 && !currprefs.mmu_model;
 }
 
-#ifdef WITH_SOFTFLOAT
+#if defined(WITH_SOFTFLOAT) || USE_LONG_DOUBLE
 static uae_u32 xhex_pi[]    ={0x2168c235, 0xc90fdaa2, 0x4000};
 uae_u32 xhex_exp_1[] ={0xa2bb4a9a, 0xadf85458, 0x4000};
 static uae_u32 xhex_l2_e[]  ={0x5c17f0bc, 0xb8aa3b29, 0x3fff};
@@ -626,6 +627,25 @@ static inline void set_fpucw_x87(uae_u32 m68k_cw)
 }
 
 #endif /* defined(CPU_i386) || defined(CPU_x86_64) */
+
+#elif USE_LONG_DOUBLE && defined(__GNUC__) && defined(__x86_64__)
+/* On x86-64 only long double uses the x87 FPU (double and float use SSE),
+ * so the FPCR rounding mode and precision can be set directly in the x87
+ * control word without changing the results of the rest of the emulator. */
+#define HAVE_set_fpucw_x87
+
+static inline void set_fpucw_x87(uae_u32 m68k_cw)
+{
+	static const uae_u16 x87_cw_tab[] = {
+		0x137f, 0x1f7f, 0x177f, 0x1b7f,	/* Extended */
+		0x107f, 0x1c7f, 0x147f, 0x187f,	/* Single */
+		0x127f, 0x1e7f, 0x167f, 0x1a7f,	/* Double */
+		0x137f, 0x1f7f, 0x177f, 0x1b7f	/* undefined */
+	};
+	uae_u16 x87_cw = x87_cw_tab[(m68k_cw >> 4) & 0xf];
+
+	__asm__ __volatile__("fldcw %0" : : "m" (x87_cw));
+}
 #endif /* ! WINUAE_FOR_HATARI */
 
 static void native_set_fpucw(uae_u32 m68k_cw)
@@ -639,6 +659,8 @@ static void native_set_fpucw(uae_u32 m68k_cw)
 #if defined(CPU_i386) || defined(CPU_x86_64)
 	set_fpucw_x87(m68k_cw);
 #endif
+#elif defined(HAVE_set_fpucw_x87)
+	set_fpucw_x87(m68k_cw);
 #endif /* ! WINUAE_FOR_HATARI */
 }
 
@@ -997,11 +1019,6 @@ static void fpu_null (void)
 		fpnan (&regs.fp[i]);
 }
 
-#define fp_round_to_minus_infinity(x) floor(x)
-#define fp_round_to_plus_infinity(x) ceil(x)
-#define fp_round_to_zero(x)	((x) >= 0.0 ? floor(x) : ceil(x))
-#define fp_round_to_nearest(x) ((x) >= 0.0 ? (int)((x) + 0.5) : (int)((x) - 0.5))
-
 static tointtype toint(fpdata *src, int size)
 {
 #ifdef WITH_SOFTFLOAT
@@ -2550,7 +2567,7 @@ static bool arithmetic_fp(fptype src, int reg, int extra)
 #endif /* X86_MSVC */
 			break;
 		case 0x02: /* FSINH */
-			regs.fp[reg].fp = sinh (src);
+			regs.fp[reg].fp = fp_sinh (src);
 			break;
 		case 0x03: /* FINTRZ */
 			regs.fp[reg].fp = fp_round_to_zero (src);
@@ -2558,49 +2575,49 @@ static bool arithmetic_fp(fptype src, int reg, int extra)
 		case 0x04: /* FSQRT */
 		case 0x41: /* FSSQRT */
 		case 0x45: /* FDSQRT */
-			regs.fp[reg].fp = sqrt (src);
+			regs.fp[reg].fp = fp_sqrt (src);
 			break;
 		case 0x06: /* FLOGNP1 */
-			regs.fp[reg].fp = log (src + 1.0);
+			regs.fp[reg].fp = fp_log1p (src);
 			break;
 		case 0x08: /* FETOXM1 */
-			regs.fp[reg].fp = exp (src) - 1.0;
+			regs.fp[reg].fp = fp_expm1 (src);
 			break;
 		case 0x09: /* FTANH */
-			regs.fp[reg].fp = tanh (src);
+			regs.fp[reg].fp = fp_tanh (src);
 			break;
 		case 0x0a: /* FATAN */
-			regs.fp[reg].fp = atan (src);
+			regs.fp[reg].fp = fp_atan (src);
 			break;
 		case 0x0c: /* FASIN */
-			regs.fp[reg].fp = asin (src);
+			regs.fp[reg].fp = fp_asin (src);
 			break;
 		case 0x0d: /* FATANH */
-			regs.fp[reg].fp = atanh (src);
+			regs.fp[reg].fp = fp_atanh (src);
 			break;
 		case 0x0e: /* FSIN */
-			regs.fp[reg].fp = sin (src);
+			regs.fp[reg].fp = fp_sin (src);
 			break;
 		case 0x0f: /* FTAN */
-			regs.fp[reg].fp = tan (src);
+			regs.fp[reg].fp = fp_tan (src);
 			break;
 		case 0x10: /* FETOX */
-			regs.fp[reg].fp = exp (src);
+			regs.fp[reg].fp = fp_exp (src);
 			break;
 		case 0x11: /* FTWOTOX */
-			regs.fp[reg].fp = pow (2.0, src);
+			regs.fp[reg].fp = fp_pow (2.0, src);
 			break;
 		case 0x12: /* FTENTOX */
-			regs.fp[reg].fp = pow (10.0, src);
+			regs.fp[reg].fp = fp_pow (10.0, src);
 			break;
 		case 0x14: /* FLOGN */
-			regs.fp[reg].fp = log (src);
+			regs.fp[reg].fp = fp_log (src);
 			break;
 		case 0x15: /* FLOG10 */
-			regs.fp[reg].fp = log10 (src);
+			regs.fp[reg].fp = fp_log10 (src);
 			break;
 		case 0x16: /* FLOG2 */
-			regs.fp[reg].fp = *fp_l2_e * log (src);
+			regs.fp[reg].fp = *fp_l2_e * fp_log (src);
 			break;
 		case 0x18: /* FABS */
 		case 0x58: /* FSABS */
@@ -2608,7 +2625,7 @@ static bool arithmetic_fp(fptype src, int reg, int extra)
 			regs.fp[reg].fp = src < 0 ? -src : src;
 			break;
 		case 0x19: /* FCOSH */
-			regs.fp[reg].fp = cosh (src);
+			regs.fp[reg].fp = fp_cosh (src);
 			break;
 		case 0x1a: /* FNEG */
 		case 0x5a: /* FSNEG */
@@ -2616,10 +2633,10 @@ static bool arithmetic_fp(fptype src, int reg, int extra)
 			regs.fp[reg].fp = -src;
 			break;
 		case 0x1c: /* FACOS */
-			regs.fp[reg].fp = acos (src);
+			regs.fp[reg].fp = fp_acos (src);
 			break;
 		case 0x1d: /* FCOS */
-			regs.fp[reg].fp = cos (src);
+			regs.fp[reg].fp = fp_cos (src);
 			break;
 		case 0x1e: /* FGETEXP */
 			{
@@ -2627,8 +2644,8 @@ static bool arithmetic_fp(fptype src, int reg, int extra)
 					regs.fp[reg].fp = 0;
 				} else {
 					int expon;
-					frexp (src, &expon);
-					regs.fp[reg].fp = (double) (expon - 1);
+					fp_frexp (src, &expon);
+					regs.fp[reg].fp = (fptype) (expon - 1);
 				}
 			}
 			break;
@@ -2638,7 +2655,7 @@ static bool arithmetic_fp(fptype src, int reg, int extra)
 					regs.fp[reg].fp = 0;
 				} else {
 					int expon;
-					regs.fp[reg].fp = frexp (src, &expon) * 2.0;
+					regs.fp[reg].fp = fp_frexp (src, &expon) * 2.0;
 				}
 			}
 			break;
@@ -2675,11 +2692,7 @@ static bool arithmetic_fp(fptype src, int reg, int extra)
 			break;
 		case 0x26: /* FSCALE */
 			if (src != 0) {
-#ifdef ldexp
-				regs.fp[reg] = ldexp (regs.fp[reg], (int) src);
-#else
-				regs.fp[reg].fp *= exp (*fp_ln_2 * (int) src);
-#endif
+				regs.fp[reg].fp = fp_ldexp (regs.fp[reg].fp, (int) src);
 			}
 			break;
 		case 0x27: /* FSGLMUL */
@@ -2699,8 +2712,8 @@ static bool arithmetic_fp(fptype src, int reg, int extra)
 		case 0x35:
 		case 0x36:
 		case 0x37:
-			regs.fp[extra & 7].fp = cos (src);
-			regs.fp[reg].fp = sin (src);
+			regs.fp[extra & 7].fp = fp_cos (src);
+			regs.fp[reg].fp = fp_sin (src);
 			break;
 		case 0x38: /* FCMP */
 			{
@@ -114,6 +114,13 @@ static bool last_address_space_24;
 
 addrbank *mem_banks[MEMORY_BANKS];
 
+/* Host pointers for the start of each bank of plain RAM/ROM, see get_long() & co */
+uae_u8 *mem_direct_read[MEMORY_BANKS];
+uae_u8 *mem_direct_write[MEMORY_BANKS];
+static bool mem_direct_enabled = true;
+
+static void memory_update_direct (void);
+
 /* This has two functions. It either holds a host address that, when added
 to the 68k address, gives the host address corresponding to that 68k
 address (in which case the value in this array is even), OR it holds the
@@ -582,6 +589,7 @@ static void REGPARAM3 STmem_lput(uaecptr addr, uae_u32 l)
 {
     addr -= STmem_start & STmem_mask;
     addr &= STmem_mask;
+    STMemory_MarkWritten(addr);
     do_put_mem_long(STmemory + addr, l);
 }
 
@@ -589,6 +597,7 @@ static void REGPARAM3 STmem_wput(uaecptr addr, uae_u32 w)
 {
     addr -= STmem_start & STmem_mask;
     addr &= STmem_mask;
+    STMemory_MarkWritten(addr);
     do_put_mem_word(STmemory + addr, w);
 }
 
@@ -596,6 +605,7 @@ static void REGPARAM3 STmem_bput(uaecptr addr, uae_u32 b)
 {
     addr -= STmem_start & STmem_mask;
     addr &= STmem_mask;
+    STMemory_MarkWritten(addr);
     STmemory[addr] = b;
 }
 
@@ -675,6 +685,7 @@ static void REGPARAM3 SysMem_lput(uaecptr addr, uae_u32 l)
       return;
     }
 
+    STMemory_MarkWritten(addr);
     do_put_mem_long(STmemory + addr, l);
 }
 
@@ -696,6 +707,7 @@ static void REGPARAM3 SysMem_wput(uaecptr addr, uae_u32 w)
 	return;
     }
 
+    STMemory_MarkWritten(addr);
     do_put_mem_word(STmemory + addr, w);
 }
 
@@ -710,6 +722,7 @@ static void REGPARAM3 SysMem_bput(uaecptr addr, uae_u32 b)
       return;
     }
 
+    STMemory_MarkWritten(addr);
     STmemory[addr] = b;
 }
 
@@ -1444,15 +1457,82 @@ void memory_init(uae_u32 nNewSTMemSize, uae_u32 nNewTTMemSize, uae_u32 nNewRomMe
 	}
     }
 
+    memory_update_direct();
+
     illegal_count = 50;
 }
 
 
+/*
+ * Fill the direct access tables from the current memory banks. Only ST RAM,
+ * TT RAM and ROM (for reading) are accessed directly, other banks like the
+ * system RAM (supervisor check), IO, void or bus error regions must always
+ * use their bank functions.
+ */
+static void memory_update_direct (void)
+{
+    addrbank *ab;
+    uaecptr bankaddr;
+    int i;
+
+    for (i = 0; i < MEMORY_BANKS; i++)
+    {
+	mem_direct_read[i] = NULL;
+	mem_direct_write[i] = NULL;
+
+	ab = mem_banks[i];
+	if (!mem_direct_enabled || !ab || !ab->baseaddr)
+	    continue;
+
+	if (ab == &STmem_bank || ab == &TTmem_bank || ab == &ROMmem_bank)
+	{
+	    /* Same address translation as in STmem_lget() & co */
+	    bankaddr = (uaecptr)i << 16;
+	    bankaddr -= ab->start & ab->mask;
+	    bankaddr &= ab->mask;
+	    mem_direct_read[i] = ab->baseaddr + bankaddr;
+	    if (ab != &ROMmem_bank)
+		mem_direct_write[i] = ab->baseaddr + bankaddr;
+	}
+    }
+}
+
+
+/*
+ * Enable or disable direct RAM/ROM accesses, depending on the CPU mode
+ */
+void memory_set_direct_access (bool enable)
+{
+    mem_direct_enabled = enable;
+    memory_update_direct();
+}
+
+
+/*
+ * Return true if reading at given address only returns the content of
+ * ST/TT RAM or ROM, without side effect or bus error in the current CPU
+ * mode (for the idle loop detection in newcpu.c)
+ */
+bool memory_is_plain_read (uaecptr addr)
+{
+    addrbank *ab = &get_mem_bank(addr);
+
+    if (ab == &SysMem_bank)
+	return regs.s || ((addr - (STmem_start & STmem_mask)) & STmem_mask) >= 0x800;
+
+    return ab == &STmem_bank || ab == &TTmem_bank || ab == &ROMmem_bank;
+}
+
+
 /*
  * Uninitialize the memory banks.
  */
 void memory_uninit (void)
 {
+    /* Memory is about to be freed, don't access it directly anymore */
+    memset(mem_direct_read, 0, sizeof(mem_direct_read));
+    memset(mem_direct_write, 0, sizeof(mem_direct_write));
+
     /* Here, we free allocated memory from memory_init */
     if (TTmemory) {
 	free(TTmemory);
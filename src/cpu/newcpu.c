@@ -55,26 +55,8 @@
 #include "debugui.h"
 #include "debugcpu.h"
 #include "stMemory.h"
-
-#if defined(__LIBRETRO__) && !defined(HAVE_LIBCO) 	/* RETRO HACK */
-
-extern int CPULOOP;
-
-#define RETRO_BREAK_LOOP  if(CPULOOP==0)return
-#define RETRO_STATIC static
-#undef TRY
-#undef CATCH
-#undef ENDTRY
-#define TRY(a) 
-#define CATCH(b) if(0)
-#define ENDTRY 
-#define prb 0
-#else
-
-#define RETRO_BREAK_LOOP 
-#define RETRO_STATIC
-
-#endif /* RETRO HACK */
+#include "memorySnapShot.h"
+#include "configuration.h"
 
 
 #ifdef JIT
@@ -1200,6 +1182,11 @@ static void set_x_funcs (void)
 	mmu_set_funcs();
 	mmu030_set_funcs();
 
+#ifdef WINUAE_FOR_HATARI
+	/* RAM/ROM can be accessed without the bank functions, except in cycle
+	 * exact modes where all accesses keep going through the memory banks */
+	memory_set_direct_access(!currprefs.cpu_cycle_exact && !currprefs.cpu_memory_cycle_exact);
+#endif
 }
 
 bool can_cpu_tracer (void)
@@ -1883,7 +1870,7 @@ static uaecptr ShowEA (void *f, uaecptr pc, uae_u16 opcode, int reg, amodes mode
 			{
 				fpdata fp;
 				to_single(&fp, get_ilong_debug(pc));
-				_stprintf(buffer, _T("#%e"), fp.fp);
+				_stprintf(buffer, _T("#%e"), (double)fp.fp);
 				pc += 4;
 			}
 			break;
@@ -1891,7 +1878,7 @@ static uaecptr ShowEA (void *f, uaecptr pc, uae_u16 opcode, int reg, amodes mode
 			{
 				fpdata fp;
 				to_double(&fp, get_ilong_debug(pc), get_ilong_debug(pc + 4));
-				_stprintf(buffer, _T("#%e"), fp.fp);
+				_stprintf(buffer, _T("#%e"), (double)fp.fp);
 				pc += 8;
 			}
 			break;
@@ -2461,6 +2448,8 @@ static int iack_cycle(int nr)
 			CALL_VAR(PendingInterruptFunction);
 		if ( MFP_UpdateNeeded == true )
 			MFP_UpdateIRQ ( 0 );					/* update MFP's state if some internal timers related to MFP expired */
+		if ( nr == 26 )
+			Video_LineBatch_Stop ();				/* next HBL pending bit must be set on the next line */
 		pendingInterrupts &= ~( 1 << ( nr - 24 ) );			/* clear HBL or VBL pending bit (even if an MFP timer occurred during IACK) */
 		CPU_IACK = false;
 	}
@@ -3249,13 +3238,20 @@ static void ExceptionX (int nr, uaecptr address)
 	/* Handle Hatari GEM and BIOS traps */
 	if (nr == 0x22) {
 		/* Intercept VDI & AES exceptions (Trap #2) */
-		if (bVdiAesIntercept && VDI_AES_Entry()) {
+		int vdi = bVdiAesIntercept ? VDI_AES_Entry() : VDI_TRAP_TOS;
+		if (vdi == VDI_TRAP_COMPLETE) {
 			/* Set 'PC' to address of 'VDI_OPCODE' illegal instruction.
 			 * This will call OpCode_VDI() after completion of Trap call!
 			 * Used to modify specific VDI return vectors contents. */
 			VDI_OldPC = m68k_getpc();
 			m68k_setpc(CART_VDI_OPCODE_ADDR);
 		}
+		else if (vdi == VDI_TRAP_DONE) {
+			/* Call was already handled, skip TOS */
+			fill_prefetch ();
+			regs.exception = 0;
+			return;
+		}
 	}
 	else if (nr == 0x2d) {
 		/* Intercept BIOS (Trap #13) calls */
@@ -4227,6 +4223,30 @@ static bool do_specialties_interrupt (int Pending)
 }
 #endif
 
+#ifdef WINUAE_FOR_HATARI
+/*
+ * When the CPU is stopped and nothing can happen before the next interrupt
+ * event, do all the 4 cycle steps of the STOP loop before this event at
+ * once. The event is then processed during the same step as without
+ * skipping, so the interrupt latency is unchanged.
+ */
+static void m68k_stop_skip(void)
+{
+	int step = INT_CONVERT_TO_INTERNAL ( 4 , INT_CPU_CYCLE );
+	int n;
+
+	if ( ( PendingInterruptCount <= step ) || !PendingInterruptFunction )
+		return;
+
+	n = ( PendingInterruptCount - 1 ) / step;
+	M68000_AddCycles ( n * 4 );
+
+	/* In CE mode without MMU, currcycle is flushed after each step */
+	if ( !currprefs.cpu_cycle_exact || currprefs.mmu_model )
+		currcycle += n * ( currprefs.cpu_cycle_exact ? 2 : 4 ) * CYCLE_UNIT;
+}
+#endif
+
 static int do_specialties (int cycles)
 {
 	if (regs.spcflags & SPCFLAG_MODE_CHANGE)
@@ -4439,6 +4459,15 @@ static int do_specialties (int cycles)
 		}
 #endif
 
+#ifdef WINUAE_FOR_HATARI
+		/* Still stopped and no interrupt waiting to be processed : */
+		/* the next steps will do nothing until the next event */
+		/* (with interrupt delay, SPCFLAG_INT stays set for masked ints) */
+		if ( ( ( regs.spcflags & ( SPCFLAG_STOP | SPCFLAG_BRK | SPCFLAG_MFP | SPCFLAG_MODE_CHANGE ) ) == SPCFLAG_STOP )
+		    && ( MFP_UpdateNeeded == false )
+		    && ( m68k_interrupt_delay ? !time_for_interrupt () : !( regs.spcflags & ( SPCFLAG_INT | SPCFLAG_DOINT ) ) ) )
+			m68k_stop_skip ();
+#endif
 	}
 
 	if (regs.spcflags & SPCFLAG_TRACE)
@@ -4596,6 +4625,320 @@ static void bus_error(void)
 	} ENDTRY
 }
 
+#ifdef WINUAE_FOR_HATARI
+/*
+ * Idle loop detection.
+ *
+ * Many programs wait for an interrupt in a short loop which only reads
+ * memory, like 'tst.w $466 ; beq.s *-4'. When such a loop did two
+ * iterations taking the same number of cycles, without any interrupt
+ * event in between, all its next iterations will do exactly the same
+ * until the next event : they can be skipped by adding their cycles
+ * in one step, the next event then happens at the same instruction
+ * and cycle as without skipping.
+ *
+ * Only loops closed by a backward Bcc/BRA whose body reads ST/TT RAM or
+ * ROM and only writes the CCR or data registers (with values depending
+ * on this memory) are skipped. IO registers can return a new value
+ * without any event (video counter, timer data, ACIA status, ...).
+ *
+ * With --idle-loops check, the loops are not skipped, but the skipped
+ * iterations are executed and compared with the prediction.
+ */
+
+#define IDLE_LOOP_MAX_SIZE	32		/* max number of bytes in the loop body */
+
+static struct {
+	uaecptr		pc;			/* address of the branch closing the loop */
+	uaecptr		start;			/* branch target, start of the loop body */
+	bool		not_idle;		/* true if the loop body has side effects */
+	Uint32		updates;		/* PendingInterruptUpdates when the branch was last taken */
+	Uint64		clock;			/* CyclesGlobalClockCounter when the branch was last taken */
+	int		pending;		/* PendingInterruptCount when the branch was last taken */
+	unsigned long	currcycle;		/* currcycle when the branch was last taken */
+	Uint64		iter_clock;		/* cycles used by the last iteration */
+	int		iter_pending;
+	unsigned long	iter_currcycle;
+	int		check_count;		/* iterations still to check in check mode */
+	int		check_total;
+} IdleLoop;
+
+
+/**
+ * Check one effective address read by the loop body and skip its
+ * extension words. Return false if it could have a side effect or read
+ * something else than RAM/ROM.
+ */
+static bool m68k_idle_loop_ea(int mode, int reg, int size, uaecptr *pc, uae_u16 *index_regs)
+{
+	uaecptr addr;
+	uae_u32 idx;
+	uae_u16 ext;
+
+	switch (mode) {
+	case 0:					/* Dn */
+	case 1:					/* An */
+		return true;
+	case 2:					/* (An) */
+		addr = m68k_areg(regs, reg);
+		break;
+	case 5:					/* d16(An) */
+		addr = m68k_areg(regs, reg) + (uae_s16)get_word_debug(*pc);
+		*pc += 2;
+		break;
+	case 6:					/* d8(An,Xn) */
+		addr = m68k_areg(regs, reg);
+		break;
+	case 7:
+		switch (reg) {
+		case 0:				/* abs.w */
+			addr = (uae_s16)get_word_debug(*pc);
+			*pc += 2;
+			break;
+		case 1:				/* abs.l */
+			addr = get_long_debug(*pc);
+			*pc += 4;
+			break;
+		case 2:				/* d16(PC) */
+			addr = *pc + (uae_s16)get_word_debug(*pc);
+			*pc += 2;
+			break;
+		case 3:				/* d8(PC,Xn) */
+			addr = *pc;
+			mode = 6;
+			break;
+		case 4:				/* #imm */
+			*pc += size == 4 ? 4 : 2;
+			return true;
+		default:
+			return false;
+		}
+		break;
+	default:				/* (An)+ and -(An) change An */
+		return false;
+	}
+
+	if (mode == 6) {
+		ext = get_word_debug(*pc);
+		*pc += 2;
+		if (ext & 0x100)		/* 68020 full extension word */
+			return false;
+		*index_regs |= 1 << (ext >> 12);
+		idx = regs.regs[ext >> 12];
+		if (!(ext & 0x800))
+			idx = (uae_s32)(uae_s16)idx;
+		if (currprefs.cpu_model >= 68020)
+			idx <<= (ext >> 9) & 3;
+		addr += (uae_s32)(uae_s8)ext + idx;
+	}
+
+	if (size > 1 && (addr & 1) && currprefs.cpu_model < 68020)
+		return false;
+	return memory_is_plain_read(addr) && memory_is_plain_read(addr + size - 1);
+}
+
+
+/**
+ * Decode the loop body between start and end (the closing branch).
+ * Return true if it only reads RAM/ROM and if executing it several times
+ * in a row gives the same result as executing it once.
+ */
+static bool m68k_idle_loop_body(uaecptr pc, uaecptr end)
+{
+	uae_u16 opcode, written_regs = 0, index_regs = 0;
+	int mode, reg, size, opmode;
+	bool old_cpu = currprefs.cpu_model < 68020;
+
+	if (!memory_is_plain_read(pc) || !memory_is_plain_read(end + 1))
+		return false;
+
+	while (pc < end) {
+		opcode = get_word_debug(pc);
+		pc += 2;
+		mode = (opcode >> 3) & 7;
+		reg = opcode & 7;
+		size = 1 << ((opcode >> 6) & 3);
+
+		switch (opcode >> 12) {
+		case 0x0:
+			if (((opcode & 0xffc0) == 0x0800 || (opcode & 0xf1c0) == 0x0100) && mode != 1) {
+				/* BTST #n,<ea> / BTST Dn,<ea> */
+				if ((opcode & 0xffc0) == 0x0800) {
+					if (mode == 7 && reg == 4)
+						return false;
+					pc += 2;
+				}
+				if (!m68k_idle_loop_ea(mode, reg, mode ? 1 : 4, &pc, &index_regs))
+					return false;
+			} else if ((opcode & 0xff00) == 0x0c00 && size <= 4) {
+				/* CMPI #imm,<ea> */
+				pc += size == 4 ? 4 : 2;
+				if (mode == 1 || (mode == 7 && (reg == 4 || (old_cpu && reg >= 2))))
+					return false;
+				if (!m68k_idle_loop_ea(mode, reg, size, &pc, &index_regs))
+					return false;
+			} else if (((opcode & 0xfd38) == 0x0000) && size <= 4) {
+				/* ORI/ANDI #imm,Dn : same result when repeated */
+				pc += size == 4 ? 4 : 2;
+				written_regs |= 1 << reg;
+			} else {
+				return false;
+			}
+			break;
+
+		case 0x1:				/* MOVE <ea>,Dn from memory or #imm */
+		case 0x2:
+		case 0x3:
+			if ((opcode & 0x01c0) != 0 || mode <= 1)
+				return false;
+			size = (opcode >> 12) == 1 ? 1 : (opcode >> 12) == 3 ? 2 : 4;
+			if (!m68k_idle_loop_ea(mode, reg, size, &pc, &index_regs))
+				return false;
+			written_regs |= 1 << ((opcode >> 9) & 7);
+			break;
+
+		case 0x4:				/* TST <ea> */
+			if ((opcode & 0xff00) != 0x4a00 || size > 4 || mode == 1
+			    || (mode == 7 && old_cpu && reg >= 2))
+				return false;
+			if (!m68k_idle_loop_ea(mode, reg, size, &pc, &index_regs))
+				return false;
+			break;
+
+		case 0x6:				/* Bcc within the loop, not BSR */
+			if ((opcode & 0x0f00) == 0x0100)
+				return false;
+			if ((opcode & 0xff) == 0)
+				pc += 2;
+			else if ((opcode & 0xff) == 0xff) {
+				if (old_cpu)
+					return false;
+				pc += 4;
+			}
+			break;
+
+		case 0xb:				/* CMP <ea>,Dn / CMPA <ea>,An */
+			opmode = (opcode >> 6) & 7;
+			if (opmode >= 4 && opmode != 7)
+				return false;
+			size = opmode == 3 ? 2 : opmode == 7 ? 4 : 1 << opmode;
+			if (mode == 1 && size == 1)
+				return false;
+			if (!m68k_idle_loop_ea(mode, reg, size, &pc, &index_regs))
+				return false;
+			break;
+
+		default:
+			return false;
+		}
+	}
+
+	/* an address depending on a register written by the loop could change */
+	return pc == end && !(written_regs & index_regs);
+}
+
+
+/**
+ * Report a difference between the predicted and executed iterations
+ */
+static void m68k_idle_loop_mismatch(void)
+{
+	if (IdleLoop.check_count > 0)
+		Log_Printf(LOG_WARN, "Idle loop at $%x-$%x: iteration %d/%d doesn't match the prediction\n",
+			   IdleLoop.start, IdleLoop.pc,
+			   IdleLoop.check_total - IdleLoop.check_count + 1, IdleLoop.check_total);
+	IdleLoop.check_count = 0;
+}
+
+
+/**
+ * Remember the state when the loop's branch was taken
+ */
+static void m68k_idle_loop_mark(void)
+{
+	IdleLoop.updates = PendingInterruptUpdates;
+	IdleLoop.clock = CyclesGlobalClockCounter;
+	IdleLoop.pending = PendingInterruptCount;
+	IdleLoop.currcycle = currcycle;
+}
+
+
+/**
+ * Called after a taken Bcc/BRA when idle loops handling is enabled and
+ * no special flag is set. If the branch closes an idle loop, skip its
+ * iterations up to the next interrupt event.
+ */
+static void m68k_idle_loop(struct regstruct *r)
+{
+	uaecptr pc = r->instruction_pc;
+	uaecptr start = m68k_getpc();
+	Uint64 iter_clock;
+	int iter_pending, n;
+	unsigned long iter_currcycle;
+
+	/* only backward branches, not BSR */
+	if (start >= pc || pc - start > IDLE_LOOP_MAX_SIZE || (r->opcode & 0x0f00) == 0x0100)
+		return;
+	/* the DSP and the CPU trace would need to run for each instruction */
+	if (bDspEnabled || LOG_TRACE_LEVEL(TRACE_CPU_DISASM))
+		return;
+
+	if (pc != IdleLoop.pc || start != IdleLoop.start) {
+		m68k_idle_loop_mismatch();
+		IdleLoop.pc = pc;
+		IdleLoop.start = start;
+		IdleLoop.not_idle = false;
+		IdleLoop.iter_clock = 0;
+		m68k_idle_loop_mark();
+		return;
+	}
+	if (IdleLoop.not_idle)
+		return;
+
+	iter_clock = CyclesGlobalClockCounter - IdleLoop.clock;
+	iter_pending = IdleLoop.pending - PendingInterruptCount;
+	iter_currcycle = currcycle - IdleLoop.currcycle;
+
+	/* an event happened or the iteration was different from the previous one */
+	if (IdleLoop.updates != PendingInterruptUpdates || iter_clock != IdleLoop.iter_clock
+	    || iter_pending != IdleLoop.iter_pending || iter_currcycle != IdleLoop.iter_currcycle) {
+		m68k_idle_loop_mismatch();
+		IdleLoop.iter_clock = IdleLoop.updates == PendingInterruptUpdates ? iter_clock : 0;
+		IdleLoop.iter_pending = iter_pending;
+		IdleLoop.iter_currcycle = iter_currcycle;
+		m68k_idle_loop_mark();
+		return;
+	}
+	m68k_idle_loop_mark();
+
+	if (IdleLoop.check_count > 0) {
+		IdleLoop.check_count--;
+		return;
+	}
+
+	/* iterations before the one during which the next event happens */
+	if (iter_pending <= 0 || PendingInterruptCount <= iter_pending)
+		return;
+	n = (PendingInterruptCount - 1) / iter_pending;
+
+	if (!m68k_idle_loop_body(start, pc)) {
+		IdleLoop.not_idle = true;
+		return;
+	}
+
+	if (ConfigureParams.System.IdleLoopMode == IDLE_LOOP_MODE_CHECK) {
+		IdleLoop.check_count = IdleLoop.check_total = n;
+		return;
+	}
+
+	PendingInterruptCount -= n * iter_pending;
+	nCyclesMainCounter += n * iter_clock;
+	CyclesGlobalClockCounter += n * iter_clock;
+	currcycle += n * iter_currcycle;
+	m68k_idle_loop_mark();
+}
+#endif
+
 #ifndef CPUEMU_11
 
 static void m68k_run_1 (void)
@@ -4609,8 +4952,8 @@ do it all for performance... :(
 This version emulates 68000's prefetch "cache" */
 static void m68k_run_1 (void)
 {
-RETRO_STATIC	struct regstruct *r = &regs;
-RETRO_STATIC	bool exit = false;
+	struct regstruct *r = &regs;
+	bool exit = false;
 
 	Log_Printf(LOG_DEBUG, "m68k_run_1\n");
 
@@ -4670,6 +5013,10 @@ RETRO_STATIC	bool exit = false;
 					CALL_VAR(PendingInterruptFunction);		/* call the interrupt handler */
 				if ( MFP_UpdateNeeded == true )
 					MFP_UpdateIRQ ( 0 );
+
+				/* Check for idle loops after taken Bcc/BRA */
+				if ( ( ( r->opcode & 0xf000 ) == 0x6000 ) && ConfigureParams.System.IdleLoopMode && ( r->spcflags == 0 ) )
+					m68k_idle_loop ( r );
 #endif
 
 				if (r->spcflags) {
@@ -4679,7 +5026,6 @@ RETRO_STATIC	bool exit = false;
 				regs.ipl = regs.ipl_pin;
 				if (!currprefs.cpu_compatible || (currprefs.cpu_cycle_exact && currprefs.cpu_model <= 68010))
 					exit = true;
-RETRO_BREAK_LOOP;
 			}
 		} CATCH (prb) {
 			bus_error();
@@ -4706,9 +5052,9 @@ static void m68k_run_1_ce (void)
 
 static void m68k_run_1_ce (void)
 {
-RETRO_STATIC	struct regstruct *r = &regs;
-RETRO_STATIC	bool first = true;
-RETRO_STATIC	bool exit = false;
+	struct regstruct *r = &regs;
+	bool first = true;
+	bool exit = false;
 
 	Log_Printf(LOG_DEBUG, "m68k_run_1_ce\n");
 
@@ -4832,7 +5178,6 @@ cont:
 
 				if (!currprefs.cpu_cycle_exact || currprefs.cpu_model > 68010)
 					exit = true;
-RETRO_BREAK_LOOP;
 			}
 		} CATCH (prb) {
 			bus_error();
@@ -5236,7 +5581,6 @@ static void m68k_run_jit(void)
 				return;
 			}
 		}
-RETRO_BREAK_LOOP;
 	}
 }
 #endif /* JIT */
@@ -5306,8 +5650,8 @@ void cpu_halt (int id)
 /* MMU 68060  */
 static void m68k_run_mmu060 (void)
 {
-RETRO_STATIC	struct flag_struct f;
-RETRO_STATIC	int halt = 0;
+	struct flag_struct f;
+	int halt = 0;
 
 #ifdef WINUAE_FOR_HATARI
 	Log_Printf(LOG_DEBUG,  "m68k_run_mmu060\n");
@@ -5367,7 +5711,6 @@ RETRO_STATIC	int halt = 0;
 //					DSP_Run ( DSP_CPU_FREQ_RATIO * ( CyclesGlobalClockCounter - DSP_CyclesGlobalClockCounter ) );
 				}
 #endif
-RETRO_BREAK_LOOP;
 			}
 		} CATCH (prb) {
 
@@ -5401,8 +5744,8 @@ RETRO_BREAK_LOOP;
 /* Aranym MMU 68040  */
 static void m68k_run_mmu040 (void)
 {
-RETRO_STATIC	struct flag_struct f;
-RETRO_STATIC	int halt = 0;
+	struct flag_struct f;
+	int halt = 0;
 
 #ifdef WINUAE_FOR_HATARI
 	Log_Printf(LOG_DEBUG,  "m68k_run_mmu040\n");
@@ -5467,7 +5810,6 @@ RETRO_STATIC	int halt = 0;
 //					DSP_Run ( DSP_CPU_FREQ_RATIO * ( CyclesGlobalClockCounter - DSP_CyclesGlobalClockCounter ) );
 				}
 #endif
-RETRO_BREAK_LOOP;
 			}
 		} CATCH (prb) {
 
@@ -5500,8 +5842,8 @@ RETRO_BREAK_LOOP;
 // Previous MMU 68030
 static void m68k_run_mmu030 (void)
 {
-RETRO_STATIC	struct flag_struct f;
-RETRO_STATIC	int halt = 0;
+	struct flag_struct f;
+	int halt = 0;
 
 #ifdef WINUAE_FOR_HATARI
 	Log_Printf(LOG_DEBUG,  "m68k_run_mmu030\n");
@@ -5612,7 +5954,6 @@ insretry:
 //					DSP_Run ( DSP_CPU_FREQ_RATIO * ( CyclesGlobalClockCounter - DSP_CyclesGlobalClockCounter ) );
 				}
 #endif
-RETRO_BREAK_LOOP;
 			}
 		} CATCH (prb) {
 
@@ -5647,8 +5988,8 @@ RETRO_BREAK_LOOP;
 
 static void m68k_run_3ce (void)
 {
-RETRO_STATIC	struct regstruct *r = &regs;
-RETRO_STATIC	bool exit = false;
+	struct regstruct *r = &regs;
+	bool exit = false;
 
 	Log_Printf(LOG_DEBUG, "m68k_run_3ce\n");
 
@@ -5702,7 +6043,6 @@ RETRO_STATIC	bool exit = false;
 //					DSP_Run ( DSP_CPU_FREQ_RATIO * ( CyclesGlobalClockCounter - DSP_CyclesGlobalClockCounter ) );
 				}
 #endif
-RETRO_BREAK_LOOP;
 			}
 		} CATCH(prb) {
 			bus_error();
@@ -5718,9 +6058,9 @@ RETRO_BREAK_LOOP;
 
 static void m68k_run_3p(void)
 {
-RETRO_STATIC	struct regstruct *r = &regs;
-RETRO_STATIC	bool exit = false;
-RETRO_STATIC	int cycles;
+	struct regstruct *r = &regs;
+	bool exit = false;
+	int cycles;
 
 	Log_Printf(LOG_DEBUG, "m68k_run_3p\n");
 
@@ -5782,7 +6122,6 @@ RETRO_STATIC	int cycles;
 //					DSP_Run ( DSP_CPU_FREQ_RATIO * ( CyclesGlobalClockCounter - DSP_CyclesGlobalClockCounter ) );
 				}
 #endif
-RETRO_BREAK_LOOP;
 			}
 		} CATCH(prb) {
 			bus_error();
@@ -5799,9 +6138,9 @@ RETRO_BREAK_LOOP;
 STATIC_INLINE struct cache030 *getcache030 (struct cache030 *cp, uaecptr addr, uae_u32 *tagp, int *lwsp);
 static void m68k_run_2ce (void)
 {
-RETRO_STATIC	struct regstruct *r = &regs;
-RETRO_STATIC	bool exit = false;
-RETRO_STATIC	bool first = true;
+	struct regstruct *r = &regs;
+	bool exit = false;
+	bool first = true;
 
 	Log_Printf(LOG_DEBUG, "m68k_run_2ce\n");
 
@@ -5972,7 +6311,6 @@ cont:
 #endif
 
 				regs.ipl = regs.ipl_pin;
-RETRO_BREAK_LOOP;
 			}
 		} CATCH(prb) {
 			bus_error();
@@ -5991,9 +6329,9 @@ RETRO_BREAK_LOOP;
 // full prefetch 020 (more compatible)
 static void m68k_run_2p (void)
 {
-RETRO_STATIC	struct regstruct *r = &regs;
-RETRO_STATIC	bool exit = false;
-RETRO_STATIC	bool first = true;
+	struct regstruct *r = &regs;
+	bool exit = false;
+	bool first = true;
 
 	Log_Printf(LOG_DEBUG, "m68k_run_2p\n");
 
@@ -6124,6 +6462,10 @@ cont:
 					CALL_VAR(PendingInterruptFunction);		/* call the interrupt handler */
 				if ( MFP_UpdateNeeded == true )
 					MFP_UpdateIRQ ( 0 );
+
+				/* Check for idle loops after taken Bcc/BRA */
+				if ( ( ( r->opcode & 0xf000 ) == 0x6000 ) && ConfigureParams.System.IdleLoopMode && ( r->spcflags == 0 ) )
+					m68k_idle_loop ( r );
 #endif
 
 				if (r->spcflags) {
@@ -6142,7 +6484,6 @@ cont:
 #endif
 
 				ipl_fetch ();
-RETRO_BREAK_LOOP;
 			}
 		} CATCH(prb) {
 			bus_error();
@@ -6160,8 +6501,8 @@ RETRO_BREAK_LOOP;
 #ifdef WITH_THREADED_CPU
 static void *cpu_thread_run_2(void *v)
 {
-RETRO_STATIC	bool exit = false;
-RETRO_STATIC	struct regstruct *r = &regs;
+	bool exit = false;
+	struct regstruct *r = &regs;
 
 	cpu_thread_active = 1;
 	while (!exit) {
@@ -6178,7 +6519,6 @@ RETRO_STATIC	struct regstruct *r = &regs;
 					if (do_specialties_thread())
 						exit = true;
 				}
-RETRO_BREAK_LOOP;
 			}
 		} CATCH(prb)
 		{
@@ -6204,8 +6544,8 @@ static void m68k_run_2 (void)
 	}
 #endif
 
-RETRO_STATIC	struct regstruct *r = &regs;
-RETRO_STATIC	bool exit = false;
+	struct regstruct *r = &regs;
+	bool exit = false;
 
 	Log_Printf(LOG_DEBUG, "m68k_run_2\n");
 
@@ -6250,6 +6590,10 @@ RETRO_STATIC	bool exit = false;
 					CALL_VAR(PendingInterruptFunction);		/* call the interrupt handler */
 				if ( MFP_UpdateNeeded == true )
 					MFP_UpdateIRQ ( 0 );
+
+				/* Check for idle loops after taken Bcc/BRA */
+				if ( ( ( r->opcode & 0xf000 ) == 0x6000 ) && ConfigureParams.System.IdleLoopMode && ( r->spcflags == 0 ) )
+					m68k_idle_loop ( r );
 #endif
 
 				if (r->spcflags) {
@@ -6264,7 +6608,6 @@ RETRO_STATIC	bool exit = false;
 //					DSP_Run ( DSP_CPU_FREQ_RATIO * ( CyclesGlobalClockCounter - DSP_CyclesGlobalClockCounter ) );
 				}
 #endif
-RETRO_BREAK_LOOP;
 			}
 		} CATCH(prb) {
 			bus_error();
@@ -6332,84 +6675,89 @@ bool is_keyboardreset(void)
 	return  cpu_keyboardreset;
 }
 
-#if defined(__LIBRETRO__) && !defined(HAVE_LIBCO) 	/* RETRO HACK */
-static int unefois=0;
-
-void RetroLoop(){
+#ifdef __LIBRETRO__	/* RETRO HACK */
+/*
+ * The libretro core can't block in m68k_go(), it has to return to the
+ * frontend after each frame. m68k_go_start() does the setup part of
+ * m68k_go() once, then each call to m68k_go_run() does one iteration of
+ * its main loop : it runs the CPU until it has to leave m68k_run_xxx()
+ * (SPCFLAG_BRK, CPU mode change, ...). m68k_go_stop() ends the emulation.
+ */
+void m68k_go_start (void)
+{
+	if (in_m68k_go) {
+		write_log (_T("Bug! m68k_go is not reentrant.\n"));
+		abort ();
+	}
 
-if(unefois==0){
 	reset_frame_rate_hack ();
 	update_68k_cycles ();
+
 	set_cpu_tracer (false);
 
 	cpu_prefs_changed_flag = 0;
+	in_m68k_go++;
 }
-        while(CPULOOP==1){
 
-		void (*run_func)(void);
+void m68k_go_run (void)
+{
+	void (*run_func)(void);
 
-#ifdef WINUAE_FOR_HATARI
-		/* Exit hatari ? */
-		if (bQuitProgram == true)
-			break;
-#endif
-if(unefois==0){
-		cputrace.state = -1;
+	cputrace.state = -1;
 
-		set_cpu_tracer (false);
+	set_cpu_tracer (false);
 
-		/* [NP] : in Hatari, build_cpufunctbl() is called directly from check_prefs_changed_cpu2() */
-		/* so we just need to set PC here */
-		if (regs.spcflags & SPCFLAG_MODE_CHANGE) {
-			if (cpu_prefs_changed_flag & 1) {
-printf ( "cpu change %d\n" , cpu_prefs_changed_flag );
-				uaecptr pc = m68k_getpc();
-				m68k_setpc_normal(pc);
-				fill_prefetch();
-			}
-			cpu_prefs_changed_flag = 0;
+#ifdef DEBUGGER
+	if (debugging)
+		debug ();
+#endif
+	/* [NP] : in Hatari, build_cpufunctbl() is called directly from check_prefs_changed_cpu2() */
+	/* so we just need to set PC here */
+	if (regs.spcflags & SPCFLAG_MODE_CHANGE) {
+		if (cpu_prefs_changed_flag & 1) {
+			uaecptr pc = m68k_getpc();
+			m68k_setpc_normal(pc);
+			fill_prefetch();
 		}
+		cpu_prefs_changed_flag = 0;
+	}
 
+	set_x_funcs();
+	unset_special(SPCFLAG_MODE_CHANGE);
 
-		set_x_funcs();
-
-		unset_special(SPCFLAG_MODE_CHANGE);
-
-		if (regs.halted) {
-			cpu_halt (regs.halted);
-			if (regs.halted < 0) {
-				haltloop();
-				continue;
-			}
+	if (regs.halted) {
+		cpu_halt (regs.halted);
+		if (regs.halted < 0) {
+			haltloop();
+			return;
 		}
-unefois++;
-}
+	}
 
-			run_func = currprefs.cpu_cycle_exact && currprefs.cpu_model <= 68010 ? m68k_run_1_ce :
-				currprefs.cpu_compatible && currprefs.cpu_model <= 68010 ? m68k_run_1 :
+	run_func = currprefs.cpu_cycle_exact && currprefs.cpu_model <= 68010 ? m68k_run_1_ce :
+		currprefs.cpu_compatible && currprefs.cpu_model <= 68010 ? m68k_run_1 :
 #ifdef JIT
-				currprefs.cpu_model >= 68020 && currprefs.cachesize ? m68k_run_jit :
+		currprefs.cpu_model >= 68020 && currprefs.cachesize ? m68k_run_jit :
 #endif
-				currprefs.cpu_model == 68030 && currprefs.mmu_model ? m68k_run_mmu030 :
-				currprefs.cpu_model == 68040 && currprefs.mmu_model ? m68k_run_mmu040 :
-				currprefs.cpu_model == 68060 && currprefs.mmu_model ? m68k_run_mmu060 :
+		currprefs.cpu_model == 68030 && currprefs.mmu_model ? m68k_run_mmu030 :
+		currprefs.cpu_model == 68040 && currprefs.mmu_model ? m68k_run_mmu040 :
+		currprefs.cpu_model == 68060 && currprefs.mmu_model ? m68k_run_mmu060 :
 
-				currprefs.cpu_model >= 68040 && currprefs.cpu_cycle_exact ? m68k_run_3ce :
-				currprefs.cpu_model >= 68020 && currprefs.cpu_cycle_exact ? m68k_run_2ce :
+		currprefs.cpu_model >= 68040 && currprefs.cpu_cycle_exact ? m68k_run_3ce :
+		currprefs.cpu_model >= 68020 && currprefs.cpu_cycle_exact ? m68k_run_2ce :
 
-				currprefs.cpu_model <= 68020 && currprefs.cpu_compatible ? m68k_run_2p :
-				currprefs.cpu_model == 68030 && currprefs.cpu_compatible ? m68k_run_2p :
-				currprefs.cpu_model >= 68040 && currprefs.cpu_compatible ? m68k_run_3p :
-
-				m68k_run_2;
-
-		run_func();
+		currprefs.cpu_model <= 68020 && currprefs.cpu_compatible ? m68k_run_2p :
+		currprefs.cpu_model == 68030 && currprefs.cpu_compatible ? m68k_run_2p :
+		currprefs.cpu_model >= 68040 && currprefs.cpu_compatible ? m68k_run_3p :
 
-	}
-       CPULOOP=1;
+		m68k_run_2;
+	run_func();
+}
 
+void m68k_go_stop (void)
+{
+	in_m68k_go--;
 }
-#endif 	/* RETRO HACK */
+#endif	/* RETRO HACK */
 
 void m68k_go (int may_quit)
 {
@@ -7369,7 +7717,7 @@ void m68k_dumpstate_2 (uaecptr pc, uaecptr *nextpc)
 	if (currprefs.fpu_model) {
 		uae_u32 fpsr;
 		for (i = 0; i < 8; i++){
-			console_out_f (_T("FP%d: %g "), i, regs.fp[i].fp);
+			console_out_f (_T("FP%d: %g "), i, (double)regs.fp[i].fp);
 			if ((i & 3) == 3)
 				console_out_f (_T("\n"));
 		}
@@ -7483,7 +7831,6 @@ uae_u8 *restore_cpu (uae_u8 *src)
 	regs.usp = restore_u32 ();
 	regs.isp = restore_u32 ();
 	regs.sr = restore_u16 ();
-printf ( "restore %x %x %x\n" , regs.usp , regs.isp , regs.sr );
 	l = restore_u32 ();
 	if (l & CPUMODE_HALT) {
 		regs.stopped = 1;
@@ -7618,11 +7965,14 @@ static void fill_prefetch_quick (void)
 
 void restore_cpu_finish (void)
 {
+#ifdef WINUAE_FOR_HATARI
+	/* CPU tables don't change between lightweight snapshots */
+	if (!MemorySnapShot_IsLight())
+#endif
 	init_m68k ();
 	m68k_setpc_normal (regs.pc);
 	doint ();
 	fill_prefetch_quick ();
-printf ( "SR %x %x %x %x\n" , regs.sr , regs.isp , regs.usp , regs.regs[15] );
 #ifndef WINUAE_FOR_HATARI
 	set_cycles (start_cycles);
 	events_schedule ();
@@ -125,7 +125,7 @@ typedef uae_u8 flagtype;
 
 #ifdef FPUEMU
 
-#ifdef USE_LONG_DOUBLE
+#if USE_LONG_DOUBLE
 typedef long double fptype;
 #define LDPTR tbyte ptr
 #else
@@ -615,6 +615,11 @@ extern bool m68k_mull (uae_u32, uae_u32, uae_u16);
 extern void init_m68k (void);
 extern void init_m68k_full (void);
 extern void m68k_go (int);
+#ifdef __LIBRETRO__	/* RETRO HACK */
+extern void m68k_go_start (void);
+extern void m68k_go_run (void);
+extern void m68k_go_stop (void);
+#endif	/* RETRO HACK */
 extern void m68k_dumpstate (uaecptr *);
 extern void m68k_dumpstate_2 (uaecptr, uaecptr *);
 extern void m68k_dumpstate_file (FILE *f, uaecptr *);
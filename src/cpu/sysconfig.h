@@ -63,6 +63,19 @@
 #define FPUEMU /* FPU emulation */
 #define FPU_UAE
 //#define WITH_SOFTFLOAT
+/* Use host long double for the FPU registers when it's the x87 80-bit
+ * format, which has the same 64-bit mantissa as the 6888x extended
+ * precision. Configure with ENABLE_FPU_LONG_DOUBLE=0 in CMake (or
+ * FPU_LONG_DOUBLE=0 for Makefile.libretro) to use double instead,
+ * tests/fpu/ compares both. */
+#ifndef USE_LONG_DOUBLE
+#include <float.h>
+#if (defined(__i386__) || defined(__x86_64__)) && LDBL_MANT_DIG == 64
+#define USE_LONG_DOUBLE 1
+#else
+#define USE_LONG_DOUBLE 0
+#endif
+#endif
 #define MMUEMU /* Aranym 68040 MMU */
 #define FULLMMU /* Aranym 68040 MMU */
 #define CPUEMU_0 /* generic 680x0 emulation */
@@ -71,6 +71,7 @@ const char CycInt_fileid[] = "Hatari cycInt.c : " __DATE__ " " __TIME__;
 
 void (*PendingInterruptFunction)(void);
 int PendingInterruptCount;
+Uint32 PendingInterruptUpdates;		/* incremented each time the next interrupt is recomputed */
 
 static int nCyclesOver;
 
@@ -122,6 +123,7 @@ void CycInt_Reset(void)
 
 	/* Reset counts */
 	PendingInterruptCount = 0;
+	PendingInterruptUpdates++;
 	ActiveInterrupt = 0;
 	nCyclesOver = 0;
 
@@ -253,6 +255,7 @@ static void CycInt_SetNewInterrupt(void)
 
 	/* Set new counts, active interrupt */
 	PendingInterruptCount = InterruptHandlers[LowestInterrupt].Cycles;
+	PendingInterruptUpdates++;
 	PendingInterruptFunction = InterruptHandlers[LowestInterrupt].pFunction;
 	ActiveInterrupt = LowestInterrupt;
 
@@ -399,6 +402,37 @@ void CycInt_ModifyInterrupt(int CycleTime, int CycleType, interrupt_id Handler)
 }
 
 
+/*-----------------------------------------------------------------------*/
+/**
+ * If an interrupt is due in more than CycleTime cycles, make it happen
+ * earlier by a whole number of CycleTime periods, so it will be due within
+ * the next CycleTime cycles. This is used for MFP timers, which can
+ * skip some periods while their interrupt is disabled.
+ */
+void CycInt_AlignInterrupt(int CycleTime, int CycleType, interrupt_id Handler)
+{
+	Sint64 Period;
+
+	if ( !InterruptHandlers[Handler].bUsed )
+		return;
+
+	if ( ActiveInterrupt > 0 )
+		CycInt_UpdateInterrupt();
+
+	Period = INT_CONVERT_TO_INTERNAL((Sint64)CycleTime , CycleType);
+	if ( ( Period <= 0 ) || ( InterruptHandlers[Handler].Cycles <= Period ) )
+		return;
+
+	InterruptHandlers[Handler].Cycles -= ( ( InterruptHandlers[Handler].Cycles - 1 ) / Period ) * Period;
+
+	CycInt_SetNewInterrupt();
+
+	LOG_TRACE(TRACE_INT, "int align video_cyc=%d handler=%d handler_cyc=%"PRId64" pending_count=%d\n",
+	          Cycles_GetCounter(CYCLES_COUNTER_VIDEO), Handler,
+	          InterruptHandlers[Handler].Cycles, PendingInterruptCount );
+}
+
+
 /*-----------------------------------------------------------------------*/
 /**
  * Remove a pending interrupt from our table
@@ -14,6 +14,7 @@ const char DebugInfo_fileid[] = "Hatari debuginfo.c : " __DATE__ " " __TIME__;
 #include <ctype.h>
 
 #include "main.h"
+#include "audio.h"
 #include "bios.h"
 #include "blitter.h"
 #include "configuration.h"
@@ -639,6 +640,7 @@ static const struct {
 	const char *info;
 } infotable[] = {
 	{ false,"aes",       AES_Info,             NULL, "Show AES vector contents (with <value>, show opcodes)" },
+	{ false,"audio",     Audio_Info,           NULL, "Show audio ring buffer fill level and resampling ratio" },
 	{ false,"basepage",  DebugInfo_Basepage,   NULL, "Show program basepage contents at given <address>" },
 	{ false,"bios",      Bios_Info,            NULL, "Show BIOS opcodes" },
 	{ false,"blitter",   Blitter_Info,         NULL, "Show Blitter register contents" },
@@ -657,6 +659,7 @@ static const struct {
 	{ true, "history",   History_Show,         NULL, "Show history of last <count> instructions" },
 	{ true, "memdump",   DebugInfo_CpuMemDump, NULL, "Dump CPU memory from given <address>" },
 	{ false,"osheader",  DebugInfo_OSHeader,   NULL, "Show TOS OS header contents" },
+	{ false,"pacing",    Main_PacingInfo,      NULL, "Show host VBL pacing method and wake-up jitter statistics" },
 	{ true, "regaddr",   DebugInfo_RegAddr, DebugInfo_RegAddrArgs, "Show <disasm|memdump> from CPU/DSP address pointed by <register>" },
 	{ true, "registers", DebugInfo_CpuRegister,NULL, "Show CPU register contents" },
 	{ false,"vdi",       VDI_Info,             NULL, "Show VDI vector contents (with <value>, show opcodes)" },
@@ -666,7 +669,7 @@ static const struct {
 	{ false,"ym",        PSG_Info,             NULL, "Show YM-2149 register contents" },
 };
 
-static int LockedFunction = 6; /* index for the "default" function */
+static int LockedFunction = 7; /* index for the "default" function */
 static Uint32 LockedArgument;
 
 /**
@@ -237,9 +237,10 @@ void Log_Printf(LOGTYPE nType, const char *psFormat, ...)
 void Log_AlertDlg(LOGTYPE nType, const char *psFormat, ...)
 {
 	va_list argptr;
+	bool bNoVideo = ConfigureParams.Screen.nVideoBackend == VIDEO_BACKEND_NONE;
 
-	/* Output to log file: */
-	if (hLogFile && nType <= TextLogLevel)
+	/* Output to log file (without video output, alerts go there too): */
+	if (hLogFile && (nType <= TextLogLevel || (bNoVideo && nType <= AlertDlgLogLevel)))
 	{
 		va_start(argptr, psFormat);
 		vfprintf(hLogFile, psFormat, argptr);
@@ -250,7 +251,7 @@ void Log_AlertDlg(LOGTYPE nType, const char *psFormat, ...)
 	}
 
 	/* Show alert dialog box: */
-	if (sdlscrn && nType <= AlertDlgLogLevel)
+	if (sdlscrn && !bNoVideo && nType <= AlertDlgLogLevel)
 	{
 		char *psTmpBuf;
 		psTmpBuf = malloc(2048);
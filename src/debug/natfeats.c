@@ -14,6 +14,8 @@
 const char Natfeats_fileid[] = "Hatari natfeats.c : " __DATE__ " " __TIME__;
 
 #include <stdio.h>
+#include <errno.h>
+#include <limits.h>
 #include "main.h"
 #include "version.h"
 #include "configuration.h"
@@ -163,6 +165,311 @@ static bool nf_fastforward(Uint32 stack, Uint32 subid, Uint32 *retval)
 	return true;
 }
 
+/* ----------------------------------
+ * Bulk memory and host file Native Features, specific to Hatari
+ *
+ * These features take their cycle accounting option from subid:
+ * with NF_SUBID_CYCLES set, emulated time advances approximately
+ * as much as a 68000 loop doing the same would take, otherwise the
+ * operation takes no emulated time.
+ *
+ * As the cycles are added at once, a call with cycle accounting
+ * processes at most NF_CYCLES_MAX_BYTES bytes. Features returning
+ * a byte count return the number of bytes actually processed, callers
+ * of NF_MEMCMP and NF_CRC32 need to split larger areas themselves.
+ */
+
+#define NF_SUBID_CYCLES	1
+
+#define NF_CYCLES_MAX_BYTES	2048
+
+/* 68000 cycles per byte for longword loops with dbra */
+#define NF_CYCLES_COPY	8	/* move.l (a0)+,(a1)+ */
+#define NF_CYCLES_SET	6	/* move.l d0,(a0)+ */
+#define NF_CYCLES_CMP	8	/* cmpm.l (a0)+,(a1)+ */
+#define NF_CYCLES_CRC	40	/* table driven CRC, per byte */
+
+/* NF_HOSTFILE operations, given as subid above NF_SUBID_CYCLES bit */
+#define NF_HOSTFILE_READ	0
+#define NF_HOSTFILE_WRITE	2
+#define NF_HOSTFILE_SIZE	4
+
+static FILE *HostFile;
+static char HostFileName[FILENAME_MAX];
+
+/**
+ * Return how many of 'len' bytes can be processed in one call
+ */
+static Uint32 nf_cycles_len(Uint32 subid, Uint32 len)
+{
+	if ((subid & NF_SUBID_CYCLES) && len > NF_CYCLES_MAX_BYTES)
+		return NF_CYCLES_MAX_BYTES;
+	return len;
+}
+
+/**
+ * Advance emulated time for 'len' bytes processed, if subid asks for it.
+ * 'len' is limited by nf_cycles_len(), so that the cycles converted to
+ * internal units can't overflow the int cycle counters.
+ */
+static void nf_add_cycles(Uint32 subid, Uint32 len, int cycles_per_byte)
+{
+	if (!(subid & NF_SUBID_CYCLES))
+		return;
+	M68000_AddCycles(len * cycles_per_byte);
+}
+
+/**
+ * Return host pointer to given emulated RAM area (ST or TT RAM).
+ * If area isn't fully within RAM, raise bus error and return NULL.
+ */
+static Uint8 *nf_ram_area(Uint32 addr, Uint32 len, int bus_rw)
+{
+	if (ConfigureParams.System.bAddressSpace24)
+		addr &= 0x00ffffff;
+
+	if (len > INT_MAX || !STMemory_CheckAreaType(addr, len, ABFLAG_RAM)) {
+		M68000_BusError(addr, bus_rw, BUS_ERROR_SIZE_BYTE, BUS_ERROR_ACCESS_DATA);
+		return NULL;
+	}
+	return get_real_address(addr);
+}
+
+/**
+ * NF_MEMCPY - copy memory, areas can overlap
+ * Stack arguments are:
+ * - destination address
+ * - source address
+ * - uint32_t byte count
+ * returns number of bytes copied
+ */
+static bool nf_memcpy(Uint32 stack, Uint32 subid, Uint32 *retval)
+{
+	Uint32 dst, src, len;
+	Uint8 *pdst, *psrc;
+
+	dst = STMemory_ReadLong(stack);
+	src = STMemory_ReadLong(stack + SIZE_LONG);
+	len = STMemory_ReadLong(stack + 2*SIZE_LONG);
+	LOG_TRACE(TRACE_NATFEATS, "NF_MEMCPY[%d](0x%x, 0x%x, %d)\n", subid, dst, src, len);
+	len = nf_cycles_len(subid, len);
+
+	*retval = len;
+	if (!len)
+		return true;
+	if (!(psrc = nf_ram_area(src, len, BUS_ERROR_READ)) ||
+	    !(pdst = nf_ram_area(dst, len, BUS_ERROR_WRITE)))
+		return false;
+
+	memmove(pdst, psrc, len);
+	STMemory_MarkAreaWritten(dst, len);
+	nf_add_cycles(subid, len, NF_CYCLES_COPY);
+	return true;
+}
+
+/**
+ * NF_MEMSET - fill memory with a byte value
+ * Stack arguments are:
+ * - destination address
+ * - uint32_t value, lowest byte of which is used
+ * - uint32_t byte count
+ * returns number of bytes set
+ */
+static bool nf_memset(Uint32 stack, Uint32 subid, Uint32 *retval)
+{
+	Uint32 dst, val, len;
+	Uint8 *pdst;
+
+	dst = STMemory_ReadLong(stack);
+	val = STMemory_ReadLong(stack + SIZE_LONG);
+	len = STMemory_ReadLong(stack + 2*SIZE_LONG);
+	LOG_TRACE(TRACE_NATFEATS, "NF_MEMSET[%d](0x%x, 0x%x, %d)\n", subid, dst, val, len);
+	len = nf_cycles_len(subid, len);
+
+	*retval = len;
+	if (!len)
+		return true;
+	if (!(pdst = nf_ram_area(dst, len, BUS_ERROR_WRITE)))
+		return false;
+
+	memset(pdst, val & 0xff, len);
+	STMemory_MarkAreaWritten(dst, len);
+	nf_add_cycles(subid, len, NF_CYCLES_SET);
+	return true;
+}
+
+/**
+ * NF_MEMCMP - compare memory areas
+ * Stack arguments are:
+ * - first area address
+ * - second area address
+ * - uint32_t byte count
+ * returns -1, 0 or 1, like memcmp()
+ */
+static bool nf_memcmp(Uint32 stack, Uint32 subid, Uint32 *retval)
+{
+	Uint32 addr1, addr2, len;
+	Uint8 *p1, *p2;
+	int ret;
+
+	addr1 = STMemory_ReadLong(stack);
+	addr2 = STMemory_ReadLong(stack + SIZE_LONG);
+	len = nf_cycles_len(subid, STMemory_ReadLong(stack + 2*SIZE_LONG));
+
+	*retval = 0;
+	if (len) {
+		if (!(p1 = nf_ram_area(addr1, len, BUS_ERROR_READ)) ||
+		    !(p2 = nf_ram_area(addr2, len, BUS_ERROR_READ)))
+			return false;
+		ret = memcmp(p1, p2, len);
+		*retval = ret < 0 ? -1 : (ret > 0 ? 1 : 0);
+		nf_add_cycles(subid, len, NF_CYCLES_CMP);
+	}
+	LOG_TRACE(TRACE_NATFEATS, "NF_MEMCMP[%d](0x%x, 0x%x, %d) -> %d\n",
+		  subid, addr1, addr2, len, (Sint32)*retval);
+	return true;
+}
+
+/**
+ * NF_CRC32 - compute CRC-32 (IEEE 802.3, same as zlib) of memory area
+ * Stack arguments are:
+ * - area address
+ * - uint32_t byte count
+ * - uint32_t CRC of preceding data, zero for first area
+ * returns updated CRC
+ */
+static bool nf_crc32(Uint32 stack, Uint32 subid, Uint32 *retval)
+{
+	static Uint32 table[256];
+	Uint32 addr, len, crc, i;
+	Uint8 *p;
+	int bit;
+
+	addr = STMemory_ReadLong(stack);
+	len = nf_cycles_len(subid, STMemory_ReadLong(stack + SIZE_LONG));
+	crc = STMemory_ReadLong(stack + 2*SIZE_LONG);
+
+	if (!table[1]) {
+		for (i = 0; i < 256; i++) {
+			Uint32 c = i;
+			for (bit = 0; bit < 8; bit++)
+				c = (c & 1) ? (c >> 1) ^ 0xedb88320 : c >> 1;
+			table[i] = c;
+		}
+	}
+
+	if (len) {
+		if (!(p = nf_ram_area(addr, len, BUS_ERROR_READ)))
+			return false;
+		crc = ~crc;
+		for (i = 0; i < len; i++)
+			crc = table[(crc ^ p[i]) & 0xff] ^ (crc >> 8);
+		crc = ~crc;
+		nf_add_cycles(subid, len, NF_CYCLES_CRC);
+	}
+	LOG_TRACE(TRACE_NATFEATS, "NF_CRC32[%d](0x%x, %d) -> 0x%08x\n", subid, addr, len, crc);
+	*retval = crc;
+	return true;
+}
+
+/**
+ * Close the host file, so that it's reopened on next access
+ */
+static void nf_hostfile_close(void)
+{
+	if (HostFile) {
+		fclose(HostFile);
+		HostFile = NULL;
+	}
+	HostFileName[0] = '\0';
+}
+
+/**
+ * Return host file given with --natfeats-file option, opened
+ * for reading & writing (created if needed), or NULL if there's none
+ */
+static FILE *nf_hostfile(void)
+{
+	const char *name = ConfigureParams.Log.sNatFeatsFileName;
+
+	if (HostFile && strcmp(name, HostFileName) == 0)
+		return HostFile;
+	nf_hostfile_close();
+	if (!*name)
+		return NULL;
+
+	HostFile = fopen(name, "r+b");
+	/* create the file only if it doesn't exist, never truncate it */
+	if (!HostFile && errno == ENOENT)
+		HostFile = fopen(name, "w+b");
+	if (!HostFile) {
+		Log_Printf(LOG_WARN, "NF_HOSTFILE: can't open '%s': %s\n", name, strerror(errno));
+		return NULL;
+	}
+	strcpy(HostFileName, name);
+	return HostFile;
+}
+
+/**
+ * NF_HOSTFILE - block access to the host file given with --natfeats-file
+ * Subid gives the operation and cycle accounting option (read & write
+ * take as much time as copying the data), stack arguments for read
+ * & write are:
+ * - buffer address
+ * - uint32_t file offset
+ * - uint32_t byte count
+ * returns number of bytes read/written, or file size for size operation,
+ * and -1 if there's no file or seeking in it fails
+ */
+static bool nf_hostfile_access(Uint32 stack, Uint32 subid, Uint32 *retval)
+{
+	Uint32 addr, offset, len, op;
+	FILE *fp;
+	Uint8 *p;
+
+	*retval = -1;
+	fp = nf_hostfile();
+	op = subid & ~NF_SUBID_CYCLES;
+	if (op == NF_HOSTFILE_SIZE) {
+		if (fp && fseek(fp, 0, SEEK_END) == 0)
+			*retval = ftell(fp);
+		LOG_TRACE(TRACE_NATFEATS, "NF_HOSTFILE[size]() -> %d\n", (Sint32)*retval);
+		return true;
+	}
+	if (op != NF_HOSTFILE_READ && op != NF_HOSTFILE_WRITE) {
+		LOG_TRACE(TRACE_NATFEATS, "ERROR: invalid NF_HOSTFILE operation %d\n", subid);
+		return true;
+	}
+
+	addr = STMemory_ReadLong(stack);
+	offset = STMemory_ReadLong(stack + SIZE_LONG);
+	len = STMemory_ReadLong(stack + 2*SIZE_LONG);
+	LOG_TRACE(TRACE_NATFEATS, "NF_HOSTFILE[%s%s](0x%x, %d, %d)\n",
+		  op == NF_HOSTFILE_READ ? "read" : "write",
+		  subid & NF_SUBID_CYCLES ? "+cycles" : "", addr, offset, len);
+	len = nf_cycles_len(subid, len);
+
+	if (!fp || fseek(fp, offset, SEEK_SET) != 0)
+		return true;
+	if (!len) {
+		*retval = 0;
+		return true;
+	}
+	if (op == NF_HOSTFILE_READ) {
+		if (!(p = nf_ram_area(addr, len, BUS_ERROR_WRITE)))
+			return false;
+		*retval = fread(p, 1, len, fp);
+		STMemory_MarkAreaWritten(addr, *retval);
+	} else {
+		if (!(p = nf_ram_area(addr, len, BUS_ERROR_READ)))
+			return false;
+		*retval = fwrite(p, 1, len, fp);
+		fflush(fp);
+	}
+	nf_add_cycles(subid, *retval, NF_CYCLES_COPY);
+	return true;
+}
+
 #if NF_COMMAND
 /**
  * NF_COMMAND - execute Hatari (cli / debugger) command
@@ -206,7 +513,12 @@ static const struct {
 	{ "NF_SHUTDOWN", true,  nf_shutdown },
 	{ "NF_EXIT",     false, nf_exit },
 	{ "NF_DEBUGGER", false, nf_debugger },
-	{ "NF_FASTFORWARD", false,  nf_fastforward }
+	{ "NF_FASTFORWARD", false,  nf_fastforward },
+	{ "NF_MEMCPY",   false, nf_memcpy },
+	{ "NF_MEMSET",   false, nf_memset },
+	{ "NF_MEMCMP",   false, nf_memcmp },
+	{ "NF_CRC32",    false, nf_crc32 },
+	{ "NF_HOSTFILE", false, nf_hostfile_access }
 #if defined(__linux__)        
         ,{ "NF_SCSIDRV",  true, nf_scsidrv }
 #endif
@@ -281,3 +593,21 @@ bool NatFeat_Call(Uint32 stack, bool super, Uint32 *retval)
 	stack += SIZE_LONG;
 	return features[idx].cb(stack, subid, retval);
 }
+
+
+/**
+ * Close the NF_HOSTFILE file on emulation reset, it's reopened
+ * (with the current --natfeats-file name) on next access
+ */
+void NatFeat_Reset(void)
+{
+	nf_hostfile_close();
+}
+
+/**
+ * Close the NF_HOSTFILE file on exit
+ */
+void NatFeat_UnInit(void)
+{
+	nf_hostfile_close();
+}
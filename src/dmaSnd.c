@@ -745,6 +745,9 @@ void DmaSnd_SoundControl_WriteWord(void)
 			FrameCycles, LineCycles, HblCounterVideo, M68000_GetPC(), CurrentInstrCycles);
 	}
 
+	/* DMA sound needs an update on each HBL */
+	Video_LineBatch_Stop();
+
         /* Before starting/stopping DMA sound, create samples up until this point with current values */
 	Sound_Update(false);
 
@@ -795,6 +798,24 @@ void DmaSnd_FrameCountLow_ReadByte(void)
 }
 
 
+/*-----------------------------------------------------------------------*/
+/**
+ * Native word/long read of the sound frame count registers (0xff8908-0xff890d),
+ * called by ioMem.c once for the whole access : the frame count is updated
+ * only once instead of once per register. The unused even bytes between the
+ * registers are read as void IO bytes.
+ */
+void DmaSnd_FrameCount_ReadWordLong(void)
+{
+	Uint32 nActCount = DmaSnd_GetFrameCount();
+
+	IoMem[0xff8908] = IoMem[0xff890a] = IoMem[0xff890c] = 0xff;
+	IoMem[0xff8909] = nActCount >> 16;
+	IoMem[0xff890b] = nActCount >> 8;
+	IoMem[0xff890d] = nActCount;
+}
+
+
 /*-----------------------------------------------------------------------*/
 /**
  * Write bytes to various registers with no action.
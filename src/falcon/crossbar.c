@@ -1612,6 +1612,7 @@ void Crossbar_SendDataToDmaRecord(Sint16 value)
 	}
 
 	pFrameStart = (Sint8 *)&STRam[dmaRecord.frameStartAddr];
+	STMemory_MarkWritten(dmaRecord.frameStartAddr + dmaRecord.frameCounter);
 
 	/* 16 bits stereo mode ? */
 	if (crossbar.is16Bits) {
@@ -885,6 +885,7 @@ bool VIDEL_renderScreen(void)
 	int nextline;
 
 	bool change = false;
+	SDL_Rect *sbar_rect;
 
 	Uint32 videoBase = VIDEL_getVideoramAddress();
 
@@ -913,6 +914,9 @@ bool VIDEL_renderScreen(void)
 		return false;
 	}
 
+	/* Restore area under overlay led, lines below it may be skipped */
+	Statusbar_OverlayRestore(sdlscrn);
+
 	if (!Screen_Lock())
 		return false;
 
@@ -936,13 +940,17 @@ bool VIDEL_renderScreen(void)
 
 	VIDEL_UpdateColors();
 
-	Screen_GenConvert(&STRam[videoBase], videl.XSize, videl.YSize,
-	                  videl.save_scrBpp, nextline, hscrolloffset,
-	                  videl.leftBorderSize, videl.rightBorderSize,
-	                  videl.upperBorderSize, videl.lowerBorderSize);
+	/* Only lines which changed since previous frame are converted */
+	change = Screen_GenConvert(&STRam[videoBase], videl.XSize, videl.YSize,
+	                           videl.save_scrBpp, nextline, hscrolloffset,
+	                           videl.leftBorderSize, videl.rightBorderSize,
+	                           videl.upperBorderSize, videl.lowerBorderSize);
 
 	Screen_UnLock();
-	Screen_GenConvUpdate(Statusbar_Update(sdlscrn, false), false);
+	Statusbar_OverlayBackup(sdlscrn);
+	sbar_rect = Statusbar_Update(sdlscrn, false);
+	if (change || sbar_rect)
+		Screen_GenConvUpdate(sbar_rect, false);
 
 	return true;
 }
@@ -1075,6 +1083,17 @@ void Videl_Color15_WriteWord(void)
 	Videl_ColorReg_WriteWord();
 }
 
+/*
+ * Native long write to 2 consecutive ST color regs, called once by ioMem.c
+ * for the whole .L access.
+ */
+void Videl_ColorRegs_WriteLong(void)
+{
+	Videl_ColorReg_WriteWord();
+	IoAccessCurrentAddress += 2;
+	Videl_ColorReg_WriteWord();
+}
+
 /**
  * display Videl registers values (for debugger info command)
  */
@@ -68,6 +68,7 @@ extern void Videl_Color12_WriteWord(void);
 extern void Videl_Color13_WriteWord(void);
 extern void Videl_Color14_WriteWord(void);
 extern void Videl_Color15_WriteWord(void);
+extern void Videl_ColorRegs_WriteLong(void);
 
 
 /* Called from cycint.c */
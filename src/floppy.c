@@ -117,6 +117,50 @@ void Floppy_Reset(void)
 }
 
 
+/*-----------------------------------------------------------------------*/
+/**
+ * Save/Restore the drives for a lightweight snapshot : the disk images
+ * stay inserted and their contents are only stored once they have been
+ * written to. Restoring doesn't clear bContentsChanged, so that written
+ * images still get saved when they're ejected.
+ * Each drive always uses FLOPPY_LIGHT_SNAPSHOT_IMAGE_BYTES, so that the
+ * snapshot size doesn't grow when a disk is written to. Only sector based
+ * images (ST/MSA/DIM) are stored, STX keeps its written sectors apart
+ * and larger images are not supported.
+ */
+static void Floppy_MemorySnapShot_CaptureLight(bool bSave)
+{
+	int i;
+	int nImageBytes;
+
+	for (i = 0; i < MAX_FLOPPYDRIVES; i++)
+	{
+		nImageBytes = 0;
+		if (EmulationDrives[i].bContentsChanged && EmulationDrives[i].pBuffer
+		    && ( EmulationDrives[i].ImageType == FLOPPY_IMAGE_TYPE_ST
+		      || EmulationDrives[i].ImageType == FLOPPY_IMAGE_TYPE_MSA
+		      || EmulationDrives[i].ImageType == FLOPPY_IMAGE_TYPE_DIM )
+		    && EmulationDrives[i].nImageBytes <= FLOPPY_LIGHT_SNAPSHOT_IMAGE_BYTES)
+			nImageBytes = EmulationDrives[i].nImageBytes;
+		MemorySnapShot_Store(&nImageBytes, sizeof(nImageBytes));
+		if (nImageBytes > 0)
+		{
+			/* Disk changed since the snapshot was made? */
+			if (!bSave && (!EmulationDrives[i].pBuffer
+			               || nImageBytes != EmulationDrives[i].nImageBytes))
+				MemorySnapShot_Skip(nImageBytes);
+			else
+				MemorySnapShot_Store(EmulationDrives[i].pBuffer, nImageBytes);
+		}
+		MemorySnapShot_Skip(FLOPPY_LIGHT_SNAPSHOT_IMAGE_BYTES - nImageBytes);
+		MemorySnapShot_Store(&EmulationDrives[i].TransitionState1,sizeof(EmulationDrives[i].TransitionState1));
+		MemorySnapShot_Store(&EmulationDrives[i].TransitionState1_VBL,sizeof(EmulationDrives[i].TransitionState1_VBL));
+		MemorySnapShot_Store(&EmulationDrives[i].TransitionState2,sizeof(EmulationDrives[i].TransitionState2));
+		MemorySnapShot_Store(&EmulationDrives[i].TransitionState2_VBL,sizeof(EmulationDrives[i].TransitionState2_VBL));
+	}
+}
+
+
 /*-----------------------------------------------------------------------*/
 /**
  * Save/Restore snapshot of local variables('MemorySnapShot_Store' handles type)
@@ -125,6 +169,12 @@ void Floppy_MemorySnapShot_Capture(bool bSave)
 {
 	int i;
 
+	if (MemorySnapShot_IsLight())
+	{
+		Floppy_MemorySnapShot_CaptureLight(bSave);
+		return;
+	}
+
 	/* If restoring then eject old drives first! */
 	if (!bSave)
 		Floppy_EjectBothDrives();
@@ -87,7 +87,6 @@ void IPF_MemorySnapShot_Capture(bool bSave)
 	{
 		StructSize = sizeof ( IPF_State );	/* 0 if HAVE_CAPSIMAGE is not defined */
 		MemorySnapShot_Store(&StructSize, sizeof(StructSize));
-fprintf ( stderr , "ipf save %d\n" , StructSize );
 		if ( StructSize > 0 )
 			MemorySnapShot_Store(&IPF_State, sizeof(IPF_State));
 	}
@@ -95,7 +94,6 @@ fprintf ( stderr , "ipf save %d\n" , StructSize );
 	else						/* Restoring snapshot */
 	{
 		MemorySnapShot_Store(&StructSize, sizeof(StructSize));
-fprintf ( stderr , "ipf load %d\n" , StructSize );
 		if ( ( StructSize == 0 ) && ( sizeof ( IPF_State ) > 0 ) )
 		{
 			Log_AlertDlg(LOG_ERROR, "This memory snapshot doesn't include IPF data but this version of Hatari was built with IPF support");
@@ -748,6 +746,31 @@ void	IPF_FDC_StatusBar ( Uint8 *pCommand , Uint8 *pHead , Uint8 *pTrack , Uint8
 
 
 
+/*
+ * Return true if an IPF image is inserted in one of the drives.
+ * In that case, the FDC's state is only updated by IPF_Emulate() which
+ * must be called on every HBL.
+ */
+bool	IPF_IsActive ( void )
+{
+#ifndef HAVE_CAPSIMAGE
+	return false;
+
+#else
+	int	Drive;
+
+	for ( Drive=0 ; Drive < MAX_FLOPPYDRIVES ; Drive++ )
+		if ( EmulationDrives[ Drive ].bDiskInserted
+		  && ( EmulationDrives[ Drive ].ImageType == FLOPPY_IMAGE_TYPE_IPF ) )
+			return true;
+
+	return false;
+#endif
+}
+
+
+
+
 /*
  * Run the FDC emulation during NbCycles cycles (relative to the 8MHz FDC's clock)
  */
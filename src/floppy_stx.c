@@ -109,6 +109,9 @@ static void	STX_FreeSaveTracksStruct ( STX_SAVE_TRACK_STRUCT *pSaveTracksStruct
 
 static void	STX_BuildSectorsSimple ( STX_TRACK_STRUCT *pStxTrack , Uint8 *p );
 static Uint16	STX_BuildSectorID_CRC ( STX_SECTOR_STRUCT *pStxSector );
+static bool	STX_BuildTracksIndex ( STX_MAIN_STRUCT *pStxMain );
+static Uint16	*STX_BuildSectorTimings ( STX_SECTOR_STRUCT *pStxSector );
+static Uint32	STX_GetTrackSize ( STX_TRACK_STRUCT *pStxTrack );
 static STX_TRACK_STRUCT	*STX_FindTrack ( Uint8 Drive , Uint8 Track , Uint8 Side );
 static STX_SECTOR_STRUCT *STX_FindSector ( Uint8 Drive , Uint8 Track , Uint8 Side , Uint8 SectorStruct_Nb );
 static STX_SECTOR_STRUCT *STX_FindSector_By_Position ( Uint8 Drive , Uint8 Track , Uint8 Side , Uint16 BitPosition );
@@ -126,6 +129,17 @@ void STX_MemorySnapShot_Capture(bool bSave)
 	STX_SECTOR_STRUCT	*pStxSector;
 	STX_TRACK_STRUCT	*pStxTrack;
 
+	/* Lightweight snapshots keep the inserted images and their 'write' buffers */
+	if ( MemorySnapShot_IsLight() )
+	{
+		MemorySnapShot_Store ( &STX_State.NextSectorStruct_Nbr , sizeof ( STX_State.NextSectorStruct_Nbr ) );
+		MemorySnapShot_Store ( &STX_State.NextSector_ID_Field_TR , sizeof ( STX_State.NextSector_ID_Field_TR ) );
+		MemorySnapShot_Store ( &STX_State.NextSector_ID_Field_SR , sizeof ( STX_State.NextSector_ID_Field_SR ) );
+		MemorySnapShot_Store ( &STX_State.NextSector_ID_Field_LEN , sizeof ( STX_State.NextSector_ID_Field_LEN ) );
+		MemorySnapShot_Store ( &STX_State.NextSector_ID_Field_CRC_OK , sizeof ( STX_State.NextSector_ID_Field_CRC_OK ) );
+		return;
+	}
+
 	if ( bSave )					/* Saving snapshot */
 	{
 		MemorySnapShot_Store( &STX_State , sizeof (STX_State) );
@@ -935,13 +949,19 @@ static void	STX_WriteU32_BE ( Uint8 *p , Uint32 val )
 static void	STX_FreeStruct ( STX_MAIN_STRUCT *pStxMain )
 {
 	int			Track;
+	int			Sector;
+	STX_TRACK_STRUCT	*pStxTrack;
 
 	if ( !pStxMain )
 		return;
 
-	for ( Track = 0 ; Track < pStxMain->TracksCount ; Track++ )
+	for ( Track = 0 ; Track < pStxMain->TracksCount && pStxMain->pTracksStruct ; Track++ )
 	{
-		free ( (pStxMain->pTracksStruct[ Track ]).pSectorsStruct );
+		pStxTrack = &(pStxMain->pTracksStruct[ Track ]);
+		if ( pStxTrack->pSectorsStruct )
+			for ( Sector = 0 ; Sector < pStxTrack->SectorsCount ; Sector++ )
+				free ( pStxTrack->pSectorsStruct[ Sector ].pByteTimings );
+		free ( pStxTrack->pSectorsStruct );
 	}
 
 	free ( pStxMain->pTracksStruct );
@@ -1314,11 +1334,142 @@ next_track:
 		pStxTrack++;
 	}
 
+	/* Precompute the index used by the FDC to find tracks/sectors and their timings */
+	if ( !STX_BuildTracksIndex ( pStxMain ) )
+	{
+		STX_FreeStruct ( pStxMain );
+		return NULL;
+	}
 
 	return pStxMain;
 }
 
 
+/*-----------------------------------------------------------------------*/
+/**
+ * Build the index used to speed up track/sector accesses during FDC commands.
+ * For each track we store its pointer in pTracksIndex[] (using TrackNumber
+ * as the index), as well as the duration of one revolution.
+ * For each sector, we store the position of the ID field in FDC cycles
+ * (sectors are sorted using BitPosition, which allows a binary search later)
+ * and the timing of each byte when the sector doesn't use standard timings.
+ * Return false if an error occurred.
+ */
+static bool	STX_BuildTracksIndex ( STX_MAIN_STRUCT *pStxMain )
+{
+	STX_TRACK_STRUCT	*pStxTrack;
+	STX_SECTOR_STRUCT	*pStxSector;
+	int			Track;
+	int			Sector;
+
+	memset ( pStxMain->pTracksIndex , 0 , sizeof ( pStxMain->pTracksIndex ) );
+
+	for ( Track = 0 ; Track < pStxMain->TracksCount ; Track++ )
+	{
+		pStxTrack = &(pStxMain->pTracksStruct[ Track ]);
+
+		/* If a track appears several times, keep the 1st one (same as a linear search) */
+		if ( pStxMain->pTracksIndex[ pStxTrack->TrackNumber ] == NULL )
+			pStxMain->pTracksIndex[ pStxTrack->TrackNumber ] = pStxTrack;
+
+		pStxTrack->TrackSize_FdcCycles = STX_GetTrackSize ( pStxTrack ) * FDC_DELAY_CYCLE_MFM_BYTE;
+
+		if ( pStxTrack->pSectorsStruct == NULL )
+			continue;
+
+		for ( Sector = 0 ; Sector < pStxTrack->SectorsCount ; Sector++ )
+		{
+			pStxSector = &(pStxTrack->pSectorsStruct[ Sector ]);
+
+			pStxSector->IDPos_FdcCycles = pStxSector->BitPosition * FDC_DELAY_CYCLE_MFM_BIT;	/* 1 bit = 32 cycles at 8 MHz */
+
+			pStxSector->pByteTimings = NULL;
+			if ( ( pStxSector->FDC_Status & STX_SECTOR_FLAG_RNF ) == 0 )
+				if ( ( pStxSector->pTimingData ) || ( pStxSector->ReadTime != 0 ) )
+				{
+					pStxSector->pByteTimings = STX_BuildSectorTimings ( pStxSector );
+					if ( pStxSector->pByteTimings == NULL )
+						return false;
+				}
+		}
+	}
+
+	return true;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Compute the timing of each byte of a sector with non standard timings.
+ * Special care must be taken to compute the timing of each byte, which can
+ * be a decimal value and must be rounded to the best possible integer.
+ * Return an array of SectorSize timings in FDC cycles, or NULL if an
+ * allocation error occurred.
+ */
+static Uint16	*STX_BuildSectorTimings ( STX_SECTOR_STRUCT *pStxSector )
+{
+	Uint16			*pByteTimings;
+	int			i;
+	Uint16			Timing;
+	Uint32			Sector_ReadTime;
+	double			Total_cur;				/* To compute closest integer timings for each byte */
+	double			Total_prev;
+
+	pByteTimings = malloc ( pStxSector->SectorSize * sizeof ( Uint16 ) );
+	if ( !pByteTimings )
+		return NULL;
+
+	Sector_ReadTime = pStxSector->ReadTime;
+	if ( Sector_ReadTime == 0 )					/* Sector has a standard delay (32 us per byte) */
+		Sector_ReadTime = 32 * pStxSector->SectorSize;		/* Use the real standard value instead of 0 */
+	Sector_ReadTime *= 8;						/* Convert delay in us to a number of FDC cycles at 8 MHz */
+
+	Total_prev = 0;
+	for ( i=0 ; i<pStxSector->SectorSize ; i++ )
+	{
+		if ( pStxSector->pTimingData )				/* Specific timing for each block of 16 bytes */
+		{
+			Timing = ( pStxSector->pTimingData[ ( i>>4 ) * 2 ] << 8 )
+				+ pStxSector->pTimingData[ ( i>>4 ) * 2 + 1 ];	/* Get big endian timing for this block of 16 bytes */
+
+			/* [NP] Formula to convert timing data comes from Pasti.prg 0.4b : */
+			/* 1 unit of timing = 32 FDC cycles at 8 MHz + 28 cycles to complete each block of 16 bytes */
+			Timing = Timing * 32 + 28;
+
+			if ( i % 16 == 0 )	Total_prev = 0;		/* New block of 16 bytes */
+			Total_cur = ( (double)Timing * ( ( i % 16 ) + 1 ) ) / 16;
+			Timing = rint ( Total_cur - Total_prev );
+			Total_prev += Timing;
+		}
+		else							/* Specific timing in us for the whole sector */
+		{
+			Total_cur = ( (double)Sector_ReadTime * ( i+1 ) ) / pStxSector->SectorSize;
+			Timing = rint ( Total_cur - Total_prev );
+			Total_prev += Timing;
+		}
+
+		pByteTimings[ i ] = Timing;
+	}
+
+	return pByteTimings;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Return the size of a track in bytes, depending on the available data
+ */
+static Uint32	STX_GetTrackSize ( STX_TRACK_STRUCT *pStxTrack )
+{
+	if ( pStxTrack->pTrackImageData )
+		return pStxTrack->TrackImageSize;
+	else if ( ( pStxTrack->Flags & STX_TRACK_FLAG_SECTOR_BLOCK ) == 0 )
+		return pStxTrack->MFMSize / 8;				/* When the track contains only sector data, MFMSize is in bits */
+	else
+		return pStxTrack->MFMSize;
+}
+
+
 /*-----------------------------------------------------------------------*/
 /**
  * When a track only consists of the content of each 512 bytes sector and
@@ -1390,16 +1541,10 @@ static Uint16	STX_BuildSectorID_CRC ( STX_SECTOR_STRUCT *pStxSector )
  */
 static STX_TRACK_STRUCT	*STX_FindTrack ( Uint8 Drive , Uint8 Track , Uint8 Side )
 {
-	int	i;
-
 	if ( STX_State.ImageBuffer[ Drive ] == NULL )
 		return NULL;
 
-	for ( i=0 ; i<STX_State.ImageBuffer[ Drive ]->TracksCount ; i++ )
-		if ( STX_State.ImageBuffer[ Drive ]->pTracksStruct[ i ].TrackNumber == ( ( Track & 0x7f ) | ( Side << 7 ) ) )
-			return &(STX_State.ImageBuffer[ Drive ]->pTracksStruct[ i ]);
-
-	return NULL;
+	return STX_State.ImageBuffer[ Drive ]->pTracksIndex[ ( Track & 0x7f ) | ( ( Side & 1 ) << 7 ) ];
 }
 
 
@@ -1420,7 +1565,7 @@ static STX_SECTOR_STRUCT	*STX_FindSector ( Uint8 Drive , Uint8 Track , Uint8 Sid
 	if ( pStxTrack == NULL )
 		return NULL;
 
-	if ( pStxTrack->pSectorsStruct == NULL )
+	if ( ( pStxTrack->pSectorsStruct == NULL ) || ( SectorStruct_Nb >= pStxTrack->SectorsCount ) )
 		return NULL;
 
 	return &(pStxTrack->pSectorsStruct[ SectorStruct_Nb ]);
@@ -1432,11 +1577,14 @@ static STX_SECTOR_STRUCT	*STX_FindSector ( Uint8 Drive , Uint8 Track , Uint8 Sid
 /**
  * Find a sector in the floppy image inserted into a drive.
  * The sector is identified by its BitPosition which is unique per track/side
+ * As sectors are sorted using BitPosition, we do a binary search first and
+ * we keep a linear search as a fallback for non sorted tracks.
  */
 static STX_SECTOR_STRUCT	*STX_FindSector_By_Position ( Uint8 Drive , Uint8 Track , Uint8 Side , Uint16 BitPosition )
 {
 	STX_TRACK_STRUCT	*pStxTrack;
 	int			Sector;
+	int			Low , High;
 
 	if ( STX_State.ImageBuffer[ Drive ] == NULL )
 		return NULL;
@@ -1448,6 +1596,19 @@ static STX_SECTOR_STRUCT	*STX_FindSector_By_Position ( Uint8 Drive , Uint8 Track
 	if ( pStxTrack->pSectorsStruct == NULL )
 		return NULL;
 
+	Low = 0;
+	High = pStxTrack->SectorsCount - 1;
+	while ( Low <= High )
+	{
+		Sector = ( Low + High ) / 2;
+		if ( pStxTrack->pSectorsStruct[ Sector ].BitPosition == BitPosition )
+			return &(pStxTrack->pSectorsStruct[ Sector ]);
+		else if ( pStxTrack->pSectorsStruct[ Sector ].BitPosition < BitPosition )
+			Low = Sector + 1;
+		else
+			High = Sector - 1;
+	}
+
 	for ( Sector=0 ; Sector<pStxTrack->SectorsCount ; Sector++ )
 		if ( pStxTrack->pSectorsStruct[ Sector ].BitPosition == BitPosition )
 			return &(pStxTrack->pSectorsStruct[ Sector ]);
@@ -1466,21 +1627,12 @@ static STX_SECTOR_STRUCT	*STX_FindSector_By_Position ( Uint8 Drive , Uint8 Track
 Uint32	FDC_GetCyclesPerRev_FdcCycles_STX ( Uint8 Drive , Uint8 Track , Uint8 Side )
 {
 	STX_TRACK_STRUCT	*pStxTrack;
-	int			TrackSize;
 
 	pStxTrack = STX_FindTrack ( Drive , Track , Side );
 	if ( pStxTrack == NULL )
-		TrackSize =  FDC_TRACK_BYTES_STANDARD;			/* Use a standard track length is track is not available */
-
-	else if ( pStxTrack->pTrackImageData )
-		TrackSize = pStxTrack->TrackImageSize;
-	else if ( ( pStxTrack->Flags & STX_TRACK_FLAG_SECTOR_BLOCK ) == 0 )
-		TrackSize = pStxTrack->MFMSize / 8;		/* When the track contains only sector data, MFMSize is in bits */
-	else
-		TrackSize = pStxTrack->MFMSize;
+		return FDC_TRACK_BYTES_STANDARD * FDC_DELAY_CYCLE_MFM_BYTE;	/* Use a standard track length is track is not available */
 
-//fprintf ( stderr , "fdc stx drive=%d track=0x%x side=%d size=%d\n" , Drive , Track, Side , TrackSize );
-	return TrackSize * FDC_DELAY_CYCLE_MFM_BYTE;
+	return pStxTrack->TrackSize_FdcCycles;
 }
 
 
@@ -1496,16 +1648,17 @@ Uint32	FDC_GetCyclesPerRev_FdcCycles_STX ( Uint8 Drive , Uint8 Track , Uint8 Sid
  * into NextSector_ID_Field_TR, the next sector's length into
  * NextSector_ID_Field_LEN and if the CRC is correct or not into NextSector_ID_Field_CRC_OK.
  * This function assumes the sectors of each track are sorted in ascending order
- * using BitPosition.
+ * using BitPosition, which allows a binary search on the precomputed IDPos_FdcCycles.
  * If there's no available drive/floppy or no ID field in the track, we return -1
  */
 int	FDC_NextSectorID_FdcCycles_STX ( Uint8 Drive , Uint8 NumberOfHeads , Uint8 Track , Uint8 Side )
 {
 	STX_TRACK_STRUCT	*pStxTrack;
+	STX_SECTOR_STRUCT	*pStxSector;
 	int			CurrentPos_FdcCycles;
 	int			i;
+	int			Low , High;
 	int			Delay_FdcCycles;
-	int			TrackSize;
 
 	CurrentPos_FdcCycles = FDC_IndexPulse_GetCurrentPos_FdcCycles ( NULL );
 	if ( CurrentPos_FdcCycles < 0 )					/* No drive/floppy available at the moment */
@@ -1521,43 +1674,41 @@ int	FDC_NextSectorID_FdcCycles_STX ( Uint8 Drive , Uint8 NumberOfHeads , Uint8 T
 	if ( pStxTrack->SectorsCount == 0 )				/* No sector (track image only, or empty / non formatted track) */
 		return -1;
 
-	/* Compare CurrentPos_FdcCycles with each sector's position in ascending order */
-	for ( i=0 ; i<pStxTrack->SectorsCount ; i++ )
+	/* Binary search for the 1st sector whose position is after CurrentPos_FdcCycles */
+	Low = 0;
+	High = pStxTrack->SectorsCount;
+	while ( Low < High )
 	{
-		if ( CurrentPos_FdcCycles < (int)pStxTrack->pSectorsStruct[ i ].BitPosition*FDC_DELAY_CYCLE_MFM_BIT )	/* 1 bit = 32 cycles at 8 MHz */
-			break;						/* We found the next sector */
+		i = ( Low + High ) / 2;
+		if ( CurrentPos_FdcCycles < (int)pStxTrack->pSectorsStruct[ i ].IDPos_FdcCycles )
+			High = i;
+		else
+			Low = i + 1;
 	}
+	i = Low;
 
 	if ( i == pStxTrack->SectorsCount )				/* CurrentPos_FdcCycles is after the last ID Field of this track */
 	{
 		/* Reach end of track (new index pulse), then go to 1st sector from current position */
-		if ( pStxTrack->pTrackImageData )
-			TrackSize = pStxTrack->TrackImageSize;
-		else if ( ( pStxTrack->Flags & STX_TRACK_FLAG_SECTOR_BLOCK ) == 0 )
-			TrackSize = pStxTrack->MFMSize / 8;		/* When the track contains only sector data, MFMSize is in bits */
-		else
-			TrackSize = pStxTrack->MFMSize;
-
-		Delay_FdcCycles = TrackSize * FDC_DELAY_CYCLE_MFM_BYTE - CurrentPos_FdcCycles
-				+ pStxTrack->pSectorsStruct[ 0 ].BitPosition*FDC_DELAY_CYCLE_MFM_BIT;
+		Delay_FdcCycles = pStxTrack->TrackSize_FdcCycles - CurrentPos_FdcCycles
+				+ pStxTrack->pSectorsStruct[ 0 ].IDPos_FdcCycles;
 		STX_State.NextSectorStruct_Nbr = 0;
-//fprintf ( stderr , "size=%d pos=%d pos0=%d delay=%d\n" , TrackSize, CurrentPos_FdcCycles, pStxTrack->pSectorsStruct[ 0 ].BitPosition , Delay_FdcCycles );
 	}
 	else								/* There's an ID Field before end of track */
 	{
-		Delay_FdcCycles = (int)pStxTrack->pSectorsStruct[ i ].BitPosition*FDC_DELAY_CYCLE_MFM_BIT - CurrentPos_FdcCycles;
+		Delay_FdcCycles = (int)pStxTrack->pSectorsStruct[ i ].IDPos_FdcCycles - CurrentPos_FdcCycles;
 		STX_State.NextSectorStruct_Nbr = i;
-//fprintf ( stderr , "i=%d pos=%d posi=%d delay=%d\n" , i, CurrentPos_FdcCycles, pStxTrack->pSectorsStruct[ i ].BitPosition*FDC_DELAY_CYCLE_MFM_BIT , Delay_FdcCycles );
 	}
 
 	/* Store the value of the track/sector numbers in the next ID field */
-	STX_State.NextSector_ID_Field_TR = pStxTrack->pSectorsStruct[ STX_State.NextSectorStruct_Nbr ].ID_Track;
-	STX_State.NextSector_ID_Field_SR = pStxTrack->pSectorsStruct[ STX_State.NextSectorStruct_Nbr ].ID_Sector;
-	STX_State.NextSector_ID_Field_LEN = pStxTrack->pSectorsStruct[ STX_State.NextSectorStruct_Nbr ].ID_Size;
+	pStxSector = &(pStxTrack->pSectorsStruct[ STX_State.NextSectorStruct_Nbr ]);
+	STX_State.NextSector_ID_Field_TR = pStxSector->ID_Track;
+	STX_State.NextSector_ID_Field_SR = pStxSector->ID_Sector;
+	STX_State.NextSector_ID_Field_LEN = pStxSector->ID_Size;
 
 	/* If RNF is set and CRC error is set, then this ID field has a CRC error */
-	if ( ( pStxTrack->pSectorsStruct[ STX_State.NextSectorStruct_Nbr ].FDC_Status & STX_SECTOR_FLAG_RNF )
-	  && ( pStxTrack->pSectorsStruct[ STX_State.NextSectorStruct_Nbr ].FDC_Status & STX_SECTOR_FLAG_CRC ) )
+	if ( ( pStxSector->FDC_Status & STX_SECTOR_FLAG_RNF )
+	  && ( pStxSector->FDC_Status & STX_SECTOR_FLAG_CRC ) )
 		STX_State.NextSector_ID_Field_CRC_OK = 0;		/* CRC bad */
 	else
 		STX_State.NextSector_ID_Field_CRC_OK = 1;		/* CRC correct */
@@ -1624,8 +1775,7 @@ Uint8	FDC_NextSectorID_CRC_OK_STX ( void )
  * Each byte of the sector is added to the FDC buffer with a default timing
  * (32 microsec) or a variable timing, depending on the sector's flags.
  * Some sectors can also contains "fuzzy" bits.
- * Special care must be taken to compute the timing of each byte, which can
- * be a decimal value and must be rounded to the best possible integer.
+ * Variable timings for each byte were precomputed in STX_BuildTracksIndex().
  *
  * If the sector's data were changed by a 'write sector' command, then we assume
  * a sector with no fuzzy byte and standard timings.
@@ -1638,10 +1788,7 @@ Uint8	FDC_ReadSector_STX ( Uint8 Drive , Uint8 Track , Uint8 Sector , Uint8 Side
 	STX_SECTOR_STRUCT	*pStxSector;
 	int			i;
 	Uint8			Byte;
-	Uint16			Timing;
-	Uint32			Sector_ReadTime;
-	double			Total_cur;				/* To compute closest integer timings for each byte */
-	double			Total_prev;
+	Uint16			*pByteTimings;
 	Uint8			*pSector_WriteData;
 
 	pStxSector = STX_FindSector ( Drive , Track , Side , STX_State.NextSectorStruct_Nbr );
@@ -1657,14 +1804,14 @@ Uint8	FDC_ReadSector_STX ( Uint8 Drive , Uint8 Track , Uint8 Sector , Uint8 Side
 		return STX_SECTOR_FLAG_RNF;				/* RNF in FDC's status register */
 
 	*pSectorSize = pStxSector->SectorSize;
-	Sector_ReadTime = pStxSector->ReadTime;
+	pByteTimings = pStxSector->pByteTimings;
 
 	/* Check if this sector was changed by a 'write sector' command */
 	/* If so, we use this recent buffer instead of the original STX content */
 	if (STX_SaveStruct[Drive].SaveSectorsCount > 0 && pStxSector->SaveSectorIndex >= 0)
 	{
 		pSector_WriteData = STX_SaveStruct[ Drive ].pSaveSectorsStruct[ pStxSector->SaveSectorIndex ].pData;
-		Sector_ReadTime = 0;					/* Standard timings */
+		pByteTimings = NULL;					/* Standard timings */
 
 		LOG_TRACE(TRACE_FDC, "fdc stx read sector drive=%d track=%d sect=%d side=%d using saved sector=%d\n" ,
 			Drive, Track, Sector, Side , pStxSector->SaveSectorIndex );
@@ -1672,11 +1819,6 @@ Uint8	FDC_ReadSector_STX ( Uint8 Drive , Uint8 Track , Uint8 Sector , Uint8 Side
 	else
 		pSector_WriteData = NULL;
 
-	if ( Sector_ReadTime == 0 )					/* Sector has a standard delay (32 us per byte) */
-		Sector_ReadTime = 32 * pStxSector->SectorSize;		/* Use the real standard value instead of 0 */
-	Sector_ReadTime *= 8;						/* Convert delay in us to a number of FDC cycles at 8 MHz */
-
-	Total_prev = 0;
 	for ( i=0 ; i<pStxSector->SectorSize ; i++ )
 	{
 		/* Get the value of each byte, with possible fuzzy bits */
@@ -1690,31 +1832,12 @@ Uint8	FDC_ReadSector_STX ( Uint8 Drive , Uint8 Track , Uint8 Sector , Uint8 Side
 		else							/* Use data from 'write sector' */
 			Byte = pSector_WriteData[ i ];
 
-		/* Compute the timing in FDC cycles to transfer this byte */
-		if ( ( pStxSector->pTimingData )			/* Specific timing for each block of 16 bytes */
-		  && ( pSector_WriteData == NULL ) )
-		{
-			Timing = ( pStxSector->pTimingData[ ( i>>4 ) * 2 ] << 8 )
-				+ pStxSector->pTimingData[ ( i>>4 ) * 2 + 1 ];	/* Get big endian timing for this block of 16 bytes */
-
-			/* [NP] Formula to convert timing data comes from Pasti.prg 0.4b : */
-			/* 1 unit of timing = 32 FDC cycles at 8 MHz + 28 cycles to complete each block of 16 bytes */
-			Timing = Timing * 32 + 28;
-
-			if ( i % 16 == 0 )	Total_prev = 0;		/* New block of 16 bytes */
-			Total_cur = ( (double)Timing * ( ( i % 16 ) + 1 ) ) / 16;
-			Timing = rint ( Total_cur - Total_prev );
-			Total_prev += Timing;
-		}
-		else							/* Specific timing in us for the whole sector */
-		{
-			Total_cur = ( (double)Sector_ReadTime * ( i+1 ) ) / pStxSector->SectorSize;
-			Timing = rint ( Total_cur - Total_prev );
-			Total_prev += Timing;
-		}
-
 		/* Add the Byte to the buffer, Timing should be a number of FDC cycles at 8 MHz */
-		FDC_Buffer_Add_Timing ( Byte , Timing );
+		/* (standard delay is 32 us per byte) */
+		if ( pByteTimings )
+			FDC_Buffer_Add_Timing ( Byte , pByteTimings[ i ] );
+		else
+			FDC_Buffer_Add_Timing ( Byte , FDC_DELAY_CYCLE_MFM_BYTE );
 	}
 
 	/* Return only bits 3 and 5 of the FDC_Status */
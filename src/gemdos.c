@@ -784,6 +784,19 @@ void GemDOS_MemorySnapShot_Capture(bool bSave)
 	int i;
 	bool bEmudrivesAvailable;
 
+	/* Lightweight snapshots keep the emulated drives and open files */
+	if (MemorySnapShot_IsLight())
+	{
+		MemorySnapShot_Store(&DTAIndex,sizeof(DTAIndex));
+		MemorySnapShot_Store(&bInitGemDOS,sizeof(bInitGemDOS));
+		MemorySnapShot_Store(&act_pd, sizeof(act_pd));
+		MemorySnapShot_Store(&DTA_Gemdos, sizeof(DTA_Gemdos));
+		if (!bSave)
+			pDTA = DTA_Gemdos ? (DTA *)STMemory_STAddrToPointer(DTA_Gemdos) : NULL;
+		MemorySnapShot_Store(&CurrentDrive,sizeof(CurrentDrive));
+		return;
+	}
+
 	/* Save/Restore the emudrives structure */
 	bEmudrivesAvailable = (emudrives != NULL);
 	MemorySnapShot_Store(&bEmudrivesAvailable, sizeof(bEmudrivesAvailable));
@@ -15,6 +15,7 @@ const char SDLGui_fileid[] = "Hatari sdlgui.c : " __DATE__ " " __TIME__;
 #include <assert.h>
 
 #include "main.h"
+#include "configuration.h"
 #include "screen.h"
 #include "sdlgui.h"
 #include "str.h"
@@ -1137,6 +1138,13 @@ int SDLGui_DoDialog(SGOBJ *dlg, SDL_Event *pEventOut, bool KeepCurrentObject)
 	if ( !KeepCurrentObject )
 		current_object = 0;
 
+	/* Nobody could answer the dialog without a window */
+	if (ConfigureParams.Screen.nVideoBackend == VIDEO_BACKEND_NONE)
+	{
+		fprintf(stderr, "No video output, can't show dialog!\n");
+		return SDLGUI_ERROR;
+	}
+
 	if (pSdlGuiScrn->h / sdlgui_fontheight < dlg[0].h)
 	{
 		fprintf(stderr, "Screen size too small for dialog!\n");
@@ -10,13 +10,16 @@
 
 #include "main.h"
 #include "hd6301_cpu.h"
+#include "log.h"
+#include "memorySnapShot.h"
 
 
 /**********************************
  *	Defines
  **********************************/
-#define HD6301_DISASM 		1
-#define HD6301_DISPLAY_REGS	1
+/* Uncomment to trace all the executed instructions */
+/* #define HD6301_DISASM 		1 */
+/* #define HD6301_DISPLAY_REGS	1 */
 
 /* HD6301 Disasm and debug code */
 #define HD6301_DISASM_UNDEFINED		0
@@ -68,6 +71,13 @@
 static Uint8 hd6301_read_memory(Uint16 addr);
 static void hd6301_write_memory (Uint16 addr, Uint8 value);
 static Uint16 hd6301_get_memory_ext(void);
+static Uint8 hd6301_read_register(Uint8 addr);
+static void hd6301_write_register(Uint8 addr, Uint8 value);
+static void hd6301_check_idle_loop(void);
+static int hd6301_next_event(void);
+static void hd6301_update_timers(int cycles);
+static int hd6301_check_interrupts(void);
+static int hd6301_interrupt(Uint16 vector);
 
 /* HD6301 opcodes functions */
 static void hd6301_undefined(void);
@@ -587,33 +597,113 @@ static struct hd6301_opcode_t hd6301_opcode_table[256] = {
 
 
 /* Variables */
-static Uint8	hd6301_cycles;
+static int	hd6301_cycles;			/* Cycles used by the last instruction */
 static Uint8	hd6301_cur_inst;
 
-static Sint8	hd6301_reg_A; 
-static Sint8	hd6301_reg_B;
-static Sint16	hd6301_reg_X;
+static Uint8	hd6301_reg_A; 
+static Uint8	hd6301_reg_B;
+static Uint16	hd6301_reg_X;
 static Uint16	hd6301_reg_SP;
 static Uint16	hd6301_reg_PC;
 static Uint8	hd6301_reg_CCR;
 
-//Uint8	hd6301_reg_RMCR;
-
 static Uint8	hd6301_intREG[32];
 static Uint8	hd6301_intRAM[128];
 static Uint8	hd6301_intROM[4096];
 
+/* Timer, SCI and low power modes */
+static Uint16	hd6301_frc;			/* Free running counter */
+static Uint8	hd6301_frc_latch;		/* FRC low byte, latched when reading FRC high byte */
+static Uint8	hd6301_tcsr_read;		/* TCSR flags that were set when TCSR was last read */
+static int	hd6301_sci_tx_cycles;		/* Cycles until TDR is empty again, 0 if transmitter is idle */
+static int	hd6301_wait_state;		/* HD6301_STATE_xxx */
+static int	hd6301_cycles_left;		/* Cycles still to run, <0 if last instruction ran past the end */
+
+#define	HD6301_STATE_RUNNING	0
+#define	HD6301_STATE_WAI	1		/* Registers are stacked, waiting for an interrupt */
+#define	HD6301_STATE_SLP	2		/* Sleeping until an interrupt */
+
+/* Idle loop detection : each time we jump backward, we compare the registers
+ * with the ones from the previous visit of the same address. If they are the
+ * same and nothing changed in the meantime (RAM, internal registers, inputs),
+ * the next iterations will do exactly the same until some timer event happens,
+ * so we can skip the time until this event instead of running the loop.
+ */
+typedef struct {
+	Uint16	PC;
+	Uint16	X;
+	Uint16	SP;
+	Uint8	A;
+	Uint8	B;
+	Uint8	CCR;
+	Uint32	StateChanges;
+} HD6301_LOOP;
+
+#define	HD6301_LOOPS_NB		8		/* Must be a power of 2 */
+
+static HD6301_LOOP	hd6301_loops[HD6301_LOOPS_NB];
+static Uint32	hd6301_state_changes;		/* Incremented each time the state changes in an observable way */
+static bool	hd6301_idle;			/* True when running an idle loop */
+
+/* Callbacks to connect the ports and the SCI to the outside world */
+Uint8	(*hd6301_read_port)(int port) = NULL;
+void	(*hd6301_sci_transmit)(Uint8 value) = NULL;
+
 
 /**********************************
  *	Emulator kernel
  **********************************/
 
+/**
+ * Something observable changed, the current loop is not idle
+ */
+static void hd6301_state_changed(void)
+{
+	hd6301_state_changes++;
+	hd6301_idle = false;
+}
+
 /**
  * Initialise hd6301 cpu
  */
 void hd6301_init_cpu(void)
 {
-	hd6301_reg_CCR = 0xc0;
+	memset(hd6301_intRAM, 0, sizeof(hd6301_intRAM));
+	hd6301_reset_cpu();
+}
+
+/**
+ * Reset hd6301 cpu : set the internal registers to their default values
+ * and jump to the reset vector. RAM content is kept.
+ */
+void hd6301_reset_cpu(void)
+{
+	memset(hd6301_intREG, 0, sizeof(hd6301_intREG));
+	hd6301_intREG[HD6301_REG_OCRH] = 0xff;
+	hd6301_intREG[HD6301_REG_OCRL] = 0xff;
+	hd6301_intREG[HD6301_REG_TRCSR] = HD6301_TRCSR_TDRE;
+
+	hd6301_frc = 0;
+	hd6301_frc_latch = 0;
+	hd6301_tcsr_read = 0;
+	hd6301_sci_tx_cycles = 0;
+	hd6301_wait_state = HD6301_STATE_RUNNING;
+	hd6301_cycles_left = 0;
+
+	hd6301_reg_CCR = 0xc0 | (1 << hd6301_REG_CCR_I);
+	hd6301_reg_PC = hd6301_read_memory(0xfffe) << 8;
+	hd6301_reg_PC += hd6301_read_memory(0xffff);
+
+	memset(hd6301_loops, 0, sizeof(hd6301_loops));
+	hd6301_state_changed();
+}
+
+/**
+ * Copy a 4 KB image into the internal ROM at $F000-$FFFF
+ */
+void hd6301_load_rom(const Uint8 *pRom)
+{
+	memcpy(hd6301_intROM, pRom, sizeof(hd6301_intROM));
 }
 
 /**
@@ -621,10 +711,14 @@ void hd6301_init_cpu(void)
  */
 void hd6301_execute_one_instruction(void)
 {
+	Uint16 pc = hd6301_reg_PC;
+	int cycles;
+
 	hd6301_cur_inst = hd6301_read_memory(hd6301_reg_PC);
 
 	/* Get opcode to execute */
 	hd6301_opcode = hd6301_opcode_table[hd6301_cur_inst];
+	hd6301_cycles = hd6301_opcode.op_n_cycles;
 
 	/* disasm opcode ? */
 #ifdef HD6301_DISASM
@@ -637,17 +731,358 @@ void hd6301_execute_one_instruction(void)
 	hd6301_display_registers();
 #endif
 
-	/* Increment instruction cycles */
-	hd6301_cycles += hd6301_opcode.op_n_cycles;
-
 	/* Increment PC register */
 	hd6301_reg_PC += hd6301_opcode.op_bytes;
 
+	/* Jumping backward could be an idle loop */
+	if (hd6301_opcode.op_bytes == 0 && hd6301_reg_PC <= pc)
+		hd6301_check_idle_loop();
+
+	/* post process timers and SCI */
+	hd6301_update_timers(hd6301_cycles);
+
 	/* post process interrupts */
+	cycles = hd6301_check_interrupts();
+	if (cycles)
+	{
+		hd6301_update_timers(cycles);
+		hd6301_cycles += cycles;
+	}
+}
 
-	/* post process timers */
+/**
+ * Run the hd6301 for the given number of cycles. If the cpu is idle or
+ * waiting for an interrupt, we directly skip to the next timer event.
+ * Extra cycles used by the last instruction are taken from the next call.
+ */
+void hd6301_run_cycles(int nCycles)
+{
+	int cycles;
 
-	/* post process SCI */
+	hd6301_cycles_left += nCycles;
+
+	while (hd6301_cycles_left > 0)
+	{
+		if (hd6301_idle || hd6301_wait_state != HD6301_STATE_RUNNING)
+		{
+			cycles = hd6301_next_event();
+			if (cycles > hd6301_cycles_left)
+				cycles = hd6301_cycles_left;
+			hd6301_update_timers(cycles);
+			hd6301_cycles_left -= cycles;
+
+			cycles = hd6301_check_interrupts();
+			if (cycles)
+			{
+				hd6301_update_timers(cycles);
+				hd6301_cycles_left -= cycles;
+			}
+			continue;
+		}
+
+		hd6301_execute_one_instruction();
+		hd6301_cycles_left -= hd6301_cycles;
+	}
+}
+
+/**
+ * Compare the state at the start of a loop with the previous iteration
+ */
+static void hd6301_check_idle_loop(void)
+{
+	HD6301_LOOP *pLoop = &hd6301_loops[hd6301_reg_PC & (HD6301_LOOPS_NB-1)];
+
+	if (pLoop->PC == hd6301_reg_PC && pLoop->StateChanges == hd6301_state_changes
+	    && pLoop->A == hd6301_reg_A && pLoop->B == hd6301_reg_B && pLoop->X == hd6301_reg_X
+	    && pLoop->SP == hd6301_reg_SP && pLoop->CCR == hd6301_reg_CCR)
+	{
+		hd6301_idle = true;
+		return;
+	}
+
+	pLoop->PC = hd6301_reg_PC;
+	pLoop->StateChanges = hd6301_state_changes;
+	pLoop->A = hd6301_reg_A;
+	pLoop->B = hd6301_reg_B;
+	pLoop->X = hd6301_reg_X;
+	pLoop->SP = hd6301_reg_SP;
+	pLoop->CCR = hd6301_reg_CCR;
+}
+
+/**
+ * Return the number of cycles until the next timer or SCI event
+ * that could change the flags seen by the program
+ */
+static int hd6301_next_event(void)
+{
+	Uint16	ocr;
+	int	cycles;
+
+	ocr = (hd6301_intREG[HD6301_REG_OCRH] << 8) | hd6301_intREG[HD6301_REG_OCRL];
+	cycles = (Uint16)(ocr - hd6301_frc);
+	if (cycles == 0)
+		cycles = 0x10000;
+	if (0x10000 - hd6301_frc < cycles)
+		cycles = 0x10000 - hd6301_frc;
+	if (hd6301_sci_tx_cycles > 0 && hd6301_sci_tx_cycles < cycles)
+		cycles = hd6301_sci_tx_cycles;
+	return cycles;
+}
+
+/**
+ * Update the free running counter and the SCI transmitter
+ * (at most 0x10000 cycles at once)
+ */
+static void hd6301_update_timers(int cycles)
+{
+	Uint16	ocr;
+	Uint8	tcsr, trcsr;
+
+	tcsr = hd6301_intREG[HD6301_REG_TCSR];
+	trcsr = hd6301_intREG[HD6301_REG_TRCSR];
+
+	/* Output compare : FRC reaches OCR during these cycles */
+	ocr = (hd6301_intREG[HD6301_REG_OCRH] << 8) | hd6301_intREG[HD6301_REG_OCRL];
+	if ((Uint16)(ocr - hd6301_frc - 1) < cycles)
+		tcsr |= HD6301_TCSR_OCF;
+
+	/* Timer overflow */
+	if (hd6301_frc + cycles > 0xffff)
+		tcsr |= HD6301_TCSR_TOF;
+	hd6301_frc += cycles;
+
+	/* Transmitter : TDR is empty again when the byte was shifted out */
+	if (hd6301_sci_tx_cycles > 0)
+	{
+		hd6301_sci_tx_cycles -= cycles;
+		if (hd6301_sci_tx_cycles <= 0)
+		{
+			hd6301_sci_tx_cycles = 0;
+			trcsr |= HD6301_TRCSR_TDRE;
+		}
+	}
+
+	if (tcsr != hd6301_intREG[HD6301_REG_TCSR] || trcsr != hd6301_intREG[HD6301_REG_TRCSR])
+	{
+		hd6301_intREG[HD6301_REG_TCSR] = tcsr;
+		hd6301_intREG[HD6301_REG_TRCSR] = trcsr;
+		hd6301_state_changed();
+	}
+}
+
+/**
+ * Check for pending maskable interrupts (in priority order) and take one.
+ * Return the number of cycles used, or 0 if no interrupt was taken.
+ */
+static int hd6301_check_interrupts(void)
+{
+	Uint8	tcsr, trcsr;
+	Uint16	vector;
+
+	if (hd6301_reg_CCR & (1 << hd6301_REG_CCR_I))
+		return 0;
+
+	tcsr = hd6301_intREG[HD6301_REG_TCSR];
+	trcsr = hd6301_intREG[HD6301_REG_TRCSR];
+
+	if ((tcsr & HD6301_TCSR_ICF) && (tcsr & HD6301_TCSR_EICI))
+		vector = 0xfff6;
+	else if ((tcsr & HD6301_TCSR_OCF) && (tcsr & HD6301_TCSR_EOCI))
+		vector = 0xfff4;
+	else if ((tcsr & HD6301_TCSR_TOF) && (tcsr & HD6301_TCSR_ETOI))
+		vector = 0xfff2;
+	else if (((trcsr & (HD6301_TRCSR_RDRF | HD6301_TRCSR_ORFE)) && (trcsr & HD6301_TRCSR_RIE))
+	         || ((trcsr & HD6301_TRCSR_TDRE) && (trcsr & HD6301_TRCSR_TIE)))
+		vector = 0xfff0;
+	else
+		return 0;
+
+	return hd6301_interrupt(vector);
+}
+
+/**
+ * Stack the registers (unless WAI already did it) and jump to an
+ * interrupt vector. Return the number of cycles used.
+ */
+static int hd6301_interrupt(Uint16 vector)
+{
+	if (hd6301_wait_state != HD6301_STATE_WAI)
+	{
+		hd6301_write_memory(hd6301_reg_SP--, hd6301_reg_PC & 0xff);
+		hd6301_write_memory(hd6301_reg_SP--, hd6301_reg_PC >> 8);
+		hd6301_write_memory(hd6301_reg_SP--, hd6301_reg_X & 0xff);
+		hd6301_write_memory(hd6301_reg_SP--, hd6301_reg_X >> 8);
+		hd6301_write_memory(hd6301_reg_SP--, hd6301_reg_A);
+		hd6301_write_memory(hd6301_reg_SP--, hd6301_reg_B);
+		hd6301_write_memory(hd6301_reg_SP--, hd6301_reg_CCR);
+	}
+	hd6301_wait_state = HD6301_STATE_RUNNING;
+
+	hd6301_reg_CCR |= 1 << hd6301_REG_CCR_I;
+	hd6301_reg_PC = hd6301_read_memory(vector) << 8;
+	hd6301_reg_PC += hd6301_read_memory(vector+1);
+
+	hd6301_state_changed();
+	return 12;
+}
+
+/**
+ * Receive a byte on the SCI. If RDR was not read yet, the byte is lost
+ * and the overrun flag is set.
+ */
+void hd6301_sci_receive(Uint8 value)
+{
+	if ((hd6301_intREG[HD6301_REG_TRCSR] & HD6301_TRCSR_RE) == 0)
+		return;
+
+	if (hd6301_intREG[HD6301_REG_TRCSR] & HD6301_TRCSR_RDRF)
+		hd6301_intREG[HD6301_REG_TRCSR] |= HD6301_TRCSR_ORFE;
+	else
+	{
+		hd6301_intREG[HD6301_REG_RDR] = value;
+		hd6301_intREG[HD6301_REG_TRCSR] |= HD6301_TRCSR_RDRF;
+	}
+	hd6301_state_changed();
+}
+
+/**
+ * Called when the values returned by hd6301_read_port() changed
+ */
+void hd6301_input_changed(void)
+{
+	hd6301_state_changed();
+}
+
+/**
+ * Return the value output on a port, inputs are pulled high
+ */
+Uint8 hd6301_get_port_output(int port)
+{
+	static const Uint8 ddr_reg[] = { HD6301_REG_DDR1, HD6301_REG_DDR2, HD6301_REG_DDR3, HD6301_REG_DDR4 };
+	static const Uint8 data_reg[] = { HD6301_REG_PORT1, HD6301_REG_PORT2, HD6301_REG_PORT3, HD6301_REG_PORT4 };
+	Uint8 ddr = hd6301_intREG[ddr_reg[port-1]];
+
+	return (hd6301_intREG[data_reg[port-1]] & ddr) | ~ddr;
+}
+
+/**
+ * Read a port : output bits come from the data register, input bits
+ * from the outside world
+ */
+static Uint8 hd6301_read_port_data(int port, Uint8 ddr_reg, Uint8 data_reg)
+{
+	Uint8 ddr = hd6301_intREG[ddr_reg];
+	Uint8 input = hd6301_read_port ? hd6301_read_port(port) : 0xff;
+
+	return (hd6301_intREG[data_reg] & ddr) | (input & ~ddr);
+}
+
+/**
+ * Read an internal register, handling the side effects
+ */
+static Uint8 hd6301_read_register(Uint8 addr)
+{
+	Uint8 value = hd6301_intREG[addr];
+
+	switch (addr) {
+		case HD6301_REG_PORT1:
+			return hd6301_read_port_data(1, HD6301_REG_DDR1, HD6301_REG_PORT1);
+		case HD6301_REG_PORT2:
+			/* Bits 5-7 are the operating mode (7 = single chip) */
+			return hd6301_read_port_data(2, HD6301_REG_DDR2, HD6301_REG_PORT2) | 0xe0;
+		case HD6301_REG_PORT3:
+			return hd6301_read_port_data(3, HD6301_REG_DDR3, HD6301_REG_PORT3);
+		case HD6301_REG_PORT4:
+			return hd6301_read_port_data(4, HD6301_REG_DDR4, HD6301_REG_PORT4);
+
+		case HD6301_REG_TCSR:
+			if (hd6301_tcsr_read != (value & 0xe0)) {
+				hd6301_tcsr_read = value & 0xe0;
+				hd6301_state_changed();
+			}
+			return value;
+		case HD6301_REG_FRCH:
+			/* Clear TOF after TCSR was read */
+			if (hd6301_tcsr_read & HD6301_TCSR_TOF) {
+				hd6301_intREG[HD6301_REG_TCSR] &= ~HD6301_TCSR_TOF;
+				hd6301_tcsr_read &= ~HD6301_TCSR_TOF;
+			}
+			hd6301_frc_latch = hd6301_frc & 0xff;
+			hd6301_state_changed();
+			return hd6301_frc >> 8;
+		case HD6301_REG_FRCL:
+			return hd6301_frc_latch;
+		case HD6301_REG_ICRH:
+			if (hd6301_tcsr_read & HD6301_TCSR_ICF) {
+				hd6301_intREG[HD6301_REG_TCSR] &= ~HD6301_TCSR_ICF;
+				hd6301_tcsr_read &= ~HD6301_TCSR_ICF;
+				hd6301_state_changed();
+			}
+			return value;
+
+		case HD6301_REG_RDR:
+			if (hd6301_intREG[HD6301_REG_TRCSR] & (HD6301_TRCSR_RDRF | HD6301_TRCSR_ORFE)) {
+				hd6301_intREG[HD6301_REG_TRCSR] &= ~(HD6301_TRCSR_RDRF | HD6301_TRCSR_ORFE);
+				hd6301_state_changed();
+			}
+			return value;
+	}
+
+	return value;
+}
+
+/**
+ * Write an internal register, handling the side effects
+ */
+static void hd6301_write_register(Uint8 addr, Uint8 value)
+{
+	static const int sci_bit_cycles[] = { 16, 128, 1024, 4096 };
+
+	switch (addr) {
+		case HD6301_REG_TCSR:
+			/* Flags are read only */
+			value = (hd6301_intREG[addr] & 0xe0) | (value & 0x1f);
+			break;
+		case HD6301_REG_FRCH:
+			/* Any write to the counter presets it to $FFF8 */
+			hd6301_frc = 0xfff8;
+			hd6301_state_changed();
+			return;
+		case HD6301_REG_FRCL:
+		case HD6301_REG_ICRH:
+		case HD6301_REG_ICRL:
+		case HD6301_REG_RDR:
+			return;
+		case HD6301_REG_OCRH:
+		case HD6301_REG_OCRL:
+			/* Clear OCF after TCSR was read */
+			if (hd6301_tcsr_read & HD6301_TCSR_OCF) {
+				hd6301_intREG[HD6301_REG_TCSR] &= ~HD6301_TCSR_OCF;
+				hd6301_tcsr_read &= ~HD6301_TCSR_OCF;
+				hd6301_state_changed();
+			}
+			break;
+		case HD6301_REG_TRCSR:
+			/* Flags are read only */
+			value = (hd6301_intREG[addr] & 0xe0) | (value & 0x1f);
+			break;
+		case HD6301_REG_TDR:
+			hd6301_intREG[addr] = value;
+			hd6301_intREG[HD6301_REG_TRCSR] &= ~HD6301_TRCSR_TDRE;
+			if (hd6301_intREG[HD6301_REG_TRCSR] & HD6301_TRCSR_TE) {
+				if (hd6301_sci_transmit)
+					hd6301_sci_transmit(value);
+				/* 1 start bit, 8 data bits, 1 stop bit */
+				hd6301_sci_tx_cycles = 10 * sci_bit_cycles[hd6301_intREG[HD6301_REG_RMCR] & 3];
+			}
+			hd6301_state_changed();
+			return;
+	}
+
+	if (hd6301_intREG[addr] != value) {
+		hd6301_intREG[addr] = value;
+		hd6301_state_changed();
+	}
 }
 
 /**
@@ -657,7 +1092,7 @@ static Uint8 hd6301_read_memory(Uint16 addr)
 {
 	/* Internal registers */
 	if (addr <= 0x1f) {
-		return hd6301_intREG[addr];
+		return hd6301_read_register(addr);
 	}
 
 	/* Internal RAM */
@@ -670,8 +1105,8 @@ static Uint8 hd6301_read_memory(Uint16 addr)
 		return hd6301_intROM[addr-0xf000];
 	}
 
-	fprintf(stderr, "hd6301: 0x%04x: 0x%04x illegal memory address\n", hd6301_reg_PC, addr);
-	exit(-1);
+	LOG_TRACE(TRACE_IKBD_EXEC, "hd6301: 0x%04x: 0x%04x illegal memory address\n", hd6301_reg_PC, addr);
+	return 0xff;
 }
 
 /**
@@ -681,23 +1116,25 @@ static void hd6301_write_memory (Uint16 addr, Uint8 value)
 {
 	/* Internal registers */
 	if (addr <= 0x1f) {
-		hd6301_intREG[addr] = value;
+		hd6301_write_register(addr, value);
 	}
 
 	/* Internal RAM */
 	else if ((addr >= 0x80) && (addr <= 0xff)) {
-		hd6301_intRAM[addr-0x80] = value;
+		if (hd6301_intRAM[addr-0x80] != value) {
+			hd6301_intRAM[addr-0x80] = value;
+			hd6301_state_changed();
+		}
 	}
 
 	/* Internal ROM */
 	else if (addr >= 0xf000) {
-		fprintf(stderr, "hd6301: 0x%04x: attempt to write to rom\n", addr);
+		LOG_TRACE(TRACE_IKBD_EXEC, "hd6301: 0x%04x: attempt to write to rom\n", addr);
 	}
 
 	/* Illegal address */
 	else {
-		fprintf(stderr, "hd6301: 0x%04x: write to illegal address\n", addr);
-		exit(-1);
+		LOG_TRACE(TRACE_IKBD_EXEC, "hd6301: 0x%04x: write to illegal address\n", addr);
 	}
 }
 
@@ -714,12 +1151,41 @@ static Uint16 hd6301_get_memory_ext(void)
 }
 
 /**
- * Undefined opcode
+ * Save/Restore snapshot of local variables
+ * ('MemorySnapShot_Store' handles type)
+ */
+void hd6301_MemorySnapShot_Capture(bool bSave)
+{
+	MemorySnapShot_Store(&hd6301_reg_A, sizeof(hd6301_reg_A));
+	MemorySnapShot_Store(&hd6301_reg_B, sizeof(hd6301_reg_B));
+	MemorySnapShot_Store(&hd6301_reg_X, sizeof(hd6301_reg_X));
+	MemorySnapShot_Store(&hd6301_reg_SP, sizeof(hd6301_reg_SP));
+	MemorySnapShot_Store(&hd6301_reg_PC, sizeof(hd6301_reg_PC));
+	MemorySnapShot_Store(&hd6301_reg_CCR, sizeof(hd6301_reg_CCR));
+	MemorySnapShot_Store(hd6301_intREG, sizeof(hd6301_intREG));
+	MemorySnapShot_Store(hd6301_intRAM, sizeof(hd6301_intRAM));
+	MemorySnapShot_Store(&hd6301_frc, sizeof(hd6301_frc));
+	MemorySnapShot_Store(&hd6301_frc_latch, sizeof(hd6301_frc_latch));
+	MemorySnapShot_Store(&hd6301_tcsr_read, sizeof(hd6301_tcsr_read));
+	MemorySnapShot_Store(&hd6301_sci_tx_cycles, sizeof(hd6301_sci_tx_cycles));
+	MemorySnapShot_Store(&hd6301_wait_state, sizeof(hd6301_wait_state));
+	MemorySnapShot_Store(&hd6301_cycles_left, sizeof(hd6301_cycles_left));
+
+	if (!bSave)
+	{
+		memset(hd6301_loops, 0, sizeof(hd6301_loops));
+		hd6301_state_changed();
+	}
+}
+
+/**
+ * Undefined opcode : trap
  */
 static void hd6301_undefined(void)
 {
-	fprintf(stderr, "hd6301: 0x%04x: 0x%02x unknown instruction\n", hd6301_reg_PC, hd6301_cur_inst);
-	exit(-1);  /* TODO: Trap the error correctly */
+	LOG_TRACE(TRACE_IKBD_EXEC, "hd6301: 0x%04x: 0x%02x unknown instruction\n", hd6301_reg_PC, hd6301_cur_inst);
+
+	hd6301_cycles += hd6301_interrupt(0xffee);
 }
 
 /**
@@ -985,7 +1451,27 @@ static void hd6301_xgdx(void)
  */
 static void hd6301_daa(void)
 {
-	/* Todo */
+	Uint8  msn, lsn;
+	Uint16 result, correction = 0;
+
+	msn = hd6301_reg_A & 0xf0;
+	lsn = hd6301_reg_A & 0x0f;
+
+	if ((lsn > 0x09) || (hd6301_reg_CCR & (1 << hd6301_REG_CCR_H)))
+		correction |= 0x06;
+	if ((msn > 0x80) && (lsn > 0x09))
+		correction |= 0x60;
+	if ((msn > 0x90) || (hd6301_reg_CCR & (1 << hd6301_REG_CCR_C)))
+		correction |= 0x60;
+
+	result = correction + hd6301_reg_A;
+
+	/* C is kept if it was already set */
+	HD6301_CLR_NZV;
+	HD6301_SET_NZ8(result);
+	HD6301_SET_C8(result);
+
+	hd6301_reg_A = result;
 }
 
 /**
@@ -996,7 +1482,7 @@ static void hd6301_daa(void)
  */
 static void hd6301_slp(void)
 {
-	/* Todo */
+	hd6301_wait_state = HD6301_STATE_SLP;
 }
 
 /**
@@ -1499,7 +1985,16 @@ static void hd6301_mul(void)
  */
 static void hd6301_wai(void)
 {
-	/* Todo */
+	hd6301_write_memory(hd6301_reg_SP--, (hd6301_reg_PC+1) & 0xff);
+	hd6301_write_memory(hd6301_reg_SP--, (hd6301_reg_PC+1) >> 8);
+	hd6301_write_memory(hd6301_reg_SP--, hd6301_reg_X & 0xff);
+	hd6301_write_memory(hd6301_reg_SP--, hd6301_reg_X >> 8);
+	hd6301_write_memory(hd6301_reg_SP--, hd6301_reg_A);
+	hd6301_write_memory(hd6301_reg_SP--, hd6301_reg_B);
+	hd6301_write_memory(hd6301_reg_SP--, hd6301_reg_CCR);
+
+	hd6301_reg_PC += 1;
+	hd6301_wait_state = HD6301_STATE_WAI;
 }
 
 /**
@@ -1672,7 +2167,7 @@ static void hd6301_deca(void)
 {
 	Uint8 overflow;
 
-	overflow = (hd6301_reg_A == (Sint8)0x80) << hd6301_REG_CCR_V;
+	overflow = (hd6301_reg_A == 0x80) << hd6301_REG_CCR_V;
 	-- hd6301_reg_A;
 
 	HD6301_CLR_NZV;
@@ -1870,7 +2365,7 @@ static void hd6301_decb(void)
 {
 	Uint8 overflow;
 
-	overflow = (hd6301_reg_B == (Sint8)0x80) << hd6301_REG_CCR_V;
+	overflow = (hd6301_reg_B == 0x80) << hd6301_REG_CCR_V;
 	-- hd6301_reg_B;
 
 	HD6301_CLR_NZV;
@@ -23,6 +23,44 @@ extern "C" {
 #define hd6301_REG_CCR_I	0x04
 #define hd6301_REG_CCR_H	0x05
 
+/* Internal registers */
+#define HD6301_REG_DDR1		0x00
+#define HD6301_REG_DDR2		0x01
+#define HD6301_REG_PORT1	0x02
+#define HD6301_REG_PORT2	0x03
+#define HD6301_REG_DDR3		0x04
+#define HD6301_REG_DDR4		0x05
+#define HD6301_REG_PORT3	0x06
+#define HD6301_REG_PORT4	0x07
+#define HD6301_REG_TCSR		0x08
+#define HD6301_REG_FRCH		0x09
+#define HD6301_REG_FRCL		0x0a
+#define HD6301_REG_OCRH		0x0b
+#define HD6301_REG_OCRL		0x0c
+#define HD6301_REG_ICRH		0x0d
+#define HD6301_REG_ICRL		0x0e
+#define HD6301_REG_RMCR		0x10
+#define HD6301_REG_TRCSR	0x11
+#define HD6301_REG_RDR		0x12
+#define HD6301_REG_TDR		0x13
+
+/* Timer control and status register */
+#define HD6301_TCSR_EICI	0x10
+#define HD6301_TCSR_EOCI	0x08
+#define HD6301_TCSR_ETOI	0x04
+#define HD6301_TCSR_ICF		0x80
+#define HD6301_TCSR_OCF		0x40
+#define HD6301_TCSR_TOF		0x20
+
+/* Transmit/receive control and status register */
+#define HD6301_TRCSR_RDRF	0x80
+#define HD6301_TRCSR_ORFE	0x40
+#define HD6301_TRCSR_TDRE	0x20
+#define HD6301_TRCSR_RIE	0x10
+#define HD6301_TRCSR_RE		0x08
+#define HD6301_TRCSR_TIE	0x04
+#define HD6301_TRCSR_TE		0x02
+
 struct hd6301_opcode_t {
 	Uint8	op_value;		/* Opcode value */
 	Uint8	op_bytes;		/* Total opcode bytes */
@@ -34,7 +72,18 @@ struct hd6301_opcode_t {
 
 /* Functions */
 extern void hd6301_init_cpu(void);
+extern void hd6301_reset_cpu(void);
+extern void hd6301_load_rom(const Uint8 *pRom);
 extern void hd6301_execute_one_instruction(void);
+extern void hd6301_run_cycles(int nCycles);
+extern void hd6301_MemorySnapShot_Capture(bool bSave);
+
+/* Ports and SCI */
+extern Uint8 (*hd6301_read_port)(int port);
+extern void (*hd6301_sci_transmit)(Uint8 value);
+extern Uint8 hd6301_get_port_output(int port);
+extern void hd6301_input_changed(void);
+extern void hd6301_sci_receive(Uint8 value);
 
 /* HF6301 Disasm and debug code */
 extern void hd6301_disasm(void);
@@ -88,6 +88,9 @@ const char IKBD_fileid[] = "Hatari ikbd.c : " __DATE__ " " __TIME__;
 #include "utils.h"
 #include "acia.h"
 #include "clocks_timings.h"
+#include "file.h"
+#include "log.h"
+#include "hd6301_cpu.h"
 
 
 #define DBL_CLICK_HISTORY  0x07     /* Number of frames since last click to see if need to send one or two clicks */
@@ -374,6 +377,42 @@ static bool	IKBD_ExeMode = false;
 
 static Uint8	ScanCodeState[ 128 ];			/* state of each key : 0=released 1=pressed */
 
+
+/*-----------------------------------------------------------------------*/
+/* Belows part is used for the low level emulation, where the HD6301	*/
+/* cpu core runs a dump of the real IKBD's ROM (--ikbd-rom option).	*/
+/*-----------------------------------------------------------------------*/
+
+#define	IKBD_LLE_CPU_CYCLES		8		/* 6301 runs at 1 MHz (4 MHz crystal / 4) : 8 cpu cycles at 8 MHz */
+#define	IKBD_LLE_MAX_CATCHUP		1000000		/* Never run more than 1 sec of 6301 time at once */
+#define	IKBD_LLE_MAX_MOUSE_STEPS	1024		/* Max number of pending mouse steps on each axis */
+#define	IKBD_LLE_CALIB_BOOT_CYCLES	500000		/* 6301 cycles to let the ROM boot before looking for the keys */
+#define	IKBD_LLE_CALIB_KEY_CYCLES	20000		/* 6301 cycles to wait for a key press or release to be reported */
+
+#define	IKBD_LLE_P2_FIRE0		0x02		/* P21 : joystick 0 fire / left mouse button */
+#define	IKBD_LLE_P2_FIRE1		0x04		/* P22 : joystick 1 fire / right mouse button */
+
+static bool	IKBD_LLE = false;			/* true if the 6301 runs the IKBD's ROM */
+static bool	IKBD_LLE_Calibrating = false;		/* true while looking for the position of each key in the matrix */
+static char	IKBD_LLE_RomFileName[ FILENAME_MAX ];	/* ROM image loaded in the 6301 or "" */
+static Uint64	IKBD_LLE_ClockCounter;			/* value of CyclesGlobalClockCounter the 6301 caught up with */
+static Uint8	IKBD_LLE_KeyPos[ 128 ];			/* (column*8 + row + 1) of each scancode in the matrix, 0 if unknown */
+static Uint8	IKBD_LLE_Matrix[ 16 ];			/* rows of the pressed keys for each column */
+static Uint8	IKBD_LLE_Joy[ 2 ];			/* joysticks directions */
+static Uint8	IKBD_LLE_Fire;				/* IKBD_LLE_P2_FIREx bits for the pressed buttons */
+static int	IKBD_LLE_MouseDX , IKBD_LLE_MouseDY;	/* mouse steps not sent yet */
+static Uint8	IKBD_LLE_MousePhase;			/* bits 0-1 : X quadrature phase  bits 2-3 : Y quadrature phase */
+static Uint8	IKBD_LLE_CalibBuffer[ 16 ];		/* bytes sent by the ROM during the calibration */
+static int	IKBD_LLE_CalibCount;
+
+static void	IKBD_LLE_Setup ( void );
+static void	IKBD_LLE_Reset ( bool bCold );
+static void	IKBD_LLE_CatchUp ( void );
+static void	IKBD_LLE_UpdateInputs ( void );
+static void	IKBD_LLE_PressKey ( Uint8 ScanCode , bool bPress );
+static Uint8	IKBD_LLE_ReadPort ( int port );
+static void	IKBD_LLE_Transmit ( Uint8 Data );
+
 /* This array contains all known custom 6301 programs, with their CRC */
 static const struct
 {
@@ -441,6 +480,10 @@ void	IKBD_Init ( void )
 
 	/* Set the callback functions for RX/TX line */
 	IKBD_Init_Pointers ( pACIA_IKBD );
+
+	/* Connect the 6301's ports and SCI for the low level emulation */
+	hd6301_read_port = IKBD_LLE_ReadPort;
+	hd6301_sci_transmit = IKBD_LLE_Transmit;
 }
 
 
@@ -486,6 +529,14 @@ void	IKBD_Reset ( bool bCold )
 	pIKBD->RSR = 0;
 	pIKBD->SCI_RX_Size = 0;
 
+	/* Use the real IKBD's ROM if one was given */
+	if ( bCold )
+		IKBD_LLE_Setup ();
+	if ( IKBD_LLE )
+	{
+		IKBD_LLE_Reset ( bCold );
+		return;
+	}
 
 	/* On cold reset, clear the whole RAM (including clock data) */
 	/* On warm reset, the clock data should be kept */
@@ -622,6 +673,10 @@ void IKBD_InterruptHandler_ResetTimer(void)
 	/* Remove this interrupt from list and re-order */
 	CycInt_AcknowledgeInterrupt();
 
+	/* The 6301 sends $F1 itself when running the ROM */
+	if ( IKBD_LLE )
+		return;
+
 	/* Reset timer is over */
 	bDuringResetCriticalTime = false;
 	bMouseEnabledDuringReset = false;
@@ -676,6 +731,26 @@ void IKBD_MemorySnapShot_Capture(bool bSave)
 	{
 		IKBD_Init_Pointers ( pACIA_IKBD );
 	}
+
+	/* Save/Restore the low level emulation */
+	MemorySnapShot_Store(&IKBD_LLE, sizeof(IKBD_LLE));
+	if ( IKBD_LLE )
+	{
+		hd6301_MemorySnapShot_Capture ( bSave );
+		MemorySnapShot_Store(&IKBD_LLE_ClockCounter, sizeof(IKBD_LLE_ClockCounter));
+		MemorySnapShot_Store(IKBD_LLE_Matrix, sizeof(IKBD_LLE_Matrix));
+		MemorySnapShot_Store(IKBD_LLE_Joy, sizeof(IKBD_LLE_Joy));
+		MemorySnapShot_Store(&IKBD_LLE_Fire, sizeof(IKBD_LLE_Fire));
+		MemorySnapShot_Store(&IKBD_LLE_MouseDX, sizeof(IKBD_LLE_MouseDX));
+		MemorySnapShot_Store(&IKBD_LLE_MouseDY, sizeof(IKBD_LLE_MouseDY));
+		MemorySnapShot_Store(&IKBD_LLE_MousePhase, sizeof(IKBD_LLE_MousePhase));
+
+		if ( ( bSave == false ) && ( IKBD_LLE_RomFileName[ 0 ] == 0 ) )
+		{
+			Log_Printf ( LOG_WARN , "Snapshot uses the IKBD ROM, but none is loaded. Using high level IKBD emulation.\n" );
+			IKBD_LLE = false;
+		}
+	}
 }
 
 
@@ -816,6 +891,10 @@ static Uint8	IKBD_SCI_Set_Line_TX ( void )
 	LOG_TRACE ( TRACE_IKBD_ACIA, "ikbd acia tx_state=%d tx_delay=%d VBL=%d HBL=%d\n" , pIKBD->SCI_TX_State , pIKBD->SCI_TX_Delay ,
 		nVBLs , nHBL );
 
+	/* Let the 6301 run until now, it could have new bytes to send */
+	if ( IKBD_LLE )
+		IKBD_LLE_CatchUp ();
+
 	StateNext = -1;
 	switch ( pIKBD->SCI_TX_State )
 	{
@@ -873,6 +952,13 @@ static void	IKBD_Process_RDR ( Uint8 RDR )
 {
 	pIKBD->TRCSR &= ~IKBD_TRCSR_BIT_RDRF;				/* RDR was read */
 
+	/* If the 6301 runs the ROM, pass the byte to its SCI */
+	if ( IKBD_LLE )
+	{
+		IKBD_LLE_CatchUp ();
+		hd6301_sci_receive ( RDR );
+		return;
+	}
 
 	/* If IKBD is executing custom code, send the byte to the function handling this code */
 	if ( IKBD_ExeMode && pIKBD_CustomCodeHandler_Write )
@@ -1110,6 +1196,10 @@ void	IKBD_UpdateClockOnVBL ( void )
 	/* Max number of days per month ; 18 entries, because the index for this array is a BCD coded month */
 	Uint8	day_max[ 18 ] = { 0x32, 0x29, 0x32, 0x31, 0x32, 0x31, 0x32, 0x32, 0x31, 0,0,0,0,0,0, 0x32, 0x31, 0x32 };
 
+	/* The 6301 updates the clock itself when running the ROM */
+	if ( IKBD_LLE )
+		return;
+
 
 	/* Check if more than 1 second passed since last increment of date/time */
         FrameDuration_micro = ClocksTimings_GetVBLDuration_micro ( ConfigureParams.System.nMachineType , nScreenRefreshRate );
@@ -1728,6 +1818,14 @@ static void IKBD_SendAutoKeyboardCommands(void)
  */
 void IKBD_PressSTKey(Uint8 ScanCode, bool bPress)
 {
+	/* If the 6301 runs the ROM, update the keyboard matrix */
+	if ( IKBD_LLE )
+	{
+		ScanCodeState[ ScanCode & 0x7f ] = bPress ? 1 : 0;
+		IKBD_LLE_PressKey ( ScanCode , bPress );
+		return;
+	}
+
 	/* If IKBD is monitoring only joysticks, don't report key */
 	if ( KeyboardProcessor.JoystickMode == AUTOMODE_JOYSTICK_MONITORING )
 		return;
@@ -1784,6 +1882,13 @@ void IKBD_InterruptHandler_AutoSend(void)
 	CycInt_AddRelativeInterrupt(Keyboard.AutoSendCycles, INT_CPU8_CYCLE, INTERRUPT_IKBD_AUTOSEND);
 #endif
 
+	/* If the 6301 runs the ROM, it will send the packets itself */
+	if ( IKBD_LLE )
+	{
+		IKBD_LLE_UpdateInputs ();
+		return;
+	}
+
 	/* We don't send keyboard data automatically within the first few
 	 * VBLs to avoid that TOS gets confused during its boot time */
 	if (nVBLs > 20)
@@ -3077,3 +3182,404 @@ static void IKBD_CustomCodeHandler_ChaosAD_Write ( Uint8 aciabyte )
 	}
 }
 
+
+
+
+
+/************************************************************************/
+/* Low level emulation of the IKBD : the HD6301 cpu core runs a dump of	*/
+/* the real IKBD's ROM and talks to the ACIA through its SCI.		*/
+/*									*/
+/* To keep the host cost low, the 6301 is not run in parallel with the	*/
+/* 68000. Instead, it only catches up with the current 68000 cycle when	*/
+/* its inputs change (ACIA serial line, key press, mouse/joystick update	*/
+/* on each VBL). When the ROM runs its scan loop without anything	*/
+/* changing, the cpu core detects the idle loop and skips directly to	*/
+/* the next timer event.						*/
+/*									*/
+/* Ports connections :							*/
+/*   P1		: keyboard matrix rows (input, active low)		*/
+/*   P21/P22	: fire buttons (input, active low)			*/
+/*   P3 , P4	: keyboard matrix columns (output, active low)		*/
+/*   P4		: joysticks directions and mouse when used as input	*/
+/*									*/
+/* The matrix position of each key is not hardcoded : when loading the	*/
+/* ROM, we press each position of the matrix in turn and record the	*/
+/* scancode reported by the ROM.						*/
+/************************************************************************/
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Run the ROM with each possible key of the matrix pressed, to build the
+ * table converting a scancode to a matrix position.
+ * Return false if the ROM didn't report any key.
+ */
+static bool	IKBD_LLE_Calibrate ( void )
+{
+	int	Column , Row , i;
+	int	KeysNb = 0;
+	Uint8	ScanCode;
+
+
+	memset ( IKBD_LLE_KeyPos , 0 , sizeof ( IKBD_LLE_KeyPos ) );
+	memset ( IKBD_LLE_Matrix , 0 , sizeof ( IKBD_LLE_Matrix ) );
+	memset ( IKBD_LLE_Joy , 0 , sizeof ( IKBD_LLE_Joy ) );
+	IKBD_LLE_Fire = 0;
+	IKBD_LLE_MouseDX = IKBD_LLE_MouseDY = 0;
+	IKBD_LLE_MousePhase = 0;
+
+	IKBD_LLE_Calibrating = true;
+
+	hd6301_init_cpu ();
+	hd6301_run_cycles ( IKBD_LLE_CALIB_BOOT_CYCLES );
+
+	for ( Column=0 ; Column<16 ; Column++ )
+		for ( Row=0 ; Row<8 ; Row++ )
+		{
+			IKBD_LLE_CalibCount = 0;
+
+			IKBD_LLE_Matrix[ Column ] = 1 << Row;
+			hd6301_input_changed ();
+			hd6301_run_cycles ( IKBD_LLE_CALIB_KEY_CYCLES );
+
+			IKBD_LLE_Matrix[ Column ] = 0;
+			hd6301_input_changed ();
+			hd6301_run_cycles ( IKBD_LLE_CALIB_KEY_CYCLES );
+
+			/* The first byte should be the make code of the key */
+			for ( i=0 ; i<IKBD_LLE_CalibCount ; i++ )
+			{
+				ScanCode = IKBD_LLE_CalibBuffer[ i ];
+				if ( ( ScanCode >= 0x01 ) && ( ScanCode <= KBD_MAX_SCANCODE ) )
+				{
+					if ( IKBD_LLE_KeyPos[ ScanCode ] == 0 )
+					{
+						IKBD_LLE_KeyPos[ ScanCode ] = Column * 8 + Row + 1;
+						KeysNb++;
+					}
+					break;
+				}
+			}
+		}
+
+	IKBD_LLE_Calibrating = false;
+
+	LOG_TRACE ( TRACE_IKBD_ALL , "ikbd lle found %d keys in the matrix\n" , KeysNb );
+	return KeysNb > 0;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Called on cold reset : load the IKBD's ROM image if it changed and
+ * choose between low level and high level emulation.
+ */
+static void	IKBD_LLE_Setup ( void )
+{
+	const char	*pszFileName = ConfigureParams.Rom.szIkbdRomFileName;
+	Uint8		*pRom;
+	long		RomSize;
+
+
+	if ( pszFileName[ 0 ] == 0 )
+	{
+		IKBD_LLE = false;
+		return;
+	}
+
+	if ( strcmp ( IKBD_LLE_RomFileName , pszFileName ) == 0 )
+	{
+		IKBD_LLE = true;				/* Same ROM as before */
+		return;
+	}
+
+	IKBD_LLE = false;
+	IKBD_LLE_RomFileName[ 0 ] = 0;
+
+	pRom = File_Read ( pszFileName , &RomSize , NULL );
+	if ( ( pRom == NULL ) || ( RomSize != 4096 ) )
+	{
+		Log_AlertDlg ( LOG_ERROR , "Can not load IKBD ROM image '%s' (it should be 4096 bytes).\n"
+			"Using high level IKBD emulation." , pszFileName );
+		free ( pRom );
+		return;
+	}
+
+	hd6301_load_rom ( pRom );
+	free ( pRom );
+
+	if ( !IKBD_LLE_Calibrate () )
+	{
+		Log_AlertDlg ( LOG_ERROR , "IKBD ROM image '%s' doesn't seem to scan the keyboard.\n"
+			"Using high level IKBD emulation." , pszFileName );
+		return;
+	}
+
+	strcpy ( IKBD_LLE_RomFileName , pszFileName );
+	IKBD_LLE = true;
+	Log_Printf ( LOG_INFO , "IKBD ROM image '%s' loaded, using low level IKBD emulation\n" , pszFileName );
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Reset the 6301. On cold reset, its RAM is also cleared.
+ */
+static void	IKBD_LLE_Reset ( bool bCold )
+{
+	int	i , Pos;
+
+
+	LOG_TRACE ( TRACE_IKBD_ALL , "ikbd lle reset mode=%s\n" , bCold?"cold":"warm" );
+
+	/* Remove the high level emulation's pending bytes and handlers */
+	Keyboard.BufferHead = Keyboard.BufferTail = 0;
+	Keyboard.NbBytesInOutputBuffer = 0;
+	Keyboard.nBytesInInputBuffer = 0;
+	Keyboard.PauseOutput = false;
+	bDuringResetCriticalTime = false;
+
+	MemoryLoadNbBytesLeft = 0;
+	pIKBD_CustomCodeHandler_Read = NULL;
+	pIKBD_CustomCodeHandler_Write = NULL;
+	IKBD_ExeMode = false;
+
+	CycInt_RemovePendingInterrupt ( INTERRUPT_IKBD_RESETTIMER );
+
+	/* Keys that are still pressed on warm reset stay in the matrix */
+	if ( bCold )
+		memset ( ScanCodeState , 0 , sizeof ( ScanCodeState ) );
+	memset ( IKBD_LLE_Matrix , 0 , sizeof ( IKBD_LLE_Matrix ) );
+	for ( i=0 ; i<128 ; i++ )
+		if ( ScanCodeState[ i ] && IKBD_LLE_KeyPos[ i ] )
+		{
+			Pos = IKBD_LLE_KeyPos[ i ] - 1;
+			IKBD_LLE_Matrix[ Pos >> 3 ] |= 1 << ( Pos & 7 );
+		}
+	IKBD_LLE_MouseDX = IKBD_LLE_MouseDY = 0;
+
+	if ( bCold )
+		hd6301_init_cpu ();
+	else
+		hd6301_reset_cpu ();
+
+	IKBD_LLE_ClockCounter = CyclesGlobalClockCounter;
+
+	/* The auto-update function is still needed to handle the host's events */
+	Keyboard.AutoSendCycles = 150000;				/* approx every VBL */
+	if ( CycInt_InterruptActive ( INTERRUPT_IKBD_AUTOSEND ) == false )
+#ifdef OLD_CPU_SHIFT
+		CycInt_AddRelativeInterrupt ( Keyboard.AutoSendCycles, INT_CPU_CYCLE, INTERRUPT_IKBD_AUTOSEND );
+#else
+		CycInt_AddRelativeInterrupt ( Keyboard.AutoSendCycles, INT_CPU8_CYCLE, INTERRUPT_IKBD_AUTOSEND );
+#endif
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Run the 6301 until it reaches the current 68000 cycle.
+ * The mouse moves by one step on each call, which gives enough time
+ * to the ROM to see each transition of the quadrature signals.
+ */
+static void	IKBD_LLE_CatchUp ( void )
+{
+	Uint64	Cycles;
+	int	Cycles6301;
+
+
+	if ( CyclesGlobalClockCounter < IKBD_LLE_ClockCounter )	/* should not happen */
+		IKBD_LLE_ClockCounter = CyclesGlobalClockCounter;
+
+	Cycles = ( CyclesGlobalClockCounter - IKBD_LLE_ClockCounter ) >> nCpuFreqShift;
+	if ( Cycles > (Uint64)IKBD_LLE_MAX_CATCHUP * IKBD_LLE_CPU_CYCLES )
+	{
+		Cycles6301 = IKBD_LLE_MAX_CATCHUP;
+		IKBD_LLE_ClockCounter = CyclesGlobalClockCounter;
+	}
+	else
+	{
+		Cycles6301 = Cycles / IKBD_LLE_CPU_CYCLES;
+		IKBD_LLE_ClockCounter += ( (Uint64)Cycles6301 * IKBD_LLE_CPU_CYCLES ) << nCpuFreqShift;
+	}
+
+	if ( Cycles6301 == 0 )
+		return;
+
+	if ( IKBD_LLE_MouseDX || IKBD_LLE_MouseDY )
+	{
+		if ( IKBD_LLE_MouseDX > 0 )
+		{
+			IKBD_LLE_MousePhase = ( IKBD_LLE_MousePhase & 0x0c ) | ( ( IKBD_LLE_MousePhase + 1 ) & 0x03 );
+			IKBD_LLE_MouseDX--;
+		}
+		else if ( IKBD_LLE_MouseDX < 0 )
+		{
+			IKBD_LLE_MousePhase = ( IKBD_LLE_MousePhase & 0x0c ) | ( ( IKBD_LLE_MousePhase - 1 ) & 0x03 );
+			IKBD_LLE_MouseDX++;
+		}
+		if ( IKBD_LLE_MouseDY > 0 )
+		{
+			IKBD_LLE_MousePhase = ( IKBD_LLE_MousePhase & 0x03 ) | ( ( IKBD_LLE_MousePhase + 4 ) & 0x0c );
+			IKBD_LLE_MouseDY--;
+		}
+		else if ( IKBD_LLE_MouseDY < 0 )
+		{
+			IKBD_LLE_MousePhase = ( IKBD_LLE_MousePhase & 0x03 ) | ( ( IKBD_LLE_MousePhase - 4 ) & 0x0c );
+			IKBD_LLE_MouseDY++;
+		}
+		hd6301_input_changed ();
+	}
+
+	hd6301_run_cycles ( Cycles6301 );
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Called on each VBL to update the joysticks, mouse and fire buttons
+ * seen by the 6301.
+ */
+static void	IKBD_LLE_UpdateInputs ( void )
+{
+	Uint8	Joy[ 2 ];
+	Uint8	Fire = 0;
+
+
+	/* Make sure the new inputs will be seen from now on, not in the past */
+	IKBD_LLE_CatchUp ();
+
+#ifdef __LIBRETRO__	/* RETRO HACK */
+	Joy[ 1 ] = MXjoy0;
+	Joy[ 0 ] = 0;
+#else
+	Joy[ 1 ] = Joy_GetStickData ( 1 );
+	Joy[ 0 ] = Joy_GetStickData ( 0 );
+#endif	/* RETRO HACK */
+
+	if ( ( Joy[ 0 ] & 0x80 ) || ( Keyboard.bLButtonDown & BUTTON_MOUSE ) )
+		Fire |= IKBD_LLE_P2_FIRE0;
+	if ( ( Joy[ 1 ] & 0x80 ) || ( Keyboard.bRButtonDown & BUTTON_MOUSE ) )
+		Fire |= IKBD_LLE_P2_FIRE1;
+
+	if ( ( Joy[ 0 ] != IKBD_LLE_Joy[ 0 ] ) || ( Joy[ 1 ] != IKBD_LLE_Joy[ 1 ] ) || ( Fire != IKBD_LLE_Fire ) )
+	{
+		IKBD_LLE_Joy[ 0 ] = Joy[ 0 ];
+		IKBD_LLE_Joy[ 1 ] = Joy[ 1 ];
+		IKBD_LLE_Fire = Fire;
+		hd6301_input_changed ();
+	}
+
+	/* Mouse moves will be sent step by step by IKBD_LLE_CatchUp */
+	IKBD_LLE_MouseDX += KeyboardProcessor.Mouse.dx;
+	IKBD_LLE_MouseDY += KeyboardProcessor.Mouse.dy;
+	KeyboardProcessor.Mouse.dx = 0;
+	KeyboardProcessor.Mouse.dy = 0;
+	if ( IKBD_LLE_MouseDX > IKBD_LLE_MAX_MOUSE_STEPS )	IKBD_LLE_MouseDX = IKBD_LLE_MAX_MOUSE_STEPS;
+	if ( IKBD_LLE_MouseDX < -IKBD_LLE_MAX_MOUSE_STEPS )	IKBD_LLE_MouseDX = -IKBD_LLE_MAX_MOUSE_STEPS;
+	if ( IKBD_LLE_MouseDY > IKBD_LLE_MAX_MOUSE_STEPS )	IKBD_LLE_MouseDY = IKBD_LLE_MAX_MOUSE_STEPS;
+	if ( IKBD_LLE_MouseDY < -IKBD_LLE_MAX_MOUSE_STEPS )	IKBD_LLE_MouseDY = -IKBD_LLE_MAX_MOUSE_STEPS;
+
+	/* Send joystick button '2' as 'Space bar' key */
+	if ( JoystickSpaceBar == JOYSTICK_SPACE_DOWN )
+	{
+		IKBD_PressSTKey ( 57 , true );			/* Press */
+		JoystickSpaceBar = JOYSTICK_SPACE_UP;
+	}
+	else if ( JoystickSpaceBar == JOYSTICK_SPACE_UP )
+	{
+		IKBD_PressSTKey ( 57 , false );			/* Release */
+		JoystickSpaceBar = false;			/* Complete */
+	}
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Press/release a key in the keyboard matrix
+ */
+static void	IKBD_LLE_PressKey ( Uint8 ScanCode , bool bPress )
+{
+	int	Pos;
+
+
+	Pos = IKBD_LLE_KeyPos[ ScanCode & 0x7f ];
+	if ( Pos == 0 )						/* This key was not found in the matrix */
+		return;
+	Pos--;
+
+	/* Make sure the key will be seen from now on, not in the past */
+	IKBD_LLE_CatchUp ();
+
+	if ( bPress )
+		IKBD_LLE_Matrix[ Pos >> 3 ] |= 1 << ( Pos & 7 );
+	else
+		IKBD_LLE_Matrix[ Pos >> 3 ] &= ~( 1 << ( Pos & 7 ) );
+	hd6301_input_changed ();
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Return the value of the signals connected to the 6301's ports
+ * (bits configured as output are ignored by the cpu core)
+ */
+static Uint8	IKBD_LLE_ReadPort ( int port )
+{
+	static const Uint8 Quadrature[ 4 ] = { 0x00 , 0x01 , 0x03 , 0x02 };
+	Uint8	Value = 0xff;
+	Uint16	Columns;
+	int	i;
+
+
+	switch ( port )
+	{
+	  case 1 :						/* Rows of the keys in the selected columns */
+		Columns = ~( hd6301_get_port_output ( 3 ) | ( hd6301_get_port_output ( 4 ) << 8 ) );
+		for ( i=0 ; i<16 ; i++ )
+			if ( Columns & ( 1 << i ) )
+				Value &= ~IKBD_LLE_Matrix[ i ];
+		break;
+
+	  case 2 :						/* Fire buttons */
+		Value &= ~IKBD_LLE_Fire;
+		break;
+
+	  case 4 :						/* Mouse and joysticks directions */
+		Value = 0xf0 | Quadrature[ IKBD_LLE_MousePhase & 3 ] | ( Quadrature[ ( IKBD_LLE_MousePhase >> 2 ) & 3 ] << 2 );
+		Value &= ~( IKBD_LLE_Joy[ 0 ] & 0x0f );
+		Value &= ~( ( IKBD_LLE_Joy[ 1 ] & 0x0f ) << 4 );
+		break;
+	}
+
+	return Value;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * The 6301 wrote a byte to its TDR : add it to the bytes to send to the ACIA
+ */
+static void	IKBD_LLE_Transmit ( Uint8 Data )
+{
+	if ( IKBD_LLE_Calibrating )
+	{
+		if ( IKBD_LLE_CalibCount < (int)sizeof ( IKBD_LLE_CalibBuffer ) )
+			IKBD_LLE_CalibBuffer[ IKBD_LLE_CalibCount++ ] = Data;
+		return;
+	}
+
+	LOG_TRACE ( TRACE_IKBD_ACIA, "ikbd lle send byte=0x%02x VBL=%d HBL=%d\n" , Data, nVBLs , nHBL );
+
+	/* Is ACIA's serial line initialised yet ? Byte is lost if not */
+	if ( pACIA_IKBD->Clock_Divider == 0 )
+		return;
+
+	if ( IKBD_OutputBuffer_CheckFreeCount ( 1 ) )
+	{
+		Keyboard.Buffer[Keyboard.BufferTail++] = Data;
+		Keyboard.BufferTail &= KEYBOARD_BUFFER_MASK;
+		Keyboard.NbBytesInOutputBuffer++;
+	}
+}
@@ -13,7 +13,16 @@ extern bool bSoundWorking;
 extern int SoundBufferSize;
 extern int CompleteSndBufIdx;
 extern int SdlAudioBufferSize;
-extern int pulse_swallowing_count;
+extern int AudioLatency;
+
+/* Atomic accesses for the counters shared with the audio callback */
+#if defined(__GNUC__)
+#define Audio_AtomicAdd(ptr, val)	__sync_fetch_and_add((ptr), (val))
+#define Audio_AtomicGet(ptr)		__sync_fetch_and_add((ptr), 0)
+#else
+extern int Audio_AtomicAdd(volatile int *ptr, int val);
+extern int Audio_AtomicGet(volatile int *ptr);
+#endif
 
 
 extern void Audio_Init(void);
@@ -23,5 +32,9 @@ extern void Audio_Unlock(void);
 extern void Audio_FreeSoundBuffer(void);
 extern void Audio_SetOutputAudioFreq(int Frequency);
 extern void Audio_EnableAudio(bool bEnable);
+extern void Audio_ResetResampling(void);
+extern int Audio_GetBufferFill(void);
+extern int Audio_GetLatencyTarget(void);
+extern void Audio_Info(FILE *fp, Uint32 dummy);
 
 #endif  /* HATARI_AUDIO_H */
@@ -0,0 +1,27 @@
+/*
+  Hatari - batch.h
+
+  This file is distributed under the GNU General Public License, version 2
+  or at your option any later version. Read the file gpl.txt for details.
+*/
+#ifndef HATARI_BATCH_H
+#define HATARI_BATCH_H
+
+#include "main.h"
+
+/* supported only on systems with fork() */
+#if HAVE_FORK
+extern const char *Batch_SetJobFile(const char *filename);
+extern const char *Batch_SetWorkers(int workers);
+extern bool Batch_IsEnabled(void);
+extern bool Batch_Run(int *pExitCode);
+extern void Batch_JobDone(void);
+#else
+#define Batch_SetJobFile(filename) "Batch mode is not supported on this platform."
+#define Batch_SetWorkers(workers) "Batch mode is not supported on this platform."
+#define Batch_IsEnabled() false
+#define Batch_Run(exitcode) true
+#define Batch_JobDone()
+#endif /* HAVE_FORK */
+
+#endif /* HATARI_BATCH_H */
@@ -74,6 +74,17 @@ extern void Blitter_LogOp_WriteByte(void);
 extern void Blitter_Control_WriteByte(void);
 extern void Blitter_Skew_WriteByte(void);
 
+extern void Blitter_Halftone_ReadLong(void);
+extern void Blitter_Halftone_WriteLong(void);
+extern void Blitter_SourceInc_ReadLong(void);
+extern void Blitter_SourceInc_WriteLong(void);
+extern void Blitter_Endmask_ReadLong(void);
+extern void Blitter_Endmask_WriteLong(void);
+extern void Blitter_DestInc_ReadLong(void);
+extern void Blitter_DestInc_WriteLong(void);
+extern void Blitter_Count_ReadLong(void);
+extern void Blitter_Count_WriteLong(void);
+
 extern void Blitter_MemorySnapShot_Capture(bool bSave);
 extern void Blitter_InterruptHandler(void);
 extern void Blitter_Info(FILE *fp, Uint32 arg);
@@ -16,6 +16,7 @@ typedef struct
 {
   char sLogFileName[FILENAME_MAX];
   char sTraceFileName[FILENAME_MAX];
+  char sNatFeatsFileName[FILENAME_MAX];
   int nExceptionDebugMask;
   int nTextLogLevel;
   int nAlertDlgLogLevel;
@@ -36,12 +37,13 @@ typedef struct
 } CNF_DEBUGGER;
 
 
-/* ROM (TOS + cartridge) configuration */
+/* ROM (TOS + cartridge + IKBD) configuration */
 typedef struct
 {
   char szTosImageFileName[FILENAME_MAX];
   bool bPatchTos;
   char szCartridgeImageFileName[FILENAME_MAX];
+  char szIkbdRomFileName[FILENAME_MAX];
 } CNF_ROM;
 
 
@@ -53,6 +55,7 @@ typedef struct
   bool bEnableSoundSync;
   int nPlaybackFreq;
   int SdlAudioBufferSize;
+  int nAudioLatency;
   char szYMCaptureFileName[FILENAME_MAX];
   int YmVolumeMixing;
 } CNF_SOUND;
@@ -245,6 +248,12 @@ typedef enum
   MONITOR_TYPE_TV
 } MONITORTYPE;
 
+typedef enum
+{
+  VIDEO_BACKEND_SDL = 0,          /* normal SDL window output */
+  VIDEO_BACKEND_NONE              /* no output, frames converted only on request */
+} VIDEOBACKEND;
+
 /* Screen configuration */
 typedef struct
 {
@@ -258,6 +267,7 @@ typedef struct
   bool bAllowOverscan;
   bool bAspectCorrect;
   bool bUseExtVdiResolutions;
+  bool bVdiHostDraw;
   int nSpec512Threshold;
   int nForceBpp;
   int nVdiColors;
@@ -270,6 +280,9 @@ typedef struct
   bool bForceMax;
   int nMaxWidth;
   int nMaxHeight;
+  bool bRenderThread;
+  bool bLineBatch;
+  VIDEOBACKEND nVideoBackend;
 #if WITH_SDL2
   int nRenderScaleQuality;
   bool bUseVsync;
@@ -331,6 +344,15 @@ typedef enum
   VIDEO_TIMING_MODE_WS4,
 } VIDEOTIMINGMODE;
 
+#if ENABLE_WINUAE_CPU
+typedef enum
+{
+  IDLE_LOOP_MODE_RUN = 0,         /* execute idle loops normally */
+  IDLE_LOOP_MODE_SKIP,            /* skip to the next interrupt event */
+  IDLE_LOOP_MODE_CHECK,           /* run them, but check that skipping would be exact */
+} IDLELOOPMODE;
+#endif
+
 typedef struct
 {
   int nCpuLevel;
@@ -350,6 +372,7 @@ typedef struct
   FPUTYPE n_FPUType;
   bool bCompatibleFPU;            /* More compatible FPU */
   bool bMMU;                      /* TRUE if MMU is enabled */
+  IDLELOOPMODE IdleLoopMode;
 #endif
 } CNF_SYSTEM;
 
@@ -80,6 +80,7 @@ typedef enum
 
 extern void (*PendingInterruptFunction)(void);
 extern int PendingInterruptCount;
+extern Uint32 PendingInterruptUpdates;
 
 extern void CycInt_Reset(void);
 extern void CycInt_MemorySnapShot_Capture(bool bSave);
@@ -88,6 +89,7 @@ extern void CycInt_AddAbsoluteInterrupt(int CycleTime, int CycleType, interrupt_
 extern void CycInt_AddRelativeInterrupt(int CycleTime, int CycleType, interrupt_id Handler);
 extern void CycInt_AddRelativeInterruptWithOffset(int CycleTime, int CycleType, interrupt_id Handler, int CycleOffset);
 extern void CycInt_ModifyInterrupt(int CycleTime, int CycleType, interrupt_id Handler);
+extern void CycInt_AlignInterrupt(int CycleTime, int CycleType, interrupt_id Handler);
 extern void CycInt_RemovePendingInterrupt(interrupt_id Handler);
 extern void CycInt_ResumeStoppedInterrupt(interrupt_id Handler);
 extern bool CycInt_InterruptActive(interrupt_id Handler);
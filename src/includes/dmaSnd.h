@@ -24,6 +24,7 @@ extern void DmaSnd_SoundControl_WriteWord(void);
 extern void DmaSnd_FrameCountHigh_ReadByte(void);
 extern void DmaSnd_FrameCountMed_ReadByte(void);
 extern void DmaSnd_FrameCountLow_ReadByte(void);
+extern void DmaSnd_FrameCount_ReadWordLong(void);
 extern void DmaSnd_FrameStartHigh_WriteByte(void);
 extern void DmaSnd_FrameStartMed_WriteByte(void);
 extern void DmaSnd_FrameStartLow_WriteByte(void);
@@ -28,6 +28,10 @@
 
 #define	FLOPPY_BOOT_SECTOR_EXE_SUM		0x1234
 
+/* Space reserved for each drive's written contents in lightweight snapshots, */
+/* so their size doesn't change during a session (86 tracks, 2 sides, 36 sectors) */
+#define	FLOPPY_LIGHT_SNAPSHOT_IMAGE_BYTES	( 86 * 2 * 36 * NUMBYTESPERSECTOR )
+
 
 /* Structure for each drive connected as emulation */
 typedef struct
@@ -22,5 +22,6 @@ extern void	IPF_SetDriveSide ( Uint8 io_porta_old , Uint8 io_porta_new );
 extern void	IPF_FDC_WriteReg ( Uint8 Reg , Uint8 Byte );
 extern Uint8	IPF_FDC_ReadReg ( Uint8 Reg );
 extern void	IPF_FDC_StatusBar ( Uint8 *pCommand , Uint8 *pHead , Uint8 *pTrack , Uint8 *pSector , Uint8 *pSide );
+extern bool	IPF_IsActive ( void );
 extern void	IPF_Emulate ( void );
 
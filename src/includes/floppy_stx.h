@@ -32,6 +32,10 @@ typedef struct {
 	Uint8		*pTimingData;				/* Data for variable bit width or null */
 
 	Sint32		SaveSectorIndex;			/* Index in STX_SaveStruct[].pSaveSectorsStruct or -1 if not used */
+
+	/* Precomputed values, to avoid recomputing them on each FDC command */
+	Uint32		IDPos_FdcCycles;			/* BitPosition converted to a number of FDC cycles */
+	Uint16		*pByteTimings;				/* Timing in FDC cycles for each byte or null if standard timings */
 } STX_SECTOR_STRUCT;
 
 #define	STX_SECTOR_BLOCK_SIZE		( 4+2+2+1+1+1+1+2+1+1 )	/* Size of the sector block in an STX file = 16 bytes */
@@ -76,6 +80,8 @@ typedef struct {
 								/* consists of 2 bytes per 16 FDC bytes */
 
 	Sint32			SaveTrackIndex;			/* Index in STX_SaveStruct[].pSaveTracksStruct or -1 if not used */
+
+	Uint32			TrackSize_FdcCycles;		/* Precomputed number of FDC cycles for one revolution */
 } STX_TRACK_STRUCT;
 
 #define	STX_TRACK_BLOCK_SIZE		( 4+4+2+2+2+1+1 )	/* Size of the track block in an STX file = 16 bytes */
@@ -100,6 +106,7 @@ typedef struct {
 
 	/* Other internal variables */
 	STX_TRACK_STRUCT	*pTracksStruct;
+	STX_TRACK_STRUCT	*pTracksIndex[ 256 ];		/* Direct access to a track using TrackNumber (track | side<<7) */
 
 	/* These variable are used to warn the user only one time if a write command is made */
 	bool		WarnedWriteSector;			/* True if a 'write sector' command was made and user was warned */
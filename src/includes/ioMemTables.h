@@ -17,11 +17,30 @@ typedef struct
 	void (*WriteFunc)(void);  /* Write function */
 } INTERCEPT_ACCESS_FUNC;
 
+/* Native word/long handlers for a group of registers. They are called
+ * once for a whole word/long access at an even address inside the group,
+ * instead of calling the handlers of each register one after the other.
+ * A native handler must take care of all the bytes of the access. */
+typedef struct
+{
+	const Uint32 Address;         /* First hardware address of the group */
+	const int SpanInBytes;        /* Size of the group */
+	void (*ReadWordFunc)(void);   /* Word read function or NULL */
+	void (*WriteWordFunc)(void);  /* Word write function or NULL */
+	void (*ReadLongFunc)(void);   /* Long read function or NULL */
+	void (*WriteLongFunc)(void);  /* Long write function or NULL */
+} INTERCEPT_NATIVE_FUNC;
+
 extern const INTERCEPT_ACCESS_FUNC IoMemTable_ST[];
 extern const INTERCEPT_ACCESS_FUNC IoMemTable_STE[];
 extern const INTERCEPT_ACCESS_FUNC IoMemTable_TT[];
 extern const INTERCEPT_ACCESS_FUNC IoMemTable_Falcon[];
 
+extern const INTERCEPT_NATIVE_FUNC IoMemNativeTable_ST[];
+extern const INTERCEPT_NATIVE_FUNC IoMemNativeTable_STE[];
+extern const INTERCEPT_NATIVE_FUNC IoMemNativeTable_TT[];
+extern const INTERCEPT_NATIVE_FUNC IoMemNativeTable_Falcon[];
+
 extern void IoMemTabFalcon_DSPnone(void (**readtab)(void), void (**writetab)(void));
 extern void IoMemTabFalcon_DSPdummy(void (**readtab)(void), void (**writetab)(void));
 #if ENABLE_DSP_EMU
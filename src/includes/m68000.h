@@ -390,6 +390,11 @@ static inline void M68000_AddCycles_CE(int cycles)
 extern void M68000_Init(void);
 extern void M68000_Reset(bool bCold);
 extern void M68000_Start(void);
+#ifdef __LIBRETRO__	/* RETRO HACK */
+extern void M68000_Setup(void);
+extern void M68000_Run(void);
+extern void M68000_Stop(void);
+#endif	/* RETRO HACK */
 extern void M68000_CheckCpuSettings(void);
 extern void M68000_MemorySnapShot_Capture(bool bSave);
 extern void M68000_BusError ( Uint32 addr , int ReadWrite , int Size , int AccessType );
@@ -65,11 +65,18 @@ extern size_t HSDL_strlcpy(char *dest, const char *source, size_t size);
 
 extern bool bQuitProgram;
 
+extern bool Main_Start(int argc, char *argv[]);
+extern int Main_Stop(void);
+#ifdef __LIBRETRO__	/* RETRO HACK */
+extern bool Main_RunFrame(void);
+#endif	/* RETRO HACK */
 extern bool Main_PauseEmulation(bool visualize);
 extern bool Main_UnPauseEmulation(void);
 extern void Main_RequestQuit(int exitval);
 extern void Main_SetRunVBLs(Uint32 vbls);
 extern bool Main_SetVBLSlowdown(int factor);
+extern void Main_SetBusyWait(bool enable);
+extern void Main_PacingInfo(FILE *fp, Uint32 dummy);
 extern void Main_WaitOnVbl(void);
 extern void Main_WarpMouse(int x, int y, bool restore);
 extern void Main_EventHandler(void);
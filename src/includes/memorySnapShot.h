@@ -10,3 +10,6 @@ extern void MemorySnapShot_Skip(int Nb);
 extern void MemorySnapShot_Store(void *pData, int Size);
 extern void MemorySnapShot_Capture(const char *pszFileName, bool bConfirm);
 extern void MemorySnapShot_Restore(const char *pszFileName, bool bConfirm);
+extern bool MemorySnapShot_IsLight(void);
+extern size_t MemorySnapShot_CaptureLight(void *pBuffer, size_t nSize);
+extern bool MemorySnapShot_RestoreLight(const void *pBuffer, size_t nSize);
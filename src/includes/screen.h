@@ -63,6 +63,7 @@ typedef struct
   Uint32 HBLPaletteMasks[HBL_PALETTE_MASKS];
   Uint8 *pSTScreen;             /* Copy of screen built up during frame (copy each line on HBL to simulate monitor raster) */
   Uint8 *pSTScreenCopy;         /* Previous frames copy of above  */
+  Uint8 *pSTScreenSpare;        /* Third buffer, used when converting in render thread */
   int VerticalOverscanCopy;	/* Previous screen overscan mode */
   bool bFullUpdate;             /* Set TRUE to cause full update on next draw */
 } FRAMEBUFFER;
@@ -111,6 +112,9 @@ extern void Screen_Reset(void);
 extern bool Screen_Lock(void);
 extern void Screen_UnLock(void);
 extern void Screen_SetFullUpdate(void);
+extern void Screen_FinishRender(void);
+extern void Screen_RequestFrame(void);
+extern bool Screen_FrameNeeded(void);
 extern void Screen_EnterFullScreen(void);
 extern void Screen_ReturnFromFullScreen(void);
 extern void Screen_ModeChanged(bool bForceChange);
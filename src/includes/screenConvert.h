@@ -8,8 +8,9 @@
 void Screen_RemapPalette(void);
 void Screen_SetPaletteColor(Uint8 idx, Uint8 red, Uint8 green, Uint8 blue);
 void ScreenConv_MemorySnapShot_Capture(bool bSave);
+void ScreenConv_SetFullUpdate(void);
 
-void Screen_GenConvert(void *fvram, int vw, int vh, int vbpp, int nextline,
+bool Screen_GenConvert(void *fvram, int vw, int vh, int vbpp, int nextline,
                        int hscroll, int leftBorderSize, int rightBorderSize,
                        int upperBorderSize, int lowerBorderSize);
 
@@ -17,10 +17,11 @@
 #define MIXBUFFER_SIZE    16384			/* Size of circular buffer to store sample to (44Khz) */
 
 extern Uint8	SoundRegs[ 14 ];		/* store YM regs 0 to 13 */
-extern int	nGeneratedSamples;
+extern volatile int	nGeneratedSamples;
 extern bool	bEnvelopeFreqFlag;
 extern Sint16	MixBuffer[MIXBUFFER_SIZE][2];
 extern bool	Sound_BufferIndexNeedReset;
+extern bool	Sound_SkipSynthesis;
 
 /* STSound sound renderer active */
 #include <SDL_types.h>
@@ -8,6 +8,20 @@
 #ifndef HATARI_SPEC512_H
 #define HATARI_SPEC512_H
 
+#include "screen.h"
+
+/* Palette change in a scanline, with the color already converted for the host */
+typedef struct
+{
+	int Span;             /* 4-cycle span in the line where the change happens */
+	int Index;            /* Index into 'STRGBPalette' */
+	Uint32 RGB;           /* Host color */
+}
+SPEC512_SPAN;
+
+extern SPEC512_SPAN *pSpec512Span;
+extern int nSpec512Span;
+
 extern bool Spec512_IsImage(void);
 extern void Spec512_StartVBL(void);
 extern void Spec512_StoreCyclePalette(Uint16 col, Uint32 addr);
@@ -15,6 +29,19 @@ extern void Spec512_StartFrame(void);
 extern void Spec512_ScanWholeLine(void);
 extern void Spec512_StartScanLine(void);
 extern void Spec512_EndScanLine(void);
-extern void Spec512_UpdatePaletteSpan(void);
+
+/**
+ * Update palette for 4-pixels span, storing to 'STRGBPalette'
+ */
+static inline void Spec512_UpdatePaletteSpan(void)
+{
+	if (pSpec512Span->Span == nSpec512Span)
+	{
+		/* Need to update palette with new entry */
+		STRGBPalette[pSpec512Span->Index] = pSpec512Span->RGB;
+		pSpec512Span += 1;
+	}
+	nSpec512Span += 1;            /* Next 4 cycles */
+}
 
 #endif  /* HATARI_SPEC512_H */
@@ -11,6 +11,22 @@
 #include "main.h"
 #include "sysdeps.h"
 #include "maccess.h"
+
+/* Write stamps : each page of ST RAM stores the stamp that was current */
+/* during its last write, which allows to know if an area of ST RAM was */
+/* modified since a given stamp. This is declared before including */
+/* emumemory.h, as the CPU's direct RAM writes also update the stamps */
+#define STMEMORY_STAMP_PAGE_SHIFT	9		/* 512 bytes per page */
+#define STMEMORY_STAMP_PAGES		((16*1024*1024) >> STMEMORY_STAMP_PAGE_SHIFT)
+
+extern Uint32 STMemory_WriteStamps[STMEMORY_STAMP_PAGES];
+extern Uint32 STMemory_WriteStamp;
+
+static inline void STMemory_MarkWritten(Uint32 addr)
+{
+	STMemory_WriteStamps[ ( addr & 0xffffff ) >> STMEMORY_STAMP_PAGE_SHIFT ] = STMemory_WriteStamp;
+}
+
 #ifdef __LIBRETRO__ 	/* RETRO HACK */
 #include "emumemory.h"
 #else
@@ -31,6 +47,11 @@ extern uae_u32 TTmem_size;
 
 extern Uint32 STRamEnd;
 
+extern void STMemory_MarkAreaWritten(Uint32 addr, Uint32 len);
+extern void STMemory_MarkAllWritten(void);
+extern bool STMemory_IsAreaWrittenSince(Uint32 addr, Uint32 len, Uint32 stamp);
+extern bool STMemory_NewWriteStamp(void);
+
 
 extern bool STMemory_SafeCopy(Uint32 addr, Uint8 *src, unsigned int len, const char *name);
 extern void STMemory_MemorySnapShot_Capture(bool bSave);
@@ -34,6 +34,14 @@
 #define MIN_VDI_HEIGHT  208
 
 
+/* VDI_AES_Entry() return values */
+enum
+{
+  VDI_TRAP_TOS,       /* let TOS handle the call */
+  VDI_TRAP_COMPLETE,  /* VDI_Complete() needs to be called on trap return */
+  VDI_TRAP_DONE       /* call was handled, skip TOS */
+};
+
 enum
 {
   GEMCOLOR_2,
@@ -49,7 +57,7 @@ extern int VDIRes,VDIPlanes;
 extern void VDI_SetResolution(int GEMColor, int WidthRequest, int HeightRequest);
 extern void AES_Info(FILE *fp, Uint32 bShowOpcodes);
 extern void VDI_Info(FILE *fp, Uint32 bShowOpcodes);
-extern bool VDI_AES_Entry(void);
+extern int VDI_AES_Entry(void);
 extern void VDI_LineA(Uint32 LineABase, Uint32 FontBase);
 extern void VDI_Complete(void);
 extern void VDI_Reset(void);
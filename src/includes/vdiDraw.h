@@ -0,0 +1,17 @@
+/*
+  Hatari - vdiDraw.h
+
+  This file is distributed under the GNU General Public License, version 2
+  or at your option any later version. Read the file gpl.txt for details.
+*/
+
+#ifndef HATARI_VDIDRAW_H
+#define HATARI_VDIDRAW_H
+
+extern void VDIDraw_Reset(void);
+extern void VDIDraw_SetFonts(Uint32 FontBase, Uint32 DefFont);
+extern bool VDIDraw_Call(Uint32 Control, Uint32 Intin, Uint32 Ptsin);
+extern void VDIDraw_Complete(Uint32 Control, Uint32 Intin);
+extern void VDIDraw_MemorySnapShot_Capture(bool bSave);
+
+#endif  /* HATARI_VDIDRAW_H */
@@ -129,6 +129,7 @@
 extern int STRes;
 extern int TTRes;
 extern int nFrameSkips;
+extern bool bSkipScreenDraw;
 extern bool bUseHighRes;
 extern int nVBLs;
 extern int nHBL;
@@ -188,6 +189,7 @@ extern void	Video_GetTTRes(int *width, int *height, int *bpp);
 extern bool	Video_RenderTTScreen(void);
 
 extern void	Video_AddInterruptTimerB ( int LineVideo , int CycleVideo , int Pos );
+extern void	Video_LineBatch_Stop ( void );
 
 extern void	Video_StartInterrupts ( int PendingCyclesOver );
 extern void	Video_InterruptHandler_VBL(void);
@@ -233,6 +235,8 @@ extern void Video_Color12_ReadWord(void);
 extern void Video_Color13_ReadWord(void);
 extern void Video_Color14_ReadWord(void);
 extern void Video_Color15_ReadWord(void);
+extern void Video_ColorRegs_ReadLong(void);
+extern void Video_ColorRegs_WriteLong(void);
 extern void Video_Res_WriteByte(void);
 extern void Video_HorScroll_Read_8264(void);
 extern void Video_HorScroll_Read_8265(void);
@@ -27,6 +27,10 @@
   to cope with all type of handlers in a straight forward way.
   Also note the 'mirror' (or shadow) registers of the PSG - this is used by most
   games.
+  As IO registers are accessed very often (e.g. palette changes for rasters),
+  the type of each address is precomputed: void and read-through regions are
+  handled without calling any handler, and some groups of registers have native
+  word/long handlers which take care of the whole access in a single call.
 */
 const char IoMem_fileid[] = "Hatari ioMem.c : " __DATE__ " " __TIME__;
 
@@ -43,6 +47,26 @@ const char IoMem_fileid[] = "Hatari ioMem.c : " __DATE__ " " __TIME__;
 static void (*pInterceptReadTable[0x8000])(void);     /* Table with read access handlers */
 static void (*pInterceptWriteTable[0x8000])(void);    /* Table with write access handlers */
 
+/*
+  To avoid calling handlers that do nothing or only fill some bytes, the type
+  of each IO address is computed once the tables above are built. Accesses
+  to read-through or void regions don't call any handler, and registers with
+  a native word/long handler are handled with one call for the whole access.
+*/
+#define IOMEM_TYPE_HANDLER	0x01                  /* A handler has to be called */
+#define IOMEM_TYPE_DIRECT	0x02                  /* No interception, plain memory access */
+#define IOMEM_TYPE_VOID		0x04                  /* Void region, read as 0xff */
+#define IOMEM_TYPE_VOID_00	0x08                  /* Void region, read as 0x00 */
+#define IOMEM_TYPE_BUSERROR	0x10                  /* Bus error region */
+#define IOMEM_TYPE_MASK		0x1f
+#define IOMEM_TYPE_NATIVE_WORD	0x20                  /* Native handler for a word access at this address */
+#define IOMEM_TYPE_NATIVE_LONG	0x40                  /* Native handler for a long access at this address */
+
+static Uint8 IoMemReadType[0x8000];                   /* IOMEM_TYPE_xxx for read accesses */
+static Uint8 IoMemWriteType[0x8000];                  /* IOMEM_TYPE_xxx for write accesses */
+static Uint8 IoMemNativeIndex[0x8000];                /* Index in pNativeAccessFuncs[] when IOMEM_TYPE_NATIVE_xxx is set */
+static const INTERCEPT_NATIVE_FUNC *pNativeAccessFuncs;
+
 int nIoMemAccessSize;                                 /* Set to 1, 2 or 4 according to byte, word or long word access */
 Uint32 IoAccessBaseAddress;                           /* Stores the base address of the IO mem access */
 Uint32 IoAccessCurrentAddress;                        /* Current byte address while handling WORD and LONG accesses */
@@ -223,6 +247,146 @@ static void IoMem_FixVoidAccessForCompatibleFalcon(void)
 }
 
 
+/**
+ * Return the IOMEM_TYPE_xxx of a read or write handler
+ */
+static Uint8 IoMem_GetHandlerType(void (*func)(void), bool bRead)
+{
+	if (func == IoMem_BusErrorEvenReadAccess || func == IoMem_BusErrorOddReadAccess
+	    || func == IoMem_BusErrorEvenWriteAccess || func == IoMem_BusErrorOddWriteAccess)
+		return IOMEM_TYPE_BUSERROR;
+
+	if (bRead)
+	{
+		if (func == IoMem_ReadWithoutInterception)
+			return IOMEM_TYPE_DIRECT;
+		if (func == IoMem_VoidRead)
+			return IOMEM_TYPE_VOID;
+		if (func == IoMem_VoidRead_00)
+			return IOMEM_TYPE_VOID_00;
+	}
+	else
+	{
+		/* Value is already stored in IO memory, nothing else to do */
+		if (func == IoMem_WriteWithoutInterception || func == IoMem_VoidWrite)
+			return IOMEM_TYPE_DIRECT;
+	}
+
+	return IOMEM_TYPE_HANDLER;
+}
+
+
+/**
+ * Compute the type of each IO address from the intercept tables and
+ * add the native word/long handlers of the current machine.
+ */
+static void IoMem_InitAccessTypes(void)
+{
+	Uint32 addr, start, end;
+	bool bReadOk, bWriteOk;
+	int i;
+
+	for (addr = 0xff8000; addr <= 0xffffff; addr++)
+	{
+		IoMemReadType[addr - 0xff8000] = IoMem_GetHandlerType(pInterceptReadTable[addr - 0xff8000], true);
+		IoMemWriteType[addr - 0xff8000] = IoMem_GetHandlerType(pInterceptWriteTable[addr - 0xff8000], false);
+		IoMemNativeIndex[addr - 0xff8000] = 0;
+	}
+
+	for (i = 0; pNativeAccessFuncs[i].Address != 0; i++)
+	{
+		start = pNativeAccessFuncs[i].Address;
+		end = start + pNativeAccessFuncs[i].SpanInBytes;
+
+		/* Registers of this group might have been disabled (e.g. no blitter) */
+		bReadOk = bWriteOk = true;
+		for (addr = start; addr < end; addr++)
+		{
+			if (IoMemReadType[addr - 0xff8000] == IOMEM_TYPE_BUSERROR)
+				bReadOk = false;
+			if (IoMemWriteType[addr - 0xff8000] == IOMEM_TYPE_BUSERROR)
+				bWriteOk = false;
+		}
+
+		for (addr = start; addr < end; addr += 2)
+		{
+			IoMemNativeIndex[addr - 0xff8000] = i;
+			if (bReadOk && pNativeAccessFuncs[i].ReadWordFunc && addr + SIZE_WORD <= end)
+				IoMemReadType[addr - 0xff8000] |= IOMEM_TYPE_NATIVE_WORD;
+			if (bReadOk && pNativeAccessFuncs[i].ReadLongFunc && addr + SIZE_LONG <= end)
+				IoMemReadType[addr - 0xff8000] |= IOMEM_TYPE_NATIVE_LONG;
+			if (bWriteOk && pNativeAccessFuncs[i].WriteWordFunc && addr + SIZE_WORD <= end)
+				IoMemWriteType[addr - 0xff8000] |= IOMEM_TYPE_NATIVE_WORD;
+			if (bWriteOk && pNativeAccessFuncs[i].WriteLongFunc && addr + SIZE_LONG <= end)
+				IoMemWriteType[addr - 0xff8000] |= IOMEM_TYPE_NATIVE_LONG;
+		}
+	}
+}
+
+
+/**
+ * Call the read handlers for all the bytes of the current access. Each handler
+ * is called only once for consecutive bytes, while void and bus error bytes
+ * are directly handled here.
+ */
+static void IoMem_CallReadHandlers(Uint32 addr, int size)
+{
+	Uint32 idx = addr - 0xff8000;
+	int n;
+
+	for (n = 0; n < size; n++)
+	{
+		switch (IoMemReadType[idx+n] & IOMEM_TYPE_MASK)
+		{
+		 case IOMEM_TYPE_HANDLER:
+			if (n == 0 || pInterceptReadTable[idx+n] != pInterceptReadTable[idx+n-1])
+			{
+				IoAccessCurrentAddress = addr + n;
+				pInterceptReadTable[idx+n]();     /* Call n-th handler */
+			}
+			break;
+		 case IOMEM_TYPE_VOID:
+			IoMem[addr+n] = 0xff;
+			break;
+		 case IOMEM_TYPE_VOID_00:
+			IoMem[addr+n] = 0x00;
+			break;
+		 case IOMEM_TYPE_BUSERROR:
+			nBusErrorAccesses += 1;
+			IoMem[addr+n] = 0xff;
+			break;
+		}
+	}
+}
+
+
+/**
+ * Same as IoMem_CallReadHandlers(), but for write accesses
+ */
+static void IoMem_CallWriteHandlers(Uint32 addr, int size)
+{
+	Uint32 idx = addr - 0xff8000;
+	int n;
+
+	for (n = 0; n < size; n++)
+	{
+		switch (IoMemWriteType[idx+n] & IOMEM_TYPE_MASK)
+		{
+		 case IOMEM_TYPE_HANDLER:
+			if (n == 0 || pInterceptWriteTable[idx+n] != pInterceptWriteTable[idx+n-1])
+			{
+				IoAccessCurrentAddress = addr + n;
+				pInterceptWriteTable[idx+n]();    /* Call n-th handler */
+			}
+			break;
+		 case IOMEM_TYPE_BUSERROR:
+			nBusErrorAccesses += 1;
+			break;
+		}
+	}
+}
+
+
 /**
  * Create 'intercept' tables for hardware address access. Each 'intercept
  * table is a list of 0x8000 pointers to a list of functions to call when
@@ -242,25 +406,31 @@ void IoMem_Init(void)
 	 case MACHINE_ST:
 		IoMem_FixVoidAccessForST();
 		pInterceptAccessFuncs = IoMemTable_ST;
+		pNativeAccessFuncs = IoMemNativeTable_ST;
 		break;
 	 case MACHINE_MEGA_ST:
 		IoMem_FixVoidAccessForMegaST();
 		pInterceptAccessFuncs = IoMemTable_ST;
+		pNativeAccessFuncs = IoMemNativeTable_ST;
 		break;
 	 case MACHINE_STE:
 		pInterceptAccessFuncs = IoMemTable_STE;
+		pNativeAccessFuncs = IoMemNativeTable_STE;
 		break;
 	 case MACHINE_MEGA_STE:
 		IoMem_FixAccessForMegaSTE();
 		pInterceptAccessFuncs = IoMemTable_STE;
+		pNativeAccessFuncs = IoMemNativeTable_STE;
 		break;
 	 case MACHINE_TT:
 		pInterceptAccessFuncs = IoMemTable_TT;
+		pNativeAccessFuncs = IoMemNativeTable_TT;
 		break;
 	 case MACHINE_FALCON:
 		if (falconBusMode == STE_BUS_COMPATIBLE)
 			IoMem_FixVoidAccessForCompatibleFalcon();
 		pInterceptAccessFuncs = IoMemTable_Falcon;
+		pNativeAccessFuncs = IoMemNativeTable_Falcon;
 		break;
 	 default:
 		abort(); /* bug */
@@ -347,6 +517,8 @@ void IoMem_Init(void)
 
 		}
 	}
+
+	IoMem_InitAccessTypes();
 }
 
 /*-----------------------------------------------------------------------*/
@@ -379,7 +551,8 @@ void IoMem_UnInit(void)
  */
 uae_u32 REGPARAM3 IoMem_bget(uaecptr addr)
 {
-	Uint8 val;
+	Uint32 idx;
+	Uint8 val, type;
 
 	/* Check if access is made by a new instruction or by the same instruction doing multiple byte accesses */
 	if ( IoAccessInstrPrevClock == CyclesGlobalClockCounter )
@@ -405,9 +578,18 @@ uae_u32 REGPARAM3 IoMem_bget(uaecptr addr)
 	IoAccessBaseAddress = addr;                   /* Store access location */
 	nIoMemAccessSize = SIZE_BYTE;
 	nBusErrorAccesses = 0;
+	idx = addr - 0xff8000;
 
-	IoAccessCurrentAddress = addr;
-	pInterceptReadTable[addr-0xff8000]();         /* Call handler */
+	type = IoMemReadType[idx] & IOMEM_TYPE_MASK;
+	if (type == IOMEM_TYPE_HANDLER)
+	{
+		IoAccessCurrentAddress = addr;
+		pInterceptReadTable[idx]();           /* Call handler */
+	}
+	else if (type != IOMEM_TYPE_DIRECT)
+	{
+		IoMem_CallReadHandlers(addr, SIZE_BYTE);
+	}
 
 	/* Check if we read from a bus-error region */
 	if (nBusErrorAccesses == 1)
@@ -432,6 +614,7 @@ uae_u32 REGPARAM3 IoMem_wget(uaecptr addr)
 {
 	Uint32 idx;
 	Uint16 val;
+	Uint8 type;
 
 	/* Check if access is made by a new instruction or by the same instruction doing multiple word accesses */
 	if ( IoAccessInstrPrevClock == CyclesGlobalClockCounter )
@@ -465,13 +648,15 @@ uae_u32 REGPARAM3 IoMem_wget(uaecptr addr)
 	nBusErrorAccesses = 0;
 	idx = addr - 0xff8000;
 
-	IoAccessCurrentAddress = addr;
-	pInterceptReadTable[idx]();                   /* Call 1st handler */
-
-	if (pInterceptReadTable[idx+1] != pInterceptReadTable[idx])
+	type = IoMemReadType[idx];
+	if (type & IOMEM_TYPE_NATIVE_WORD)
+	{
+		IoAccessCurrentAddress = addr;
+		pNativeAccessFuncs[IoMemNativeIndex[idx]].ReadWordFunc();	/* One call for the whole word */
+	}
+	else if (((type | IoMemReadType[idx+1]) & IOMEM_TYPE_MASK) != IOMEM_TYPE_DIRECT)
 	{
-		IoAccessCurrentAddress = addr + 1;
-		pInterceptReadTable[idx+1]();             /* Call 2nd handler */
+		IoMem_CallReadHandlers(addr, SIZE_WORD);
 	}
 
 	/* Check if we completely read from a bus-error region */
@@ -497,7 +682,7 @@ uae_u32 REGPARAM3 IoMem_lget(uaecptr addr)
 {
 	Uint32 idx;
 	Uint32 val;
-	int n;
+	Uint8 type;
 
 	/* Check if access is made by a new instruction or by the same instruction doing multiple long accesses */
 	if ( IoAccessInstrPrevClock == CyclesGlobalClockCounter )
@@ -530,16 +715,16 @@ uae_u32 REGPARAM3 IoMem_lget(uaecptr addr)
 	nBusErrorAccesses = 0;
 	idx = addr - 0xff8000;
 
-	IoAccessCurrentAddress = addr;
-	pInterceptReadTable[idx]();                   /* Call 1st handler */
-
-	for (n = 1; n < nIoMemAccessSize; n++)
+	type = IoMemReadType[idx];
+	if (type & IOMEM_TYPE_NATIVE_LONG)
 	{
-		if (pInterceptReadTable[idx+n] != pInterceptReadTable[idx+n-1])
-		{
-			IoAccessCurrentAddress = addr + n;
-			pInterceptReadTable[idx+n]();     /* Call n-th handler */
-		}
+		IoAccessCurrentAddress = addr;
+		pNativeAccessFuncs[IoMemNativeIndex[idx]].ReadLongFunc();	/* One call for the whole long word */
+	}
+	else if (((type | IoMemReadType[idx+1] | IoMemReadType[idx+2] | IoMemReadType[idx+3])
+	          & IOMEM_TYPE_MASK) != IOMEM_TYPE_DIRECT)
+	{
+		IoMem_CallReadHandlers(addr, SIZE_LONG);
 	}
 
 	/* Check if we completely read from a bus-error region */
@@ -563,6 +748,9 @@ uae_u32 REGPARAM3 IoMem_lget(uaecptr addr)
  */
 void REGPARAM3 IoMem_bput(uaecptr addr, uae_u32 val)
 {
+	Uint32 idx;
+	Uint8 type;
+
 	/* Check if access is made by a new instruction or by the same instruction doing multiple byte accesses */
 	if ( IoAccessInstrPrevClock == CyclesGlobalClockCounter )
 		IoAccessInstrCount++;			/* Same instruction, increase access count */
@@ -591,9 +779,18 @@ void REGPARAM3 IoMem_bput(uaecptr addr, uae_u32 val)
 	nBusErrorAccesses = 0;
 
 	IoMem[addr] = val;
+	idx = addr - 0xff8000;
 
-	IoAccessCurrentAddress = addr;
-	pInterceptWriteTable[addr-0xff8000]();        /* Call handler */
+	type = IoMemWriteType[idx] & IOMEM_TYPE_MASK;
+	if (type == IOMEM_TYPE_HANDLER)
+	{
+		IoAccessCurrentAddress = addr;
+		pInterceptWriteTable[idx]();          /* Call handler */
+	}
+	else if (type != IOMEM_TYPE_DIRECT)
+	{
+		IoMem_CallWriteHandlers(addr, SIZE_BYTE);
+	}
 
 	/* Check if we wrote to a bus-error region */
 	if (nBusErrorAccesses == 1)
@@ -610,6 +807,7 @@ void REGPARAM3 IoMem_bput(uaecptr addr, uae_u32 val)
 void REGPARAM3 IoMem_wput(uaecptr addr, uae_u32 val)
 {
 	Uint32 idx;
+	Uint8 type;
 
 	/* Check if access is made by a new instruction or by the same instruction doing multiple word accesses */
 	if ( IoAccessInstrPrevClock == CyclesGlobalClockCounter )
@@ -647,13 +845,15 @@ void REGPARAM3 IoMem_wput(uaecptr addr, uae_u32 val)
 	IoMem_WriteWord(addr, val);
 	idx = addr - 0xff8000;
 
-	IoAccessCurrentAddress = addr;
-	pInterceptWriteTable[idx]();                  /* Call 1st handler */
-
-	if (pInterceptWriteTable[idx+1] != pInterceptWriteTable[idx])
+	type = IoMemWriteType[idx];
+	if (type & IOMEM_TYPE_NATIVE_WORD)
+	{
+		IoAccessCurrentAddress = addr;
+		pNativeAccessFuncs[IoMemNativeIndex[idx]].WriteWordFunc();	/* One call for the whole word */
+	}
+	else if (((type | IoMemWriteType[idx+1]) & IOMEM_TYPE_MASK) != IOMEM_TYPE_DIRECT)
 	{
-		IoAccessCurrentAddress = addr + 1;
-		pInterceptWriteTable[idx+1]();            /* Call 2nd handler */
+		IoMem_CallWriteHandlers(addr, SIZE_WORD);
 	}
 
 	/* Check if we wrote to a bus-error region */
@@ -671,7 +871,7 @@ void REGPARAM3 IoMem_wput(uaecptr addr, uae_u32 val)
 void REGPARAM3 IoMem_lput(uaecptr addr, uae_u32 val)
 {
 	Uint32 idx;
-	int n;
+	Uint8 type;
 
 	/* Check if access is made by a new instruction or by the same instruction doing multiple long accesses */
 	if ( IoAccessInstrPrevClock == CyclesGlobalClockCounter )
@@ -708,16 +908,16 @@ void REGPARAM3 IoMem_lput(uaecptr addr, uae_u32 val)
 	IoMem_WriteLong(addr, val);
 	idx = addr - 0xff8000;
 
-	IoAccessCurrentAddress = addr;
-	pInterceptWriteTable[idx]();                  /* Call first handler */
-
-	for (n = 1; n < nIoMemAccessSize; n++)
+	type = IoMemWriteType[idx];
+	if (type & IOMEM_TYPE_NATIVE_LONG)
 	{
-		if (pInterceptWriteTable[idx+n] != pInterceptWriteTable[idx+n-1])
-		{
-			IoAccessCurrentAddress = addr + n;
-			pInterceptWriteTable[idx+n]();   /* Call n-th handler */
-		}
+		IoAccessCurrentAddress = addr;
+		pNativeAccessFuncs[IoMemNativeIndex[idx]].WriteLongFunc();	/* One call for the whole long word */
+	}
+	else if (((type | IoMemWriteType[idx+1] | IoMemWriteType[idx+2] | IoMemWriteType[idx+3])
+	          & IOMEM_TYPE_MASK) != IOMEM_TYPE_DIRECT)
+	{
+		IoMem_CallWriteHandlers(addr, SIZE_LONG);
 	}
 
 	/* Check if we wrote to a bus-error region */
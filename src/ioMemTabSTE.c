@@ -271,3 +271,20 @@ const INTERCEPT_ACCESS_FUNC IoMemTable_STE[] =
 
 	{ 0, 0, NULL, NULL }
 };
+
+
+/*-----------------------------------------------------------------------*/
+/*
+  List of native word/long access handlers for a STE.
+*/
+const INTERCEPT_NATIVE_FUNC IoMemNativeTable_STE[] =
+{
+	{ 0xff8240, 32, NULL, NULL, Video_ColorRegs_ReadLong, Video_ColorRegs_WriteLong },     /* Palette */
+	{ 0xff8908, 6,  DmaSnd_FrameCount_ReadWordLong, NULL, DmaSnd_FrameCount_ReadWordLong, NULL }, /* DMA sound frame count */
+	{ 0xff8a00, 32, NULL, NULL, Blitter_Halftone_ReadLong, Blitter_Halftone_WriteLong },   /* Blitter halftone RAM */
+	{ 0xff8a20, 4,  NULL, NULL, Blitter_SourceInc_ReadLong, Blitter_SourceInc_WriteLong }, /* Blitter source x/y increment */
+	{ 0xff8a28, 6,  NULL, NULL, Blitter_Endmask_ReadLong, Blitter_Endmask_WriteLong },     /* Blitter endmasks */
+	{ 0xff8a2e, 4,  NULL, NULL, Blitter_DestInc_ReadLong, Blitter_DestInc_WriteLong },     /* Blitter dest. x/y increment */
+	{ 0xff8a36, 4,  NULL, NULL, Blitter_Count_ReadLong, Blitter_Count_WriteLong },         /* Blitter x/y count */
+	{ 0, 0, NULL, NULL, NULL, NULL }
+};
@@ -195,3 +195,14 @@ const INTERCEPT_ACCESS_FUNC IoMemTable_TT[] =
 
 	{ 0, 0, NULL, NULL }
 };
+
+
+/*-----------------------------------------------------------------------*/
+/*
+  List of native word/long access handlers for a TT.
+*/
+const INTERCEPT_NATIVE_FUNC IoMemNativeTable_TT[] =
+{
+	{ 0xff8908, 6,  DmaSnd_FrameCount_ReadWordLong, NULL, DmaSnd_FrameCount_ReadWordLong, NULL }, /* DMA sound frame count */
+	{ 0, 0, NULL, NULL, NULL, NULL }
+};
@@ -267,11 +267,10 @@ void M68000_Reset(bool bCold)
 
 /*-----------------------------------------------------------------------*/
 /**
- * Start 680x0 emulation
+ * Load the initial memory snapshot, if any
  */
-void M68000_Start(void)
+static void M68000_LoadInitialSnapShot(void)
 {
-	/* Load initial memory snapshot */
 	if (bLoadMemorySave)
 	{
 		MemorySnapShot_Restore(ConfigureParams.Memory.szMemoryCaptureFileName, false);
@@ -280,11 +279,58 @@ void M68000_Start(void)
 	{
 		MemorySnapShot_Restore(ConfigureParams.Memory.szAutoSaveFileName, false);
 	}
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Start 680x0 emulation
+ */
+void M68000_Start(void)
+{
+	M68000_LoadInitialSnapShot();
 
 	m68k_go(true);
 }
 
 
+#ifdef __LIBRETRO__	/* RETRO HACK */
+/*-----------------------------------------------------------------------*/
+/**
+ * Same as M68000_Start(), but return without running the CPU.
+ * The emulation is then run by calling M68000_Run() repeatedly,
+ * until M68000_Stop() is called.
+ */
+void M68000_Setup(void)
+{
+	M68000_LoadInitialSnapShot();
+
+	m68k_go_start();
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Run 680x0 emulation until the CPU is asked to leave its main loop
+ * with SPCFLAG_BRK (or until the CPU mode changes)
+ */
+void M68000_Run(void)
+{
+	m68k_go_run();
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * End 680x0 emulation started with M68000_Setup()
+ */
+void M68000_Stop(void)
+{
+	m68k_go_stop();
+}
+#endif	/* RETRO HACK */
+
+
 /*-----------------------------------------------------------------------*/
 /**
  * Check whether CPU settings have been changed.
@@ -388,6 +434,16 @@ void M68000_MemorySnapShot_Capture(bool bSave)
 	int len;
 	uae_u8 chunk[ 1000 ];
 
+	/* Lightweight snapshots are restored within the same session, so the */
+	/* 68000 state can be copied as is, without rebuilding the CPU tables */
+	/* (more complex CPUs use the normal functions, see restore_cpu_finish) */
+	if (MemorySnapShot_IsLight() && currprefs.cpu_model < 68020 && !currprefs.fpu_model)
+	{
+		MemorySnapShot_Store(&regs, sizeof(regs));
+		MemorySnapShot_Store(&regflags, sizeof(regflags));
+		return;
+	}
+
 	if (bSave)
 	{
 		//m68k_dumpstate_file(stderr, NULL);
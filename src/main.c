@@ -10,6 +10,7 @@ const char Main_fileid[] = "Hatari main.c : " __DATE__ " " __TIME__;
 
 #include <time.h>
 #include <errno.h>
+#include <math.h>
 #include <SDL.h>
 
 #include "main.h"
@@ -19,6 +20,7 @@ const char Main_fileid[] = "Hatari main.c : " __DATE__ " " __TIME__;
 #include "options.h"
 #include "dialog.h"
 #include "audio.h"
+#include "batch.h"
 #include "joy.h"
 #include "floppy.h"
 #include "floppy_ipf.h"
@@ -35,6 +37,7 @@ const char Main_fileid[] = "Hatari main.c : " __DATE__ " " __TIME__;
 #include "m68000.h"
 #include "memorySnapShot.h"
 #include "midi.h"
+#include "natfeats.h"
 #include "nvram.h"
 #include "paths.h"
 #include "printer.h"
@@ -83,6 +86,20 @@ static int nVBLSlowdown = 1;		  /* host VBL wait multiplier */
 
 static bool bEmulationActive = true;      /* Run emulation when started */
 static bool bAccurateDelays;              /* Host system has an accurate SDL_Delay()? */
+static Sint64 nDelayOvershoot_micro = 1000; /* How late Time_Delay() wakes up on this host */
+static bool bBusyWait = false;            /* Busy wait for the end of the VBL (old behavior) */
+#ifdef __LIBRETRO__	/* RETRO HACK */
+static bool bFrameDone;                   /* VBL reached, return from Main_RunFrame() */
+#endif	/* RETRO HACK */
+
+/* Statistics about the difference between the expected and real end of each VBL wait */
+static struct {
+	Uint32 nCount;
+	Sint64 nMin_micro;
+	Sint64 nMax_micro;
+	double Sum_micro;
+	double SumSquares_micro;
+} PacingStats;
 static bool bIgnoreNextMouseMotion = false;  /* Next mouse motion will be ignored (needed after SDL_WarpMouse) */
 
 #ifndef __LIBRETRO__	/* RETRO HACK */
@@ -134,7 +151,11 @@ static Sint64	Time_GetTicks ( void )
 {
 	Sint64	ticks_micro;
 
-#if HAVE_GETTIMEOFDAY
+#if HAVE_CLOCK_NANOSLEEP
+	struct timespec	now;
+	clock_gettime ( CLOCK_MONOTONIC , &now );		/* not affected by changes of the system clock */
+	ticks_micro = (Sint64)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+#elif HAVE_GETTIMEOFDAY
 	struct timeval	now;
 	gettimeofday ( &now , NULL );
 	ticks_micro = (Sint64)now.tv_sec * 1000000 + now.tv_usec;
@@ -172,6 +193,32 @@ static void	Time_Delay ( Sint64 ticks_micro )
 }
 
 
+/*-----------------------------------------------------------------------*/
+/**
+ * Sleep until Time_GetTicks() reaches a given number of micro seconds.
+ * If clock_nanosleep is available, we use an absolute deadline on the
+ * monotonic clock, so the time spent before sleeping or a possible
+ * interruption by a signal doesn't accumulate errors. Else we use
+ * Time_Delay with the remaining delay.
+ */
+
+static void	Time_SleepUntil ( Sint64 ticks_micro )
+{
+#if HAVE_CLOCK_NANOSLEEP
+	struct timespec	ts;
+	ts.tv_sec = ticks_micro / 1000000;
+	ts.tv_nsec = (ticks_micro % 1000000) * 1000;	/* micro sec -> nano sec */
+	/* keep on sleeping if we were interrupted by a signal */
+	while ( clock_nanosleep ( CLOCK_MONOTONIC , TIMER_ABSTIME , &ts , NULL ) == EINTR )
+		;
+#else
+	Sint64	nDelay = ticks_micro - Time_GetTicks();
+	if ( nDelay > 0 )
+		Time_Delay ( nDelay );
+#endif
+}
+
+
 /*-----------------------------------------------------------------------*/
 /**
  * Pause emulation, stop sound.  'visualize' should be set true,
@@ -184,6 +231,9 @@ bool Main_PauseEmulation(bool visualize)
 	if ( !bEmulationActive )
 		return false;
 
+	/* dialogs etc. may draw on the screen surface */
+	Screen_FinishRender();
+
 	Audio_EnableAudio(false);
 	bEmulationActive = false;
 	if (visualize)
@@ -248,7 +298,8 @@ void Main_RequestQuit(int exitval)
 		bQuitProgram = true;
 		MemorySnapShot_Capture(ConfigureParams.Memory.szAutoSaveFileName, false);
 	}
-	else if (ConfigureParams.Log.bConfirmQuit)
+	else if (ConfigureParams.Log.bConfirmQuit
+	         && ConfigureParams.Screen.nVideoBackend != VIDEO_BACKEND_NONE)
 	{
 		bQuitProgram = false;	/* if set true, dialog exits */
 		bQuitProgram = DlgAlert_Query("All unsaved data will be lost.\nDo you really want to quit?");
@@ -296,14 +347,122 @@ bool Main_SetVBLSlowdown(int factor)
 	return true;
 }
 
+/*-----------------------------------------------------------------------*/
+/**
+ * Enable/disable busy waiting at the end of each VBL
+ */
+void Main_SetBusyWait(bool enable)
+{
+	fprintf(stderr, "Busy waiting for VBL %s.\n", enable ? "enabled" : "disabled");
+	bBusyWait = enable;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Update the statistics about the wake-up time at the end of a VBL wait,
+ * nJitter is the difference between the real and expected wake-up times.
+ */
+static void Main_UpdatePacingStats(Sint64 nJitter_micro)
+{
+	if (PacingStats.nCount == 0 || nJitter_micro < PacingStats.nMin_micro)
+		PacingStats.nMin_micro = nJitter_micro;
+	if (PacingStats.nCount == 0 || nJitter_micro > PacingStats.nMax_micro)
+		PacingStats.nMax_micro = nJitter_micro;
+	PacingStats.Sum_micro += nJitter_micro;
+	PacingStats.SumSquares_micro += (double)nJitter_micro * nJitter_micro;
+	PacingStats.nCount++;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Show VBL pacing method and wake-up jitter statistics (for the
+ * debugger's "info" command). Statistics are reset after being shown.
+ */
+void Main_PacingInfo(FILE *fp, Uint32 dummy)
+{
+	double Mean, Variance;
+
+	fprintf(fp, "VBL pacing: ");
+	if (Audio_GetLatencyTarget() > 0)
+		fprintf(fp, "audio output, %d ms latency\n", AudioLatency);
+	else if (bBusyWait)
+		fprintf(fp, "sleep + busy wait (sleep overshoot %d us)\n", (int)nDelayOvershoot_micro);
+#if HAVE_CLOCK_NANOSLEEP
+	else
+		fprintf(fp, "clock_nanosleep with absolute deadline\n");
+#else
+	else
+		fprintf(fp, "sleep with relative delay\n");
+#endif
+
+	if (PacingStats.nCount == 0)
+	{
+		fprintf(fp, "- no timer based VBL wait since last check\n");
+		return;
+	}
+
+	Mean = PacingStats.Sum_micro / PacingStats.nCount;
+	Variance = PacingStats.SumSquares_micro / PacingStats.nCount - Mean * Mean;
+	fprintf(fp, "- wake-up jitter over %u VBLs: min %d us, max %d us, mean %.1f us, std dev %.1f us\n",
+		PacingStats.nCount, (int)PacingStats.nMin_micro, (int)PacingStats.nMax_micro,
+		Mean, Variance > 0 ? sqrt(Variance) : 0);
+
+	memset(&PacingStats, 0, sizeof(PacingStats));
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * When the emulation is paced by the audio output (--sound-latency), wait
+ * until the number of samples in the sound buffer goes down to the target
+ * latency. The delay is computed from the number of samples in excess, so
+ * we sleep until the audio output consumed them and there's no busy wait.
+ * As a new frame of samples is generated after each wait, this keeps the
+ * latency close to the target, whatever the drift between the host clock
+ * and the sound card's clock.
+ * Return false if the emulation can't be paced by the audio output.
+ */
+static bool Main_WaitOnAudio(Sint64 FrameDuration_micro)
+{
+	int Target, Excess;
+	Sint64 nDelay;
+	Sint64 nWaited = 0;
+
+	Target = Audio_GetLatencyTarget();
+	if (Target <= 0 || nVBLSlowdown > 1)
+		return false;
+
+	while ((Excess = Audio_GetBufferFill() - Target) > 0)
+	{
+		nDelay = (Sint64)Excess * 1000000 / nAudioFrequency;
+
+		/* The audio output consumes samples by blocks ; if it seems to be */
+		/* stalled, don't wait for more than a few frames */
+		if (nWaited + nDelay > 4*FrameDuration_micro)
+			nDelay = 4*FrameDuration_micro - nWaited;
+		if (nDelay <= 0)
+			break;
+
+		Time_Delay(nDelay);
+		nWaited += nDelay;
+	}
+
+	return true;
+}
+
+
 /*-----------------------------------------------------------------------*/
 /**
  * This function waits on each emulated VBL to synchronize the real time
  * with the emulated ST.
- * Unfortunately SDL_Delay and other sleep functions like usleep or nanosleep
- * are very inaccurate on some systems like Linux 2.4 or Mac OS X (they can only
- * wait for a multiple of 10ms due to the scheduler on these systems), so we have
- * to "busy wait" there to get an accurate timing.
+ * If the emulation is paced by the audio output, we only wait for the
+ * sound buffer to reach the target latency (see Main_WaitOnAudio()).
+ * Else we sleep until the absolute time of the end of the VBL. If the user
+ * asked for it (--busy-wait), we sleep until shortly before the end of the
+ * VBL and we "busy wait" for the remaining time, to get an accurate timing
+ * on systems where sleep functions are inaccurate.
  * All times are expressed as micro seconds, to avoid too much rounding error.
  */
 void Main_WaitOnVbl(void)
@@ -312,25 +471,38 @@ void Main_WaitOnVbl(void)
 	static Sint64 DestTicks = 0;
 	Sint64 FrameDuration_micro;
 	Sint64 nDelay;
-#ifdef __LIBRETRO__	/* RETRO HACK */
-if(pauseg==1)pause_select();
-#ifdef HAVE_LIBCO
-co_switch(mainThread);
-#else
-CPULOOP=0;
-#endif
-#endif	/* RETRO HACK */
+
 	nVBLCount++;
 	if (nRunVBLs &&	nVBLCount >= nRunVBLs)
 	{
 		/* show VBLs/s */
 		Main_PauseEmulation(true);
+		Batch_JobDone();
 		exit(0);
 	}
+	/* batch job saves the screen of the last frame */
+	if (nRunVBLs && nVBLCount + 1 >= nRunVBLs)
+		Screen_RequestFrame();
+#ifdef __LIBRETRO__	/* RETRO HACK */
+	/* leave the CPU loop, so the frame can be returned to the frontend.
+	 * The frontend paces the emulation (and may run several frames in
+	 * a row, e.g. for run-ahead), so don't wait here */
+	bFrameDone = true;
+	M68000_SetSpecial(SPCFLAG_BRK);
+	return;
+#endif	/* RETRO HACK */
 
 //	FrameDuration_micro = (Sint64) ( 1000000.0 / nScreenRefreshRate + 0.5 );	/* round to closest integer */
 	FrameDuration_micro = ClocksTimings_GetVBLDuration_micro ( ConfigureParams.System.nMachineType , nScreenRefreshRate );
 	FrameDuration_micro *= nVBLSlowdown;
+
+	if (ConfigureParams.System.bFastForward == false
+	    && Main_WaitOnAudio(FrameDuration_micro))
+	{
+		DestTicks = 0;			/* resync host timer if audio pacing is stopped */
+		return;
+	}
+
 	CurrentTicks = Time_GetTicks();
 
 	if (DestTicks == 0)			/* on first call, init DestTicks */
@@ -338,8 +510,6 @@ CPULOOP=0;
 		DestTicks = CurrentTicks + FrameDuration_micro;
 	}
 
-	DestTicks += pulse_swallowing_count;	/* audio.c - Audio_CallBack() */
-
 	nDelay = DestTicks - CurrentTicks;
 
 	/* Do not wait if we are in fast forward mode or if we are totally out of sync */
@@ -371,15 +541,27 @@ CPULOOP=0;
 		// Log_Printf(LOG_DEBUG, "Decreased frameskip to %d\n", nFrameSkips);
 	}
 
+	if (!bBusyWait)
+	{
+		/* Sleep until the end of the VBL, the CPU is free in the meantime */
+		if (nDelay > 0)
+			Time_SleepUntil(DestTicks);
+		CurrentTicks = Time_GetTicks();
+		Main_UpdatePacingStats(CurrentTicks - DestTicks);
+		DestTicks += FrameDuration_micro;
+		return;
+	}
+
 	if (bAccurateDelays)
 	{
-		/* Accurate sleeping is possible -> use SDL_Delay to free the CPU */
-		if (nDelay > 1000)
-			Time_Delay(nDelay - 1000);
+		/* Accurate sleeping is possible -> sleep until shortly before */
+		/* the end of the VBL, depending on the measured overshoot */
+		if (nDelay > nDelayOvershoot_micro + 500)
+			Time_Delay(nDelay - nDelayOvershoot_micro - 500);
 	}
 	else
 	{
-		/* No accurate SDL_Delay -> only wait if more than 5ms to go... */
+		/* No accurate sleep -> only wait if more than 5ms to go... */
 		if (nDelay > 5000)
 			Time_Delay(nDelay<10000 ? nDelay-1000 : 9000);
 	}
@@ -394,6 +576,7 @@ CPULOOP=0;
 		if (nDelay > FrameDuration_micro)
 			break;
 	}
+	Main_UpdatePacingStats(Time_GetTicks() - DestTicks);
 
 //printf ( "tick %lld\n" , CurrentTicks );
 	/* Update DestTicks for next VBL */
@@ -403,27 +586,36 @@ CPULOOP=0;
 
 /*-----------------------------------------------------------------------*/
 /**
- * Since SDL_Delay and friends are very inaccurate on some systems, we have
- * to check if we can rely on this delay function.
+ * Sleep functions can be inaccurate on some systems, so we measure how
+ * late a 1 ms delay wakes up. This is used in busy wait mode to know how
+ * long we can sleep before starting to busy wait.
  */
 static void Main_CheckForAccurateDelays(void)
 {
-	int nStartTicks, nEndTicks;
+	Sint64 nStartTicks, nOvershoot;
+	int i;
 
 	/* Force a task switch now, so we have a longer timeslice afterwards */
-	SDL_Delay(10);
+	Time_Delay(10000);
 
-	nStartTicks = SDL_GetTicks();
-	SDL_Delay(1);
-	nEndTicks = SDL_GetTicks();
+	/* Keep the worst case of a few measures */
+	nDelayOvershoot_micro = 0;
+	for (i = 0; i < 5; i++)
+	{
+		nStartTicks = Time_GetTicks();
+		Time_Delay(1000);
+		nOvershoot = Time_GetTicks() - nStartTicks - 1000;
+		if (nOvershoot > nDelayOvershoot_micro)
+			nDelayOvershoot_micro = nOvershoot;
+	}
 
 	/* If the delay took longer than 10ms, we are on an inaccurate system! */
-	bAccurateDelays = ((nEndTicks - nStartTicks) < 9);
+	bAccurateDelays = (nDelayOvershoot_micro < 8000);
 
 	if (bAccurateDelays)
-		Log_Printf(LOG_DEBUG, "Host system has accurate delays. (%d)\n", nEndTicks - nStartTicks);
+		Log_Printf(LOG_DEBUG, "Host system has accurate delays. (%d us late)\n", (int)nDelayOvershoot_micro);
 	else
-		Log_Printf(LOG_WARN, "Host system does not have accurate delays. (%d)\n", nEndTicks - nStartTicks);
+		Log_Printf(LOG_WARN, "Host system does not have accurate delays. (%d us late)\n", (int)nDelayOvershoot_micro);
 }
 
 
@@ -645,8 +837,10 @@ else SND=-1;
 
 		 case SDL_WINDOWEVENT:
 			if (event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED
-			    || event.window.event == SDL_WINDOWEVENT_RESTORED)
+			    || event.window.event == SDL_WINDOWEVENT_RESTORED
+			    || event.window.event == SDL_WINDOWEVENT_EXPOSED)
 			{
+				/* repaint the whole window, even if the screen didn't change */
 				SDL_UpdateRect(sdlscrn, 0, 0, 0, 0);
 				break;
 			}
@@ -815,6 +1009,7 @@ void Main_UnInit(void)
 	Floppy_UnInit();
 	HDC_UnInit();
 	Midi_UnInit();
+	NatFeat_UnInit();
 	RS232_UnInit();
 	Printer_UnInit();
 	IoMem_UnInit();
@@ -903,15 +1098,12 @@ static void Main_StatusbarSetup(void)
 
 
 /**
- * Main
- * 
- * Note: 'argv' cannot be declared const, MinGW would then fail to link.
+ * Initialize Hatari from the command line, up to the point where
+ * the emulation can be started.
+ * Return false if Hatari should exit instead, nQuitValue is then
+ * the exit code.
  */
-#ifdef __LIBRETRO__	/* RETRO HACK */
-int hmain(int argc, char *argv[])
-#else
-int main(int argc, char *argv[])
-#endif	/* RETRO HACK */
+bool Main_Start(int argc, char *argv[])
 {
 	/* Generate random seed */
 	srand(time(NULL));
@@ -935,7 +1127,8 @@ int main(int argc, char *argv[])
 	if (!Opt_ParseParameters(argc, (const char * const *)argv))
 	{
 #ifndef __LIBRETRO__	/* RETRO HACK */
-		return 1;
+		nQuitValue = 1;
+		return false;
 #endif	/* RETRO HACK */
 	}
 	/* monitor type option might require "reset" -> true */
@@ -963,6 +1156,13 @@ int main(int argc, char *argv[])
 	/* Check if SDL_Delay is accurate */
 	Main_CheckForAccurateDelays();
 
+	/* In batch mode, only the forked job processes run the emulation */
+	if (Batch_IsEnabled() && !Batch_Run(&nQuitValue))
+	{
+		Main_UnInit();
+		return false;
+	}
+
 	if ( AviRecordOnStartup )	/* Immediately starts avi recording ? */
 		Avi_StartRecording ( ConfigureParams.Video.AviRecordFile , ConfigureParams.Screen.bCrop ,
 			ConfigureParams.Video.AviRecordFps == 0 ?
@@ -973,10 +1173,23 @@ int main(int argc, char *argv[])
 
 	/* Run emulation */
 	Main_UnPauseEmulation();
-#ifdef HAVE_LIBCO
+#ifdef __LIBRETRO__	/* RETRO HACK */
+	/* the CPU is then run frame by frame with Main_RunFrame() */
+	M68000_Setup();
+#endif	/* RETRO HACK */
+	return true;
+}
 
-	M68000_Start();                 /* Start emulation */
 
+/**
+ * Un-initialize Hatari after the emulation has ended.
+ * Return the exit code.
+ */
+int Main_Stop(void)
+{
+#ifdef __LIBRETRO__	/* RETRO HACK */
+	M68000_Stop();
+#endif	/* RETRO HACK */
 	if (bRecordingAvi)
 	{
 		/* cleanly close the avi file */
@@ -987,30 +1200,44 @@ int main(int argc, char *argv[])
 	/* Un-init emulation system */
 	Main_UnInit();
 #ifdef __LIBRETRO__	/* RETRO HACK */
-pauseg=-1;
-#endif /* RETRO HACK */
-
-#endif /* RETRO HACK */
+	pauseg=-1;
+#endif	/* RETRO HACK */
 
 	return nQuitValue;
 }
-#if defined(__LIBRETRO__) && !defined(HAVE_LIBCO) /* RETRO HACK */
-void Quit_Hatari(){
 
-       if (bRecordingAvi)
-       {
-               /* cleanly close the avi file */
-               Statusbar_AddMessage("Finishing AVI file...", 100);
-               Statusbar_Update(sdlscrn, true);
-               Avi_StopRecording();
-       }
-       /* Un-init emulation system */
-       Main_UnInit();
 
-       pauseg=-1;
-       //return nQuitValue;
+#ifdef __LIBRETRO__	/* RETRO HACK */
+/**
+ * Run the emulation until the end of the current VBL, so that the libretro
+ * core can return to the frontend after each frame without needing its own
+ * thread or stack for the emulation.
+ * Return false once Hatari should quit.
+ */
+bool Main_RunFrame(void)
+{
+	bFrameDone = false;
+	while (!bFrameDone && !bQuitProgram)
+		M68000_Run();
+
+	return !bQuitProgram;
+}
+
+#else
+
+/**
+ * Main
+ * 
+ * Note: 'argv' cannot be declared const, MinGW would then fail to link.
+ */
+int main(int argc, char *argv[])
+{
+	if (!Main_Start(argc, argv))
+		return nQuitValue;
 
+	M68000_Start();                 /* Start emulation */
 
+	return Main_Stop();
 }
-#endif /* RETRO HACK */
+#endif	/* RETRO HACK */
 
@@ -15,6 +15,14 @@
   save/restore all variables that are local to it. We use one function to
   reduce redundancy and the function 'MemorySnapShot_Store' decides if it
   should save or restore the data.
+
+  Lightweight snapshots (MemorySnapShot_CaptureLight/RestoreLight) are
+  stored in a memory buffer instead of a file, for frontends which save
+  and restore the state on every frame (e.g. for run-ahead). They are only
+  valid within the same session : they skip all the data which doesn't
+  change while the emulation runs (configuration, TOS ROM and cartridge,
+  unmodified disk images, debugger state) and restoring them doesn't reset
+  the emulated machine nor rebuild the CPU tables.
 */
 const char MemorySnapShot_fileid[] = "Hatari memorySnapShot.c : " __DATE__ " " __TIME__;
 
@@ -56,9 +64,10 @@ const char MemorySnapShot_fileid[] = "Hatari memorySnapShot.c : " __DATE__ " " _
 #include "falcon/videl.h"
 #include "statusbar.h"
 #include "cart.h"
+#include "vdiDraw.h"
 
 
-#define VERSION_STRING      "2.0.1"   /* Version number of compatible memory snapshots - Always 6 bytes (inc' NULL) */
+#define VERSION_STRING      "2.0.3"   /* Version number of compatible memory snapshots - Always 6 bytes (inc' NULL) */
 #define SNAPSHOT_MAGIC      0xDeadBeef
 
 #if HAVE_LIBZ
@@ -82,6 +91,10 @@ typedef FILE* MSS_File;
 static MSS_File CaptureFile;
 static bool bCaptureSave, bCaptureError;
 
+static bool bCaptureLight;			/* true while a lightweight snapshot is done */
+static Uint8 *pCaptureBuffer;			/* NULL if only computing the size */
+static size_t nCaptureBufferSize, nCaptureBufferPos;
+
 
 /*-----------------------------------------------------------------------*/
 /**
@@ -257,6 +270,14 @@ void MemorySnapShot_Skip(int Nb)
 {
 	int res;
 
+	if (bCaptureLight)
+	{
+		nCaptureBufferPos += Nb;
+		if (nCaptureBufferPos > nCaptureBufferSize)
+			bCaptureError = true;
+		return;
+	}
+
 	/* Check no file errors */
 	if (CaptureFile != NULL)
 	{
@@ -277,6 +298,24 @@ void MemorySnapShot_Store(void *pData, int Size)
 {
 	long nBytes;
 
+	if (bCaptureLight)
+	{
+		if (bCaptureError || nCaptureBufferPos + Size > nCaptureBufferSize)
+		{
+			bCaptureError = true;
+			return;
+		}
+		if (pCaptureBuffer)
+		{
+			if (bCaptureSave)
+				memcpy(pCaptureBuffer + nCaptureBufferPos, pData, Size);
+			else
+				memcpy(pData, pCaptureBuffer + nCaptureBufferPos, Size);
+		}
+		nCaptureBufferPos += Size;
+		return;
+	}
+
 	/* Check no file errors */
 	if (CaptureFile != NULL)
 	{
@@ -330,6 +369,7 @@ void MemorySnapShot_Capture(const char *pszFileName, bool bConfirm)
 		DSP_MemorySnapShot_Capture(true);
 		DebugUI_MemorySnapShot_Capture(pszFileName, true);
 		IoMem_MemorySnapShot_Capture(true);
+		VDIDraw_MemorySnapShot_Capture(true);
 		ScreenConv_MemorySnapShot_Capture(true);
 
 		/* end marker */
@@ -394,6 +434,7 @@ void MemorySnapShot_Restore(const char *pszFileName, bool bConfirm)
 		DSP_MemorySnapShot_Capture(false);
 		DebugUI_MemorySnapShot_Capture(pszFileName, false);
 		IoMem_MemorySnapShot_Capture(false);
+		VDIDraw_MemorySnapShot_Capture(false);
 		ScreenConv_MemorySnapShot_Capture(false);
 
 		/* version string check catches release-to-release
@@ -431,6 +472,129 @@ void MemorySnapShot_Restore(const char *pszFileName, bool bConfirm)
 }
 
 
+/*-----------------------------------------------------------------------*/
+/**
+ * Return true if a lightweight snapshot is being saved/restored,
+ * in which case data that can't change during the emulation
+ * shouldn't be stored.
+ */
+bool MemorySnapShot_IsLight(void)
+{
+	return bCaptureLight;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Save/Restore the variables changed by the emulation for a lightweight
+ * snapshot. The header allows to detect a snapshot made with another
+ * machine configuration.
+ */
+static void MemorySnapShot_StoreLight(void)
+{
+	char VersionString[] = VERSION_STRING;
+	Uint32 magic = SNAPSHOT_MAGIC;
+	int MachineType = ConfigureParams.System.nMachineType;
+	int MemorySize = ConfigureParams.Memory.nMemorySize;
+	Uint16 Version = TosVersion;
+
+	MemorySnapShot_Store(VersionString, sizeof(VersionString));
+	MemorySnapShot_Store(&MachineType, sizeof(MachineType));
+	MemorySnapShot_Store(&MemorySize, sizeof(MemorySize));
+	MemorySnapShot_Store(&Version, sizeof(Version));
+	if (strcmp(VersionString, VERSION_STRING)
+	    || MachineType != ConfigureParams.System.nMachineType
+	    || MemorySize != ConfigureParams.Memory.nMemorySize
+	    || Version != TosVersion)
+	{
+		bCaptureError = true;
+		return;
+	}
+
+	STMemory_MemorySnapShot_Capture(bCaptureSave);
+	Cycles_MemorySnapShot_Capture(bCaptureSave);		/* Before fdc (for CyclesGlobalClockCounter) */
+	FDC_MemorySnapShot_Capture(bCaptureSave);
+	Floppy_MemorySnapShot_Capture(bCaptureSave);
+	IPF_MemorySnapShot_Capture(bCaptureSave);		/* After fdc/floppy */
+	STX_MemorySnapShot_Capture(bCaptureSave);		/* After fdc/floppy */
+	GemDOS_MemorySnapShot_Capture(bCaptureSave);
+	ACIA_MemorySnapShot_Capture(bCaptureSave);
+	IKBD_MemorySnapShot_Capture(bCaptureSave);		/* After ACIA */
+	MIDI_MemorySnapShot_Capture(bCaptureSave);
+	CycInt_MemorySnapShot_Capture(bCaptureSave);
+	M68000_MemorySnapShot_Capture(bCaptureSave);
+	MFP_MemorySnapShot_Capture(bCaptureSave);
+	PSG_MemorySnapShot_Capture(bCaptureSave);
+	Sound_MemorySnapShot_Capture(bCaptureSave);
+	Video_MemorySnapShot_Capture(bCaptureSave);
+	Blitter_MemorySnapShot_Capture(bCaptureSave);
+	DmaSnd_MemorySnapShot_Capture(bCaptureSave);
+	Crossbar_MemorySnapShot_Capture(bCaptureSave);
+	VIDEL_MemorySnapShot_Capture(bCaptureSave);
+	DSP_MemorySnapShot_Capture(bCaptureSave);
+	IoMem_MemorySnapShot_Capture(bCaptureSave);
+	VDIDraw_MemorySnapShot_Capture(bCaptureSave);
+	ScreenConv_MemorySnapShot_Capture(bCaptureSave);
+
+	/* end marker */
+	MemorySnapShot_Store(&magic, sizeof(magic));
+	if (magic != SNAPSHOT_MAGIC)
+		bCaptureError = true;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Save a lightweight snapshot to the given buffer. If pBuffer is NULL,
+ * only compute the needed size.
+ * Return the number of bytes used, or 0 if the buffer is too small.
+ */
+size_t MemorySnapShot_CaptureLight(void *pBuffer, size_t nSize)
+{
+	bCaptureLight = true;
+	bCaptureSave = true;
+	bCaptureError = false;
+	pCaptureBuffer = pBuffer;
+	nCaptureBufferSize = pBuffer ? nSize : (size_t)-1;
+	nCaptureBufferPos = 0;
+
+	MemorySnapShot_StoreLight();
+
+	bCaptureLight = false;
+	pCaptureBuffer = NULL;
+	return bCaptureError ? 0 : nCaptureBufferPos;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Restore a lightweight snapshot saved with MemorySnapShot_CaptureLight()
+ * in the same session. Return false if the snapshot doesn't match the
+ * current machine, in which case the emulation state is unchanged, or
+ * if it's truncated, in which case the state is undefined.
+ */
+bool MemorySnapShot_RestoreLight(const void *pBuffer, size_t nSize)
+{
+	bCaptureLight = true;
+	bCaptureSave = false;
+	bCaptureError = false;
+	pCaptureBuffer = (Uint8 *)pBuffer;
+	nCaptureBufferSize = nSize;
+	nCaptureBufferPos = 0;
+
+	MemorySnapShot_StoreLight();
+
+	bCaptureLight = false;
+	pCaptureBuffer = NULL;
+	if (bCaptureError)
+	{
+		Log_Printf(LOG_WARN, "Lightweight memory state restore failed");
+		return false;
+	}
+	return true;
+}
+
+
 /*-----------------------------------------------------------------------*/
 /*
  * Save and restore functions required by the UAE CPU core...
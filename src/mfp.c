@@ -228,6 +228,12 @@ static int nTimerDFakeValue;        /* Faked Timer-D data register for the Timer
 
 static int PendingCyclesOver = 0;   /* >= 0 value, used to "loop" a timer when data counter reaches 0 */
 
+/* When a timer's interrupt is disabled in IERA/IERB, its underflows have no */
+/* visible effect. In that case the timer is only restarted every few periods */
+/* (about one VBL worth of mfp cycles) and the counter is computed from the */
+/* remaining cycles modulo the period when it's read. */
+#define	MFP_TIMER_LAZY_CYCLES		( 2457600 / 50 )
+
 
 #define	MFP_IRQ_DELAY_TO_CPU		4		/* When MFP_IRQ is set, it takes 4 CPU cycles before it's visible to the CPU */
 
@@ -912,6 +918,58 @@ void MFP_TimerB_EventCount_Interrupt ( int Delayed_Cycles )
 }
 
 
+/*-----------------------------------------------------------------------*/
+/**
+ * Return the MFP interrupt number for a timer's handler
+ */
+static int MFP_TimerInterrupt(interrupt_id Handler)
+{
+	switch ( Handler )
+	{
+	 case INTERRUPT_MFP_TIMERA:	return MFP_INT_TIMER_A;
+	 case INTERRUPT_MFP_TIMERB:	return MFP_INT_TIMER_B;
+	 case INTERRUPT_MFP_TIMERC:	return MFP_INT_TIMER_C;
+	 default:			return MFP_INT_TIMER_D;
+	}
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Return how many timer periods can pass before the next underflow
+ * needs to be handled. This is 1 when the timer's interrupt is enabled,
+ * else we can skip the underflows for about one VBL.
+ */
+static int MFP_TimerLazyPeriods(int TimerClockCycles, interrupt_id Handler)
+{
+	Uint8	*pEnableReg;
+	Uint8	Bit;
+
+	Bit = MFP_ConvertIntNumber ( MFP_TimerInterrupt ( Handler ) , &pEnableReg , NULL , NULL , NULL );
+	if ( ( *pEnableReg & Bit ) || ( TimerClockCycles <= 0 ) || ( TimerClockCycles >= MFP_TIMER_LAZY_CYCLES ) )
+		return 1;
+
+	return MFP_TIMER_LAZY_CYCLES / TimerClockCycles;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Return the number of mfp cycles before the next underflow of a running
+ * timer, taking into account the periods skipped by MFP_TimerLazyPeriods
+ */
+static int MFP_TimerCyclesLeft(int TimerClockCycles, interrupt_id Handler)
+{
+	int	Cycles;
+
+	Cycles = CycInt_FindCyclesPassed ( Handler, INT_MFP_CYCLE );
+	if ( ( TimerClockCycles > 0 ) && ( Cycles > TimerClockCycles ) )
+		Cycles = ( Cycles - 1 ) % TimerClockCycles + 1;
+
+	return Cycles;
+}
+
+
 /*-----------------------------------------------------------------------*/
 /**
  * Start Timer A or B - EventCount mode is done in HBL handler to time correctly
@@ -997,7 +1055,9 @@ static int MFP_StartTimer_AB(Uint8 TimerControl, Uint16 TimerData, interrupt_id
 					if ( PendingCyclesOver > TimerClockCyclesInternal )
 						PendingCyclesOver = PendingCyclesOver % TimerClockCyclesInternal;
 
-					CycInt_AddRelativeInterruptWithOffset(TimerClockCycles, INT_MFP_CYCLE, Handler, -PendingCyclesOver);
+					/* If the interrupt is disabled, we don't need to stop at each underflow */
+					CycInt_AddRelativeInterruptWithOffset(TimerClockCycles * MFP_TimerLazyPeriods ( TimerClockCycles , Handler ),
+					                                      INT_MFP_CYCLE, Handler, -PendingCyclesOver);
 				}
 
 				*pTimerCanResume = true;		/* timer was set, resume is possible if stop/start it later */
@@ -1103,7 +1163,9 @@ static int MFP_StartTimer_CD(Uint8 TimerControl, Uint16 TimerData, interrupt_id
 					if ( PendingCyclesOver > TimerClockCyclesInternal )
 						PendingCyclesOver = PendingCyclesOver % TimerClockCyclesInternal;
 
-					CycInt_AddRelativeInterruptWithOffset(TimerClockCycles, INT_MFP_CYCLE, Handler, -PendingCyclesOver);
+					/* If the interrupt is disabled, we don't need to stop at each underflow */
+					CycInt_AddRelativeInterruptWithOffset(TimerClockCycles * MFP_TimerLazyPeriods ( TimerClockCycles , Handler ),
+					                                      INT_MFP_CYCLE, Handler, -PendingCyclesOver);
 				}
 
 				*pTimerCanResume = true;		/* timer was set, resume is possible if stop/start it later */
@@ -1145,7 +1207,7 @@ static Uint8 MFP_ReadTimer_AB(Uint8 TimerControl, Uint8 MainCounter, int TimerCy
 	{
 		/* Find cycles passed since last interrupt */
 		//TimerCyclesPassed = TimerCycles - CycInt_FindCyclesPassed ( Handler, INT_MFP_CYCLE );
-		MainCounter = MFP_CYCLE_TO_REG ( CycInt_FindCyclesPassed ( Handler, INT_MFP_CYCLE ), TimerControl );
+		MainCounter = MFP_CYCLE_TO_REG ( MFP_TimerCyclesLeft ( TimerCycles, Handler ), TimerControl );
 		//fprintf ( stderr , "mfp read AB passed %d count %d\n" , TimerCyclesPassed, MainCounter );
 	}
 
@@ -1154,7 +1216,7 @@ static Uint8 MFP_ReadTimer_AB(Uint8 TimerControl, Uint8 MainCounter, int TimerCy
 	/* if no write is made to the data reg before */
 	if ( TimerIsStopping )
 	{
-		if ( CycInt_FindCyclesPassed ( Handler, INT_MFP_CYCLE ) < MFP_REG_TO_CYCLES ( 1 , TimerControl ) )
+		if ( MFP_TimerCyclesLeft ( TimerCycles, Handler ) < MFP_REG_TO_CYCLES ( 1 , TimerControl ) )
 		{
 			MainCounter = 0;			/* internal mfp counter becomes 0 (=256) */
 			LOG_TRACE(TRACE_MFP_READ , "mfp read AB handler=%d stopping timer while data reg between 1 and 0 : forcing data to 256\n" ,
@@ -1189,7 +1251,7 @@ static Uint8 MFP_ReadTimerCD(Uint8 TimerControl, Uint8 TimerData, Uint8 MainCoun
 	{
 		/* Find cycles passed since last interrupt */
 		//TimerCyclesPassed = TimerCycles - CycInt_FindCyclesPassed ( Handler, INT_MFP_CYCLE );
-		MainCounter = MFP_CYCLE_TO_REG ( CycInt_FindCyclesPassed ( Handler, INT_MFP_CYCLE ), TimerControl);
+		MainCounter = MFP_CYCLE_TO_REG ( MFP_TimerCyclesLeft ( TimerCycles, Handler ), TimerControl);
 		//fprintf ( stderr , "mfp read CD passed %d count %d\n" , TimerCyclesPassed, MainCounter );
 	}
 
@@ -1198,7 +1260,7 @@ static Uint8 MFP_ReadTimerCD(Uint8 TimerControl, Uint8 TimerData, Uint8 MainCoun
 	/* if no write is made to the data reg before */
 	if ( TimerIsStopping )
 	{
-		if ( CycInt_FindCyclesPassed ( Handler, INT_MFP_CYCLE ) < MFP_REG_TO_CYCLES ( 1 , TimerControl ) )
+		if ( MFP_TimerCyclesLeft ( TimerCycles, Handler ) < MFP_REG_TO_CYCLES ( 1 , TimerControl ) )
 		{
 			MainCounter = 0;			/* internal mfp counter becomes 0 (=256) */
 			LOG_TRACE(TRACE_MFP_READ , "mfp read CD handler=%d stopping timer while data reg between 1 and 0 : forcing data to 256\n" ,
@@ -1872,6 +1934,12 @@ void MFP_EnableA_WriteByte(void)
 
 	MFP_IERA = IoMem[0xfffa07];
 	MFP_IPRA &= MFP_IERA;
+
+	/* Timers with a newly enabled interrupt must stop again at each underflow */
+	if ( MFP_IERA & ( 1 << ( MFP_INT_TIMER_A - 8 ) ) )
+		CycInt_AlignInterrupt ( TimerAClockCycles , INT_MFP_CYCLE , INTERRUPT_MFP_TIMERA );
+	if ( MFP_IERA & ( 1 << ( MFP_INT_TIMER_B - 8 ) ) )
+		CycInt_AlignInterrupt ( TimerBClockCycles , INT_MFP_CYCLE , INTERRUPT_MFP_TIMERB );
 	MFP_UpdateIRQ ( Cycles_GetClockCounterOnWriteAccess() );
 }
 
@@ -1885,6 +1953,12 @@ void MFP_EnableB_WriteByte(void)
 
 	MFP_IERB = IoMem[0xfffa09];
 	MFP_IPRB &= MFP_IERB;
+
+	/* Timers with a newly enabled interrupt must stop again at each underflow */
+	if ( MFP_IERB & ( 1 << MFP_INT_TIMER_C ) )
+		CycInt_AlignInterrupt ( TimerCClockCycles , INT_MFP_CYCLE , INTERRUPT_MFP_TIMERC );
+	if ( MFP_IERB & ( 1 << MFP_INT_TIMER_D ) )
+		CycInt_AlignInterrupt ( TimerDClockCycles , INT_MFP_CYCLE , INTERRUPT_MFP_TIMERD );
 	MFP_UpdateIRQ ( Cycles_GetClockCounterOnWriteAccess() );
 }
 
@@ -2009,6 +2083,9 @@ void MFP_TimerACtrl_WriteByte(void)
 
 	if ( MFP_TACR != new_tacr )         /* Timer control changed */
 	{
+		/* Don't keep skipped periods when stopping/resuming the timer */
+		CycInt_AlignInterrupt ( TimerAClockCycles , INT_MFP_CYCLE , INTERRUPT_MFP_TIMERA );
+
 		/* If we stop a timer which was in delay mode, we need to store
 		 * the current value of the counter to be able to read it or to
 		 * continue from where we left if the timer is restarted later
@@ -2035,6 +2112,9 @@ void MFP_TimerBCtrl_WriteByte(void)
 
 	if (MFP_TBCR != new_tbcr)           /* Timer control changed */
 	{
+		/* Don't keep skipped periods when stopping/resuming the timer */
+		CycInt_AlignInterrupt ( TimerBClockCycles , INT_MFP_CYCLE , INTERRUPT_MFP_TIMERB );
+
 		/* If we stop a timer which was in delay mode, we need to store
 		 * the current value of the counter to be able to read it or to
 		 * continue from where we left if the timer is restarted later
@@ -2042,6 +2122,10 @@ void MFP_TimerBCtrl_WriteByte(void)
 		if ((new_tbcr == 0) && (MFP_TBCR >= 1) && (MFP_TBCR <= 7))
 			MFP_ReadTimerB(true);	/* Store result in 'MFP_TB_MAINCOUNTER' */
 
+		/* Event count mode needs the EndLine interrupt on each line */
+		if ( new_tbcr == 0x08 )
+			Video_LineBatch_Stop();
+
 		MFP_TBCR = new_tbcr;            /* set to new value before calling MFP_StartTimer */
 		MFP_StartTimerB();              /* start/stop timer depending on control reg */
 	}
@@ -2064,6 +2148,9 @@ void MFP_TimerCDCtrl_WriteByte(void)
 
 	if ((old_tcdcr & 0x70) != (new_tcdcr & 0x70))	/* Timer C control changed */
 	{
+		/* Don't keep skipped periods when stopping/resuming the timer */
+		CycInt_AlignInterrupt ( TimerCClockCycles , INT_MFP_CYCLE , INTERRUPT_MFP_TIMERC );
+
 		/* If we stop a timer which was in delay mode, we need to store
 		 * the current value of the counter to be able to read it or to
 		 * continue from where we left if the timer is restarted later
@@ -2079,6 +2166,9 @@ void MFP_TimerCDCtrl_WriteByte(void)
 	{
 		Uint32 pc = M68000_GetPC();
 
+		/* Don't keep skipped periods when stopping/resuming the timer */
+		CycInt_AlignInterrupt ( TimerDClockCycles , INT_MFP_CYCLE , INTERRUPT_MFP_TIMERD );
+
 		/* Need to change baud rate of RS232 emulation? */
 		if (ConfigureParams.RS232.bEnableRS232)
 		{
@@ -2131,6 +2221,10 @@ void MFP_TimerAData_WriteByte(void)
 		MFP_TA_MAINCOUNTER = MFP_TADR;  /* Timer is off, store to main counter */
 		TimerACanResume = false;        /* we need to set a new int when timer start */
 	}
+	else                                /* New data will be used at next underflow */
+	{
+		CycInt_AlignInterrupt ( TimerAClockCycles , INT_MFP_CYCLE , INTERRUPT_MFP_TIMERA );
+	}
 
 	if ( LOG_TRACE_LEVEL( TRACE_MFP_WRITE ) )
 	{
@@ -2156,6 +2250,10 @@ void MFP_TimerBData_WriteByte(void)
 		MFP_TB_MAINCOUNTER = MFP_TBDR;  /* Timer is off, store to main counter */
 		TimerBCanResume = false;        /* we need to set a new int when timer start */
 	}
+	else                                /* New data will be used at next underflow */
+	{
+		CycInt_AlignInterrupt ( TimerBClockCycles , INT_MFP_CYCLE , INTERRUPT_MFP_TIMERB );
+	}
 
 	if ( LOG_TRACE_LEVEL( TRACE_MFP_WRITE ) )
 	{
@@ -2181,6 +2279,10 @@ void MFP_TimerCData_WriteByte(void)
 		MFP_TC_MAINCOUNTER = MFP_TCDR;  /* Timer is off, store to main counter */
 		TimerCCanResume = false;        /* we need to set a new int when timer start */
 	}
+	else                                /* New data will be used at next underflow */
+	{
+		CycInt_AlignInterrupt ( TimerCClockCycles , INT_MFP_CYCLE , INTERRUPT_MFP_TIMERC );
+	}
 
 	if ( LOG_TRACE_LEVEL( TRACE_MFP_WRITE ) )
 	{
@@ -2220,6 +2322,10 @@ void MFP_TimerDData_WriteByte(void)
 		MFP_TD_MAINCOUNTER = MFP_TDDR;  /* Timer is off, store to main counter */
 		TimerDCanResume = false;        /* we need to set a new int when timer start */
 	}
+	else                                /* New data will be used at next underflow */
+	{
+		CycInt_AlignInterrupt ( TimerDClockCycles , INT_MFP_CYCLE , INTERRUPT_MFP_TIMERD );
+	}
 
 	if ( LOG_TRACE_LEVEL( TRACE_MFP_WRITE ) )
 	{
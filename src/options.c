@@ -39,6 +39,7 @@ const char Options_fileid[] = "Hatari options.c : " __DATE__ " " __TIME__;
 #include "tos.h"
 #include "paths.h"
 #include "avi_record.h"
+#include "batch.h"
 #include "hatari-glue.h"
 #include "68kDisass.h"
 #include "xbios.h"
@@ -67,17 +68,21 @@ enum {
 	OPT_GRAB,
 	OPT_FRAMESKIPS,
 	OPT_SLOWDOWN,
+	OPT_BUSYWAIT,
 	OPT_MOUSE_WARP,
 	OPT_STATUSBAR,
 	OPT_DRIVE_LED,
 	OPT_MAXWIDTH,
 	OPT_MAXHEIGHT,
 	OPT_FORCEBPP,
+	OPT_VIDEO,
 	OPT_BORDERS,		/* ST/STE display options */
 	OPT_RESOLUTION_ST,
 	OPT_SPEC512,
 	OPT_ZOOM,
 	OPT_VIDEO_TIMING,
+	OPT_RENDER_THREAD,
+	OPT_LINE_BATCH,
 	OPT_RESOLUTION,		/* TT/Falcon display options */
 	OPT_FORCE_MAX,
 	OPT_ASPECT,
@@ -85,6 +90,7 @@ enum {
 	OPT_VDI_PLANES,
 	OPT_VDI_WIDTH,
 	OPT_VDI_HEIGHT,
+	OPT_VDI_HOST,
 	OPT_SCREEN_CROP,        /* screen capture options */
 	OPT_AVIRECORD,
 	OPT_AVIRECORD_VCODEC,
@@ -127,6 +133,7 @@ enum {
 	OPT_TOS,		/* ROM options */
 	OPT_PATCHTOS,
 	OPT_CARTRIDGE,
+	OPT_IKBDROM,
 	OPT_CPULEVEL,		/* CPU options */
 	OPT_CPUCLOCK,
 	OPT_COMPATIBLE,
@@ -136,6 +143,7 @@ enum {
 	OPT_FPU_TYPE,
 /*	OPT_FPU_JIT_COMPAT, */
 	OPT_MMU,
+	OPT_IDLE_LOOPS,
 #endif
 	OPT_MACHINE,		/* system options */
 	OPT_BLITTER,
@@ -146,6 +154,7 @@ enum {
 	OPT_SOUND,
 	OPT_SOUNDBUFFERSIZE,
 	OPT_SOUNDSYNC,
+	OPT_SOUNDLATENCY,
 	OPT_YM_MIXING,
 #ifdef WIN32
 	OPT_WINCON,		/* debug options */
@@ -156,6 +165,7 @@ enum {
 	OPT_CONOUT,
 	OPT_DISASM,
 	OPT_NATFEATS,
+	OPT_NATFEATS_FILE,
 	OPT_TRACE,
 	OPT_TRACEFILE,
 	OPT_PARSE,
@@ -166,6 +176,8 @@ enum {
 	OPT_LOGLEVEL,
 	OPT_ALERTLEVEL,
 	OPT_RUNVBLS,
+	OPT_BATCH,
+	OPT_BATCHWORKERS,
 	OPT_ERROR,
 	OPT_CONTINUE
 };
@@ -210,6 +222,8 @@ static const opt_t HatariOptions[] = {
 	  "<x>", "Skip <x> frames after each shown frame (0=off, >4=auto/max)" },
 	{ OPT_SLOWDOWN, NULL, "--slowdown",
 	  "<x>", "VBL wait time multiplier (1-8, default 1)" },
+	{ OPT_BUSYWAIT, NULL, "--busy-wait",
+	  "<bool>", "Busy wait at the end of each VBL (more accurate, uses a full host CPU)" },
 	{ OPT_MOUSE_WARP, NULL, "--mousewarp",
 	  "<bool>", "Center host mouse on reset & resolution changes" },
 	{ OPT_STATUSBAR, NULL, "--statusbar",
@@ -222,6 +236,8 @@ static const opt_t HatariOptions[] = {
 	  "<x>", "Maximum window height for borders & zooming" },
 	{ OPT_FORCEBPP, NULL, "--bpp",
 	  "<x>", "Force internal bitdepth (x = 15/16/32, 0=disable)" },
+	{ OPT_VIDEO, NULL, "--video",
+	  "<x>", "Video output (x = sdl/none)" },
 
 	{ OPT_HEADER, NULL, NULL, NULL, "ST/STE specific display" },
 	{ OPT_BORDERS, NULL, "--borders",
@@ -234,6 +250,10 @@ static const opt_t HatariOptions[] = {
 	  "<x>", "Double small resolutions (1=no, 2=yes)" },
 	{ OPT_VIDEO_TIMING,   NULL, "--video-timing",
 	  "<x>", "Wakeup State for MMU/GLUE (x=ws1/ws2/ws3/ws4/random, default ws3)" },
+	{ OPT_RENDER_THREAD, NULL, "--render-thread",
+	  "<bool>", "Convert screen in separate thread (adds 1 frame latency)" },
+	{ OPT_LINE_BATCH, NULL, "--line-batch",
+	  "<bool>", "Process lines in batches when there are no raster effects" },
 
 	{ OPT_HEADER, NULL, NULL, NULL, "TT/Falcon specific display" },
 	{ OPT_RESOLUTION, NULL, "--desktop",
@@ -252,6 +272,8 @@ static const opt_t HatariOptions[] = {
 	  "<w>", "VDI mode width (320 < w <= 1280)" },
 	{ OPT_VDI_HEIGHT,     NULL, "--vdi-height",
 	  "<h>", "VDI mode height (200 < h <= 960)" },
+	{ OPT_VDI_HOST,     NULL, "--vdi-host",
+	  "<bool>", "Draw common VDI primitives on host" },
 
 	{ OPT_HEADER, NULL, NULL, NULL, "Screen capture" },
 	{ OPT_SCREEN_CROP, NULL, "--crop",
@@ -351,6 +373,8 @@ static const opt_t HatariOptions[] = {
 	  "<bool>", "Apply TOS patches (experts only, leave it enabled!)" },
 	{ OPT_CARTRIDGE, NULL, "--cartridge",
 	  "<file>", "Use ROM cartridge image <file>" },
+	{ OPT_IKBDROM, NULL, "--ikbd-rom",
+	  "<file>", "Emulate the keyboard processor with its ROM image <file>" },
 
 #if ENABLE_WINUAE_CPU
 	{ OPT_HEADER, NULL, NULL, NULL, "CPU/FPU/bus" },
@@ -374,6 +398,8 @@ static const opt_t HatariOptions[] = {
 	  "<bool>", "Use more compatible, but slower FPU JIT emulation" },*/
 	{ OPT_MMU, NULL, "--mmu",
 	  "<bool>", "Use MMU emulation" },
+	{ OPT_IDLE_LOOPS, NULL, "--idle-loops",
+	  "<x>", "Idle loops handling (x=run/skip/check)" },
 #endif
 
 	{ OPT_HEADER, NULL, NULL, NULL, "Misc system" },
@@ -397,6 +423,8 @@ static const opt_t HatariOptions[] = {
 	  "<x>", "Sound buffer size in ms (x=0/10-100, 0=default)" },
 	{ OPT_SOUNDSYNC,   NULL, "--sound-sync",
 	  "<bool>", "Sound synchronized emulation (on|off, off=default)" },
+	{ OPT_SOUNDLATENCY,   NULL, "--sound-latency",
+	  "<x>", "Pace emulation with sound output, latency in ms (x=0/10-200, 0=off)" },
 	{ OPT_YM_MIXING,   NULL, "--ym-mixing",
 	  "<x>", "YM sound mixing method (x=linear/table/model)" },
 
@@ -417,6 +445,8 @@ static const opt_t HatariOptions[] = {
 	  "<x>", "Set disassembly options (help/uae/ext/<bitmask>)" },
 	{ OPT_NATFEATS, NULL, "--natfeats",
 	  "<bool>", "Whether Native Features support is enabled" },
+	{ OPT_NATFEATS_FILE, NULL, "--natfeats-file",
+	  "<file>", "Host file for NF_HOSTFILE block I/O" },
 	{ OPT_TRACE,   NULL, "--trace",
 	  "<flags>", "Activate emulation tracing, see '--trace help'" },
 	{ OPT_TRACEFILE, NULL, "--trace-file",
@@ -439,6 +469,12 @@ static const opt_t HatariOptions[] = {
 	  "<x>", "Show dialog for log messages above given level" },
 	{ OPT_RUNVBLS, NULL, "--run-vbls",
 	  "<x>", "Exit after x VBLs" },
+#if HAVE_FORK
+	{ OPT_BATCH, NULL, "--batch",
+	  "<file>", "Run headless emulation jobs listed in <file>" },
+	{ OPT_BATCHWORKERS, NULL, "--batch-workers",
+	  "<x>", "Run at most x batch jobs at the same time (0=CPU count)" },
+#endif
 
 	{ OPT_ERROR, NULL, NULL, NULL, NULL }
 };
@@ -948,6 +984,7 @@ bool Opt_ParseParameters(int argc, const char * const argv[])
 	const char *errstr, *str;
 	int i, ok = true;
 	int val;
+	bool bBusyWait;
 
 	/* Defaults for loading initial memory snap-shots */
 	bLoadMemorySave = false;
@@ -1058,6 +1095,12 @@ bool Opt_ParseParameters(int argc, const char * const argv[])
 			}
 			break;
 
+		case OPT_BUSYWAIT:
+			ok = Opt_Bool(argv[++i], OPT_BUSYWAIT, &bBusyWait);
+			if (ok)
+				Main_SetBusyWait(bBusyWait);
+			break;
+
 		case OPT_MOUSE_WARP:
 			ok = Opt_Bool(argv[++i], OPT_MOUSE_WARP, &ConfigureParams.Screen.bMouseWarp);
 			break;
@@ -1088,6 +1131,16 @@ bool Opt_ParseParameters(int argc, const char * const argv[])
 			ConfigureParams.Screen.nForceBpp = planes;
 			break;
 
+		case OPT_VIDEO:
+			i += 1;
+			if (strcasecmp(argv[i], "sdl") == 0)
+				ConfigureParams.Screen.nVideoBackend = VIDEO_BACKEND_SDL;
+			else if (strcasecmp(argv[i], "none") == 0)
+				ConfigureParams.Screen.nVideoBackend = VIDEO_BACKEND_NONE;
+			else
+				return Opt_ShowError(OPT_VIDEO, argv[i], "Unknown video output");
+			break;
+
 			/* ST/STE display options */
 		case OPT_BORDERS:
 			ok = Opt_Bool(argv[++i], OPT_BORDERS, &ConfigureParams.Screen.bAllowOverscan);
@@ -1146,6 +1199,14 @@ bool Opt_ParseParameters(int argc, const char * const argv[])
 			fprintf(stderr, "\nvideo-timing : Work in progress, this option has no effect at the moment\n\n");
 			break;
 
+		case OPT_RENDER_THREAD:
+			ok = Opt_Bool(argv[++i], OPT_RENDER_THREAD, &ConfigureParams.Screen.bRenderThread);
+			break;
+
+		case OPT_LINE_BATCH:
+			ok = Opt_Bool(argv[++i], OPT_LINE_BATCH, &ConfigureParams.Screen.bLineBatch);
+			break;
+
 			/* Falcon/TT display options */
 		case OPT_RESOLUTION:
 			ok = Opt_Bool(argv[++i], OPT_RESOLUTION, &ConfigureParams.Screen.bKeepResolution);
@@ -1257,6 +1318,10 @@ bool Opt_ParseParameters(int argc, const char * const argv[])
 			bLoadAutoSave = false;
 			break;
 
+		case OPT_VDI_HOST:
+			ok = Opt_Bool(argv[++i], OPT_VDI_HOST, &ConfigureParams.Screen.bVdiHostDraw);
+			break;
+
 			/* devices options */
 		case OPT_JOYSTICK:
 			i++;
@@ -1550,6 +1615,13 @@ bool Opt_ParseParameters(int argc, const char * const argv[])
 			}
 			break;
 
+		case OPT_IKBDROM:
+			i += 1;
+			ok = Opt_StrCpy(OPT_IKBDROM, true, ConfigureParams.Rom.szIkbdRomFileName,
+					argv[i], sizeof(ConfigureParams.Rom.szIkbdRomFileName),
+					NULL);
+			break;
+
 		case OPT_MEMSTATE:
 			i += 1;
 			ok = Opt_StrCpy(OPT_MEMSTATE, true, ConfigureParams.Memory.szMemoryCaptureFileName,
@@ -1641,6 +1713,18 @@ bool Opt_ParseParameters(int argc, const char * const argv[])
 			ok = Opt_Bool(argv[++i], OPT_MMU, &ConfigureParams.System.bMMU);
 			bLoadAutoSave = false;
 			break;
+
+		case OPT_IDLE_LOOPS:
+			i += 1;
+			if (strcasecmp(argv[i], "run") == 0)
+				ConfigureParams.System.IdleLoopMode = IDLE_LOOP_MODE_RUN;
+			else if (strcasecmp(argv[i], "skip") == 0)
+				ConfigureParams.System.IdleLoopMode = IDLE_LOOP_MODE_SKIP;
+			else if (strcasecmp(argv[i], "check") == 0)
+				ConfigureParams.System.IdleLoopMode = IDLE_LOOP_MODE_CHECK;
+			else
+				return Opt_ShowError(OPT_IDLE_LOOPS, argv[i], "Unknown idle loops mode");
+			break;
 #endif
 
 			/* system options */
@@ -1804,6 +1888,19 @@ bool Opt_ParseParameters(int argc, const char * const argv[])
 		case OPT_SOUNDSYNC:
 			ok = Opt_Bool(argv[++i], OPT_SOUNDSYNC, &ConfigureParams.Sound.bEnableSoundSync);
 			break;
+
+		case OPT_SOUNDLATENCY:
+			i += 1;
+			temp = atoi(argv[i]);
+			if ( temp == 0 )			/* paced by the host timer */
+				;
+			else if (temp < 10 || temp > 200)
+				{
+					return Opt_ShowError(OPT_SOUNDLATENCY, argv[i], "Unsupported sound latency");
+				}
+			fprintf(stderr, "Sound latency = %d ms.\n", temp);
+			ConfigureParams.Sound.nAudioLatency = temp;
+			break;
 			
 		case OPT_MICROPHONE:
 			ok = Opt_Bool(argv[++i], OPT_MICROPHONE, &ConfigureParams.Sound.bEnableMicrophone);
@@ -1880,6 +1977,13 @@ bool Opt_ParseParameters(int argc, const char * const argv[])
 			fprintf(stderr, "Native Features %s.\n", ConfigureParams.Log.bNatFeats ? "enabled" : "disabled");
 			break;
 
+		case OPT_NATFEATS_FILE:
+			i += 1;
+			ok = Opt_StrCpy(OPT_NATFEATS_FILE, false, ConfigureParams.Log.sNatFeatsFileName,
+					argv[i], sizeof(ConfigureParams.Log.sNatFeatsFileName),
+					NULL);
+			break;
+
 		case OPT_PARACHUTE:
 			bNoSDLParachute = true;
 			break;
@@ -1965,6 +2069,24 @@ bool Opt_ParseParameters(int argc, const char * const argv[])
 		case OPT_RUNVBLS:
 			Main_SetRunVBLs(atol(argv[++i]));
 			break;
+
+		case OPT_BATCH:
+			i += 1;
+			errstr = Batch_SetJobFile(argv[i]);
+			if (errstr)
+			{
+				return Opt_ShowError(OPT_BATCH, argv[i], errstr);
+			}
+			break;
+
+		case OPT_BATCHWORKERS:
+			i += 1;
+			errstr = Batch_SetWorkers(atoi(argv[i]));
+			if (errstr)
+			{
+				return Opt_ShowError(OPT_BATCHWORKERS, argv[i], errstr);
+			}
+			break;
 		       
 		case OPT_ERROR:
 			/* unknown option or missing option parameter */
@@ -37,6 +37,7 @@ const char Reset_fileid[] = "Hatari reset.c : " __DATE__ " " __TIME__;
 #include "debugcpu.h"
 #include "debugdsp.h"
 #include "nf_scsidrv.h"
+#include "natfeats.h"
 
 /*-----------------------------------------------------------------------*/
 /**
@@ -101,6 +102,7 @@ static int Reset_ST(bool bCold)
 	DebugDsp_SetDebugging();
 
 	Midi_Reset();
+	NatFeat_Reset();
 
 #if defined(__linux__)
         nf_scsidrv_reset();
@@ -76,7 +76,10 @@ Uint8 *pSTScreen;
 FRAMEBUFFER *pFrameBuffer;    /* Pointer into current 'FrameBuffer' */
 
 static FRAMEBUFFER FrameBuffers[NUM_FRAMEBUFFERS]; /* Store frame buffer details to tell how to update */
+static Uint8 *pSTScreenConv;                       /* ST screen data being converted */
 static Uint8 *pSTScreenCopy;                       /* Keep track of current and previous ST screen data */
+static Uint16 *pConvHBLPalettes;                   /* HBL palettes for the screen being converted */
+static Uint32 *pConvHBLPaletteMasks;               /* HBL palette masks for the screen being converted */
 static Uint8 *pPCScreenDest;                       /* Destination PC buffer */
 static int STScreenEndHorizLine;                   /* End lines to be converted */
 static int PCScreenBytesPerLine;
@@ -91,6 +94,10 @@ static Uint16 HBLPalette[16], PrevHBLPalette[16];  /* Current palette for line,
 static void (*ScreenDrawFunctionsNormal[3])(void); /* Screen draw functions */
 
 static bool bScreenContentsChanged;     /* true if buffer changed and requires blitting */
+static bool bScreenChangedAll;          /* whole ST screen area needs blitting */
+static Uint8 *pPCScreenBase;            /* Start of the converted surface */
+static Uint8 *pPCScreenChangedStart;    /* First and last changed converted line, */
+static Uint8 *pPCScreenChangedEnd;      /* start is NULL if converter didn't track them */
 static bool bScrDoubleY;                /* true if double on Y */
 static int ScrUpdateFlag;               /* Bit mask of how to update screen */
 
@@ -98,8 +105,27 @@ static int ScrUpdateFlag;               /* Bit mask of how to update screen */
 static int genconv_width_req, genconv_height_req, genconv_bpp;
 static bool genconv_do_update;          /* HW surface is available -> the SDL need not to update the surface after ->pixel access */
 
+/* For the "none" video backend, frames are converted only on request */
+static bool bFrameRequested;            /* next frame needs to be converted */
+static bool bFramesSkipped;             /* surface is out of date with the ST screen */
+#if !WITH_SDL2 && !defined(__LIBRETRO__)
+static bool bNullVideoSurface;          /* sdlscrn was allocated by us, not by SDL */
+#endif
+
+#ifndef __LIBRETRO__	/* RETRO HACK */
+/* Render thread, converting the ST screen while the emulation continues */
+static SDL_Thread *RenderThread;
+static SDL_sem *RenderStartSem;         /* posted when there's a frame to convert */
+static SDL_sem *RenderDoneSem;          /* posted when the frame has been converted */
+static void (*pRenderDrawFunction)(void);
+static bool bRenderPending;             /* frame given to render thread, not yet shown */
+static bool bRenderQuit;
+static Uint32 RenderHBLPaletteMasks[HBL_PALETTE_MASKS];
+#endif	/* RETRO HACK */
+
 
 static bool Screen_DrawFrame(bool bForceFlip);
+static void Screen_RenderThreadUnInit(void);
 
 #if WITH_SDL2
 
@@ -109,7 +135,66 @@ static SDL_Texture *sdlTexture;
 
 void SDL_UpdateRects(SDL_Surface *screen, int numrects, SDL_Rect *rects)
 {
-	SDL_UpdateTexture(sdlTexture, NULL, screen->pixels, screen->pitch);
+	int i, y, bpp, pitch, rowbytes;
+	bool bUpdated = false;
+	Uint8 *src, *dst;
+	void *pixels;
+
+	/* nothing to show with the "none" video backend */
+	if (!sdlTexture)
+		return;
+
+	/* upload only the given areas to the streaming texture */
+	bpp = screen->format->BytesPerPixel;
+	for (i = 0; i < numrects; i++)
+	{
+		SDL_Rect rect = rects[i];
+
+		/* like with SDL1, zero sized rect means whole surface */
+		if (rect.x == 0 && rect.y == 0 && rect.w == 0 && rect.h == 0)
+		{
+			rect.w = screen->w;
+			rect.h = screen->h;
+		}
+		if (rect.x < 0)
+		{
+			rect.w += rect.x;
+			rect.x = 0;
+		}
+		if (rect.y < 0)
+		{
+			rect.h += rect.y;
+			rect.y = 0;
+		}
+		if (rect.x + rect.w > screen->w)
+			rect.w = screen->w - rect.x;
+		if (rect.y + rect.h > screen->h)
+			rect.h = screen->h - rect.y;
+		if (rect.w <= 0 || rect.h <= 0)
+			continue;
+
+		src = (Uint8 *)screen->pixels + rect.y * screen->pitch + rect.x * bpp;
+		if (SDL_LockTexture(sdlTexture, &rect, &pixels, &pitch) == 0)
+		{
+			rowbytes = rect.w * bpp;
+			dst = pixels;
+			for (y = 0; y < rect.h; y++)
+			{
+				memcpy(dst, src, rowbytes);
+				src += screen->pitch;
+				dst += pitch;
+			}
+			SDL_UnlockTexture(sdlTexture);
+		}
+		else
+		{
+			SDL_UpdateTexture(sdlTexture, &rect, src, screen->pitch);
+		}
+		bUpdated = true;
+	}
+	if (!bUpdated)
+		return;
+
 	SDL_RenderClear(sdlRenderer);
 	SDL_RenderCopy(sdlRenderer, sdlTexture, NULL, NULL);
 	SDL_RenderPresent(sdlRenderer);
@@ -174,7 +259,7 @@ static void Screen_ConvertHighRes(void)
 {
 	int linewidth = 640 / 16;
 
-	Screen_GenConvert(pSTScreen, 640, 400, 1, linewidth, 0, 0, 0, 0, 0);
+	Screen_GenConvert(pSTScreenConv, 640, 400, 1, linewidth, 0, 0, 0, 0, 0);
 	bScreenContentsChanged = true;
 }
 
@@ -295,6 +380,54 @@ static void Screen_FreeSDL2Resources(void)
 }
 #endif
 
+#ifndef __LIBRETRO__	/* RETRO HACK */
+/**
+ * Set up the screen surface for the "none" video backend. It's just
+ * a memory buffer for screenshots and AVI recording, without window,
+ * renderer or texture.
+ */
+static void Screen_SetNullVideoSize(int width, int height, int bitdepth)
+{
+	Uint32 rm, gm, bm;
+
+#if WITH_SDL2
+	Screen_FreeSDL2Resources();
+	if (sdlWindow)
+	{
+		SDL_DestroyWindow(sdlWindow);
+		sdlWindow = NULL;
+	}
+#else
+	/* SDL1 window (if one was already opened) stays until exit */
+	if (bNullVideoSurface && sdlscrn)
+		SDL_FreeSurface(sdlscrn);
+	bNullVideoSurface = true;
+#endif
+
+	if (bitdepth == 15)
+	{
+		rm = 0x7C00;
+		gm = 0x03E0;
+		bm = 0x001F;
+	}
+	else if (bitdepth == 16)
+	{
+		rm = 0xF800;
+		gm = 0x07E0;
+		bm = 0x001F;
+	}
+	else
+	{
+		bitdepth = 32;
+		rm = 0x00FF0000;
+		gm = 0x0000FF00;
+		bm = 0x000000FF;
+	}
+	DEBUGPRINT(("Null screen request: %d x %d @ %d\n", width, height, bitdepth));
+	sdlscrn = SDL_CreateRGBSurface(0, width, height, bitdepth, rm, gm, bm, 0);
+}
+#endif	/* RETRO HACK */
+
 /**
  * Change the SDL video mode.
  * @return true if mode has been changed, false if change was not necessary
@@ -317,6 +450,9 @@ bool Screen_SetSDLVideoSize(int width, int height, int bitdepth, bool bForceChan
 	    && sdlscrn->format->BitsPerPixel == bitdepth && !bForceChange)
 		return false;
 
+	/* Render thread may still be converting to the old surface */
+	Screen_FinishRender();
+
 	/* We can not continue recording with a different resolution */
 	if (Avi_AreWeRecording())
 		Avi_StopRecording();
@@ -327,6 +463,29 @@ bool Screen_SetSDLVideoSize(int width, int height, int bitdepth, bool bForceChan
 		__mf_unregister(sdlscrn->pixels, sdlscrn->pitch*sdlscrn->h, __MF_TYPE_GUESS);
 	}
 #endif
+
+#ifndef __LIBRETRO__	/* RETRO HACK */
+	if (ConfigureParams.Screen.nVideoBackend == VIDEO_BACKEND_NONE)
+	{
+		Screen_SetNullVideoSize(width, height, bitdepth);
+		if (!sdlscrn)
+		{
+			fprintf(stderr, "Could not create screen surface:\n %s\n", SDL_GetError());
+			SDL_Quit();
+			exit(-2);
+		}
+		return true;
+	}
+#if !WITH_SDL2
+	if (bNullVideoSurface)
+	{
+		SDL_FreeSurface(sdlscrn);
+		sdlscrn = NULL;
+		bNullVideoSurface = false;
+	}
+#endif
+#endif	/* RETRO HACK */
+
 	if (bInFullScreen)
 	{
 		/* unhide the Hatari WM window for fullscreen */
@@ -678,7 +837,9 @@ void Screen_Init(void)
 	{
 		FrameBuffers[i].pSTScreen = malloc(MAX_VDI_BYTES);
 		FrameBuffers[i].pSTScreenCopy = malloc(MAX_VDI_BYTES);
-		if (!FrameBuffers[i].pSTScreen || !FrameBuffers[i].pSTScreenCopy)
+		FrameBuffers[i].pSTScreenSpare = malloc(MAX_VDI_BYTES);
+		if (!FrameBuffers[i].pSTScreen || !FrameBuffers[i].pSTScreenCopy
+		    || !FrameBuffers[i].pSTScreenSpare)
 		{
 			fprintf(stderr, "Failed to allocate frame buffer memory.\n");
 			exit(-1);
@@ -722,11 +883,14 @@ void Screen_UnInit(void)
 {
 	int i;
 
+	Screen_RenderThreadUnInit();
+
 	/* Free memory used for copies */
 	for (i = 0; i < NUM_FRAMEBUFFERS; i++)
 	{
 		free(FrameBuffers[i].pSTScreen);
 		free(FrameBuffers[i].pSTScreenCopy);
+		free(FrameBuffers[i].pSTScreenSpare);
 	}
 
 #if WITH_SDL2
@@ -736,6 +900,13 @@ void Screen_UnInit(void)
 		SDL_DestroyWindow(sdlWindow);
 		sdlWindow = NULL;
 	}
+#elif !defined(__LIBRETRO__)
+	if (bNullVideoSurface)
+	{
+		SDL_FreeSurface(sdlscrn);
+		sdlscrn = NULL;
+		bNullVideoSurface = false;
+	}
 #endif
 }
 
@@ -781,6 +952,9 @@ void Screen_SetFullUpdate(void)
 	/* Update frame buffers */
 	for (i = 0; i < NUM_FRAMEBUFFERS; i++)
 		FrameBuffers[i].bFullUpdate = true;
+
+	/* and generic (TT/Falcon/VDI) screen conversion */
+	ScreenConv_SetFullUpdate();
 }
 
 
@@ -791,6 +965,7 @@ void Screen_SetFullUpdate(void)
 static void Screen_ClearScreen(void)
 {
 	SDL_FillRect(sdlscrn, &STScreenRect, SDL_MapRGB(sdlscrn->format, 0, 0, 0));
+	ScreenConv_SetFullUpdate();
 }
 
 
@@ -1089,9 +1264,10 @@ static void Screen_SetFullUpdateMask(void)
  */
 static void Screen_SetConvertDetails(void)
 {
-	pSTScreen = pFrameBuffer->pSTScreen;          /* Source in ST memory */
+	pSTScreenConv = pFrameBuffer->pSTScreen;      /* Source in ST memory */
 	pSTScreenCopy = pFrameBuffer->pSTScreenCopy;  /* Previous ST screen */
 	pPCScreenDest = sdlscrn->pixels;              /* Destination PC screen */
+	pPCScreenBase = pPCScreenDest;
 
 	PCScreenBytesPerLine = sdlscrn->pitch;        /* Bytes per line */
 
@@ -1099,6 +1275,8 @@ static void Screen_SetConvertDetails(void)
 	pPCScreenDest += PCScreenOffsetY * PCScreenBytesPerLine + PCScreenOffsetX * (sdlscrn->format->BitsPerPixel/8);
 
 	pHBLPalettes = pFrameBuffer->HBLPalettes;     /* HBL palettes pointer */
+	pConvHBLPalettes = pFrameBuffer->HBLPalettes;
+	pConvHBLPaletteMasks = HBLPaletteMasks;
 	/* Not in TV-Mode? Then double up on Y: */
 	bScrDoubleY = !(ConfigureParams.Screen.nMonitorType == MONITOR_TYPE_TV);
 
@@ -1162,12 +1340,36 @@ void Screen_UnLock(void)
 
 /*-----------------------------------------------------------------------*/
 /**
- * Blit our converted ST screen to window/full-screen
+ * Get the part of the ST screen area changed by the last conversion.
+ * Whole area is used when converter didn't track the changed lines.
  */
-static void Screen_Blit(SDL_Rect *sbar_rect)
+static void Screen_GetChangedRect(SDL_Rect *rect)
 {
-	unsigned char *pTmpScreen;
+	int top, bottom;
+
+	*rect = STScreenRect;
+	if (bScreenChangedAll || !pPCScreenChangedStart)
+		return;
 
+	/* last changed line may be doubled on Y */
+	top = (pPCScreenChangedStart - pPCScreenBase) / PCScreenBytesPerLine;
+	bottom = (pPCScreenChangedEnd - pPCScreenBase) / PCScreenBytesPerLine + 2;
+	if (top > rect->y)
+	{
+		rect->h -= top - rect->y;
+		rect->y = top;
+	}
+	if (bottom < rect->y + rect->h)
+		rect->h = bottom - rect->y;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Update converted ST screen area and statusbar to window/full-screen
+ */
+static void Screen_BlitRects(SDL_Rect *sbar_rect)
+{
 #if 0	/* double buffering cannot be used with partial screen updates */
 # if NUM_FRAMEBUFFERS > 1
 	if (bInFullScreen && (sdlscrn->flags & SDL_DOUBLEBUF))
@@ -1183,16 +1385,29 @@ static void Screen_Blit(SDL_Rect *sbar_rect)
 # endif
 #endif
 	{
-		int count = 1;
+		int count = 0;
 		SDL_Rect rects[2];
-		rects[0] = STScreenRect;
+
+		/* skip the ST screen area on statusbar only updates */
+		if (bScreenContentsChanged || bScreenChangedAll)
+			Screen_GetChangedRect(&rects[count++]);
 		if (sbar_rect)
-		{
-			rects[1] = *sbar_rect;
-			count = 2;
-		}
-		SDL_UpdateRects(sdlscrn, count, rects);
+			rects[count++] = *sbar_rect;
+		if (count)
+			SDL_UpdateRects(sdlscrn, count, rects);
 	}
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Blit our converted ST screen to window/full-screen
+ */
+static void Screen_Blit(SDL_Rect *sbar_rect)
+{
+	unsigned char *pTmpScreen;
+
+	Screen_BlitRects(sbar_rect);
 
 	/* Swap copy/raster buffers in screen. */
 	pTmpScreen = pFrameBuffer->pSTScreenCopy;
@@ -1201,6 +1416,170 @@ static void Screen_Blit(SDL_Rect *sbar_rect)
 }
 
 
+/* -------------- render thread ---------------------------------------------
+  With the render thread enabled, Screen_DrawFrame() does the palette and
+  resolution bookkeeping for the frame on the emulation thread, snapshots
+  the line palette masks and hands the ST screen buffer over to the render
+  thread.  Emulation then continues to a third ST screen buffer, while the
+  render thread converts the frame to the locked screen surface.  The frame
+  is shown on the next VBL, as SDL needs screen updates to be done from the
+  main thread, so the render thread adds one frame of display latency.
+  Spectrum 512 and monochrome frames use state that emulation modifies
+  during the next frame, so those are still converted synchronously.
+*/
+
+#ifndef __LIBRETRO__	/* RETRO HACK */
+/**
+ * Render thread main loop
+ */
+static int Screen_RenderThreadFunc(void *data)
+{
+	for (;;)
+	{
+		SDL_SemWait(RenderStartSem);
+		if (bRenderQuit)
+			break;
+		CALL_VAR(pRenderDrawFunction);
+		SDL_SemPost(RenderDoneSem);
+	}
+	return 0;
+}
+#endif	/* RETRO HACK */
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Create the render thread if it's not yet running.
+ * Return false if it couldn't be created.
+ */
+static bool Screen_RenderThreadInit(void)
+{
+#ifndef __LIBRETRO__	/* RETRO HACK */
+	if (RenderThread)
+		return true;
+
+	RenderStartSem = SDL_CreateSemaphore(0);
+	RenderDoneSem = SDL_CreateSemaphore(0);
+	if (RenderStartSem && RenderDoneSem)
+	{
+		bRenderQuit = false;
+#if WITH_SDL2
+		RenderThread = SDL_CreateThread(Screen_RenderThreadFunc, "render", NULL);
+#else
+		RenderThread = SDL_CreateThread(Screen_RenderThreadFunc, NULL);
+#endif
+		if (RenderThread)
+			return true;
+	}
+
+	Log_Printf(LOG_WARN, "Failed to create screen render thread, converting screen in main thread.\n");
+	ConfigureParams.Screen.bRenderThread = false;
+	Screen_RenderThreadUnInit();
+#endif	/* RETRO HACK */
+	return false;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Finish and stop the render thread
+ */
+static void Screen_RenderThreadUnInit(void)
+{
+#ifndef __LIBRETRO__	/* RETRO HACK */
+	Screen_FinishRender();
+
+	if (RenderThread)
+	{
+		bRenderQuit = true;
+		SDL_SemPost(RenderStartSem);
+		SDL_WaitThread(RenderThread, NULL);
+		RenderThread = NULL;
+	}
+	if (RenderStartSem)
+	{
+		SDL_DestroySemaphore(RenderStartSem);
+		RenderStartSem = NULL;
+	}
+	if (RenderDoneSem)
+	{
+		SDL_DestroySemaphore(RenderDoneSem);
+		RenderDoneSem = NULL;
+	}
+#endif	/* RETRO HACK */
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Give given (already set up) screen conversion to the render thread.
+ * Return false if frame needs to be converted synchronously instead.
+ */
+static bool Screen_RenderDispatch(void (*pDrawFunction)(void))
+{
+#ifndef __LIBRETRO__	/* RETRO HACK */
+	Uint8 *pTmpScreen;
+
+	/* AVI recording grabs the surface right after the VBL, and
+	 * frames for the "none" video backend are wanted right away
+	 */
+	if (!ConfigureParams.Screen.bRenderThread || Avi_AreWeRecording()
+	    || ConfigureParams.Screen.nVideoBackend == VIDEO_BACKEND_NONE)
+		return false;
+	if (!Screen_RenderThreadInit())
+		return false;
+
+	/* Emulation updates palette masks during the next frame */
+	memcpy(RenderHBLPaletteMasks, HBLPaletteMasks, sizeof(RenderHBLPaletteMasks));
+	pConvHBLPaletteMasks = RenderHBLPaletteMasks;
+
+	/* Converted screen becomes the copy to compare next frame against,
+	 * and emulation continues to the spare buffer
+	 */
+	pTmpScreen = pFrameBuffer->pSTScreenCopy;
+	pFrameBuffer->pSTScreenCopy = pFrameBuffer->pSTScreen;
+	pFrameBuffer->pSTScreen = pFrameBuffer->pSTScreenSpare;
+	pFrameBuffer->pSTScreenSpare = pTmpScreen;
+
+	pRenderDrawFunction = pDrawFunction;
+	bRenderPending = true;
+	SDL_SemPost(RenderStartSem);
+	return true;
+#else
+	return false;
+#endif	/* RETRO HACK */
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Wait until render thread has converted the frame it was given and
+ * show it.  Needs to be called before anything else accesses the screen
+ * surface or the conversion state.  Does nothing if render thread isn't
+ * converting anything.
+ */
+void Screen_FinishRender(void)
+{
+#ifndef __LIBRETRO__	/* RETRO HACK */
+	SDL_Rect *sbar_rect;
+
+	if (!bRenderPending)
+		return;
+	bRenderPending = false;
+
+	SDL_SemWait(RenderDoneSem);
+	Screen_UnLock();
+
+	/* draw overlay led(s) or statusbar after unlock */
+	Statusbar_OverlayBackup(sdlscrn);
+	sbar_rect = Statusbar_Update(sdlscrn, false);
+
+	if (bScreenContentsChanged || sbar_rect)
+		Screen_BlitRects(sbar_rect);
+#endif	/* RETRO HACK */
+}
+
+
 /*-----------------------------------------------------------------------*/
 /**
  * Draw ST screen to window/full-screen framebuffer
@@ -1216,6 +1595,9 @@ static bool Screen_DrawFrame(bool bForceFlip)
 
 	assert(!bUseVDIRes);
 
+	/* Show previous frame from render thread before touching its state */
+	Screen_FinishRender();
+
 	/* Scan palette/resolution masks for each line and build up palette/difference tables */
 	new_res = Screen_ComparePaletteMask(STRes);
 	/* Did we change resolution this frame - allocate new screen if did so */
@@ -1233,6 +1615,8 @@ static bool Screen_DrawFrame(bool bForceFlip)
 	if (Screen_Lock())
 	{
 		bScreenContentsChanged = false;      /* Did change (ie needs blit?) */
+		bScreenChangedAll = pFrameBuffer->bFullUpdate || bForceFlip;
+		pPCScreenChangedStart = pPCScreenChangedEnd = NULL;
 
 		/* Set details */
 		Screen_SetConvertDetails();
@@ -1270,6 +1654,17 @@ static bool Screen_DrawFrame(bool bForceFlip)
 			bPrevFrameWasSpec512 = false;
 		}
 
+		/* Plain low/medium res frames can be converted in render thread
+		 * (forced flip is used for redraws while emulation is paused)
+		 */
+		if (pDrawFunction && !bForceFlip && STRes != ST_HIGH_RES
+		    && !Spec512_IsImage() && Screen_RenderDispatch(pDrawFunction))
+		{
+			pFrameBuffer->bFullUpdate = false;
+			pFrameBuffer->VerticalOverscanCopy = VerticalOverscan;
+			return true;
+		}
+
 		if (pDrawFunction)
 			CALL_VAR(pDrawFunction);
 
@@ -1297,6 +1692,44 @@ static bool Screen_DrawFrame(bool bForceFlip)
 }
 
 
+/*-----------------------------------------------------------------------*/
+/**
+ * Request the next frame to be converted to the screen surface, even
+ * when the "none" video backend is used, e.g. for a screenshot.
+ */
+void Screen_RequestFrame(void)
+{
+	bFrameRequested = true;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Return true if the current frame needs to be converted to the screen
+ * surface. With the "none" video backend, this is the case only when
+ * the frame has been requested or AVI recording is in progress.
+ */
+bool Screen_FrameNeeded(void)
+{
+	if (ConfigureParams.Screen.nVideoBackend != VIDEO_BACKEND_NONE
+	    || bFrameRequested || Avi_AreWeRecording())
+	{
+		/* lines unchanged since the last converted frame
+		 * aren't necessarily up to date in the surface
+		 */
+		if (bFramesSkipped)
+		{
+			Screen_SetFullUpdate();
+			bFramesSkipped = false;
+		}
+		bFrameRequested = false;
+		return true;
+	}
+	bFramesSkipped = true;
+	return false;
+}
+
+
 /*-----------------------------------------------------------------------*/
 /**
  * Draw ST screen to window/full-screen
@@ -1322,6 +1755,9 @@ void Screen_SetGenConvSize(int width, int height, int bpp, bool bForceChange)
 	int screenwidth, screenheight, maxw, maxh;
 	int scalex, scaley, sbarheight;
 
+	/* screen surface may be cleared or re-created */
+	ScreenConv_SetFullUpdate();
+
 	if (bpp == 24)
 		bpp = 32;
 
@@ -1518,7 +1954,7 @@ static int AdjustLinePaletteRemap(int y)
 	int i;
 
 	/* Copy palette and convert to RGB in display format */
-	actHBLPal = pHBLPalettes + (y<<4);    /* offset in palette */
+	actHBLPal = pConvHBLPalettes + (y<<4);    /* offset in palette */
 	for (i=0; i<16; i++)
 	{
 #if SDL_BYTEORDER == SDL_BIG_ENDIAN
@@ -1527,7 +1963,7 @@ static int AdjustLinePaletteRemap(int y)
 		STRGBPalette[i] = ST2RGB[*actHBLPal++];
 #endif
 	}
-	ScrUpdateFlag = HBLPaletteMasks[y];
+	ScrUpdateFlag = pConvHBLPaletteMasks[y];
 	return ScrUpdateFlag;
 }
 
@@ -17,6 +17,18 @@
 #include "stMemory.h"
 #include "video.h"
 
+/* Vector versions of the conversion loops, for little endian hosts where
+ * SSE2 (all x86-64 CPUs) or NEON (all AArch64 CPUs) is always available */
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+# if defined(__SSE2__)
+#  include <emmintrin.h>
+#  define SCREENCONV_SSE2 1
+# elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#  include <arm_neon.h>
+#  define SCREENCONV_NEON 1
+# endif
+#endif
+
 
 struct screen_zoom_s {
 	Uint16 zoomwidth;
@@ -31,6 +43,32 @@ static struct screen_zoom_s screen_zoom;
 static bool bTTSampleHold = false;		/* TT special video mode */
 static int nSampleHoldIdx;
 
+/* Parameters of a frame conversion, a change in any of them
+ * requires the whole frame to be converted again */
+struct screen_conv_params_s {
+	void *fvram;
+	void *hvram;
+	int pitch, hbpp;
+	int zoomx, zoomy;
+	int vw, vh, vbpp;
+	int nextline, hscrolloffset;
+	int leftBorder, rightBorder;
+	int upperBorder, lowerBorder;
+	bool bSampleHold;
+};
+
+/* Copy of the source lines converted for the previous frame, used
+ * to skip the conversion of the lines that didn't change since then */
+static struct {
+	Uint8 *lines;			/* source data of previous frame */
+	int size;			/* allocated size of 'lines' */
+	int linebytes;			/* number of source bytes per line */
+	int nlines;			/* number of lines in 'lines' */
+	bool bFullUpdate;		/* convert all lines and borders */
+	bool bChanged;			/* some line was converted for this frame */
+	struct screen_conv_params_s params;
+} ScreenConvCache = { .bFullUpdate = true };
+
 
 /* TOS palette (bpp < 16) to SDL color mapping */
 static struct
@@ -41,12 +79,18 @@ static struct
 
 void Screen_SetPaletteColor(Uint8 idx, Uint8 red, Uint8 green, Uint8 blue)
 {
+	Uint32 color;
+
 	// set the SDL standard RGB palette settings
 	palette.standard[idx].r = red;
 	palette.standard[idx].g = green;
 	palette.standard[idx].b = blue;
 	// convert the color to native
-	palette.native[idx] = SDL_MapRGB(sdlscrn->format, red, green, blue);
+	color = SDL_MapRGB(sdlscrn->format, red, green, blue);
+	if (color != palette.native[idx]) {
+		palette.native[idx] = color;
+		ScreenConvCache.bFullUpdate = true;
+	}
 }
 
 void Screen_RemapPalette(void)
@@ -59,6 +103,7 @@ void Screen_RemapPalette(void)
 	for(i = 0; i < 256; i++, native++, standard++) {
 		*native = SDL_MapRGB(fmt, standard->r, standard->g, standard->b);
 	}
+	ScreenConvCache.bFullUpdate = true;
 }
 
 void ScreenConv_MemorySnapShot_Capture(bool bSave)
@@ -68,6 +113,91 @@ void ScreenConv_MemorySnapShot_Capture(bool bSave)
 		Screen_RemapPalette();
 }
 
+/**
+ * Force conversion of the whole screen on next frame, for example
+ * when something else has drawn over the converted screen
+ */
+void ScreenConv_SetFullUpdate(void)
+{
+	ScreenConvCache.bFullUpdate = true;
+}
+
+/**
+ * Check whether conversion parameters changed since previous frame
+ * and prepare the copy of the source lines for this frame.
+ */
+static void ScreenConv_StartFrame(Uint16 *fvram, Uint8 *hvram, int vw, int vh,
+                                  int vbpp, int nextline, int hscrolloffset,
+                                  int leftBorder, int rightBorder,
+                                  int upperBorder, int lowerBorder)
+{
+	struct screen_conv_params_s params;
+	int size;
+
+	memset(&params, 0, sizeof(params));
+	params.fvram = fvram;
+	params.hvram = hvram;
+	params.pitch = sdlscrn->pitch;
+	params.hbpp = sdlscrn->format->BytesPerPixel;
+	params.zoomx = nScreenZoomX;
+	params.zoomy = nScreenZoomY;
+	params.vw = vw;
+	params.vh = vh;
+	params.vbpp = vbpp;
+	params.nextline = nextline;
+	params.hscrolloffset = hscrolloffset;
+	params.leftBorder = leftBorder;
+	params.rightBorder = rightBorder;
+	params.upperBorder = upperBorder;
+	params.lowerBorder = lowerBorder;
+	params.bSampleHold = bTTSampleHold;
+	if (memcmp(&params, &ScreenConvCache.params, sizeof(params)) != 0) {
+		ScreenConvCache.params = params;
+		ScreenConvCache.bFullUpdate = true;
+	}
+
+	if (vbpp < 16) {
+		/* 16-pixel blocks of vbpp words, +1 block for fine scrolling */
+		ScreenConvCache.linebytes = (((vw + 15) >> 4) + (hscrolloffset ? 1 : 0)) * vbpp * 2;
+	} else {
+		ScreenConvCache.linebytes = vw * 2;
+	}
+	ScreenConvCache.nlines = vh;
+	ScreenConvCache.bChanged = false;
+
+	size = ScreenConvCache.linebytes * vh;
+	if (size > ScreenConvCache.size) {
+		free(ScreenConvCache.lines);
+		ScreenConvCache.lines = malloc(size);
+		ScreenConvCache.size = ScreenConvCache.lines ? size : 0;
+		ScreenConvCache.bFullUpdate = true;
+	}
+	if (!ScreenConvCache.lines)
+		ScreenConvCache.bFullUpdate = true;
+}
+
+/**
+ * Return true if given source line changed since previous frame
+ * (or whole screen needs to be converted), false if it can be skipped.
+ */
+static bool ScreenConv_LineChanged(int y, const Uint16 *fvram_line)
+{
+	Uint8 *copy;
+
+	if (!ScreenConvCache.lines || y >= ScreenConvCache.nlines) {
+		ScreenConvCache.bChanged = true;
+		return true;
+	}
+	copy = ScreenConvCache.lines + y * ScreenConvCache.linebytes;
+	if (!ScreenConvCache.bFullUpdate &&
+	    memcmp(copy, fvram_line, ScreenConvCache.linebytes) == 0)
+		return false;
+
+	memcpy(copy, fvram_line, ScreenConvCache.linebytes);
+	ScreenConvCache.bChanged = true;
+	return true;
+}
+
 static void Screen_memset_uint32(Uint32 *addr, Uint32 color, int count)
 {
 	while (count-- > 0) {
@@ -285,6 +415,128 @@ static void Screen_BitplaneToChunky32(Uint16 *atariBitplaneData, Uint16 bpp,
 #endif
 }
 
+#if defined(SCREENCONV_SSE2) || defined(SCREENCONV_NEON)
+
+#if defined(SCREENCONV_SSE2)
+typedef __m128i vec_u32;
+#define VEC_SET1(v)	_mm_set1_epi32((int)(v))
+#define VEC_AND(a, b)	_mm_and_si128(a, b)
+#define VEC_OR(a, b)	_mm_or_si128(a, b)
+#define VEC_SHL(a, n)	_mm_slli_epi32(a, n)
+#define VEC_SHR(a, n)	_mm_srli_epi32(a, n)
+#define VEC_STORE(p, a)	_mm_storeu_si128((__m128i *)(p), a)
+#else
+typedef uint32x4_t vec_u32;
+#define VEC_SET1(v)	vdupq_n_u32(v)
+#define VEC_AND(a, b)	vandq_u32(a, b)
+#define VEC_OR(a, b)	vorrq_u32(a, b)
+#define VEC_SHL(a, n)	vshlq_n_u32(a, n)
+#define VEC_SHR(a, n)	vshrq_n_u32(a, n)
+#define VEC_STORE(p, a)	vst1q_u32(p, a)
+#endif
+
+/**
+ * Same as Screen_BitplaneToChunky16/32(), but converts four consecutive
+ * 16-pixel blocks of 4 or 8 bitplanes at the same time into 64 color
+ * indexes, one block per vector lane.
+ */
+static void Screen_BitplaneToIndex64(Uint16 *atariBitplaneData, Uint16 bpp,
+                                     Uint8 *idx)
+{
+	Uint32 la[4], lb[4], lc[4], ld[4];
+	vec_u32 a, b, c, d, x;
+	int i;
+
+	/* Gather same 32-bit words of the four blocks in the same vector */
+#if defined(SCREENCONV_SSE2)
+	if (bpp == 8) {
+		__m128i r0 = _mm_loadu_si128((__m128i *)&atariBitplaneData[0]);
+		__m128i r1 = _mm_loadu_si128((__m128i *)&atariBitplaneData[8]);
+		__m128i r2 = _mm_loadu_si128((__m128i *)&atariBitplaneData[16]);
+		__m128i r3 = _mm_loadu_si128((__m128i *)&atariBitplaneData[24]);
+		__m128i t0 = _mm_unpacklo_epi32(r0, r1);
+		__m128i t1 = _mm_unpacklo_epi32(r2, r3);
+		__m128i t2 = _mm_unpackhi_epi32(r0, r1);
+		__m128i t3 = _mm_unpackhi_epi32(r2, r3);
+		d = _mm_unpacklo_epi64(t0, t1);
+		c = _mm_unpackhi_epi64(t0, t1);
+		b = _mm_unpacklo_epi64(t2, t3);
+		a = _mm_unpackhi_epi64(t2, t3);
+	} else {
+		__m128i r0 = _mm_loadu_si128((__m128i *)&atariBitplaneData[0]);
+		__m128i r1 = _mm_loadu_si128((__m128i *)&atariBitplaneData[8]);
+		r0 = _mm_shuffle_epi32(r0, _MM_SHUFFLE(3, 1, 2, 0));
+		r1 = _mm_shuffle_epi32(r1, _MM_SHUFFLE(3, 1, 2, 0));
+		d = _mm_unpacklo_epi64(r0, r1);
+		c = _mm_unpackhi_epi64(r0, r1);
+		a = b = _mm_setzero_si128();
+	}
+#else
+	if (bpp == 8) {
+		uint32x4x4_t r = vld4q_u32((const uint32_t *)atariBitplaneData);
+		d = r.val[0];
+		c = r.val[1];
+		b = r.val[2];
+		a = r.val[3];
+	} else {
+		uint32x4x2_t r = vld2q_u32((const uint32_t *)atariBitplaneData);
+		d = r.val[0];
+		c = r.val[1];
+		a = b = vdupq_n_u32(0);
+	}
+#endif
+
+	x = a;
+	a = VEC_OR(VEC_AND(a, VEC_SET1(0xf0f0f0f0)), VEC_SHR(VEC_AND(c, VEC_SET1(0xf0f0f0f0)), 4));
+	c = VEC_OR(VEC_SHL(VEC_AND(x, VEC_SET1(0x0f0f0f0f)), 4), VEC_AND(c, VEC_SET1(0x0f0f0f0f)));
+	x = b;
+	b = VEC_OR(VEC_AND(b, VEC_SET1(0xf0f0f0f0)), VEC_SHR(VEC_AND(d, VEC_SET1(0xf0f0f0f0)), 4));
+	d = VEC_OR(VEC_SHL(VEC_AND(x, VEC_SET1(0x0f0f0f0f)), 4), VEC_AND(d, VEC_SET1(0x0f0f0f0f)));
+
+	x = a;
+	a = VEC_OR(VEC_AND(a, VEC_SET1(0xcccccccc)), VEC_SHR(VEC_AND(b, VEC_SET1(0xcccccccc)), 2));
+	b = VEC_OR(VEC_SHL(VEC_AND(x, VEC_SET1(0x33333333)), 2), VEC_AND(b, VEC_SET1(0x33333333)));
+	x = c;
+	c = VEC_OR(VEC_AND(c, VEC_SET1(0xcccccccc)), VEC_SHR(VEC_AND(d, VEC_SET1(0xcccccccc)), 2));
+	d = VEC_OR(VEC_SHL(VEC_AND(x, VEC_SET1(0x33333333)), 2), VEC_AND(d, VEC_SET1(0x33333333)));
+
+#define VEC_SWAP_BITS(v) VEC_OR(VEC_OR(VEC_AND(v, VEC_SET1(0xaaaa5555)), \
+	                               VEC_SHL(VEC_AND(v, VEC_SET1(0x0000aaaa)), 15)), \
+	                        VEC_SHR(VEC_AND(v, VEC_SET1(0x55550000)), 15))
+	a = VEC_SWAP_BITS(a);
+	b = VEC_SWAP_BITS(b);
+	c = VEC_SWAP_BITS(c);
+	d = VEC_SWAP_BITS(d);
+#undef VEC_SWAP_BITS
+
+	VEC_STORE(la, a);
+	VEC_STORE(lb, b);
+	VEC_STORE(lc, c);
+	VEC_STORE(ld, d);
+
+	/* Same pixel order as in Screen_BitplaneToChunky16/32() */
+	for (i = 0; i < 4; i++) {
+		*idx++ = la[i] >> 16;
+		*idx++ = la[i];
+		*idx++ = lb[i] >> 16;
+		*idx++ = lb[i];
+		*idx++ = lc[i] >> 16;
+		*idx++ = lc[i];
+		*idx++ = ld[i] >> 16;
+		*idx++ = ld[i];
+		*idx++ = la[i] >> 24;
+		*idx++ = la[i] >> 8;
+		*idx++ = lb[i] >> 24;
+		*idx++ = lb[i] >> 8;
+		*idx++ = lc[i] >> 24;
+		*idx++ = lc[i] >> 8;
+		*idx++ = ld[i] >> 24;
+		*idx++ = ld[i] >> 8;
+	}
+}
+
+#endif /* SCREENCONV_SSE2 || SCREENCONV_NEON */
+
 static inline Uint16 *ScreenConv_BitplaneLineTo16bpp(Uint16 *fvram_column,
                                                      Uint16 *hvram_column, int vw,
                                                      int vbpp, int hscrolloffset)
@@ -301,7 +553,24 @@ static inline Uint16 *ScreenConv_BitplaneLineTo16bpp(Uint16 *fvram_column,
 	fvram_column += vbpp;
 
 	/* Now the main part of the line */
-	for (i = 1; i < (vw + 15) >> 4; i++)
+	i = 1;
+#if defined(SCREENCONV_SSE2) || defined(SCREENCONV_NEON)
+	if (vbpp == 4 || vbpp == 8)
+	{
+		Uint8 idx[64];
+		int j;
+
+		for (; i + 4 <= (vw + 15) >> 4; i += 4)
+		{
+			Screen_BitplaneToIndex64(fvram_column, vbpp, idx);
+			for (j = 0; j < 64; j++)
+				hvram_column[j] = idx2pal(idx[j]);
+			hvram_column += 64;
+			fvram_column += 4 * vbpp;
+		}
+	}
+#endif
+	for (; i < (vw + 15) >> 4; i++)
 	{
 		Screen_BitplaneToChunky16(fvram_column, vbpp, hvram_column);
 		hvram_column += 16;
@@ -337,7 +606,24 @@ static inline Uint32 *ScreenConv_BitplaneLineTo32bpp(Uint16 *fvram_column,
 	fvram_column += vbpp;
 
 	/* Now the main part of the line */
-	for (i = 1; i < (vw + 15) >> 4; i++)
+	i = 1;
+#if defined(SCREENCONV_SSE2) || defined(SCREENCONV_NEON)
+	if (vbpp == 4 || vbpp == 8)
+	{
+		Uint8 idx[64];
+		int j;
+
+		for (; i + 4 <= (vw + 15) >> 4; i += 4)
+		{
+			Screen_BitplaneToIndex64(fvram_column, vbpp, idx);
+			for (j = 0; j < 64; j++)
+				hvram_column[j] = idx2pal(idx[j]);
+			hvram_column += 64;
+			fvram_column += 4 * vbpp;
+		}
+	}
+#endif
+	for (; i < (vw + 15) >> 4; i++)
 	{
 		Screen_BitplaneToChunky32(fvram_column, vbpp, hvram_column);
 		hvram_column += 16;
@@ -357,6 +643,129 @@ static inline Uint32 *ScreenConv_BitplaneLineTo32bpp(Uint16 *fvram_column,
 	return hvram_column;
 }
 
+/**
+ * Convert a line of Falcon high-color pixels (big endian RGB565)
+ * into native 16-bit (RGB565) pixels
+ */
+static void ScreenConv_HiColorLineTo16bpp(Uint16 *fvram_column,
+                                          Uint16 *hvram_column, int vw)
+{
+	int w = 0;
+
+#if defined(SCREENCONV_SSE2)
+	for (; w + 8 <= vw; w += 8)
+	{
+		__m128i v = _mm_loadu_si128((__m128i *)&fvram_column[w]);
+		v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+		_mm_storeu_si128((__m128i *)&hvram_column[w], v);
+	}
+#elif defined(SCREENCONV_NEON)
+	for (; w + 8 <= vw; w += 8)
+	{
+		uint8x16_t v = vld1q_u8((const uint8_t *)&fvram_column[w]);
+		vst1q_u8((uint8_t *)&hvram_column[w], vrev16q_u8(v));
+	}
+#endif
+	for (; w < vw; w++)
+		hvram_column[w] = SDL_SwapBE16(fvram_column[w]);
+}
+
+#if defined(SCREENCONV_SSE2) || defined(SCREENCONV_NEON)
+/**
+ * Expand four RGB565 pixels (one per 32-bit lane) into 8 bits
+ * per component values, same as in ScreenConv_HiColorLineTo32bpp()
+ */
+#define VEC_HICOLOR_R(s) VEC_OR(VEC_AND(VEC_SHR(s, 8), VEC_SET1(0xf8)), VEC_SHR(s, 13))
+#define VEC_HICOLOR_G(s) VEC_OR(VEC_AND(VEC_SHR(s, 3), VEC_SET1(0xfc)), \
+                                VEC_AND(VEC_SHR(s, 9), VEC_SET1(0x03)))
+#define VEC_HICOLOR_B(s) VEC_OR(VEC_AND(VEC_SHL(s, 3), VEC_SET1(0xf8)), \
+                                VEC_AND(VEC_SHR(s, 2), VEC_SET1(0x07)))
+#endif
+
+/**
+ * Convert a line of Falcon high-color pixels (big endian RGB565)
+ * into native 32-bit pixels
+ */
+static void ScreenConv_HiColorLineTo32bpp(Uint16 *fvram_column,
+                                          Uint32 *hvram_column, int vw)
+{
+	SDL_PixelFormat *fmt = sdlscrn->format;
+	int w = 0;
+
+	if (fmt->Rloss || fmt->Gloss || fmt->Bloss)
+	{
+		/* Not 8 bits per component, let SDL do the mapping */
+		for (w = 0; w < vw; w++)
+		{
+			Uint16 srcword = SDL_SwapBE16(fvram_column[w]);
+			Uint8 r = ((srcword >> 8) & 0xf8) | (srcword >> 13);
+			Uint8 g = ((srcword >> 3) & 0xfc) | ((srcword >> 9) & 0x3);
+			Uint8 b = (srcword << 3) | ((srcword >> 2) & 0x07);
+			hvram_column[w] = SDL_MapRGB(fmt, r, g, b);
+		}
+		return;
+	}
+
+#if defined(SCREENCONV_SSE2)
+	{
+		const __m128i rshift = _mm_cvtsi32_si128(fmt->Rshift);
+		const __m128i gshift = _mm_cvtsi32_si128(fmt->Gshift);
+		const __m128i bshift = _mm_cvtsi32_si128(fmt->Bshift);
+		const __m128i amask = _mm_set1_epi32(fmt->Amask);
+		const __m128i zero = _mm_setzero_si128();
+		__m128i v, s, p;
+		int i;
+
+		for (; w + 8 <= vw; w += 8)
+		{
+			v = _mm_loadu_si128((__m128i *)&fvram_column[w]);
+			v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+			for (i = 0; i < 2; i++)
+			{
+				s = i ? _mm_unpackhi_epi16(v, zero) : _mm_unpacklo_epi16(v, zero);
+				p = _mm_or_si128(_mm_sll_epi32(VEC_HICOLOR_R(s), rshift),
+				                 _mm_sll_epi32(VEC_HICOLOR_G(s), gshift));
+				p = _mm_or_si128(p, _mm_sll_epi32(VEC_HICOLOR_B(s), bshift));
+				_mm_storeu_si128((__m128i *)&hvram_column[w + 4 * i],
+				                 _mm_or_si128(p, amask));
+			}
+		}
+	}
+#elif defined(SCREENCONV_NEON)
+	{
+		const int32x4_t rshift = vdupq_n_s32(fmt->Rshift);
+		const int32x4_t gshift = vdupq_n_s32(fmt->Gshift);
+		const int32x4_t bshift = vdupq_n_s32(fmt->Bshift);
+		const uint32x4_t amask = vdupq_n_u32(fmt->Amask);
+		uint16x8_t v;
+		uint32x4_t s, p;
+		int i;
+
+		for (; w + 8 <= vw; w += 8)
+		{
+			v = vreinterpretq_u16_u8(vrev16q_u8(vld1q_u8((const uint8_t *)&fvram_column[w])));
+			for (i = 0; i < 2; i++)
+			{
+				s = vmovl_u16(i ? vget_high_u16(v) : vget_low_u16(v));
+				p = vorrq_u32(vshlq_u32(VEC_HICOLOR_R(s), rshift),
+				              vshlq_u32(VEC_HICOLOR_G(s), gshift));
+				p = vorrq_u32(p, vshlq_u32(VEC_HICOLOR_B(s), bshift));
+				vst1q_u32(&hvram_column[w + 4 * i], vorrq_u32(p, amask));
+			}
+		}
+	}
+#endif
+	for (; w < vw; w++)
+	{
+		Uint32 srcword = SDL_SwapBE16(fvram_column[w]);
+		Uint32 r = ((srcword >> 8) & 0xf8) | (srcword >> 13);
+		Uint32 g = ((srcword >> 3) & 0xfc) | ((srcword >> 9) & 0x3);
+		Uint32 b = ((srcword << 3) & 0xf8) | ((srcword >> 2) & 0x07);
+		hvram_column[w] = (r << fmt->Rshift) | (g << fmt->Gshift)
+		                  | (b << fmt->Bshift) | fmt->Amask;
+	}
+}
+
 static void ScreenConv_BitplaneTo16bppNoZoom(Uint16 *fvram_line, Uint8 *hvram,
                                              int scrwidth, int scrheight,
                                              int vw, int vh, int vbpp,
@@ -371,7 +780,8 @@ static void ScreenConv_BitplaneTo16bppNoZoom(Uint16 *fvram_line, Uint8 *hvram,
 	/* Render the upper border */
 	for (h = 0; h < upperBorder; h++)
 	{
-		Screen_memset_uint16(hvram_line, palette.native[0], scrwidth);
+		if (ScreenConvCache.bFullUpdate)
+			Screen_memset_uint16(hvram_line, palette.native[0], scrwidth);
 		hvram_line += pitch;
 	}
 
@@ -380,6 +790,14 @@ static void ScreenConv_BitplaneTo16bppNoZoom(Uint16 *fvram_line, Uint8 *hvram,
 	{
 		Uint16 *hvram_column = hvram_line;
 
+		/* Skip the lines which didn't change since previous frame */
+		if (!ScreenConv_LineChanged(h, fvram_line))
+		{
+			fvram_line += nextline;
+			hvram_line += pitch;
+			continue;
+		}
+
 		nSampleHoldIdx = 0;
 
 		/* Left border first */
@@ -399,7 +817,8 @@ static void ScreenConv_BitplaneTo16bppNoZoom(Uint16 *fvram_line, Uint8 *hvram,
 	/* Render the lower border */
 	for (h = 0; h < lowBorder; h++)
 	{
-		Screen_memset_uint16(hvram_line, palette.native[0], scrwidth);
+		if (ScreenConvCache.bFullUpdate)
+			Screen_memset_uint16(hvram_line, palette.native[0], scrwidth);
 		hvram_line += pitch;
 	}
 }
@@ -418,7 +837,8 @@ static void ScreenConv_BitplaneTo32bppNoZoom(Uint16 *fvram_line, Uint8 *hvram,
 	/* Render the upper border */
 	for (h = 0; h < upperBorder; h++)
 	{
-		Screen_memset_uint32(hvram_line, palette.native[0], scrwidth);
+		if (ScreenConvCache.bFullUpdate)
+			Screen_memset_uint32(hvram_line, palette.native[0], scrwidth);
 		hvram_line += pitch;
 	}
 
@@ -427,6 +847,14 @@ static void ScreenConv_BitplaneTo32bppNoZoom(Uint16 *fvram_line, Uint8 *hvram,
 	{
 		Uint32 *hvram_column = hvram_line;
 
+		/* Skip the lines which didn't change since previous frame */
+		if (!ScreenConv_LineChanged(h, fvram_line))
+		{
+			fvram_line += nextline;
+			hvram_line += pitch;
+			continue;
+		}
+
 		nSampleHoldIdx = 0;
 
 		/* Left border first */
@@ -446,7 +874,8 @@ static void ScreenConv_BitplaneTo32bppNoZoom(Uint16 *fvram_line, Uint8 *hvram,
 	/* Render the lower border */
 	for (h = 0; h < lowBorder; h++)
 	{
-		Screen_memset_uint32(hvram_line, palette.native[0], scrwidth);
+		if (ScreenConvCache.bFullUpdate)
+			Screen_memset_uint32(hvram_line, palette.native[0], scrwidth);
 		hvram_line += pitch;
 	}
 }
@@ -465,7 +894,8 @@ static void ScreenConv_HiColorTo16bppNoZoom(Uint16 *fvram_line, Uint8 *hvram,
 	/* Render the upper border */
 	for (h = 0; h < upperBorder; h++)
 	{
-		Screen_memset_uint16(hvram_line, palette.native[0], scrwidth);
+		if (ScreenConvCache.bFullUpdate)
+			Screen_memset_uint16(hvram_line, palette.native[0], scrwidth);
 		hvram_line += pitch;
 	}
 
@@ -473,10 +903,15 @@ static void ScreenConv_HiColorTo16bppNoZoom(Uint16 *fvram_line, Uint8 *hvram,
 	for (h = 0; h < vh; h++)
 	{
 		Uint16 *hvram_column = hvram_line;
-#if SDL_BYTEORDER != SDL_BIG_ENDIAN
-		Uint16 *fvram_column;
-		int w;
-#endif
+
+		/* Skip the lines which didn't change since previous frame */
+		if (!ScreenConv_LineChanged(h, fvram_line))
+		{
+			fvram_line += nextline;
+			hvram_line += pitch;
+			continue;
+		}
+
 		/* Left border first */
 		Screen_memset_uint16(hvram_column, palette.native[0], leftBorder);
 		hvram_column += leftBorder;
@@ -488,10 +923,9 @@ static void ScreenConv_HiColorTo16bppNoZoom(Uint16 *fvram_line, Uint8 *hvram,
 		memcpy(hvram_column, fvram_line, vw<<1);
 		hvram_column += vw;
 #else
-		fvram_column = fvram_line;
 		/* Graphical area */
-		for (w = 0; w < vw; w++)
-			*hvram_column ++ = SDL_SwapBE16(*fvram_column++);
+		ScreenConv_HiColorLineTo16bpp(fvram_line, hvram_column, vw);
+		hvram_column += vw;
 #endif /* SDL_BYTEORDER == SDL_BIG_ENDIAN */
 
 		/* Right border */
@@ -504,7 +938,8 @@ static void ScreenConv_HiColorTo16bppNoZoom(Uint16 *fvram_line, Uint8 *hvram,
 	/* Render the bottom border */
 	for (h = 0; h < lowBorder; h++)
 	{
-		Screen_memset_uint16(hvram_line, palette.native[0], scrwidth);
+		if (ScreenConvCache.bFullUpdate)
+			Screen_memset_uint16(hvram_line, palette.native[0], scrwidth);
 		hvram_line += pitch;
 	}
 }
@@ -518,34 +953,36 @@ static void ScreenConv_HiColorTo32bppNoZoom(Uint16 *fvram_line, Uint8 *hvram,
 {
 	Uint32 *hvram_line = (Uint32 *)hvram;
 	int pitch = sdlscrn->pitch >> 2;
-	int h, w;
+	int h;
 
 	/* Render the upper border */
 	for (h = 0; h < upperBorder; h++)
 	{
-		Screen_memset_uint32(hvram_line, palette.native[0], scrwidth);
+		if (ScreenConvCache.bFullUpdate)
+			Screen_memset_uint32(hvram_line, palette.native[0], scrwidth);
 		hvram_line += pitch;
 	}
 
 	/* Render the graphical area */
 	for (h = 0; h < vh; h++)
 	{
-		Uint16 *fvram_column = fvram_line;
 		Uint32 *hvram_column = hvram_line;
 
+		/* Skip the lines which didn't change since previous frame */
+		if (!ScreenConv_LineChanged(h, fvram_line))
+		{
+			fvram_line += nextline;
+			hvram_line += pitch;
+			continue;
+		}
+
 		/* Left border first */
 		Screen_memset_uint32(hvram_column, palette.native[0], leftBorder);
 		hvram_column += leftBorder;
 
 		/* Graphical area */
-		for (w = 0; w < vw; w++)
-		{
-			Uint16 srcword = SDL_SwapBE16(*fvram_column++);
-			Uint8 r = ((srcword >> 8) & 0xf8) | (srcword >> 13);
-			Uint8 g = ((srcword >> 3) & 0xfc) | ((srcword >> 9) & 0x3);
-			Uint8 b = (srcword << 3) | ((srcword >> 2) & 0x07);
-			*hvram_column ++ = SDL_MapRGB(sdlscrn->format, r, g, b);
-		}
+		ScreenConv_HiColorLineTo32bpp(fvram_line, hvram_column, vw);
+		hvram_column += vw;
 
 		/* Right border */
 		Screen_memset_uint32(hvram_column, palette.native[0], rightBorder);
@@ -557,7 +994,8 @@ static void ScreenConv_HiColorTo32bppNoZoom(Uint16 *fvram_line, Uint8 *hvram,
 	/* Render the bottom border */
 	for (h = 0; h < lowBorder; h++)
 	{
-		Screen_memset_uint32(hvram_line, palette.native[0], scrwidth);
+		if (ScreenConvCache.bFullUpdate)
+			Screen_memset_uint32(hvram_line, palette.native[0], scrwidth);
 		hvram_line += pitch;
 	}
 }
@@ -579,9 +1017,6 @@ static void Screen_ConvertWithoutZoom(Uint16 *fvram, int vw, int vh, int vbpp, i
 		nextline += vbpp;
 	}
 
-	/* The sample-hold feature exists only on the TT */
-	bTTSampleHold = (TTSpecialVideoMode & 0x80) != 0;
-
 	/* Clip to SDL_Surface dimensions */
 	scrwidth = Screen_GetGenConvWidth();
 	scrheight = Screen_GetGenConvHeight();
@@ -686,13 +1121,15 @@ static void ScreenConv_BitplaneTo16bppZoomed(Uint16 *fvram, Uint8 *hvram,
 	Uint16 *fvram_line;
 	int pitch = sdlscrn->pitch >> 1;
 	int cursrcline = -1;
+	bool bLineChanged = false;
 	int scrIdx = 0;
 	int w, h;
 
 	/* Render the upper border */
 	for (h = 0; h < upperBorder * coefy; h++)
 	{
-		Screen_memset_uint16(hvram_line, palette.native[0], scrwidth);
+		if (ScreenConvCache.bFullUpdate)
+			Screen_memset_uint16(hvram_line, palette.native[0], scrwidth);
 		hvram_line += pitch;
 	}
 
@@ -706,9 +1143,11 @@ static void ScreenConv_BitplaneTo16bppZoomed(Uint16 *fvram, Uint8 *hvram,
 		/* Recopy the same line ? */
 		if (screen_zoom.zoomytable[h] == cursrcline)
 		{
-			memcpy(hvram_line, hvram_line - pitch, scrwidth * sdlscrn->format->BytesPerPixel);
+			if (bLineChanged)
+				memcpy(hvram_line, hvram_line - pitch, scrwidth * sdlscrn->format->BytesPerPixel);
 		}
-		else
+		/* Convert the line only if it changed since previous frame */
+		else if ((bLineChanged = ScreenConv_LineChanged(screen_zoom.zoomytable[h], fvram_line)))
 		{
 			ScreenConv_BitplaneLineTo16bpp(fvram_line, p2cline,
 			                               vw, vbpp, hscrolloffset);
@@ -736,7 +1175,8 @@ static void ScreenConv_BitplaneTo16bppZoomed(Uint16 *fvram, Uint8 *hvram,
 	/* Render the lower border */
 	for (h = 0; h < lowerBorder * coefy; h++)
 	{
-		Screen_memset_uint16(hvram_line, palette.native[0], scrwidth);
+		if (ScreenConvCache.bFullUpdate)
+			Screen_memset_uint16(hvram_line, palette.native[0], scrwidth);
 		hvram_line += pitch;
 	}
 
@@ -758,13 +1198,15 @@ static void ScreenConv_BitplaneTo32bppZoomed(Uint16 *fvram, Uint8 *hvram,
 	Uint16 *fvram_line;
 	int pitch = sdlscrn->pitch >> 2;
 	int cursrcline = -1;
+	bool bLineChanged = false;
 	int scrIdx = 0;
 	int w, h;
 
 	/* Render the upper border */
 	for (h = 0; h < upperBorder * coefy; h++)
 	{
-		Screen_memset_uint32(hvram_line, palette.native[0], scrwidth);
+		if (ScreenConvCache.bFullUpdate)
+			Screen_memset_uint32(hvram_line, palette.native[0], scrwidth);
 		hvram_line += pitch;
 	}
 
@@ -778,9 +1220,11 @@ static void ScreenConv_BitplaneTo32bppZoomed(Uint16 *fvram, Uint8 *hvram,
 		/* Recopy the same line ? */
 		if (screen_zoom.zoomytable[h] == cursrcline)
 		{
-			memcpy(hvram_line, hvram_line - pitch, scrwidth * sdlscrn->format->BytesPerPixel);
+			if (bLineChanged)
+				memcpy(hvram_line, hvram_line - pitch, scrwidth * sdlscrn->format->BytesPerPixel);
 		}
-		else
+		/* Convert the line only if it changed since previous frame */
+		else if ((bLineChanged = ScreenConv_LineChanged(screen_zoom.zoomytable[h], fvram_line)))
 		{
 			ScreenConv_BitplaneLineTo32bpp(fvram_line, p2cline,
 			                               vw, vbpp, hscrolloffset);
@@ -809,7 +1253,8 @@ static void ScreenConv_BitplaneTo32bppZoomed(Uint16 *fvram, Uint8 *hvram,
 	/* Render the lower border */
 	for (h = 0; h < lowerBorder * coefy; h++)
 	{
-		Screen_memset_uint32(hvram_line, palette.native[0], scrwidth);
+		if (ScreenConvCache.bFullUpdate)
+			Screen_memset_uint32(hvram_line, palette.native[0], scrwidth);
 		hvram_line += pitch;
 	}
 
@@ -829,13 +1274,15 @@ static void ScreenConv_HiColorTo16bppZoomed(Uint16 *fvram, Uint8 *hvram,
 	Uint16 *fvram_line;
 	int pitch = sdlscrn->pitch >> 1;
 	int cursrcline = -1;
+	bool bLineChanged = false;
 	int scrIdx = 0;
 	int w, h;
 
 	/* Render the upper border */
 	for (h = 0; h < upperBorder * coefy; h++)
 	{
-		Screen_memset_uint16(hvram_line, palette.native[0], scrwidth);
+		if (ScreenConvCache.bFullUpdate)
+			Screen_memset_uint16(hvram_line, palette.native[0], scrwidth);
 		hvram_line += pitch;
 	}
 
@@ -852,9 +1299,11 @@ static void ScreenConv_HiColorTo16bppZoomed(Uint16 *fvram, Uint8 *hvram,
 		/* Recopy the same line ? */
 		if (screen_zoom.zoomytable[h] == cursrcline)
 		{
-			memcpy(hvram_line, hvram_line - pitch, scrwidth * sdlscrn->format->BytesPerPixel);
+			if (bLineChanged)
+				memcpy(hvram_line, hvram_line - pitch, scrwidth * sdlscrn->format->BytesPerPixel);
 		}
-		else
+		/* Convert the line only if it changed since previous frame */
+		else if ((bLineChanged = ScreenConv_LineChanged(screen_zoom.zoomytable[h], fvram_line)))
 		{
 			hvram_column = hvram_line;
 
@@ -878,7 +1327,8 @@ static void ScreenConv_HiColorTo16bppZoomed(Uint16 *fvram, Uint8 *hvram,
 	/* Render the lower border */
 	for (h = 0; h < lowerBorder * coefy; h++)
 	{
-		Screen_memset_uint16(hvram_line, palette.native[0], scrwidth);
+		if (ScreenConvCache.bFullUpdate)
+			Screen_memset_uint16(hvram_line, palette.native[0], scrwidth);
 		hvram_line += pitch;
 	}
 }
@@ -896,13 +1346,15 @@ static void ScreenConv_HiColorTo32bppZoomed(Uint16 *fvram, Uint8 *hvram,
 	Uint16 *fvram_line;
 	int pitch = sdlscrn->pitch >> 2;
 	int cursrcline = -1;
+	bool bLineChanged = false;
 	int scrIdx = 0;
 	int w, h;
 
 	/* Render the upper border */
 	for (h = 0; h < upperBorder * coefy; h++)
 	{
-		Screen_memset_uint32(hvram_line, palette.native[0], scrwidth);
+		if (ScreenConvCache.bFullUpdate)
+			Screen_memset_uint32(hvram_line, palette.native[0], scrwidth);
 		hvram_line += pitch;
 	}
 
@@ -918,9 +1370,11 @@ static void ScreenConv_HiColorTo32bppZoomed(Uint16 *fvram, Uint8 *hvram,
 		/* Recopy the same line ? */
 		if (screen_zoom.zoomytable[h] == cursrcline)
 		{
-			memcpy(hvram_line, hvram_line - pitch, scrwidth * sdlscrn->format->BytesPerPixel);
+			if (bLineChanged)
+				memcpy(hvram_line, hvram_line - pitch, scrwidth * sdlscrn->format->BytesPerPixel);
 		}
-		else
+		/* Convert the line only if it changed since previous frame */
+		else if ((bLineChanged = ScreenConv_LineChanged(screen_zoom.zoomytable[h], fvram_line)))
 		{
 			hvram_column = hvram_line;
 
@@ -952,7 +1406,8 @@ static void ScreenConv_HiColorTo32bppZoomed(Uint16 *fvram, Uint8 *hvram,
 	/* Render the lower border */
 	for (h = 0; h < lowerBorder * coefy; h++)
 	{
-		Screen_memset_uint32(hvram_line, palette.native[0], scrwidth);
+		if (ScreenConvCache.bFullUpdate)
+			Screen_memset_uint32(hvram_line, palette.native[0], scrwidth);
 		hvram_line += pitch;
 	}
 }
@@ -968,9 +1423,6 @@ static void Screen_ConvertWithZoom(Uint16 *fvram, int vw, int vh, int vbpp, int
 	int vw_b, vh_b;
 	int i;
 
-	/* The sample-hold feature exists only on the TT */
-	bTTSampleHold = (TTSpecialVideoMode & 0x80) != 0;
-
 	vw_b = vw + leftBorder + rightBorder;
 	vh_b = vh + upperBorder + lowerBorder;
 
@@ -998,6 +1450,10 @@ static void Screen_ConvertWithZoom(Uint16 *fvram, int vw, int vh, int vbpp, int
 		/* Center screen */
 		hvram += ((Screen_GetGenConvHeight()-scrheight)>>1)*scrpitch;
 		hvram += ((Screen_GetGenConvWidth()-scrwidth)>>1)*scrbpp;
+	} else {
+		/* Downscaling can read source pixels outside of
+		 * the compared line data, so convert all lines */
+		ScreenConvCache.bFullUpdate = true;
 	}
 
 	/* New zoom ? */
@@ -1068,10 +1524,26 @@ static void Screen_ConvertWithZoom(Uint16 *fvram, int vw, int vh, int vbpp, int
 	}
 }
 
-void Screen_GenConvert(void *fvram, int vw, int vh, int vbpp, int nextline,
+/**
+ * Convert given Atari screen into the host screen surface.
+ * Only the lines that changed since previous frame are converted,
+ * unless the palette or any of the conversion parameters changed,
+ * or ScreenConv_SetFullUpdate() was called.
+ * Return true if host screen contents changed.
+ */
+bool Screen_GenConvert(void *fvram, int vw, int vh, int vbpp, int nextline,
                        int hscroll, int leftBorderSize, int rightBorderSize,
                        int upperBorderSize, int lowerBorderSize)
 {
+	bool bChanged;
+
+	/* The sample-hold feature exists only on the TT */
+	bTTSampleHold = (TTSpecialVideoMode & 0x80) != 0;
+
+	ScreenConv_StartFrame(fvram, sdlscrn->pixels, vw, vh, vbpp, nextline, hscroll,
+	                      leftBorderSize, rightBorderSize,
+	                      upperBorderSize, lowerBorderSize);
+
 	if (nScreenZoomX * nScreenZoomY != 1) {
 		Screen_ConvertWithZoom(fvram, vw, vh, vbpp, nextline, hscroll,
 		                       leftBorderSize, rightBorderSize,
@@ -1081,13 +1553,22 @@ void Screen_GenConvert(void *fvram, int vw, int vh, int vbpp, int nextline,
 		                          leftBorderSize, rightBorderSize,
 		                          upperBorderSize, lowerBorderSize);
 	}
+
+	bChanged = ScreenConvCache.bFullUpdate || ScreenConvCache.bChanged;
+	ScreenConvCache.bFullUpdate = false;
+	return bChanged;
 }
 
 bool Screen_GenDraw(uint32_t vaddr, int vw, int vh, int vbpp, int nextline,
                     int leftBorder, int rightBorder,
                     int upperBorder, int lowerBorder)
 {
+	SDL_Rect *sbar_rect;
 	int hscrolloffset;
+	bool bChanged;
+
+	/* Restore area under overlay led, lines below it may be skipped */
+	Statusbar_OverlayRestore(sdlscrn);
 
 	if (!Screen_Lock())
 		return false;
@@ -1097,10 +1578,15 @@ bool Screen_GenDraw(uint32_t vaddr, int vw, int vh, int vbpp, int nextline,
 	else
 		hscrolloffset = IoMem_ReadByte(0xff8265) & 0x0f;
 
-	Screen_GenConvert(&STRam[vaddr], vw, vh, vbpp, nextline, hscrolloffset,
-	                  leftBorder, rightBorder, upperBorder, lowerBorder);
+	bChanged = Screen_GenConvert(&STRam[vaddr], vw, vh, vbpp, nextline, hscrolloffset,
+	                             leftBorder, rightBorder, upperBorder, lowerBorder);
 
 	Screen_UnLock();
-	Screen_GenConvUpdate(Statusbar_Update(sdlscrn, false), false);
+	Statusbar_OverlayBackup(sdlscrn);
+	sbar_rect = Statusbar_Update(sdlscrn, false);
+	if (bChanged)
+		Screen_GenConvUpdate(sbar_rect, false);
+	else if (sbar_rect)
+		SDL_UpdateRects(sdlscrn, 1, sbar_rect);	/* statusbar only */
 	return true;
 }
@@ -13,6 +13,7 @@ const char ScreenSnapShot_fileid[] = "Hatari screenSnapShot.c : " __DATE__ " " _
 #include <string.h>
 #include "main.h"
 #include "configuration.h"
+#include "file.h"
 #include "log.h"
 #include "paths.h"
 #include "screen.h"
@@ -28,6 +29,7 @@ const char ScreenSnapShot_fileid[] = "Hatari screenSnapShot.c : " __DATE__ " " _
 
 
 static int nScreenShots = 0;                /* Number of screen shots saved */
+static bool bSnapShotPending;               /* screen shot waits for a converted frame */
 
 
 /*-----------------------------------------------------------------------*/
@@ -219,10 +221,26 @@ png_cleanup:
  */
 void ScreenSnapShot_SaveScreen(void)
 {
-	char *szFileName = malloc(FILENAME_MAX);
+	char *szFileName;
 
+	/* with "none" video backend, surface is up to date only for
+	 * requested frames, so save the screen once next one is drawn
+	 */
+	if (ConfigureParams.Screen.nVideoBackend == VIDEO_BACKEND_NONE
+	    && !bSnapShotPending)
+	{
+		bSnapShotPending = true;
+		Screen_RequestFrame();
+		return;
+	}
+	bSnapShotPending = false;
+
+	szFileName = malloc(FILENAME_MAX);
 	if (!szFileName)  return;
 
+	/* make sure screen surface contains the whole frame */
+	Screen_FinishRender();
+
 	ScreenSnapShot_GetNum();
 	/* Create our filename */
 	nScreenShots++;
@@ -245,3 +263,42 @@ void ScreenSnapShot_SaveScreen(void)
 	free(szFileName);
 }
 
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Called after a frame has been drawn, saves the screen shot that
+ * was deferred until then, if any.
+ */
+void ScreenSnapShot_FrameDone(void)
+{
+	if (bSnapShotPending)
+		ScreenSnapShot_SaveScreen();
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Save screen shot to given file. PNG format is used when the file name
+ * has a '.png' extension and Hatari was built with PNG support, otherwise
+ * the screen shot is saved as BMP.
+ * Return true on success, false on error.
+ */
+bool ScreenSnapShot_SaveToFile(const char *szFileName)
+{
+	bool bOK;
+
+	Screen_FinishRender();
+
+#if HAVE_LIBPNG
+	if (File_DoesFileExtensionMatch(szFileName, ".png"))
+		bOK = ScreenSnapShot_SavePNG(sdlscrn, szFileName) > 0;
+	else
+#endif
+		bOK = SDL_SaveBMP(sdlscrn, szFileName) == 0;
+
+	if (bOK)
+		fprintf(stderr, "Screen dump saved to: %s\n", szFileName);
+	else
+		fprintf(stderr, "Screen dump to '%s' failed!\n", szFileName);
+	return bOK;
+}
@@ -226,7 +226,7 @@ bool		UseLowPassFilter = false;
 bool		bEnvelopeFreqFlag;			/* Cleared each frame for YM saving */
 
 Sint16		MixBuffer[MIXBUFFER_SIZE][2];
-int		nGeneratedSamples;			/* Generated samples since audio buffer update */
+volatile int	nGeneratedSamples;			/* Generated samples since audio buffer update */
 static int	ActiveSndBufIdx;			/* Current working index into above mix buffer */
 static int	ActiveSndBufIdxAvi;			/* Current working index to save an AVI audio frame */
 
@@ -235,6 +235,7 @@ static int 	SamplesPerFrame;			/* Number of samples to generate for the current
 static int	CurrentSamplesNb = 0;			/* Number of samples already generated for the current VBL */
 
 bool		Sound_BufferIndexNeedReset = false;
+bool		Sound_SkipSynthesis = false;		/* true when the generated samples won't be heard */
 
 
 /*--------------------------------------------------------------*/
@@ -260,6 +261,7 @@ static ymu32	Ym2149_ToneStepCompute	(ymu8 rHigh , ymu8 rLow);
 static ymu32	Ym2149_NoiseStepCompute	(ymu8 rNoise);
 static ymu32	Ym2149_EnvStepCompute	(ymu8 rHigh , ymu8 rLow);
 static ymsample	YM2149_NextSample	(void);
+static void	YM2149_SkipSamples	(int nSamples);
 
 static int	Sound_SetSamplesPassed(bool FillFrame);
 static void	Sound_GenerateSamples(int SamplesToGenerate);
@@ -944,6 +946,41 @@ static ymsample	YM2149_NextSample(void)
 
 
 
+/*-----------------------------------------------------------------------*/
+/**
+ * Advance the YM2149's tone, noise and envelope generators by nSamples,
+ * like YM2149_NextSample() does, but without computing the samples.
+ * Used when sound synthesis is skipped (see Sound_SkipSynthesis).
+ */
+static void	YM2149_SkipSamples(int nSamples)
+{
+	int		i;
+	yms64		pos;
+
+	/* The random generator is updated at most once per sample */
+	for ( i=0 ; i<nSamples ; i++ )
+	{
+		if ( noisePos&0xff000000 )
+		{
+			currentNoise = YM2149_RndCompute();
+			noisePos &= 0xffffff;
+		}
+		noisePos += noiseStep;
+	}
+
+	posA += stepA * nSamples;
+	posB += stepB * nSamples;
+	posC += stepC * nSamples;
+
+	/* Once blocks 0, 1 and 2 were used, blocks 1 and 2 are looped */
+	pos = (yms64)envPos + (yms64)envStep * nSamples;
+	if ( pos >= (3*32) << 24 )
+		pos = (32<<24) + ( pos - (32<<24) ) % ( (2*32) << 24 );
+	envPos = pos;
+}
+
+
+
 /*-----------------------------------------------------------------------*/
 /**
  * Update internal variables (steps, volume masks, ...) each
@@ -1115,6 +1152,7 @@ void Sound_Reset(void)
 	SamplesPerFrame = SAMPLES_PER_FRAME;
 	CurrentSamplesNb = 0;
 	ActiveSndBufIdxAvi = ActiveSndBufIdx;
+	Audio_ResetResampling();
 //fprintf ( stderr , "Sound_Reset SoundBufferSize %d SAMPLES_PER_FRAME %d nGeneratedSamples %d , ActiveSndBufIdx %d\n" ,
 //	SoundBufferSize , SAMPLES_PER_FRAME, nGeneratedSamples , ActiveSndBufIdx );
 
@@ -1141,6 +1179,7 @@ void Sound_ResetBufferIndex(void)
 	SamplesPerFrame = SAMPLES_PER_FRAME;
 	CurrentSamplesNb = 0;
 	ActiveSndBufIdxAvi = ActiveSndBufIdx;
+	Audio_ResetResampling();
 //fprintf ( stderr , "Sound_ResetBufferIndex SoundBufferSize %d SAMPLES_PER_FRAME %d nGeneratedSamples %d , ActiveSndBufIdx %d\n" ,
 //	SoundBufferSize , SAMPLES_PER_FRAME, nGeneratedSamples , ActiveSndBufIdx );
 	Audio_Unlock();
@@ -1272,7 +1311,17 @@ static void Sound_GenerateSamples(int SamplesToGenerate)
 	if (SamplesToGenerate <= 0)
 		return;
 
-	if (Config_IsMachineFalcon())
+	if (Sound_SkipSynthesis)
+	{
+		/* Only keep the YM2149 state up to date, but DMA sound */
+		/* still needs to be processed as it's visible to the CPU */
+		YM2149_SkipSamples(SamplesToGenerate);
+		if (Config_IsMachineFalcon())
+			Crossbar_GenerateSamples(ActiveSndBufIdx, SamplesToGenerate);
+		else if (!Config_IsMachineST())
+			DmaSnd_GenerateSamples(ActiveSndBufIdx, SamplesToGenerate);
+	}
+	else if (Config_IsMachineFalcon())
 	{
 		for (i = 0; i < SamplesToGenerate; i++)
 		{
@@ -1302,7 +1351,8 @@ static void Sound_GenerateSamples(int SamplesToGenerate)
  	}
 
 	ActiveSndBufIdx = (ActiveSndBufIdx + SamplesToGenerate) % MIXBUFFER_SIZE;
-	nGeneratedSamples += SamplesToGenerate;
+	/* Publish the new samples to the audio callback only once they're written */
+	Audio_AtomicAdd(&nGeneratedSamples, SamplesToGenerate);
 	CurrentSamplesNb += SamplesToGenerate;				/* number of samples generated for current VBL */
 }
 
@@ -1319,8 +1369,8 @@ void Sound_Update(bool FillFrame)
 	int OldSndBufIdx = ActiveSndBufIdx;
 	int SamplesToGenerate;
 
-	/* Make sure that we don't interfere with the audio callback function */
-	Audio_Lock();
+	/* No lock is needed, MixBuffer is a single producer / single consumer */
+	/* ring buffer (see Audio_CallBack()) */
 
 	/* Find how many samples to generate */
 	SamplesToGenerate = Sound_SetSamplesPassed( FillFrame );
@@ -1328,9 +1378,6 @@ void Sound_Update(bool FillFrame)
 	/* And generate */
 	Sound_GenerateSamples( SamplesToGenerate );
 
-	/* Allow audio callback function to occur again */
-	Audio_Unlock();
-
 	/* Save to WAV file, if open */
 	if (bRecordingWav)
 		WAVFormat_Update(MixBuffer, OldSndBufIdx, SamplesToGenerate);
@@ -1341,35 +1388,10 @@ extern short signed int SNDBUF[1024*2];
 static void Retro_Audio_CallBack(int len)
 {
 	Sint16 *pBuffer;
-	int i, window, nSamplesPerFrame;
+	int i;
 	pBuffer = (Sint16 *)&SNDBUF[0];
 	len = len / 4; // Use length in samples (16 bit stereo), not in bytes
-/* Adjust emulation rate within +/- 0.58% (10 cents) occasionally,
-* to synchronize sound. Note that an octave (frequency doubling)
-* has 12 semitones (12th root of two for a semitone), and that
-* one semitone has 100 cents (1200th root of two for one cent).
-* Ten cents are desired, thus, the 120th root of two minus one is
-* multiplied by 1,000,000 to convert to microseconds, and divided
-* by nScreenRefreshRate=60 to get a 96 microseconds swallow size.
-* (2^(10cents/(12semitones*100cents)) - 1) * 10^6 / nScreenRefreshRate
-* See: main.c - Main_WaitOnVbl()
-*/
-	pulse_swallowing_count = 0; /* 0 = Unaltered emulation rate */
-	if (ConfigureParams.Sound.bEnableSoundSync)
-	{
-	/* Sound synchronized emulation */
-		nSamplesPerFrame = nAudioFrequency/nScreenRefreshRate;
-		window = (nSamplesPerFrame > SoundBufferSize) ? nSamplesPerFrame : SoundBufferSize;
-	/* Window Comparator for SoundBufferSize */
-		if (nGeneratedSamples < window + (window >> 1))
-			/* Increase emulation rate to maintain sound synchronization */
-			pulse_swallowing_count = -5793 / nScreenRefreshRate;
-		else
-			if (nGeneratedSamples > (window << 1) + (window >> 2))
-			/* Decrease emulation rate to maintain sound synchronization */
-				pulse_swallowing_count = 5793 / nScreenRefreshRate;
-				/* Otherwise emulation rate is unaltered. */
-		}
+	/* The frontend paces the emulation, so there's no rate to adjust here */
 		if (nGeneratedSamples >= len)
 		{
 		/* Enough samples available: Pass completed buffer to audio system
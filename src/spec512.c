@@ -95,14 +95,21 @@ CYCLEPALETTE;
 
 /* 314k; 1024-bytes per line */
 static CYCLEPALETTE CyclePalettes[(MAX_SCANLINES_PER_FRAME+1)*MAX_CYCLEPALETTES_PERLINE];
-static CYCLEPALETTE *pCyclePalette;
 static int nCyclePalettes[(MAX_SCANLINES_PER_FRAME+1)];  /* Number of entries in above table for each scanline */
 static int nPalettesAccesses;   /* Number of times accessed palette registers */
 static Uint16 CycleColour;
 static int CycleColourIndex;
-static int nScanLine, ScanLineCycleCount;
+static int nScanLine;
 static bool bIsSpec512Display;
 
+/* Palette changes of each scanline, built from 'CyclePalettes' when */
+/* starting the conversion of a frame (same layout as 'CyclePalettes') */
+static SPEC512_SPAN SpanPalettes[(MAX_SCANLINES_PER_FRAME+1)*MAX_CYCLEPALETTES_PERLINE];
+SPEC512_SPAN *pSpec512Span;     /* Next palette change in the current line */
+int nSpec512Span;               /* Current 4-cycle span in the line */
+
+#define SPEC512_SPAN_END  0x7fffffff    /* 'Span' of a line's terminator */
+
 #if SDL_BYTEORDER == SDL_BIG_ENDIAN
 static const int STRGBPalEndianTable[16] =
 {
@@ -225,6 +232,47 @@ void Spec512_StoreCyclePalette(Uint16 col, Uint32 addr)
 }
 
 
+/*-----------------------------------------------------------------------*/
+/**
+ * Convert the palette writes stored for each line into a list of palette
+ * changes per 4-cycle span, with colors already converted to host RGB.
+ * A write is only used if it is stored at a multiple of 4 cycles after
+ * the previous one ; the following writes on the same line are ignored
+ * (they would never be reached when scanning the line 4 cycles at a time).
+ */
+static void Spec512_BuildSpans(void)
+{
+	CYCLEPALETTE *pCyclePalette;
+	SPEC512_SPAN *pSpan;
+	int i, n, Span;
+
+	for (i = 0; i < (nScanlinesPerFrame+1); i++)
+	{
+		pCyclePalette = &CyclePalettes[i*MAX_CYCLEPALETTES_PERLINE];
+		pSpan = &SpanPalettes[i*MAX_CYCLEPALETTES_PERLINE];
+		Span = 0;
+
+		for (n = 0; n < nCyclePalettes[i]; n++, pCyclePalette++)
+		{
+			if ((pCyclePalette->LineCycles & 3) || pCyclePalette->LineCycles < Span*4)
+				break;
+
+			Span = pCyclePalette->LineCycles / 4;
+			pSpan->Span = Span++;
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+			pSpan->Index = STRGBPalEndianTable[pCyclePalette->Index];
+#else
+			pSpan->Index = pCyclePalette->Index;
+#endif
+			pSpan->RGB = ST2RGB[pCyclePalette->Colour];
+			pSpan++;
+		}
+
+		pSpan->Span = SPEC512_SPAN_END;          /* Term */
+	}
+}
+
+
 /*-----------------------------------------------------------------------*/
 /**
  * Begin palette calculation for Spectrum 512 style images,
@@ -236,12 +284,8 @@ void Spec512_StartFrame(void)
 	/* Set so screen gets full-update when returns from Spectrum 512 display */
 	Screen_SetFullUpdate();
 
-	/* Set terminators on each line, so when scan during conversion we know when to stop */
-	for (i = 0; i < (nScanlinesPerFrame+1); i++)
-	{
-		pCyclePalette = &CyclePalettes[ (i*MAX_CYCLEPALETTES_PERLINE) + nCyclePalettes[i] ];
-		pCyclePalette->LineCycles = -1;          /* Term */
-	}
+	/* Build palette changes of each line, so conversion only has to look them up */
+	Spec512_BuildSpans();
 
        /* Copy first line palette, kept in 'HBLPalettes' and store to 'STRGBPalette' */
        for (i = 0; i < 16; i++)
@@ -271,28 +315,43 @@ void Spec512_StartFrame(void)
  */
 void Spec512_ScanWholeLine(void)
 {
-	/* Store pointer to line of palette cycle writes */
-	pCyclePalette = &CyclePalettes[nScanLine*MAX_CYCLEPALETTES_PERLINE];
+	/* Store pointer to line of palette changes */
+	pSpec512Span = &SpanPalettes[nScanLine*MAX_CYCLEPALETTES_PERLINE];
 	/* Ready for next scan line */
 	nScanLine++;
 
 	/* Update palette entries until we reach start of displayed screen */
-	ScanLineCycleCount = 0;
+	nSpec512Span = 0;
 	Spec512_EndScanLine();        /* Read whole line of palettes and update 'STRGBPalette' */
 }
 
 
+/*-----------------------------------------------------------------------*/
+/**
+ * Update palette for the next 'count' 4-pixels spans at once
+ */
+static void Spec512_UpdatePaletteSpans(int count)
+{
+	nSpec512Span += count;
+
+	while (pSpec512Span->Span < nSpec512Span)
+	{
+		STRGBPalette[pSpec512Span->Index] = pSpec512Span->RGB;
+		pSpec512Span += 1;
+	}
+}
+
+
 /*-----------------------------------------------------------------------*/
 /**
  * Build up palette for this scan line and store in 'ScanLinePalettes'
  */
 void Spec512_StartScanLine(void)
 {
-	int i;
 	int LineStartCycle;
 
-	/* Store pointer to line of palette cycle writes */
-	pCyclePalette = &CyclePalettes[nScanLine*MAX_CYCLEPALETTES_PERLINE];
+	/* Store pointer to line of palette changes */
+	pSpec512Span = &SpanPalettes[nScanLine*MAX_CYCLEPALETTES_PERLINE];
 	/* Ready for next scan line */
 	nScanLine++;
 
@@ -302,13 +361,13 @@ void Spec512_StartScanLine(void)
 		LineStartCycle = LINE_START_CYCLE_60;			/* The screen was 60 Hz */
 
 	/* Update palette entries until we reach start of displayed screen */
-	ScanLineCycleCount = 0;
-	for (i=0; i<((LineStartCycle-SCREENBYTES_LEFT*2)/4 + 7); i++)	/* [NP] '7' is required to align pixels and colors */
-		Spec512_UpdatePaletteSpan();              /* Update palette for this 4-cycle period */
+	nSpec512Span = 0;
+	if ((LineStartCycle-SCREENBYTES_LEFT*2)/4 + 7 > 0)	/* [NP] '7' is required to align pixels and colors */
+		Spec512_UpdatePaletteSpans((LineStartCycle-SCREENBYTES_LEFT*2)/4 + 7);
 
 	/* And skip for left border is not using overscan display to user */
-	for (i=0; i<(STScreenLeftSkipBytes/2); i++)   /* Eg, 16 bytes = 32 pixels or 8 palette periods */
-		Spec512_UpdatePaletteSpan();
+	if (STScreenLeftSkipBytes > 0)     /* Eg, 16 bytes = 32 pixels or 8 palette periods */
+		Spec512_UpdatePaletteSpans(STScreenLeftSkipBytes/2);
 }
 
 
@@ -324,27 +383,6 @@ void Spec512_EndScanLine(void)
 	CycleEnd >>= nCpuFreqShift;
 #endif
 	/* Continue to reads palette until complete so have correct version for next line */
-	while (ScanLineCycleCount < CycleEnd)
-		Spec512_UpdatePaletteSpan();
-}
-
-
-/*-----------------------------------------------------------------------*/
-/**
- * Update palette for 4-pixels span, storing to 'STRGBPalette'
- */
-void Spec512_UpdatePaletteSpan(void)
-{
-	if (pCyclePalette->LineCycles == ScanLineCycleCount)
-	{
-		/* Need to update palette with new entry */
-#if SDL_BYTEORDER == SDL_BIG_ENDIAN
-		STRGBPalette[STRGBPalEndianTable[pCyclePalette->Index]] = ST2RGB[pCyclePalette->Colour];
-#else
-		STRGBPalette[pCyclePalette->Index] = ST2RGB[pCyclePalette->Colour];
-//fprintf ( stderr , "upd spec cyc %d %x %x\n" , ScanLineCycleCount , pCyclePalette->Index , pCyclePalette->Colour );
-#endif
-		pCyclePalette += 1;
-	}
-	ScanLineCycleCount += 4;      /* Next 4 cycles */
+	if (nSpec512Span*4 < CycleEnd)
+		Spec512_UpdatePaletteSpans((CycleEnd+3)/4 - nSpec512Span);
 }
@@ -33,6 +33,82 @@ Uint8 STRam[16*1024*1024];
 
 Uint32 STRamEnd;            /* End of ST Ram, above this address is no-mans-land and ROM/IO memory */
 
+Uint32 STMemory_WriteStamps[STMEMORY_STAMP_PAGES];	/* Stamp of the last write for each page */
+Uint32 STMemory_WriteStamp = 1;				/* Current write stamp */
+static Uint32 STMemory_WriteStampAll;			/* Stamp of the last write to an unknown area */
+
+
+/**
+ * Mark given area of ST memory as written with the current stamp
+ */
+void STMemory_MarkAreaWritten(Uint32 addr, Uint32 len)
+{
+	Uint32 page, last;
+
+	if (len == 0)
+		return;
+
+	page = ( addr & 0xffffff ) >> STMEMORY_STAMP_PAGE_SHIFT;
+	last = ( ( addr + len - 1 ) & 0xffffff ) >> STMEMORY_STAMP_PAGE_SHIFT;
+	if (last < page)			/* area wraps at the end of the 24 bit space */
+	{
+		STMemory_MarkAllWritten();
+		return;
+	}
+	for ( ; page <= last ; page++)
+		STMemory_WriteStamps[page] = STMemory_WriteStamp;
+}
+
+/**
+ * Mark the whole ST memory as written with the current stamp, used when
+ * the memory is modified in a way where the written area is not known
+ * (direct pointer, snapshot restore, ...)
+ */
+void STMemory_MarkAllWritten(void)
+{
+	STMemory_WriteStampAll = STMemory_WriteStamp;
+}
+
+/**
+ * Return true if some bytes of the given area of ST memory could have
+ * been modified since the given stamp was current.
+ * Writes are marked only at their start address, so the check also
+ * covers the 3 bytes before the area for long writes crossing pages.
+ */
+bool STMemory_IsAreaWrittenSince(Uint32 addr, Uint32 len, Uint32 stamp)
+{
+	Uint32 page, last;
+
+	if (STMemory_WriteStampAll >= stamp)
+		return true;
+
+	page = ( ( addr - 3 ) & 0xffffff ) >> STMEMORY_STAMP_PAGE_SHIFT;
+	last = ( ( addr + len - 1 ) & 0xffffff ) >> STMEMORY_STAMP_PAGE_SHIFT;
+	if (last < page)
+		return true;
+	for ( ; page <= last ; page++)
+		if (STMemory_WriteStamps[page] >= stamp)
+			return true;
+	return false;
+}
+
+/**
+ * Start a new write stamp, writes marked from now on will be seen as
+ * newer than all the previous stamps.
+ * Return false if the stamps wrapped around ; in that case the caller
+ * must forget all the stamps it stored before.
+ */
+bool STMemory_NewWriteStamp(void)
+{
+	if (++STMemory_WriteStamp != 0)
+		return true;
+
+	memset(STMemory_WriteStamps, 0, sizeof(STMemory_WriteStamps));
+	STMemory_WriteStamp = 1;
+	STMemory_WriteStampAll = 1;
+	return false;
+}
+
 
 /**
  * Clear section of ST's memory space.
@@ -40,6 +116,7 @@ Uint32 STRamEnd;            /* End of ST Ram, above this address is no-mans-land
 static void STMemory_Clear(Uint32 StartAddress, Uint32 EndAddress)
 {
 	memset(&STRam[StartAddress], 0, EndAddress-StartAddress);
+	STMemory_MarkAreaWritten(StartAddress, EndAddress-StartAddress);
 }
 
 /**
@@ -61,6 +138,7 @@ bool STMemory_SafeCopy(Uint32 addr, Uint8 *src, unsigned int len, const char *na
 	if ( STMemory_CheckAreaType ( addr, len, ABFLAG_RAM ) )
 	{
 		memcpy(&STRam[addr], src, len);
+		STMemory_MarkAreaWritten(addr, len);
 		return true;
 	}
 	Log_Printf(LOG_WARN, "Invalid '%s' RAM range 0x%x+%i!\n", name, addr, len);
@@ -68,7 +146,10 @@ bool STMemory_SafeCopy(Uint32 addr, Uint8 *src, unsigned int len, const char *na
 	for (end = addr + len; addr < end; addr++, src++)
 	{
 		if ( STMemory_CheckAreaType ( addr, 1, ABFLAG_RAM ) )
+		{
 			STRam[addr] = *src;
+			STMemory_MarkWritten(addr);
+		}
 	}
 	return false;
 }
@@ -84,8 +165,15 @@ void STMemory_MemorySnapShot_Capture(bool bSave)
 	/* Only save/restore area of memory machine is set to, eg 1Mb */
 	MemorySnapShot_Store(STRam, STRamEnd);
 
-	/* And Cart/TOS/Hardware area */
-	MemorySnapShot_Store(&RomMem[0xE00000], 0x200000);
+	/* And Cart/TOS/Hardware area (in lightweight snapshots, only */
+	/* the hardware area, TOS and cartridge don't change) */
+	if (MemorySnapShot_IsLight())
+		MemorySnapShot_Store(&RomMem[0xFF0000], 0x10000);
+	else
+		MemorySnapShot_Store(&RomMem[0xE00000], 0x200000);
+
+	if (!bSave)
+		STMemory_MarkAllWritten();
 }
 
 
@@ -370,6 +458,9 @@ void	*STMemory_STAddrToPointer ( Uint32 addr )
 		addr &= 0x00ffffff;			/* Only keep the 24 lowest bits */
 
 	p = get_real_address ( addr );
+
+	/* The caller can modify the memory through this pointer */
+	STMemory_MarkAllWritten();
 	return (void *)p;
 }
 
@@ -401,13 +492,15 @@ void	STMemory_Write ( Uint32 addr , Uint32 val , int size )
 	if ( pBank->baseaddr == NULL )
 		return;					/* No real memory, do nothing */
 
+	STMemory_MarkWritten ( addr );
+
 	addr -= pBank->start & pBank->mask;
 	addr &= pBank->mask;
 	p = pBank->baseaddr + addr;
 
 	/* We modify the memory, so we flush the instr/data caches if needed */
 	M68000_Flush_All_Caches ( addr , size );
-	
+
 	if ( size == 4 )
 		do_put_mem_long ( p , val );
 	else if ( size == 2 )
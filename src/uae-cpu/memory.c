@@ -261,6 +261,7 @@ static void STmem_lput(uaecptr addr, uae_u32 l)
 {
     addr -= STmem_start & STmem_mask;
     addr &= STmem_mask;
+    STMemory_MarkWritten(addr);
     do_put_mem_long(STmemory + addr, l);
 }
 
@@ -268,6 +269,7 @@ static void STmem_wput(uaecptr addr, uae_u32 w)
 {
     addr -= STmem_start & STmem_mask;
     addr &= STmem_mask;
+    STMemory_MarkWritten(addr);
     do_put_mem_word(STmemory + addr, w);
 }
 
@@ -275,6 +277,7 @@ static void STmem_bput(uaecptr addr, uae_u32 b)
 {
     addr -= STmem_start & STmem_mask;
     addr &= STmem_mask;
+    STMemory_MarkWritten(addr);
     STmemory[addr] = b;
 }
 
@@ -354,6 +357,7 @@ static void SysMem_lput(uaecptr addr, uae_u32 l)
       return;
     }
 
+    STMemory_MarkWritten(addr);
     do_put_mem_long(STmemory + addr, l);
 }
 
@@ -375,6 +379,7 @@ static void SysMem_wput(uaecptr addr, uae_u32 w)
 	return;
     }
 
+    STMemory_MarkWritten(addr);
     do_put_mem_word(STmemory + addr, w);
 }
 
@@ -389,6 +394,7 @@ static void SysMem_bput(uaecptr addr, uae_u32 b)
       return;
     }
 
+    STMemory_MarkWritten(addr);
     STmemory[addr] = b;
 }
 
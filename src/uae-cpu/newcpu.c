@@ -907,6 +907,8 @@ void Exception(int nr, uaecptr oldpc, int ExceptionSource)
             CALL_VAR(PendingInterruptFunction);
         if ( MFP_UpdateNeeded == true )
             MFP_UpdateIRQ ( 0 );					/* update MFP's state if some internal timers related to MFP expired */
+        if ( nr == 26 )
+            Video_LineBatch_Stop ();				/* next HBL pending bit must be set on the next line */
         pendingInterrupts &= ~( 1 << ( nr - 24 ) );			/* clear HBL or VBL pending bit */
 	CPU_IACK = false;
     }
@@ -917,7 +919,13 @@ void Exception(int nr, uaecptr oldpc, int ExceptionSource)
         if (nr == 0x22)
         {
           /* Intercept VDI & AES exceptions (Trap #2) */
-          if(bVdiAesIntercept && VDI_AES_Entry())
+          int vdi = bVdiAesIntercept ? VDI_AES_Entry() : VDI_TRAP_TOS;
+          if (vdi == VDI_TRAP_DONE)
+          {
+            /* Call was already handled, skip TOS */
+            return;
+          }
+          if (vdi == VDI_TRAP_COMPLETE)
           {
             /* Set 'PC' to address of 'VDI_OPCODE' illegal instruction.
              * This will call OpCode_VDI() after completion of Trap call!
@@ -1737,10 +1745,6 @@ static int do_specialties (void)
     return 0;
 }
 
-#if defined(__LIBRETRO__) && !defined(HAVE_LIBCO) 	/* RETRO HACK */
-extern int CPULOOP;
-#endif /* RETRO HACK */
-
 /* It's really sad to have two almost identical functions for this, but we
    do it all for performance... :( */
 static void m68k_run_1 (void)
@@ -1850,9 +1854,6 @@ static void m68k_run_1 (void)
 	if (bDspEnabled) {
 	    DSP_Run( Cycles_GetCounter(CYCLES_COUNTER_CPU) * DSP_CPU_FREQ_RATIO);
 	}
-#if defined(__LIBRETRO__) && !defined(HAVE_LIBCO) 	/* RETRO HACK */
-        if(CPULOOP==0)break;
-#endif 	/* RETRO HACK */
     }
 }
 
@@ -1919,35 +1920,43 @@ static void m68k_run_2 (void)
 	if (bDspEnabled) {
 	    DSP_Run( Cycles_GetCounter(CYCLES_COUNTER_CPU) * DSP_CPU_FREQ_RATIO);
 	}
-#if defined(__LIBRETRO__) && !defined(HAVE_LIBCO) 	/* RETRO HACK */
-        if(CPULOOP==0)break;
-#endif 	/* RETRO HACK */
-
     }
 }
 
-#if defined(__LIBRETRO__) && !defined(HAVE_LIBCO) 	/* RETRO HACK */
+static int in_m68k_go = 0;
 
-void RetroLoop()
+#ifdef __LIBRETRO__	/* RETRO HACK */
+/*
+ * The libretro core can't block in m68k_go(), it has to return to the
+ * frontend after each frame. m68k_go_run() runs the CPU until it's asked
+ * to break (SPCFLAG_BRK) or until the CPU mode changes.
+ */
+void m68k_go_start (void)
 {
-       while(CPULOOP==1){
-
-         if(currprefs.cpu_compatible)
-          m68k_run_1();
-         else
-          m68k_run_2();
+    if (in_m68k_go) {
+	write_log ("Bug! m68k_go is not reentrant.\n");
+	abort ();
+    }
+    in_m68k_go++;
+}
 
-       }
+void m68k_go_run (void)
+{
+    if(currprefs.cpu_compatible)
+      m68k_run_1();
+    else
+      m68k_run_2();
+    unset_special(SPCFLAG_BRK);
+}
 
-       CPULOOP=1;
-       // TODO HANDLE SPCFLAG_BRK
+void m68k_go_stop (void)
+{
+    in_m68k_go--;
 }
-#endif 	/* RETRO HACK */
+#endif	/* RETRO HACK */
 
 void m68k_go (int may_quit)
 {
-    static int in_m68k_go = 0;
-
     if (in_m68k_go || !may_quit) {
 	write_log ("Bug! m68k_go is not reentrant.\n");
 	abort ();
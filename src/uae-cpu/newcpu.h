@@ -346,6 +346,11 @@ extern void m68k_mull (uae_u32, uae_u32, uae_u16);
 extern void build_cpufunctbl(void);
 extern void init_m68k (void);
 extern void m68k_go (int);
+#ifdef __LIBRETRO__	/* RETRO HACK */
+extern void m68k_go_start (void);
+extern void m68k_go_run (void);
+extern void m68k_go_stop (void);
+#endif	/* RETRO HACK */
 extern void m68k_dumpstate (FILE *, uaecptr *);
 extern void m68k_disasm (FILE *, uaecptr, uaecptr *, int);
 extern void m68k_reset (void);
@@ -22,6 +22,7 @@ const char VDI_fileid[] = "Hatari vdi.c : " __DATE__ " " __TIME__;
 #include "screen.h"
 #include "stMemory.h"
 #include "vdi.h"
+#include "vdiDraw.h"
 #include "video.h"
 
 
@@ -160,6 +161,7 @@ void VDI_Reset(void)
 {
 	/* no VDI calls in progress */
 	VDI_OldPC = 0;
+	VDIDraw_Reset();
 }
 
 /*-----------------------------------------------------------------------*/
@@ -757,13 +759,14 @@ static inline bool VDI_isWorkstationOpen(Uint16 opcode)
 
 /**
  * Check whether this is VDI/AES call and see if we need to re-direct
- * it to our own routines. Return true if VDI_Complete() function
- * needs to be called on OS call exit, otherwise return false.
+ * it to our own routines. Return VDI_TRAP_COMPLETE if VDI_Complete()
+ * function needs to be called on OS call exit, VDI_TRAP_DONE if call
+ * was already handled here, otherwise VDI_TRAP_TOS.
  *
  * We enter here with Trap #2, so D0 tells which OS call it is (VDI/AES)
  * and D1 is pointer to VDI/AES vectors, i.e. Control, Intin, Ptsin etc...
  */
-bool VDI_AES_Entry(void)
+int VDI_AES_Entry(void)
 {
 	Uint16 call = Regs[REG_D0];
 	Uint32 TablePtr = Regs[REG_D1];
@@ -775,7 +778,7 @@ bool VDI_AES_Entry(void)
 		if ( !STMemory_CheckAreaType ( TablePtr, 24, ABFLAG_RAM ) )
 		{
 			Log_Printf(LOG_WARN, "AES call failed due to invalid parameter block address 0x%x+%i\n", TablePtr, 24);
-			return false;
+			return VDI_TRAP_TOS;
 		}
 		/* store values for debugger "info aes" command */
 		AESControl = STMemory_ReadLong(TablePtr);
@@ -795,7 +798,7 @@ bool VDI_AES_Entry(void)
 		 * both VDI & AES as AES functions can be called
 		 * recursively and VDI calls happen inside AES calls.
 		 */
-		return false;
+		return VDI_TRAP_TOS;
 	}
 #endif
 
@@ -805,7 +808,7 @@ bool VDI_AES_Entry(void)
 		if ( !STMemory_CheckAreaType ( TablePtr, 20, ABFLAG_RAM ) )
 		{
 			Log_Printf(LOG_WARN, "VDI call failed due to invalid parameter block address 0x%x+%i\n", TablePtr, 20);
-			return false;
+			return VDI_TRAP_TOS;
 		}
 		/* store values for extended VDI resolution handling
 		 * and debugger "info vdi" command
@@ -824,12 +827,19 @@ bool VDI_AES_Entry(void)
 			  VDI_Opcode2Name(VDIOpCode, subcode));
 		}
 #endif
+		if (bUseVDIRes && ConfigureParams.Screen.bVdiHostDraw)
+		{
+			if (VDIDraw_Call(VDIControl, VDIIntin, VDIPtsin))
+				return VDI_TRAP_DONE;
+		}
 		/* Only workstation open needs to be handled at trap return */
-		return bUseVDIRes && VDI_isWorkstationOpen(VDIOpCode);
+		if (bUseVDIRes && VDI_isWorkstationOpen(VDIOpCode))
+			return VDI_TRAP_COMPLETE;
+		return VDI_TRAP_TOS;
 	}
 
 	LOG_TRACE((TRACE_OS_VDI|TRACE_OS_AES), "Trap #2 with D0 = 0x%hX\n", call);
-	return false;
+	return VDI_TRAP_TOS;
 }
 
 
@@ -872,6 +882,7 @@ void VDI_LineA(Uint32 linea, Uint32 fontbase)
 			/* set DEFAULT flag for choosen font */
 			STMemory_WriteWord(fontadr + 66, STMemory_ReadWord(fontadr + 66) | 0x01);
 		}
+		VDIDraw_SetFonts(fontbase, fontadr);
 		cel_wd = STMemory_ReadWord(fontadr + 52);
 		cel_ht = STMemory_ReadWord(fontadr + 82);
 		if (cel_wd <= 0)
@@ -906,16 +917,10 @@ void VDI_LineA(Uint32 linea, Uint32 fontbase)
 
 /*-----------------------------------------------------------------------*/
 /**
- * This is called on completion of a VDI Trap workstation open,
- * to modify the return structure for extended resolutions.
+ * Modify workstation open return values for extended resolutions
  */
-void VDI_Complete(void)
+static void VDI_CompleteOpen(void)
 {
-	/* right opcode? */
-	assert(VDI_isWorkstationOpen(VDIOpCode));
-	/* not changed between entry and completion? */
-	assert(VDIOpCode == STMemory_ReadWord(VDIControl));
-
 	STMemory_WriteWord(VDIIntout, VDIWidth-1);           /* IntOut[0] Width-1 */
 	STMemory_WriteWord(VDIIntout+1*2, VDIHeight-1);      /* IntOut[1] Height-1 */
 	STMemory_WriteWord(VDIIntout+13*2, 1 << VDIPlanes);  /* IntOut[13] #colors */
@@ -927,6 +932,22 @@ void VDI_Complete(void)
 	VDI_LineA(LineABase, FontBase);  /* And modify Line-A structure accordingly */
 }
 
+/**
+ * This is called on completion of a VDI Trap workstation open,
+ * to modify the return structure for extended resolutions, and
+ * on completion of attribute calls tracked for host side drawing.
+ */
+void VDI_Complete(void)
+{
+	/* not changed between entry and completion? */
+	assert(VDIOpCode == STMemory_ReadWord(VDIControl));
+
+	if (VDI_isWorkstationOpen(VDIOpCode))
+		VDI_CompleteOpen();
+	if (ConfigureParams.Screen.bVdiHostDraw)
+		VDIDraw_Complete(VDIControl, VDIIntin);
+}
+
 
 /*-----------------------------------------------------------------------*/
 /**
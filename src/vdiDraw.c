@@ -0,0 +1,966 @@
+/*
+  Hatari - vdiDraw.c
+
+  This file is distributed under the GNU General Public License, version 2
+  or at your option any later version. Read the file gpl.txt for details.
+
+  Host side drawing of the most common VDI primitives in the extended
+  VDI resolutions.
+
+  GEM programs do most of their redraws with few VDI calls: raster copies
+  (vro_cpyfm, vrt_cpyfm), filled rectangles (vr_recfl, v_bar), horizontal
+  and vertical lines (v_pline) and system font text (v_gtext).  When such
+  a call and the workstation attributes it uses are something handled
+  here, it's drawn directly to the screen (or MFDB) in ST RAM and the TOS
+  VDI isn't called at all.  Everything else is left to TOS.
+
+  VDI workstation attributes are private to the VDI, so they are tracked
+  for each workstation handle from the attribute calls when they're made,
+  validated the same way as TOS does it.  Only workstation opens need the
+  values returned by TOS.  Calls for handles that were opened before
+  tracking started are always given to TOS.
+*/
+const char VDIDraw_fileid[] = "Hatari vdiDraw.c : " __DATE__ " " __TIME__;
+
+#include "main.h"
+#include "configuration.h"
+#include "log.h"
+#include "memorySnapShot.h"
+#include "stMemory.h"
+#include "vdi.h"
+#include "vdiDraw.h"
+
+
+#define VDIDRAW_MAX_HANDLES 64
+#define VDIDRAW_MAX_PLANES  8
+#define VDIDRAW_MAX_WORDS   256     /* bitmap line width in words, per plane */
+#define VDIDRAW_MAX_POINTS  1024
+
+/* VDI opcodes */
+enum
+{
+	VDI_OPNWK = 1,
+	VDI_CLSWK = 2,
+	VDI_PLINE = 6,
+	VDI_GTEXT = 8,
+	VDI_GDP = 11,
+	VST_HEIGHT = 12,
+	VST_ROTATION = 13,
+	VSL_TYPE = 15,
+	VSL_WIDTH = 16,
+	VSL_COLOR = 17,
+	VST_FONT = 21,
+	VST_COLOR = 22,
+	VSF_INTERIOR = 23,
+	VSF_STYLE = 24,
+	VSF_COLOR = 25,
+	VSWR_MODE = 32,
+	VST_ALIGNMENT = 39,
+	VDI_OPNVWK = 100,
+	VDI_CLSVWK = 101,
+	VSF_PERIMETER = 104,
+	VST_EFFECTS = 106,
+	VST_POINT = 107,
+	VSL_ENDS = 108,
+	VRO_CPYFM = 109,
+	VR_RECFL = 114,
+	VRT_CPYFM = 121,
+	VS_CLIP = 129
+};
+
+#define GDP_BAR 1
+
+/* writing modes */
+#define MD_REPLACE  1
+#define MD_TRANS    2
+#define MD_XOR      3
+#define MD_ERASE    4
+
+/* fill interiors */
+#define FIS_HOLLOW  0
+#define FIS_SOLID   1
+
+/* text alignments */
+#define ALI_LEFT    0
+#define ALI_BASE    0
+#define ALI_TOP     5
+
+/* Attributes of an open workstation, -1 when TOS could have set
+ * something else than what was asked for
+ */
+typedef struct
+{
+	bool bOpen;             /* attributes are tracked for this handle */
+	Sint16 WriteMode;
+	Sint16 LineType;
+	Sint16 LineColor;
+	Sint16 LineWidth;
+	Sint16 LineBegStyle;
+	Sint16 LineEndStyle;
+	Sint16 FillInterior;
+	Sint16 FillColor;
+	Sint16 FillPerimeter;
+	Sint16 TextColor;
+	Sint16 TextEffects;
+	Sint16 TextRotation;
+	Sint16 TextHorAlign;
+	Sint16 TextVerAlign;
+	Uint32 TextFont;        /* system font header address, 0 if other font */
+	bool bSystemFace;       /* system font face (of any size) is selected */
+	bool bClip;
+	Sint16 ClipX1, ClipY1, ClipX2, ClipY2;
+} VDIDRAW_WORKSTATION;
+
+/* Screen or MFDB bitmap in device specific (interleaved planes) format */
+typedef struct
+{
+	Uint32 Addr;
+	int Width;
+	int Height;
+	int Planes;
+	int LineBytes;          /* bytes per line, for all planes */
+} VDIDRAW_BITMAP;
+
+static VDIDRAW_WORKSTATION Workstations[VDIDRAW_MAX_HANDLES];
+static Uint32 SystemFonts[3];   /* 6x6, 8x8 and 8x16 font headers */
+static Uint32 DefaultFont;
+
+/* one bitmap line, aligned to the destination pixels */
+static Uint16 LineBuf[VDIDRAW_MAX_PLANES][VDIDRAW_MAX_WORDS+1];
+
+/* VDI color index -> pixel value */
+static const Uint8 Colors2[2] = { 0, 1 };
+static const Uint8 Colors4[4] = { 0, 3, 1, 2 };
+static const Uint8 Colors16[16] = { 0, 15, 1, 2, 4, 6, 3, 5, 7, 8, 9, 10, 12, 14, 11, 13 };
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Forget all workstations, e.g. on reset
+ */
+void VDIDraw_Reset(void)
+{
+	memset(Workstations, 0, sizeof(Workstations));
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Set system font headers from the Line-A font table and the default font
+ */
+void VDIDraw_SetFonts(Uint32 FontBase, Uint32 DefFont)
+{
+	int i;
+
+	for (i = 0; i < 3; i++)
+		SystemFonts[i] = STMemory_ReadLong(FontBase + 4*i);
+	DefaultFont = DefFont;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Save/restore the tracked workstation attributes
+ */
+void VDIDraw_MemorySnapShot_Capture(bool bSave)
+{
+	MemorySnapShot_Store(Workstations, sizeof(Workstations));
+	MemorySnapShot_Store(SystemFonts, sizeof(SystemFonts));
+	MemorySnapShot_Store(&DefaultFont, sizeof(DefaultFont));
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Return tracked workstation for given control array, or NULL
+ */
+static VDIDRAW_WORKSTATION *VDIDraw_GetWorkstation(Uint32 Control)
+{
+	Uint16 handle = STMemory_ReadWord(Control + 2*6);
+
+	if (handle == 0 || handle >= VDIDRAW_MAX_HANDLES)
+		return NULL;
+	return &Workstations[handle];
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Convert VDI color index to pixel value for given number of planes.
+ * Return -1 for invalid index.
+ */
+static int VDIDraw_Pixel(int color, int planes)
+{
+	if (color < 0 || color >= (1 << planes))
+		return -1;
+	switch (planes)
+	{
+	 case 1:
+		return Colors2[color];
+	 case 2:
+		return Colors4[color];
+	 case 4:
+		return Colors16[color];
+	}
+	return -1;
+}
+
+/**
+ * Return given VDI color index, or -1 if it's not valid for the screen
+ */
+static Sint16 VDIDraw_CheckColor(Sint16 color)
+{
+	return VDIDraw_Pixel(color, VDIPlanes) < 0 ? -1 : color;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Start tracking attributes for a (virtual) workstation that TOS opened,
+ * with defaults from VDI and the values given to the open call.
+ */
+static void VDIDraw_OpenWorkstation(Uint32 Control, Uint32 Intin)
+{
+	VDIDRAW_WORKSTATION *wk;
+	Sint16 value;
+
+	wk = VDIDraw_GetWorkstation(Control);
+	if (!wk)
+		return;
+	memset(wk, 0, sizeof(*wk));
+
+	/* only raster coordinates */
+	if (STMemory_ReadWord(Intin + 2*10) != 2)
+		return;
+
+	wk->bOpen = true;
+	wk->WriteMode = MD_REPLACE;
+	wk->LineWidth = 1;
+	wk->LineBegStyle = wk->LineEndStyle = 0;
+	wk->FillPerimeter = 1;
+	wk->TextEffects = 0;
+	wk->TextRotation = 0;
+	wk->TextHorAlign = ALI_LEFT;
+	wk->TextVerAlign = ALI_BASE;
+	wk->bClip = false;
+
+	value = STMemory_ReadWord(Intin + 2*1);
+	wk->LineType = (value >= 1 && value <= 7) ? value : -1;
+	wk->LineColor = VDIDraw_CheckColor(STMemory_ReadWord(Intin + 2*2));
+	wk->bSystemFace = STMemory_ReadWord(Intin + 2*5) == 1;
+	wk->TextFont = wk->bSystemFace ? DefaultFont : 0;
+	wk->TextColor = VDIDraw_CheckColor(STMemory_ReadWord(Intin + 2*6));
+	value = STMemory_ReadWord(Intin + 2*7);
+	wk->FillInterior = (value >= 0 && value <= 4) ? value : -1;
+	wk->FillColor = VDIDraw_CheckColor(STMemory_ReadWord(Intin + 2*9));
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Return given color index the way TOS validates it (invalid ones
+ * are replaced with 1), or -1 if it's not valid for the screen.
+ */
+static Sint16 VDIDraw_ValidColor(Sint16 color)
+{
+	if (VDIDraw_CheckColor(color) < 0)
+		color = 1;
+	return VDIDraw_CheckColor(color);
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Return the system font whose header word at given offset (top line
+ * height or point size) matches the requested value.  Otherwise TOS could
+ * select a smaller font or scale one, so 0 is returned.
+ */
+static Uint32 VDIDraw_FindFont(int offset, int value)
+{
+	int i;
+
+	for (i = 0; i < 3; i++)
+	{
+		Uint32 font = SystemFonts[i];
+		if (font && STMemory_ReadWord(font + offset) == value)
+			return font;
+	}
+	return 0;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Track the attributes set by a VDI call, on trap entry.  Values are
+ * validated the same way as TOS does it.  When the result could differ
+ * from that (fonts), the attribute is set to a value which makes drawing
+ * fall back to TOS.
+ */
+static void VDIDraw_SetAttrib(VDIDRAW_WORKSTATION *wk, Uint16 opcode,
+                              Uint32 Intin, Uint32 Ptsin)
+{
+	Sint16 value, x1, y1, x2, y2;
+
+	switch (opcode)
+	{
+	 case VDI_CLSWK:
+	 case VDI_CLSVWK:
+		wk->bOpen = false;
+		break;
+	 case VSWR_MODE:
+		value = STMemory_ReadWord(Intin);
+		wk->WriteMode = (value >= MD_REPLACE && value <= MD_ERASE) ? value : MD_REPLACE;
+		break;
+	 case VSL_TYPE:
+		value = STMemory_ReadWord(Intin);
+		wk->LineType = (value >= 1 && value <= 7) ? value : 1;
+		break;
+	 case VSL_WIDTH:
+		value = STMemory_ReadWord(Ptsin);
+		if (value > 40)
+			value = 40;
+		else if (value < 1)
+			value = 1;
+		if (!(value & 1))
+			value--;
+		wk->LineWidth = value;
+		break;
+	 case VSL_COLOR:
+		wk->LineColor = VDIDraw_ValidColor(STMemory_ReadWord(Intin));
+		break;
+	 case VSL_ENDS:
+		value = STMemory_ReadWord(Intin);
+		wk->LineBegStyle = (value >= 0 && value <= 2) ? value : 0;
+		value = STMemory_ReadWord(Intin + 2);
+		wk->LineEndStyle = (value >= 0 && value <= 2) ? value : 0;
+		break;
+	 case VSF_INTERIOR:
+		value = STMemory_ReadWord(Intin);
+		wk->FillInterior = (value >= 0 && value <= 4) ? value : 0;
+		break;
+	 case VSF_COLOR:
+		wk->FillColor = VDIDraw_ValidColor(STMemory_ReadWord(Intin));
+		break;
+	 case VSF_PERIMETER:
+		wk->FillPerimeter = STMemory_ReadWord(Intin) != 0;
+		break;
+	 case VST_COLOR:
+		wk->TextColor = VDIDraw_ValidColor(STMemory_ReadWord(Intin));
+		break;
+	 case VST_EFFECTS:
+		/* TOS masks unsupported effects, any left one isn't drawn here */
+		wk->TextEffects = STMemory_ReadWord(Intin);
+		break;
+	 case VST_ROTATION:
+		/* TOS rounds the angle, only the unrotated text is drawn here */
+		wk->TextRotation = STMemory_ReadWord(Intin);
+		break;
+	 case VST_ALIGNMENT:
+		value = STMemory_ReadWord(Intin);
+		wk->TextHorAlign = (value >= 0 && value <= 2) ? value : ALI_LEFT;
+		value = STMemory_ReadWord(Intin + 2);
+		wk->TextVerAlign = (value >= 0 && value <= 5) ? value : ALI_BASE;
+		break;
+	 case VST_FONT:
+		/* other than system font size stays */
+		if (STMemory_ReadWord(Intin) != 1)
+		{
+			wk->bSystemFace = false;
+			wk->TextFont = 0;
+		}
+		break;
+	 case VST_HEIGHT:
+		/* top line height is given */
+		wk->TextFont = wk->bSystemFace ? VDIDraw_FindFont(40, STMemory_ReadWord(Ptsin + 2)) : 0;
+		break;
+	 case VST_POINT:
+		wk->TextFont = wk->bSystemFace ? VDIDraw_FindFont(2, STMemory_ReadWord(Intin)) : 0;
+		break;
+	 case VS_CLIP:
+		wk->bClip = STMemory_ReadWord(Intin) != 0;
+		x1 = STMemory_ReadWord(Ptsin);
+		y1 = STMemory_ReadWord(Ptsin + 2);
+		x2 = STMemory_ReadWord(Ptsin + 4);
+		y2 = STMemory_ReadWord(Ptsin + 6);
+		wk->ClipX1 = x1 < x2 ? x1 : x2;
+		wk->ClipX2 = x1 < x2 ? x2 : x1;
+		wk->ClipY1 = y1 < y2 ? y1 : y2;
+		wk->ClipY2 = y1 < y2 ? y2 : y1;
+		break;
+	}
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Called when TOS returns from a workstation open, to start tracking
+ * the attributes of the handle it returned.
+ */
+void VDIDraw_Complete(Uint32 Control, Uint32 Intin)
+{
+	Uint16 opcode = STMemory_ReadWord(Control);
+
+	if (opcode == VDI_OPNWK || opcode == VDI_OPNVWK)
+		VDIDraw_OpenWorkstation(Control, Intin);
+}
+
+
+/* -------------- bitmap access -------------------------------------------- */
+
+/**
+ * Return true if whole bitmap is in ST RAM and of supported size
+ */
+static bool VDIDraw_CheckBitmap(const VDIDRAW_BITMAP *bm)
+{
+	Uint32 size;
+
+	if ((bm->Addr & 1) || bm->Planes < 1 || bm->Planes > VDIDRAW_MAX_PLANES
+	    || bm->Width <= 0 || bm->Height <= 0
+	    || bm->LineBytes % (2*bm->Planes) != 0
+	    || bm->LineBytes / (2*bm->Planes) > VDIDRAW_MAX_WORDS
+	    || bm->Width > bm->LineBytes / bm->Planes * 8)
+		return false;
+
+	size = bm->LineBytes * bm->Height;
+	return bm->Addr < STRamEnd && size <= STRamEnd - bm->Addr;
+}
+
+/**
+ * Set up bitmap for the screen VDI draws to
+ */
+static bool VDIDraw_GetScreen(VDIDRAW_BITMAP *bm)
+{
+	bm->Addr = STMemory_ReadLong(0x44e);	/* _v_bas_ad */
+	bm->Width = VDIWidth;
+	bm->Height = VDIHeight;
+	bm->Planes = VDIPlanes;
+	bm->LineBytes = VDIWidth * VDIPlanes / 8;
+	return VDIDraw_CheckBitmap(bm);
+}
+
+/**
+ * Set up bitmap from given MFDB, screen for NULL address
+ */
+static bool VDIDraw_GetMFDB(Uint32 mfdb, VDIDRAW_BITMAP *bm)
+{
+	Uint32 addr;
+
+	if (!STMemory_CheckAreaType(mfdb, 20, ABFLAG_RAM))
+		return false;
+
+	addr = STMemory_ReadLong(mfdb);
+	if (addr == 0)
+		return VDIDraw_GetScreen(bm);
+
+	/* only device specific format */
+	if (STMemory_ReadWord(mfdb + 10) != 0)
+		return false;
+
+	bm->Addr = addr;
+	bm->Width = (Sint16)STMemory_ReadWord(mfdb + 4);
+	bm->Height = (Sint16)STMemory_ReadWord(mfdb + 6);
+	bm->Planes = (Sint16)STMemory_ReadWord(mfdb + 12);
+	bm->LineBytes = (Sint16)STMemory_ReadWord(mfdb + 8) * 2 * bm->Planes;
+	return VDIDraw_CheckBitmap(bm);
+}
+
+/**
+ * Return host pointer to the word containing pixel x on line y of given plane
+ */
+static inline Uint8 *VDIDraw_WordPtr(const VDIDRAW_BITMAP *bm, int x, int y, int plane)
+{
+	return &STRam[bm->Addr + y * bm->LineBytes + ((x >> 4) * bm->Planes + plane) * 2];
+}
+
+/**
+ * Return 16 pixels of given bitmap plane starting from pixel x, which
+ * can be at any bit position.  Pixels outside the bitmap line are zero.
+ */
+static Uint16 VDIDraw_GetBits(const VDIDRAW_BITMAP *bm, int x, int y, int plane)
+{
+	int words = bm->LineBytes / (2 * bm->Planes);
+	int word = (x + 16) / 16 - 1;     /* rounds also negative x down */
+	int shift = x - word * 16;
+	Uint32 bits = 0;
+	Uint8 *p = &STRam[bm->Addr + y * bm->LineBytes + plane * 2];
+
+	if (word >= 0 && word < words)
+		bits = do_get_mem_word(p + word * bm->Planes * 2) << 16;
+	if (shift && word + 1 >= 0 && word + 1 < words)
+		bits |= do_get_mem_word(p + (word + 1) * bm->Planes * 2);
+	return bits >> (16 - shift);
+}
+
+/**
+ * Read pixels x1-x2 of given bitmap line to LineBuf[] so that pixel x1
+ * ends up at bit position of destination pixel dx1 within its word.
+ */
+static void VDIDraw_ReadLine(const VDIDRAW_BITMAP *bm, int x1, int x2, int y, int dx1)
+{
+	int plane, w, words, x;
+
+	words = ((dx1 + x2 - x1) >> 4) - (dx1 >> 4) + 1;
+	for (plane = 0; plane < bm->Planes; plane++)
+	{
+		/* source pixel matching the first pixel of the destination word */
+		x = x1 - (dx1 & 15);
+		for (w = 0; w < words; w++, x += 16)
+			LineBuf[plane][w] = VDIDraw_GetBits(bm, x, y, plane);
+	}
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Draw pixels x1-x2 on given bitmap line with given writing mode
+ * (replace, transparent or XOR), foreground and background pixel values.
+ * 'pattern' gives the foreground bits for each word from the one
+ * containing x1, NULL means that all bits are 'fill'.
+ */
+static void VDIDraw_Line(const VDIDRAW_BITMAP *bm, int x1, int x2, int y,
+                         const Uint16 *pattern, Uint16 fill, int mode, int fg, int bg)
+{
+	Uint16 fgbits[VDIDRAW_MAX_PLANES], bgbits[VDIDRAW_MAX_PLANES];
+	Uint16 mask, bits, d;
+	int plane, w, words;
+	Uint8 *p;
+
+	for (plane = 0; plane < bm->Planes; plane++)
+	{
+		fgbits[plane] = (fg >> plane) & 1 ? 0xffff : 0;
+		bgbits[plane] = (bg >> plane) & 1 ? 0xffff : 0;
+	}
+	p = VDIDraw_WordPtr(bm, x1, y, 0);
+	words = (x2 >> 4) - (x1 >> 4) + 1;
+
+	for (w = 0; w < words; w++, p += bm->Planes * 2)
+	{
+		mask = 0xffff;
+		if (w == 0)
+			mask &= 0xffff >> (x1 & 15);
+		if (w == words - 1)
+			mask &= 0xffff << (15 - (x2 & 15));
+		bits = pattern ? pattern[w] : fill;
+
+		for (plane = 0; plane < bm->Planes; plane++)
+		{
+			d = do_get_mem_word(p + plane * 2);
+			switch (mode)
+			{
+			 case MD_REPLACE:
+				d = (d & ~mask) | (mask & ((bits & fgbits[plane]) | (~bits & bgbits[plane])));
+				break;
+			 case MD_TRANS:
+				d = (d & ~(mask & bits)) | (mask & bits & fgbits[plane]);
+				break;
+			 case MD_XOR:
+				d ^= mask & bits;
+				break;
+			}
+			do_put_mem_word(p + plane * 2, d);
+		}
+	}
+	STMemory_MarkAreaWritten(bm->Addr + y * bm->LineBytes + (x1 >> 4) * bm->Planes * 2,
+	                         words * bm->Planes * 2);
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Get the area where given workstation draws on the screen
+ */
+static void VDIDraw_GetClip(const VDIDRAW_WORKSTATION *wk, const VDIDRAW_BITMAP *bm,
+                            int *x1, int *y1, int *x2, int *y2)
+{
+	*x1 = 0;
+	*y1 = 0;
+	*x2 = bm->Width - 1;
+	*y2 = bm->Height - 1;
+	if (wk->bClip)
+	{
+		if (wk->ClipX1 > *x1)
+			*x1 = wk->ClipX1;
+		if (wk->ClipY1 > *y1)
+			*y1 = wk->ClipY1;
+		if (wk->ClipX2 < *x2)
+			*x2 = wk->ClipX2;
+		if (wk->ClipY2 < *y2)
+			*y2 = wk->ClipY2;
+	}
+}
+
+/**
+ * Fill given rectangle, clipped to the workstation clip area.
+ */
+static void VDIDraw_FillRect(const VDIDRAW_WORKSTATION *wk, const VDIDRAW_BITMAP *bm,
+                             int x1, int y1, int x2, int y2,
+                             Uint16 fill, int mode, int fg)
+{
+	int cx1, cy1, cx2, cy2, y;
+
+	VDIDraw_GetClip(wk, bm, &cx1, &cy1, &cx2, &cy2);
+	if (x1 < cx1)
+		x1 = cx1;
+	if (y1 < cy1)
+		y1 = cy1;
+	if (x2 > cx2)
+		x2 = cx2;
+	if (y2 > cy2)
+		y2 = cy2;
+
+	for (y = y1; y <= y2 && x1 <= x2; y++)
+		VDIDraw_Line(bm, x1, x2, y, NULL, fill, mode, fg, 0);
+}
+
+
+/* -------------- VDI functions -------------------------------------------- */
+
+/**
+ * vr_recfl() and v_bar(): filled rectangle, v_bar() with perimeter
+ */
+static bool VDIDraw_Bar(const VDIDRAW_WORKSTATION *wk, Uint32 Ptsin, bool bPerimeter)
+{
+	VDIDRAW_BITMAP bm;
+	Sint16 x1, y1, x2, y2, tmp;
+	Uint16 fill;
+	int fg;
+
+	if (wk->FillInterior == FIS_SOLID)
+		fill = 0xffff;
+	else if (wk->FillInterior == FIS_HOLLOW)
+		fill = 0;
+	else
+		return false;
+
+	/* perimeter is drawn in fill color over the edges,
+	 * only solid lines with non-XOR modes are handled
+	 */
+	bPerimeter = bPerimeter && wk->FillPerimeter;
+	if (bPerimeter && wk->WriteMode != MD_REPLACE && wk->WriteMode != MD_TRANS)
+		return false;
+	if (wk->WriteMode < MD_REPLACE || wk->WriteMode > MD_XOR)
+		return false;
+	if (wk->FillColor < 0 || !VDIDraw_GetScreen(&bm))
+		return false;
+	fg = VDIDraw_Pixel(wk->FillColor, bm.Planes);
+
+	x1 = STMemory_ReadWord(Ptsin);
+	y1 = STMemory_ReadWord(Ptsin + 2);
+	x2 = STMemory_ReadWord(Ptsin + 4);
+	y2 = STMemory_ReadWord(Ptsin + 6);
+	if (x1 > x2)
+	{
+		tmp = x1; x1 = x2; x2 = tmp;
+	}
+	if (y1 > y2)
+	{
+		tmp = y1; y1 = y2; y2 = tmp;
+	}
+
+	VDIDraw_FillRect(wk, &bm, x1, y1, x2, y2, fill, wk->WriteMode, fg);
+	if (bPerimeter && fill != 0xffff)
+	{
+		VDIDraw_FillRect(wk, &bm, x1, y1, x2, y1, 0xffff, wk->WriteMode, fg);
+		VDIDraw_FillRect(wk, &bm, x1, y2, x2, y2, 0xffff, wk->WriteMode, fg);
+		VDIDraw_FillRect(wk, &bm, x1, y1, x1, y2, 0xffff, wk->WriteMode, fg);
+		VDIDraw_FillRect(wk, &bm, x2, y1, x2, y2, 0xffff, wk->WriteMode, fg);
+	}
+	return true;
+}
+
+
+/**
+ * v_pline(): only solid, one pixel wide, horizontal and vertical lines
+ * without XOR, so that the way TOS draws line ends and joints doesn't
+ * matter.
+ */
+static bool VDIDraw_PolyLine(const VDIDRAW_WORKSTATION *wk, Uint32 Control, Uint32 Ptsin)
+{
+	VDIDRAW_BITMAP bm;
+	Sint16 x1, y1, x2, y2;
+	int count, i, fg;
+
+	if (wk->LineType != 1 || wk->LineWidth != 1
+	    || wk->LineBegStyle != 0 || wk->LineEndStyle != 0
+	    || (wk->WriteMode != MD_REPLACE && wk->WriteMode != MD_TRANS))
+		return false;
+	if (wk->LineColor < 0 || !VDIDraw_GetScreen(&bm))
+		return false;
+	fg = VDIDraw_Pixel(wk->LineColor, bm.Planes);
+
+	count = (Sint16)STMemory_ReadWord(Control + 2*1);
+	if (count < 2 || count > VDIDRAW_MAX_POINTS)
+		return false;
+	for (i = 0; i < count - 1; i++)
+	{
+		x1 = STMemory_ReadWord(Ptsin + 4*i);
+		y1 = STMemory_ReadWord(Ptsin + 4*i + 2);
+		x2 = STMemory_ReadWord(Ptsin + 4*i + 4);
+		y2 = STMemory_ReadWord(Ptsin + 4*i + 6);
+		if (x1 != x2 && y1 != y2)
+			return false;
+	}
+
+	x2 = STMemory_ReadWord(Ptsin);
+	y2 = STMemory_ReadWord(Ptsin + 2);
+	for (i = 1; i < count; i++)
+	{
+		x1 = x2;
+		y1 = y2;
+		x2 = STMemory_ReadWord(Ptsin + 4*i);
+		y2 = STMemory_ReadWord(Ptsin + 4*i + 2);
+		VDIDraw_FillRect(wk, &bm, x1 < x2 ? x1 : x2, y1 < y2 ? y1 : y2,
+		                 x1 < x2 ? x2 : x1, y1 < y2 ? y2 : y1,
+		                 0xffff, wk->WriteMode, fg);
+	}
+	return true;
+}
+
+
+/**
+ * v_gtext(): system fonts without effects or rotation, left aligned
+ * to baseline or top line.
+ */
+static bool VDIDraw_Text(const VDIDRAW_WORKSTATION *wk, Uint32 Control,
+                         Uint32 Intin, Uint32 Ptsin)
+{
+	VDIDRAW_BITMAP bm;
+	Uint32 font, offtable, dattable;
+	int count, first, last, formwidth, formheight;
+	int x, y, cx1, cy1, cx2, cy2, x1, x2, row, i, fg;
+	Uint16 chars[VDIDRAW_MAX_POINTS];
+
+	font = wk->TextFont;
+	if (!font || wk->TextEffects != 0 || wk->TextRotation != 0
+	    || wk->TextHorAlign != ALI_LEFT
+	    || (wk->TextVerAlign != ALI_BASE && wk->TextVerAlign != ALI_TOP))
+		return false;
+	if (wk->WriteMode < MD_REPLACE || wk->WriteMode > MD_XOR)
+		return false;
+	if (wk->TextColor < 0 || !VDIDraw_GetScreen(&bm))
+		return false;
+	fg = VDIDraw_Pixel(wk->TextColor, bm.Planes);
+
+	/* not byte swapped font data */
+	if (STMemory_ReadWord(font + 66) & 0x04)
+		return false;
+	first = STMemory_ReadWord(font + 36);
+	last = STMemory_ReadWord(font + 38);
+	offtable = STMemory_ReadLong(font + 72);
+	dattable = STMemory_ReadLong(font + 76);
+	formwidth = STMemory_ReadWord(font + 80);
+	formheight = STMemory_ReadWord(font + 82);
+
+	count = (Sint16)STMemory_ReadWord(Control + 2*3);
+	if (count < 0 || count > VDIDRAW_MAX_POINTS)
+		return false;
+	for (i = 0; i < count; i++)
+	{
+		chars[i] = STMemory_ReadWord(Intin + 2*i);
+		if (chars[i] < first || chars[i] > last)
+			return false;
+	}
+
+	x = (Sint16)STMemory_ReadWord(Ptsin);
+	y = (Sint16)STMemory_ReadWord(Ptsin + 2);
+	if (wk->TextVerAlign == ALI_BASE)
+		y -= STMemory_ReadWord(font + 40);	/* top line distance */
+
+	/* horizontal extent of the text, clipped */
+	VDIDraw_GetClip(wk, &bm, &cx1, &cy1, &cx2, &cy2);
+	x2 = x;
+	for (i = 0; i < count; i++)
+		x2 += STMemory_ReadWord(offtable + 2*(chars[i] - first + 1))
+		      - STMemory_ReadWord(offtable + 2*(chars[i] - first));
+	x1 = x < cx1 ? cx1 : x;
+	x2 = x2 - 1 > cx2 ? cx2 : x2 - 1;
+	if (x1 > x2)
+		return true;
+
+	for (row = 0; row < formheight; row++)
+	{
+		int px, w;
+
+		if (y + row < cy1 || y + row > cy2)
+			continue;
+
+		/* collect glyph bits of the whole line */
+		w = (x2 >> 4) - (x1 >> 4) + 1;
+		memset(LineBuf[0], 0, w * sizeof(LineBuf[0][0]));
+		px = x;
+		for (i = 0; i < count && px <= x2; i++)
+		{
+			int off = STMemory_ReadWord(offtable + 2*(chars[i] - first));
+			int width = STMemory_ReadWord(offtable + 2*(chars[i] - first + 1)) - off;
+			Uint32 data = dattable + row * formwidth;
+			int b;
+
+			for (b = 0; b < width; b++, px++)
+			{
+				int bit = off + b;
+				if (px < x1 || px > x2)
+					continue;
+				if (STMemory_ReadByte(data + bit / 8) & (0x80 >> (bit & 7)))
+					LineBuf[0][(px >> 4) - (x1 >> 4)] |= 0x8000 >> (px & 15);
+			}
+		}
+		VDIDraw_Line(&bm, x1, x2, y + row, LineBuf[0], 0, wk->WriteMode, fg, 0);
+	}
+	return true;
+}
+
+
+/**
+ * vro_cpyfm() and vrt_cpyfm(): opaque and transparent raster copies.
+ * Destinations that would be clipped are left to TOS.
+ */
+static bool VDIDraw_CopyRaster(const VDIDRAW_WORKSTATION *wk, Uint32 Control,
+                               Uint32 Intin, Uint32 Ptsin, bool bTransparent)
+{
+	VDIDRAW_BITMAP src, dst;
+	Sint16 pxy[8];
+	int mode, fg = 0, bg = 0, width, height, y, dy, step, cx1, cy1, cx2, cy2;
+	int plane, w, words, count;
+	Uint16 m11, m10, m01, m00, mask, s, d;
+	Uint8 *p;
+
+	for (count = 0; count < 8; count++)
+		pxy[count] = STMemory_ReadWord(Ptsin + 2*count);
+	mode = (Sint16)STMemory_ReadWord(Intin);
+
+	if (!VDIDraw_GetMFDB(STMemory_ReadLong(Control + 2*7), &src)
+	    || !VDIDraw_GetMFDB(STMemory_ReadLong(Control + 2*9), &dst))
+		return false;
+
+	if (bTransparent)
+	{
+		if (src.Planes != 1 || mode < MD_REPLACE || mode > MD_XOR)
+			return false;
+		fg = VDIDraw_Pixel((Sint16)STMemory_ReadWord(Intin + 2), dst.Planes);
+		bg = VDIDraw_Pixel((Sint16)STMemory_ReadWord(Intin + 4), dst.Planes);
+		if (fg < 0 || bg < 0)
+			return false;
+	}
+	else if (src.Planes != dst.Planes || mode < 0 || mode > 15)
+		return false;
+
+	/* only sorted source corners, both rectangles inside bitmaps */
+	width = pxy[2] - pxy[0] + 1;
+	height = pxy[3] - pxy[1] + 1;
+	if (width <= 0 || height <= 0)
+		return false;
+	pxy[6] = pxy[4] + width - 1;
+	pxy[7] = pxy[5] + height - 1;
+	if (pxy[0] < 0 || pxy[1] < 0 || pxy[2] >= src.Width || pxy[3] >= src.Height
+	    || pxy[4] < 0 || pxy[5] < 0 || pxy[6] >= dst.Width || pxy[7] >= dst.Height)
+		return false;
+	if (wk->bClip)
+	{
+		VDIDraw_GetClip(wk, &dst, &cx1, &cy1, &cx2, &cy2);
+		if (pxy[4] < cx1 || pxy[5] < cy1 || pxy[6] > cx2 || pxy[7] > cy2)
+			return false;
+	}
+
+	/* copy lines in the order that works with overlapping areas */
+	if (src.Addr == dst.Addr && pxy[5] > pxy[1])
+	{
+		y = height - 1;
+		step = -1;
+	}
+	else
+	{
+		y = 0;
+		step = 1;
+	}
+
+	m11 = (mode & 1) ? 0xffff : 0;
+	m10 = (mode & 2) ? 0xffff : 0;
+	m01 = (mode & 4) ? 0xffff : 0;
+	m00 = (mode & 8) ? 0xffff : 0;
+	words = (pxy[6] >> 4) - (pxy[4] >> 4) + 1;
+
+	for (count = 0; count < height; count++, y += step)
+	{
+		dy = pxy[5] + y;
+		VDIDraw_ReadLine(&src, pxy[0], pxy[2], pxy[1] + y, pxy[4]);
+		if (bTransparent)
+		{
+			VDIDraw_Line(&dst, pxy[4], pxy[6], dy, LineBuf[0], 0, mode, fg, bg);
+			continue;
+		}
+
+		p = VDIDraw_WordPtr(&dst, pxy[4], dy, 0);
+		for (w = 0; w < words; w++, p += dst.Planes * 2)
+		{
+			mask = 0xffff;
+			if (w == 0)
+				mask &= 0xffff >> (pxy[4] & 15);
+			if (w == words - 1)
+				mask &= 0xffff << (15 - (pxy[6] & 15));
+			for (plane = 0; plane < dst.Planes; plane++)
+			{
+				s = LineBuf[plane][w];
+				d = do_get_mem_word(p + plane * 2);
+				s = (s & d & m11) | (s & ~d & m10) | (~s & d & m01) | (~s & ~d & m00);
+				do_put_mem_word(p + plane * 2, (d & ~mask) | (s & mask));
+			}
+		}
+		STMemory_MarkAreaWritten(dst.Addr + dy * dst.LineBytes + (pxy[4] >> 4) * dst.Planes * 2,
+		                         words * dst.Planes * 2);
+	}
+	return true;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Draw given VDI call on host, if it's something that can be done here,
+ * and track the attributes set by other calls.
+ * Return true if call was handled, false if TOS needs to do it.
+ */
+bool VDIDraw_Call(Uint32 Control, Uint32 Intin, Uint32 Ptsin)
+{
+	VDIDRAW_WORKSTATION *wk;
+	Uint16 opcode;
+	bool bDone;
+
+	wk = VDIDraw_GetWorkstation(Control);
+	if (!wk || !wk->bOpen)
+		return false;
+
+	opcode = STMemory_ReadWord(Control);
+	switch (opcode)
+	{
+	 case VDI_PLINE:
+		bDone = VDIDraw_PolyLine(wk, Control, Ptsin);
+		break;
+	 case VDI_GTEXT:
+		bDone = VDIDraw_Text(wk, Control, Intin, Ptsin);
+		break;
+	 case VDI_GDP:
+		bDone = STMemory_ReadWord(Control + 2*5) == GDP_BAR
+		        && VDIDraw_Bar(wk, Ptsin, true);
+		break;
+	 case VR_RECFL:
+		bDone = VDIDraw_Bar(wk, Ptsin, false);
+		break;
+	 case VRO_CPYFM:
+		bDone = VDIDraw_CopyRaster(wk, Control, Intin, Ptsin, false);
+		break;
+	 case VRT_CPYFM:
+		bDone = VDIDraw_CopyRaster(wk, Control, Intin, Ptsin, true);
+		break;
+	 default:
+		/* TOS still does attribute calls, they're only tracked here */
+		VDIDraw_SetAttrib(wk, opcode, Intin, Ptsin);
+		return false;
+	}
+	if (!bDone)
+		return false;
+
+	/* no output */
+	STMemory_WriteWord(Control + 2*2, 0);
+	STMemory_WriteWord(Control + 2*4, 0);
+	LOG_TRACE(TRACE_OS_VDI, "VDI call %3hd drawn on host\n", opcode);
+	return true;
+}
@@ -468,6 +468,7 @@ const char Video_fileid[] = "Hatari video.c : " __DATE__ " " __TIME__;
 int STRes = ST_LOW_RES;                         /* current ST resolution */
 int TTRes;                                      /* TT shifter resolution mode */
 int nFrameSkips;                                /* speed up by skipping video frames */
+bool bSkipScreenDraw;                           /* don't draw frames, their output won't be shown */
 
 bool bUseHighRes;                               /* Use hi-res (ie Mono monitor) */
 int VerticalOverscan;				/* V_OVERSCAN_xxxx for current display frame */
@@ -529,6 +530,31 @@ const int VblJitterArrayPending[] = {
 
 static int	BlankLines = 0;			/* Number of empty line with no signal (by switching hi/lo near cycles 500) */
 
+#define	LINE_BATCH_MAX		32		/* Max number of lines handled by a single HBL interrupt */
+static int	LineBatchEnd = -1;		/* Line of the HBL interrupt ending the current batch, or -1 */
+static int	LineBatchAccessVBL = -1;	/* Value of nVBLs the last time a video register was accessed */
+
+/* Each line copied to a frame buffer is stored with its address in ST RAM and the */
+/* write stamp at that time. When the same buffer receives the same line later and */
+/* the ST RAM was not modified in between, the buffer already holds the correct */
+/* data and the copy is skipped. */
+#define	LINE_CAPTURE_LINES	400			/* Max number of lines in a buffer (mono) */
+#define	LINE_CAPTURE_BUFFERS	( NUM_FRAMEBUFFERS*3 )	/* pSTScreen, pSTScreenCopy, pSTScreenSpare */
+#define	LINE_CAPTURE_NONE	0xffffffff		/* Line is not a plain copy of ST RAM */
+#define	LINE_CAPTURE_BLANK	0xfffffffe		/* Line is cleared to color 0 */
+
+typedef struct
+{
+	Uint8	*pBuffer;				/* Frame buffer for these lines, or NULL */
+	int	Layout;					/* Bytes per line and bytes in left border */
+	Uint32	LastVBL;				/* Value of nVBLs when the buffer was last used */
+	Uint32	Addr[ LINE_CAPTURE_LINES ];		/* Address of each line in ST RAM */
+	Uint32	Stamp[ LINE_CAPTURE_LINES ];		/* ST RAM write stamp when the line was copied */
+} LINE_CAPTURE;
+
+static LINE_CAPTURE	LineCaptures[ LINE_CAPTURE_BUFFERS ];
+static LINE_CAPTURE	*pLineCapture;			/* Lines of the buffer used by pSTScreen */
+
 
 typedef struct
 {
@@ -679,6 +705,14 @@ static void	Video_ClearOnVBL(void);
 static void	Video_AddInterrupt ( int Line , int PosCycles , interrupt_id Handler );
 static void	Video_AddInterruptHBL ( int Line , int Pos );
 
+static void	Video_LineBatch_ProcessLines ( int LastLine , int FrameCycles );
+static bool	Video_LineBatch_Start ( int FrameCycles , int HblPos );
+static void	Video_LineBatch_RegAccess ( void );
+
+static void	Video_LineCapture_Reset ( void );
+static void	Video_LineCapture_StartFrame ( void );
+static bool	Video_LineCapture_Check ( int LineBytes , int LeftBytes , Uint32 Addr , int Size );
+
 static void	Video_ColorReg_WriteWord(void);
 static void	Video_ColorReg_ReadWord(void);
 
@@ -722,6 +756,8 @@ void Video_MemorySnapShot_Capture(bool bSave)
 	MemorySnapShot_Store(&VblJitterIndex, sizeof(VblJitterIndex));
 	MemorySnapShot_Store(&ShifterFrame, sizeof(ShifterFrame));
 	MemorySnapShot_Store(&TTSpecialVideoMode, sizeof(TTSpecialVideoMode));
+	MemorySnapShot_Store(&LineBatchEnd, sizeof(LineBatchEnd));
+	MemorySnapShot_Store(&LineBatchAccessVBL, sizeof(LineBatchAccessVBL));
 }
 
 
@@ -739,6 +775,11 @@ void Video_Reset(void)
 
 	/* Reset VBL counter */
 	nVBLs = 0;
+	/* Don't process lines in batches during the first VBLs */
+	LineBatchEnd = -1;
+	LineBatchAccessVBL = 0;
+	/* Forget the content of the frame buffers */
+	Video_LineCapture_Reset();
 	/* Reset addresses */
 	VideoBase = 0L;
 
@@ -1062,6 +1103,12 @@ void	Video_ConvertPosition ( int FrameCycles , int *pHBL , int *pLineCycles )
 			*pLineCycles = FrameCycles - ShifterFrame.ShifterLines[ nHBL-1 ].StartCycle;
 		}
 	
+		else if ( LineBatchEnd >= 0 )				/* some lines will be processed later as a batch */
+		{
+			*pHBL = nHBL + *pLineCycles / nCyclesPerLine;
+			*pLineCycles %= nCyclesPerLine;
+		}
+
 		else if ( *pLineCycles >= nCyclesPerLine )		/* reading on the next line, but HBL int was delayed */
 		{
 			*pHBL = nHBL+1;
@@ -2543,6 +2590,8 @@ void Video_Sync_WriteByte ( void )
 	if ( bUseVDIRes )
 		return;						/* no 50/60 Hz freq in VDI mode */
 
+	Video_LineBatch_RegAccess();
+
 	/* We're only interested in bit 1 (50/60Hz) */
 	Freq = IoMem[0xff820a] & 2;
 
@@ -2740,6 +2789,7 @@ void Video_InterruptHandler_HBL ( void )
 	int FrameCycles , HblCounterVideo , LineCycles;
 	int PendingCyclesOver;
 	int NewHBLPos;
+	bool bLineBatchDone = false;
 
 	Video_GetPosition ( &FrameCycles , &HblCounterVideo , &LineCycles );
 
@@ -2773,6 +2823,15 @@ void Video_InterruptHandler_HBL ( void )
 	}
 
 
+	/* This HBL ends a batch of lines : process the lines before this one */
+	if ( LineBatchEnd >= 0 )
+	{
+		Video_LineBatch_ProcessLines ( LineBatchEnd , FrameCycles );
+		LineBatchEnd = -1;
+		bLineBatchDone = true;
+	}
+
+
 	if (Config_IsMachineFalcon())
 	{
 		VIDEL_VideoRasterHBL();
@@ -2835,7 +2894,16 @@ void Video_InterruptHandler_HBL ( void )
 		NewHBLPos = Video_HBL_GetDefaultPos();
 		ShifterFrame.HBL_CyclePos = NewHBLPos;
 //fprintf ( stderr , "NewHBLPos %d\n", NewHBLPos );
-		Video_AddInterruptHBL ( nHBL , NewHBLPos );
+
+		/* If possible, handle the next lines with a single HBL interrupt, */
+		/* else restore the EndLine interrupt if it was removed for a batch */
+		if ( !Video_LineBatch_Start ( FrameCycles , NewHBLPos ) )
+		{
+			Video_AddInterruptHBL ( nHBL , NewHBLPos );
+			if ( bLineBatchDone )
+				Video_AddInterruptTimerB ( nHBL , FrameCycles - ShifterFrame.ShifterLines[ nHBL ].StartCycle ,
+							   Video_TimerB_GetDefaultPos() );
+		}
 
 		/* Add new VBL interrupt just after the last HBL (for example : VblVideoCycleOffset cycles after end of HBL 312 at 50 Hz) */
 		/* We setup VBL one HBL earlier (eg at nHBL=312 instead of 313) to be sure we don't miss it */
@@ -2880,6 +2948,236 @@ void Video_InterruptHandler_HBL ( void )
 }
 
 
+/*-----------------------------------------------------------------------*/
+/**
+ * When no raster effects are possible, the HBL interrupts of several lines
+ * can be replaced by a single one at the end of the last line (the EndLine
+ * interrupt is not needed either). The HBL pending bit is already set and
+ * can't be acknowledged by the CPU (IPL >= 2), so the skipped lines are
+ * processed all at once when this HBL happens, or before the current
+ * state is needed (video register access, HBL IACK, timer B event count
+ * mode, DMA sound start, ...).
+ * Lines are not batched during a VBL where a video register was accessed,
+ * nor during the next one, nor when an IPF image is inserted (the FDC is
+ * only updated on each HBL and its registers can be read without catching up).
+ * As lines are copied from ST RAM at the end of the batch, writes to the
+ * screen memory during a batch can be visible in lines already displayed,
+ * which is why batching is not enabled by default.
+ */
+static bool Video_LineBatch_Possible ( void )
+{
+	return ConfigureParams.Screen.bLineBatch
+		&& ( Config_IsMachineST() || Config_IsMachineSTE() )
+		&& !bUseVDIRes
+		&& ( LineBatchAccessVBL < nVBLs - 1 )
+		&& !RestartVideoCounter
+		&& ( regs.intmask >= 2 )
+		&& ( pendingInterrupts & ( 1 << 2 ) )
+		&& ( MFP_TBCR != 0x08 )
+		&& !( nDmaSoundControl & DMASNDCTRL_PLAY )
+		&& !IPF_IsActive();
+}
+
+
+/**
+ * Start a batch on the current line nHBL : remove the HBL/EndLine interrupts
+ * and add a single HBL interrupt at the end of the last line of the batch.
+ * The batch must end before the lines where the video counter is restarted
+ * and before the last line (where the next VBL is set), as these need
+ * some special handling in the HBL interrupt.
+ * Return false if no batch was started.
+ */
+static bool Video_LineBatch_Start ( int FrameCycles , int HblPos )
+{
+	int LastLine;
+
+	if ( !Video_LineBatch_Possible() )
+		return false;
+
+	LastLine = nHBL + LINE_BATCH_MAX;
+	if ( LastLine > nScanlinesPerFrame - 2 )
+		LastLine = nScanlinesPerFrame - 2;
+	if ( ( pVideoTiming->RestartVideoCounter_Line_50 > nHBL ) && ( LastLine >= pVideoTiming->RestartVideoCounter_Line_50 ) )
+		LastLine = pVideoTiming->RestartVideoCounter_Line_50 - 1;
+	if ( ( pVideoTiming->RestartVideoCounter_Line_60 > nHBL ) && ( LastLine >= pVideoTiming->RestartVideoCounter_Line_60 ) )
+		LastLine = pVideoTiming->RestartVideoCounter_Line_60 - 1;
+	if ( LastLine <= nHBL )
+		return false;
+
+	CycInt_RemovePendingInterrupt ( INTERRUPT_VIDEO_ENDLINE );
+	CycInt_AddRelativeInterrupt ( ( HblPos << nCpuFreqShift ) + ShifterFrame.ShifterLines[ nHBL ].StartCycle
+				      + ( LastLine - nHBL ) * nCyclesPerLine - FrameCycles , INT_CPU_CYCLE , INTERRUPT_VIDEO_HBL );
+	LineBatchEnd = LastLine;
+
+	LOG_TRACE ( TRACE_VIDEO_HBL , "HBL %d start batch until HBL %d\n" , nHBL , LastLine );
+	return true;
+}
+
+
+/**
+ * Process the lines of the current batch until LastLine (not included),
+ * as long as their HBL position is before FrameCycles. This does the same
+ * work as Video_InterruptHandler_HBL for each line, except setting the
+ * HBL pending bit which is already set.
+ */
+static void Video_LineBatch_ProcessLines ( int LastLine , int FrameCycles )
+{
+	int HblPos = ShifterFrame.HBL_CyclePos << nCpuFreqShift;
+
+	while ( ( nHBL < LastLine ) && ( ShifterFrame.ShifterLines[ nHBL ].StartCycle + HblPos <= FrameCycles ) )
+	{
+		HblJitterIndex++;
+		HblJitterIndex %= HBL_JITTER_ARRAY_SIZE;
+
+		Video_EndHBL();
+		DmaSnd_STE_HBL_Update();
+		IPF_Emulate();
+
+		nHBL++;
+		ShifterFrame.ShifterLines[ nHBL ].StartCycle = ShifterFrame.ShifterLines[ nHBL-1 ].StartCycle + nCyclesPerLine;
+		Video_StartHBL();
+	}
+}
+
+
+/**
+ * Stop the current batch of lines (if any) : process the lines whose HBL
+ * position was already reached and go back to one HBL/EndLine interrupt
+ * per line.
+ */
+void Video_LineBatch_Stop ( void )
+{
+	int FrameCycles , HblCounterVideo , LineCycles;
+
+	if ( LineBatchEnd < 0 )
+		return;
+
+	Video_GetPosition ( &FrameCycles , &HblCounterVideo , &LineCycles );
+	Video_LineBatch_ProcessLines ( LineBatchEnd , FrameCycles );
+
+	/* If the HBL ending the batch was not reached yet, add the HBL for the current line */
+	if ( nHBL < LineBatchEnd )
+	{
+		CycInt_RemovePendingInterrupt ( INTERRUPT_VIDEO_HBL );
+		Video_AddInterruptHBL ( nHBL , ShifterFrame.HBL_CyclePos );
+	}
+	LineBatchEnd = -1;
+
+	Video_AddInterruptTimerB ( nHBL , FrameCycles - ShifterFrame.ShifterLines[ nHBL ].StartCycle ,
+				   Video_TimerB_GetDefaultPos() );
+
+	LOG_TRACE ( TRACE_VIDEO_HBL , "HBL %d stop batch video_cyc=%d\n" , nHBL , FrameCycles );
+}
+
+
+/**
+ * Called when a video register is accessed : stop the current batch and
+ * don't start new ones during this VBL and the next one.
+ */
+static void Video_LineBatch_RegAccess ( void )
+{
+	Video_LineBatch_Stop();
+	LineBatchAccessVBL = nVBLs;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Forget the content of all the frame buffers (on reset, the buffers
+ * could have been reallocated).
+ */
+static void Video_LineCapture_Reset ( void )
+{
+	memset ( LineCaptures , 0 , sizeof ( LineCaptures ) );
+	pLineCapture = NULL;
+}
+
+
+/**
+ * Called on VBL when pSTScreen points to the start of a new frame buffer :
+ * get the lines stored for this buffer. Buffers are rotated by screen.c,
+ * so they are identified by their address.
+ */
+static void Video_LineCapture_StartFrame ( void )
+{
+	LINE_CAPTURE	*pOldest;
+	int		i;
+
+	/* Writes from now on are newer than the lines copied until now */
+	if ( !STMemory_NewWriteStamp() )
+		Video_LineCapture_Reset();
+
+	pLineCapture = NULL;
+	pOldest = &LineCaptures[ 0 ];
+	for ( i = 0 ; i < LINE_CAPTURE_BUFFERS ; i++ )
+	{
+		if ( LineCaptures[ i ].pBuffer == pSTScreen )
+		{
+			pLineCapture = &LineCaptures[ i ];
+			break;
+		}
+		if ( LineCaptures[ i ].LastVBL < pOldest->LastVBL )
+			pOldest = &LineCaptures[ i ];
+	}
+
+	if ( pLineCapture == NULL )			/* new buffer, content is unknown */
+	{
+		pLineCapture = pOldest;
+		pLineCapture->pBuffer = pSTScreen;
+		pLineCapture->Layout = 0;
+		memset ( pLineCapture->Addr , 0xff , sizeof ( pLineCapture->Addr ) );
+	}
+	pLineCapture->LastVBL = nVBLs;
+}
+
+
+/**
+ * Check if the buffer line pointed to by pSTScreen already holds the data
+ * that should be copied to it : Size bytes from the ST RAM at Addr, stored
+ * after LeftBytes in the line (and the rest of the line cleared to 0).
+ * Addr can also be LINE_CAPTURE_BLANK for a line cleared to 0, or
+ * LINE_CAPTURE_NONE for a line built in any other way.
+ * Return true if the buffer line is valid and the copy can be skipped,
+ * else the line is stored as the new content of the buffer line and the
+ * caller must copy it.
+ */
+static bool Video_LineCapture_Check ( int LineBytes , int LeftBytes , Uint32 Addr , int Size )
+{
+	int	Offset;
+	int	Line;
+	int	Layout;
+
+	if ( pLineCapture == NULL )
+		return false;
+
+	Offset = pSTScreen - pLineCapture->pBuffer;
+	Line = Offset / LineBytes;
+	Layout = ( LineBytes << 16 ) | LeftBytes;
+
+	/* If the lines' size or position changed, all lines in the buffer are unknown */
+	if ( Layout != pLineCapture->Layout || Offset % LineBytes != 0 )
+	{
+		memset ( pLineCapture->Addr , 0xff , sizeof ( pLineCapture->Addr ) );
+		pLineCapture->Layout = ( Offset % LineBytes == 0 ) ? Layout : 0;
+	}
+	if ( Offset < 0 || Line >= LINE_CAPTURE_LINES || pLineCapture->Layout == 0 )
+		return false;
+
+	/* Writes are only tracked in RAM (not for the IO area for example) */
+	if ( ( Addr < LINE_CAPTURE_BLANK ) && ( Addr + Size > STRamEnd ) )
+		Addr = LINE_CAPTURE_NONE;
+
+	if ( ( Addr != LINE_CAPTURE_NONE ) && ( pLineCapture->Addr[ Line ] == Addr )
+	  && ( ( Addr == LINE_CAPTURE_BLANK )
+	    || !STMemory_IsAreaWrittenSince ( Addr , Size , pLineCapture->Stamp[ Line ] ) ) )
+		return true;
+
+	pLineCapture->Addr[ Line ] = Addr;
+	pLineCapture->Stamp[ Line ] = STMemory_WriteStamp;
+	return false;
+}
+
+
 /*-----------------------------------------------------------------------*/
 /**
  * Check at end of each HBL to see if any Shifter hardware tricks have been attempted
@@ -3179,8 +3477,13 @@ static void Video_StoreResolution(int y , bool start)
  */
 static void Video_CopyScreenLineMono(void)
 {
+	Uint32 CaptureAddr;
+
 	/* Copy one line - 80 bytes in ST high resolution */
-	memcpy(pSTScreen, pVideoRaster, SCREENBYTES_MONOLINE);
+	/* (unless the buffer already holds it, which can't be used with fine scrolling) */
+	CaptureAddr = HWScrollCount ? LINE_CAPTURE_NONE : (Uint32)( pVideoRaster - STRam );
+	if ( !Video_LineCapture_Check ( SCREENBYTES_MONOLINE , 0 , CaptureAddr , SCREENBYTES_MONOLINE ) )
+		memcpy(pSTScreen, pVideoRaster, SCREENBYTES_MONOLINE);
 	pVideoRaster += SCREENBYTES_MONOLINE;
 
 	/* Handle STE fine scrolling (HWScrollCount is zero on ST). */
@@ -3265,6 +3568,8 @@ static void Video_CopyScreenLineColor(void)
 	Uint8 *pVideoRasterEndLine;			/* addr of the last byte copied from pVideoRaster to pSTScreen (for HWScrollCount) */
 	int i;
 	Uint32 VideoMask;
+	Uint32 CaptureAddr;
+	bool bLineCached;
 
 	LineBorderMask = ShifterFrame.ShifterLines[ nHBL ].BorderMask;
 	STF_PixelScroll = ShifterFrame.ShifterLines[ nHBL ].DisplayPixelShift;
@@ -3339,16 +3644,26 @@ static void Video_CopyScreenLineColor(void)
 		// fprintf(stderr , "scr off %d %d\n" , STF_PixelScroll , VideoOffset);
 	}
 
+	/* Without border removal and scrolling, the line is a plain copy of 160 bytes */
+	/* from ST RAM, which can be skipped if the buffer already holds the same line */
+	if ( LineBorderMask == 0 && STF_PixelScroll == 0 && !bSteBorderFlag && !HWScrollCount )
+		CaptureAddr = pVideoRaster - STRam;
+	else
+		CaptureAddr = LINE_CAPTURE_NONE;
+
 
 	/* Is total blank line? I.e. top/bottom border? */
 	if ((nHBL < nStartHBL) || (nHBL >= nEndHBL + BlankLines)
 	    || (LineBorderMask & ( BORDERMASK_EMPTY_LINE|BORDERMASK_NO_DE ) ))
 	{
 		/* Clear line to color '0' */
-		memset(pSTScreen, 0, SCREENBYTES_LINE);
+		if ( !Video_LineCapture_Check ( SCREENBYTES_LINE , SCREENBYTES_LEFT , LINE_CAPTURE_BLANK , 0 ) )
+			memset(pSTScreen, 0, SCREENBYTES_LINE);
 	}
 	else
 	{
+		bLineCached = Video_LineCapture_Check ( SCREENBYTES_LINE , SCREENBYTES_LEFT , CaptureAddr , SCREENBYTES_MIDDLE );
+
 		/* Does have left border ? */
 		if ( LineBorderMask & ( BORDERMASK_LEFT_OFF | BORDERMASK_LEFT_OFF_MED ) )	/* bigger line by 26 bytes on the left */
 		{
@@ -3394,7 +3709,7 @@ static void Video_CopyScreenLineColor(void)
 
 			pVideoRaster += 4*2;
 		}
-		else
+		else if ( !bLineCached )
 			memset(pSTScreen,0,SCREENBYTES_LEFT);		/* left border not removed, clear to color '0' */
 
 		/* Short line due to hires in the middle ? */
@@ -3408,7 +3723,8 @@ static void Video_CopyScreenLineColor(void)
 		else
 		{
 			/* normal middle part (160 bytes) */
-			memcpy(pSTScreen+SCREENBYTES_LEFT, pVideoRaster, SCREENBYTES_MIDDLE);
+			if ( !bLineCached )
+				memcpy(pSTScreen+SCREENBYTES_LEFT, pVideoRaster, SCREENBYTES_MIDDLE);
 			pVideoRaster += SCREENBYTES_MIDDLE;
 		}
 
@@ -3429,7 +3745,8 @@ static void Video_CopyScreenLineColor(void)
 		else
 		{
 			/* Simply clear right border to '0' */
-			memset(pSTScreen+SCREENBYTES_LEFT+SCREENBYTES_MIDDLE,0,SCREENBYTES_RIGHT);
+			if ( !bLineCached )
+				memset(pSTScreen+SCREENBYTES_LEFT+SCREENBYTES_MIDDLE,0,SCREENBYTES_RIGHT);
 			pVideoRasterEndLine = pVideoRaster;
 		}
 
@@ -3915,6 +4232,7 @@ static void Video_ClearOnVBL(void)
 		Video_RestartVideoCounter();
 
 	pSTScreen = pFrameBuffer->pSTScreen;
+	Video_LineCapture_StartFrame();
 
 	Video_SetScreenRasters();
 	Video_InitShifterLines();
@@ -4057,7 +4375,7 @@ bool Video_RenderTTScreen(void)
 static void Video_DrawScreen(void)
 {
 	/* Skip frame if need to */
-	if (nVBLs % (nFrameSkips+1))
+	if (nVBLs % (nFrameSkips+1) || bSkipScreenDraw || !Screen_FrameNeeded())
 		return;
 
 	/* Now draw the screen! */
@@ -4092,6 +4410,9 @@ static void Video_DrawScreen(void)
 
 		Screen_Draw();
 	}
+
+	/* Save screenshot deferred until there was a frame to save */
+	ScreenSnapShot_FrameDone();
 }
 
 
@@ -4375,6 +4696,8 @@ void Video_ScreenCounter_ReadByte(void)
 {
 	Uint32 addr;
 
+	Video_LineBatch_RegAccess();
+
 	addr = Video_CalculateAddress();		/* get current video address */
 
 	/* On STE, handle modifications of the video counter address $ff8205/07/09 */
@@ -4416,6 +4739,8 @@ void Video_ScreenCounter_WriteByte(void)
 	int Delayed;
 	int MMUStartCycle;
 
+	Video_LineBatch_RegAccess();
+
 	Video_GetPosition_OnWriteAccess ( &FrameCycles , &HblCounterVideo , &LineCycles );
 	LineCycles = VIDEO_CYCLE_TO_HPOS ( LineCycles );
 
@@ -4581,6 +4906,8 @@ void Video_LineWidth_WriteByte(void)
 	int FrameCycles, HblCounterVideo, LineCycles;
 	int Delayed;
 
+	Video_LineBatch_RegAccess();
+
 	Video_GetPosition_OnWriteAccess ( &FrameCycles , &HblCounterVideo , &LineCycles );
 	LineCycles = VIDEO_CYCLE_TO_HPOS ( LineCycles );
 
@@ -4627,6 +4954,8 @@ static void Video_ColorReg_WriteWord(void)
 
 	addr = IoAccessCurrentAddress;
 
+	Video_LineBatch_RegAccess();
+
 	/* Access to shifter regs are on a 4 cycle boundary */
 	M68000_SyncCpuBus_OnWriteAccess();
 
@@ -4905,6 +5234,25 @@ void Video_Color15_ReadWord(void)
 	Video_ColorReg_ReadWord();
 }
 
+/*
+ * Native long access to 2 consecutive color regs : ioMem.c calls these
+ * once for the whole .L access, which is then handled as 2 .W accesses
+ * like on a real 68000.
+ */
+void Video_ColorRegs_ReadLong(void)
+{
+	Video_ColorReg_ReadWord();
+	IoAccessCurrentAddress += 2;
+	Video_ColorReg_ReadWord();
+}
+
+void Video_ColorRegs_WriteLong(void)
+{
+	Video_ColorReg_WriteWord();
+	IoAccessCurrentAddress += 2;
+	Video_ColorReg_WriteWord();
+}
+
 
 /*-----------------------------------------------------------------------*/
 /**
@@ -4933,6 +5281,8 @@ void Video_Res_WriteByte(void)
 	}
 	else if (!bUseVDIRes)	/* ST and STE mode */
 	{
+		Video_LineBatch_RegAccess();
+
 		/* We only care for lower 2-bits */
 		VideoShifterByte = IoMem[0xff8260] & 3;
 		/* 3 is not a valid resolution, use high res instead */
@@ -5042,6 +5392,8 @@ void Video_HorScroll_Write(void)
 	static Uint8 LastVal8265 = 0;
 	int Delayed;
 
+	Video_LineBatch_RegAccess();
+
 	Video_GetPosition_OnWriteAccess ( &FrameCycles , &HblCounterVideo , &LineCycles );
 	LineCycles = VIDEO_CYCLE_TO_HPOS ( LineCycles );
 
@@ -0,0 +1,343 @@
+/*
+ * Code to compare the two host backends of the FPU emulation in
+ * src/cpu/fpp.c : host double (USE_LONG_DOUBLE=0) and host long double
+ * (USE_LONG_DOUBLE=1, 64-bit mantissa like the 6888x extended precision).
+ *
+ * This file is built once for each backend. The ops below use the same
+ * formulas as arithmetic_fp() and the same fp_*() functions (fpp-math.h).
+ *
+ * "fputest-d > results.txt" prints the double results for random operands,
+ * "fputest-ld results.txt" computes the same ops in long double, rounds
+ * them to double and reports the difference in units in the last place
+ * (ulps) for each op.  It fails when an op differs by more than expected
+ * from the rounding of each backend.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
+
+#ifndef USE_LONG_DOUBLE
+#error "Build with -DUSE_LONG_DOUBLE=0 or -DUSE_LONG_DOUBLE=1"
+#endif
+
+#if USE_LONG_DOUBLE
+typedef long double fptype;
+#else
+typedef double fptype;
+#endif
+
+#include "fpp-math.h"
+
+#define ARRAY_SIZE(x) (int)(sizeof(x)/sizeof(x[0]))
+
+#define NUM_OPERANDS	10000
+
+/* log2(e), as in fp_l2_e */
+#define FP_L2_E		((fptype)1.44269504088896340735992468100189214L)
+
+/* Operand ranges */
+enum {
+	RANGE_ANY,	/* +/- 2^-30 .. 2^30 */
+	RANGE_POS,	/* 2^-30 .. 2^30 */
+	RANGE_UNIT,	/* -1 .. 1 */
+	RANGE_EXP,	/* +/- 2^-8 .. 2^6, results stay finite */
+	RANGE_MOD,	/* dividend of FMOD/FREM, the quotient must fit an int */
+	RANGE_DIVISOR,	/* +/- 2^-4 .. 2^4 */
+	RANGE_SCALE	/* integers -16 .. 16 */
+};
+
+typedef struct {
+	const char *name;
+	int range;	/* range of the source operand */
+	int dstrange;	/* range of the destination operand, -1 for monadic ops */
+	int maxulps;	/* maximum expected difference */
+} fpu_op_t;
+
+static const fpu_op_t ops[] = {
+	{ "FINTRZ",	RANGE_ANY,	-1,		0 },
+	{ "FSQRT",	RANGE_POS,	-1,		1 },
+	{ "FSINH",	RANGE_EXP,	-1,		4 },
+	{ "FLOGNP1",	RANGE_POS,	-1,		4 },
+	{ "FETOXM1",	RANGE_EXP,	-1,		4 },
+	{ "FTANH",	RANGE_ANY,	-1,		4 },
+	{ "FATAN",	RANGE_ANY,	-1,		4 },
+	{ "FASIN",	RANGE_UNIT,	-1,		4 },
+	{ "FATANH",	RANGE_UNIT,	-1,		4 },
+	{ "FSIN",	RANGE_EXP,	-1,		4 },
+	{ "FTAN",	RANGE_EXP,	-1,		4 },
+	{ "FETOX",	RANGE_EXP,	-1,		4 },
+	{ "FTWOTOX",	RANGE_EXP,	-1,		4 },
+	{ "FTENTOX",	RANGE_EXP,	-1,		4 },
+	{ "FLOGN",	RANGE_POS,	-1,		4 },
+	{ "FLOG10",	RANGE_POS,	-1,		4 },
+	{ "FLOG2",	RANGE_POS,	-1,		4 },
+	{ "FCOSH",	RANGE_EXP,	-1,		4 },
+	{ "FACOS",	RANGE_UNIT,	-1,		4 },
+	{ "FCOS",	RANGE_EXP,	-1,		4 },
+	{ "FGETEXP",	RANGE_ANY,	-1,		0 },
+	{ "FGETMAN",	RANGE_ANY,	-1,		0 },
+	{ "FDIV",	RANGE_ANY,	RANGE_ANY,	1 },
+	{ "FMOD",	RANGE_DIVISOR,	RANGE_MOD,	2 },
+	{ "FADD",	RANGE_ANY,	RANGE_ANY,	1 },
+	{ "FMUL",	RANGE_ANY,	RANGE_ANY,	1 },
+	{ "FREM",	RANGE_DIVISOR,	RANGE_MOD,	2 },
+	{ "FSCALE",	RANGE_SCALE,	RANGE_ANY,	0 },
+	{ "FSUB",	RANGE_ANY,	RANGE_ANY,	1 },
+};
+
+
+/* Same operations as arithmetic_fp() in src/cpu/fpp.c */
+static fptype fpu_op(const char *name, fptype src, fptype dst)
+{
+	int expon;
+
+	if (!strcmp(name, "FINTRZ"))
+		return fp_round_to_zero(src);
+	if (!strcmp(name, "FSQRT"))
+		return fp_sqrt(src);
+	if (!strcmp(name, "FSINH"))
+		return fp_sinh(src);
+	if (!strcmp(name, "FLOGNP1"))
+		return fp_log1p(src);
+	if (!strcmp(name, "FETOXM1"))
+		return fp_expm1(src);
+	if (!strcmp(name, "FTANH"))
+		return fp_tanh(src);
+	if (!strcmp(name, "FATAN"))
+		return fp_atan(src);
+	if (!strcmp(name, "FASIN"))
+		return fp_asin(src);
+	if (!strcmp(name, "FATANH"))
+		return fp_atanh(src);
+	if (!strcmp(name, "FSIN"))
+		return fp_sin(src);
+	if (!strcmp(name, "FTAN"))
+		return fp_tan(src);
+	if (!strcmp(name, "FETOX"))
+		return fp_exp(src);
+	if (!strcmp(name, "FTWOTOX"))
+		return fp_pow(2.0, src);
+	if (!strcmp(name, "FTENTOX"))
+		return fp_pow(10.0, src);
+	if (!strcmp(name, "FLOGN"))
+		return fp_log(src);
+	if (!strcmp(name, "FLOG10"))
+		return fp_log10(src);
+	if (!strcmp(name, "FLOG2"))
+		return FP_L2_E * fp_log(src);
+	if (!strcmp(name, "FCOSH"))
+		return fp_cosh(src);
+	if (!strcmp(name, "FACOS"))
+		return fp_acos(src);
+	if (!strcmp(name, "FCOS"))
+		return fp_cos(src);
+	if (!strcmp(name, "FGETEXP")) {
+		if (src == 0)
+			return 0;
+		fp_frexp(src, &expon);
+		return (fptype)(expon - 1);
+	}
+	if (!strcmp(name, "FGETMAN")) {
+		if (src == 0)
+			return 0;
+		return fp_frexp(src, &expon) * 2.0;
+	}
+	if (!strcmp(name, "FDIV"))
+		return dst / src;
+	if (!strcmp(name, "FMOD")) {
+		fptype quot = fp_round_to_zero(dst / src);
+		return dst - quot * src;
+	}
+	if (!strcmp(name, "FADD"))
+		return dst + src;
+	if (!strcmp(name, "FMUL"))
+		return dst * src;
+	if (!strcmp(name, "FREM")) {
+		fptype quot = fp_round_to_nearest(dst / src);
+		return dst - quot * src;
+	}
+	if (!strcmp(name, "FSCALE")) {
+		if (src != 0)
+			return fp_ldexp(dst, (int)src);
+		return dst;
+	}
+	if (!strcmp(name, "FSUB"))
+		return dst - src;
+
+	fprintf(stderr, "Unknown op '%s'\n", name);
+	exit(1);
+}
+
+
+/* Simple LCG, so that both builds get the same operands on any host */
+static uint32_t rnd_state = 0x1234567;
+
+static uint32_t rnd(void)
+{
+	rnd_state = rnd_state * 1103515245 + 12345;
+	return rnd_state >> 8;
+}
+
+/* Random double (exactly representable in both backends) in given range */
+static double rnd_operand(int range)
+{
+	uint32_t hi = rnd(), lo = rnd();
+	double mant = 1.0 + hi / 16777216.0 + lo / 281474976710656.0;	/* 48-bit mantissa */
+	bool neg = rnd() & 1;
+	double value;
+
+	switch (range) {
+	case RANGE_POS:
+		return ldexp(mant, (int)(rnd() % 61) - 30);
+	case RANGE_UNIT:
+		value = ldexp(mant, -(int)(rnd() % 31) - 1);
+		break;
+	case RANGE_EXP:
+		value = ldexp(mant, (int)(rnd() % 14) - 8);
+		break;
+	case RANGE_MOD:
+		value = ldexp(mant, (int)(rnd() % 21));
+		break;
+	case RANGE_DIVISOR:
+		value = ldexp(mant, (int)(rnd() % 9) - 4);
+		break;
+	case RANGE_SCALE:
+		value = (int)(rnd() % 17);
+		break;
+	default:
+		value = ldexp(mant, (int)(rnd() % 61) - 30);
+		break;
+	}
+	return neg ? -value : value;
+}
+
+
+/* Map a double to an integer which is ordered like the doubles */
+static int64_t double_to_ordered(double d)
+{
+	int64_t i;
+
+	memcpy(&i, &d, sizeof(i));
+	return i < 0 ? INT64_MIN - i : i;
+}
+
+/* Distance between 2 doubles in ulps, huge if only one is a NaN */
+static int64_t ulps_diff(double a, double b)
+{
+	int64_t diff;
+
+	if (isnan(a) || isnan(b))
+		return (isnan(a) && isnan(b)) ? 0 : INT64_MAX;
+	diff = double_to_ordered(a) - double_to_ordered(b);
+	return diff < 0 ? -diff : diff;
+}
+
+/* Scale used for the difference of FMOD/FREM results, which are
+ * computed by subtracting values of the order of the dividend */
+static double error_scale(const char *name, double dst, double result)
+{
+	if (!strcmp(name, "FMOD") || !strcmp(name, "FREM"))
+		return fabs(dst);
+	return fabs(result);
+}
+
+
+/* Print the results of this backend for all ops */
+static int dump_results(void)
+{
+	int op, i;
+
+	for (op = 0; op < ARRAY_SIZE(ops); op++) {
+		for (i = 0; i < NUM_OPERANDS; i++) {
+			double src = rnd_operand(ops[op].range);
+			double dst = ops[op].dstrange >= 0 ? rnd_operand(ops[op].dstrange) : 0.0;
+			double result = (double)fpu_op(ops[op].name, src, dst);
+			printf("%s %a %a %a\n", ops[op].name, src, dst, result);
+		}
+	}
+	return 0;
+}
+
+/* Compare the results of the other backend with this one */
+static int compare_results(const char *filename)
+{
+	char name[16];
+	double src, dst, other, result;
+	int64_t diff, maxdiff[ARRAY_SIZE(ops)];
+	int op, count[ARRAY_SIZE(ops)], over[ARRAY_SIZE(ops)];
+	int tests = 0, errors = 0;
+	FILE *fp;
+
+	fp = fopen(filename, "r");
+	if (!fp) {
+		perror(filename);
+		return 1;
+	}
+	memset(maxdiff, 0, sizeof(maxdiff));
+	memset(count, 0, sizeof(count));
+	memset(over, 0, sizeof(over));
+
+	while (fscanf(fp, "%15s %la %la %la", name, &src, &dst, &other) == 4) {
+		for (op = 0; op < ARRAY_SIZE(ops); op++)
+			if (!strcmp(name, ops[op].name))
+				break;
+		if (op == ARRAY_SIZE(ops)) {
+			fprintf(stderr, "Unknown op '%s' in %s\n", name, filename);
+			fclose(fp);
+			return 1;
+		}
+		result = (double)fpu_op(name, src, dst);
+
+		diff = ulps_diff(result, other);
+		if (diff && !isnan(result) && !isnan(other)) {
+			/* express the difference relative to the scale of the op */
+			double scale = error_scale(name, dst, result);
+			if (scale != 0 && isfinite(scale) && isfinite(result) && isfinite(other)) {
+				double ulps = ceil(fabs(result - other) / ldexp(1.0, ilogb(scale) - 52));
+				diff = (int64_t)ulps;
+			}
+		}
+		if (diff > maxdiff[op])
+			maxdiff[op] = diff;
+		if (diff > ops[op].maxulps) {
+			if (over[op] == 0)
+				fprintf(stderr, "- %s %a, %a: %a instead of %a\n",
+					name, src, dst, other, result);
+			over[op]++;
+		}
+		count[op]++;
+	}
+	fclose(fp);
+
+	fprintf(stderr, "\nMaximum difference of the double results (in ulps):\n");
+	for (op = 0; op < ARRAY_SIZE(ops); op++) {
+		fprintf(stderr, "- %-8s %3lld (%d/%d above %d)\n", ops[op].name,
+			(long long)maxdiff[op], over[op], count[op], ops[op].maxulps);
+		if (count[op] == 0 || over[op])
+			errors++;
+		tests++;
+	}
+
+	if (errors) {
+		fprintf(stderr, "\n***Detected %d ERRORs in %d automated tests!***\n\n",
+			errors, tests);
+	} else {
+		fprintf(stderr, "\nFinished without any errors!\n\n");
+	}
+	return errors;
+}
+
+
+int main(int argc, const char *argv[])
+{
+	if (argc > 2) {
+		fprintf(stderr, "usage: %s [results of the other backend]\n", argv[0]);
+		return 1;
+	}
+	if (argc == 2)
+		return compare_results(argv[1]);
+	return dump_results();
+}
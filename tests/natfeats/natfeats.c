@@ -99,8 +99,173 @@ void nf_exit(long exitval)
 	}
 }
 
+/* memory & host file features take cycle accounting option
+ * as subid bit 0, and then process at most NF_CYCLES_MAX_BYTES
+ * per call, so the functions below loop over larger areas
+ */
+#define NF_CYCLES_MAX_BYTES 2048
+
+static long nf_cycles_id(const char *name, int cycles)
+{
+	long id;
+	if (nf_ok && (id = nf_id(name))) {
+		if (cycles) {
+			id |= 0x0001;
+		}
+		return id;
+	}
+	Cconws(name);
+	Cconws(" unavailable!\r\n");
+	return 0;
+}
+
+/* call NF taking buffer, value & length until whole length is processed,
+ * value is an address or offset advanced with the buffer if 'step' is set
+ */
+static long nf_loop(long id, char *buf, unsigned long value, unsigned long len, int step)
+{
+	unsigned long done = 0;
+	long ret;
+	while (done < len) {
+		ret = nf_call(id, (long)(buf + done), step ? value + done : value, len - done);
+		if (ret <= 0) {
+			return done ? (long)done : ret;
+		}
+		done += ret;
+	}
+	return done;
+}
+
+long nf_memcpy(void *dst, const void *src, unsigned long len, int cycles)
+{
+	long id;
+	if (!(id = nf_cycles_id("NF_MEMCPY", cycles))) {
+		return -1;
+	}
+	return nf_loop(id, dst, (unsigned long)src, len, 1);
+}
+
+long nf_memset(void *dst, int value, unsigned long len, int cycles)
+{
+	long id;
+	if (!(id = nf_cycles_id("NF_MEMSET", cycles))) {
+		return -1;
+	}
+	return nf_loop(id, dst, value, len, 0);
+}
+
+long nf_memcmp(const void *s1, const void *s2, unsigned long len, int cycles)
+{
+	const char *p1 = s1, *p2 = s2;
+	unsigned long chunk;
+	long id, ret;
+	if (!(id = nf_cycles_id("NF_MEMCMP", cycles))) {
+		return -1;
+	}
+	do {
+		chunk = (cycles && len > NF_CYCLES_MAX_BYTES) ? NF_CYCLES_MAX_BYTES : len;
+		ret = nf_call(id, (long)p1, (long)p2, chunk);
+		p1 += chunk;
+		p2 += chunk;
+		len -= chunk;
+	} while (!ret && len);
+	return ret;
+}
+
+unsigned long nf_crc32(const void *buf, unsigned long len, unsigned long crc, int cycles)
+{
+	const char *p = buf;
+	unsigned long chunk;
+	long id;
+	if (!(id = nf_cycles_id("NF_CRC32", cycles))) {
+		return 0;
+	}
+	do {
+		chunk = (cycles && len > NF_CYCLES_MAX_BYTES) ? NF_CYCLES_MAX_BYTES : len;
+		crc = nf_call(id, (long)p, chunk, crc);
+		p += chunk;
+		len -= chunk;
+	} while (len);
+	return crc;
+}
+
+/* host file operation is given as subid above cycle accounting bit */
+long nf_hostfile_read(void *buf, unsigned long offset, unsigned long len, int cycles)
+{
+	long id;
+	if (!(id = nf_cycles_id("NF_HOSTFILE", cycles))) {
+		return -1;
+	}
+	return nf_loop(id, buf, offset, len, 1);
+}
+
+long nf_hostfile_write(const void *buf, unsigned long offset, unsigned long len, int cycles)
+{
+	long id;
+	if (!(id = nf_cycles_id("NF_HOSTFILE", cycles))) {
+		return -1;
+	}
+	return nf_loop(id | 0x0002, (char *)buf, offset, len, 1);
+}
+
+long nf_hostfile_size(void)
+{
+	long id;
+	if (!(id = nf_cycles_id("NF_HOSTFILE", 0))) {
+		return -1;
+	}
+	return nf_call(id | 0x0004);
+}
+
 #ifdef TEST
 
+/* check memory features with a round trip, return number of failures */
+static int nf_testmem(void)
+{
+	/* larger than what's processed in one call with cycle accounting */
+	static char src[2*NF_CYCLES_MAX_BYTES+16], dst[2*NF_CYCLES_MAX_BYTES+16];
+	static const char digits[] = "123456789";
+	int i, failed = 0;
+
+	for (i = 0; i < (int)sizeof(src); i++) {
+		src[i] = i;
+	}
+	if (nf_memset(dst, 0xa5, sizeof(dst), 0) != sizeof(dst) ||
+	    dst[0] != (char)0xa5 || dst[sizeof(dst)-1] != (char)0xa5) {
+		nf_print("NF_MEMSET failed!\n");
+		failed++;
+	}
+	if (nf_memcmp(src, dst, sizeof(src), 0) == 0) {
+		nf_print("NF_MEMCMP didn't notice a difference!\n");
+		failed++;
+	}
+	if (nf_memcpy(dst, src, sizeof(dst), 1) != sizeof(dst) ||
+	    dst[sizeof(dst)-1] != src[sizeof(src)-1]) {
+		nf_print("NF_MEMCPY failed!\n");
+		failed++;
+	}
+	if (nf_memcmp(src, dst, sizeof(src), 1) != 0) {
+		nf_print("NF_MEMCMP after NF_MEMCPY failed!\n");
+		failed++;
+	}
+	/* standard CRC-32 check value */
+	if (nf_crc32(digits, 9, 0, 0) != 0xCBF43926UL) {
+		nf_print("NF_CRC32 of \"123456789\" isn't 0xCBF43926!\n");
+		failed++;
+	}
+	/* same in two parts */
+	if (nf_crc32(digits+4, 5, nf_crc32(digits, 4, 0, 0), 0) != 0xCBF43926UL) {
+		nf_print("Chained NF_CRC32 failed!\n");
+		failed++;
+	}
+	/* with cycle accounting, area is processed in several calls */
+	if (nf_crc32(src, sizeof(src), 0, 1) != nf_crc32(src, sizeof(src), 0, 0)) {
+		nf_print("NF_CRC32 with cycle accounting failed!\n");
+		failed++;
+	}
+	return failed;
+}
+
 /* show emulator name */
 static void nf_showname(void)
 {
@@ -130,6 +295,7 @@ static int wait_key(void)
 int main()
 {
 	long old_ff;
+	int failed;
 	if (!nf_init()) {
 		Cconws("\r\nStart Hatari with '--natfeats yes' option!\r\n");
 		wait_key();
@@ -138,11 +304,14 @@ int main()
 	old_ff = nf_fastforward(1);
 	nf_print("Emulator name:\n");
 	nf_showname();
+	nf_print("Testing memory features...\n");
+	failed = nf_testmem();
+	nf_print(failed ? "Memory features FAILED\n" : "Memory features OK\n");
 	nf_print("Invoking debugger...\n");
 	nf_debugger();
 	nf_print("Restoring fastforward & shutting down...\n");
 	nf_fastforward(old_ff);
-	nf_exit(0);
+	nf_exit(failed);
 	wait_key();
 	return 0;
 }
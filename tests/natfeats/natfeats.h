@@ -69,4 +69,38 @@ extern void nf_shutdown(void);
  */
 extern void nf_exit(long exitval);
 
+/**
+ * host speed memory operations on ST/TT RAM
+ * (Hatari specific)
+ * if 'cycles' is set, emulated time advances as if done by a 68000 loop
+ * (Hatari then processes at most 2 KB per call, these functions loop)
+ * memcpy & memset return byte count, memcmp returns -1, 0 or 1
+ */
+extern long nf_memcpy(void *dst, const void *src, unsigned long len, int cycles);
+extern long nf_memset(void *dst, int value, unsigned long len, int cycles);
+extern long nf_memcmp(const void *s1, const void *s2, unsigned long len, int cycles);
+
+/**
+ * return CRC-32 (same as zlib) of given memory area,
+ * 'crc' is CRC of the preceding data, zero for the first area
+ * (Hatari specific)
+ */
+extern unsigned long nf_crc32(const void *buf, unsigned long len, unsigned long crc, int cycles);
+
+/**
+ * read/write blocks of the host file given with --natfeats-file option
+ * (Hatari specific)
+ * if 'cycles' is set, emulated time advances as if the data was copied
+ * returns number of bytes read/written, or -1 for error
+ */
+extern long nf_hostfile_read(void *buf, unsigned long offset, unsigned long len, int cycles);
+extern long nf_hostfile_write(const void *buf, unsigned long offset, unsigned long len, int cycles);
+
+/**
+ * return size of the host file given with --natfeats-file option
+ * (Hatari specific)
+ * returns -1 for error
+ */
+extern long nf_hostfile_size(void);
+
 #endif /* _NATFEAT_H */